@@ -13,6 +13,8 @@
 rm -rf ../../Unix/Source
 rm -rf ../../Unix/APIincludes
 rm -rf ../../Unix/Examples
+rm -f ../../Unix/Benchmark
+rm -f ../../Unix/TexturePrepTest
 
 
 
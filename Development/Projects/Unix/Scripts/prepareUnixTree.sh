@@ -27,6 +27,9 @@ ln -sf ../../../Source/Renderers
 
 popd
 
+ln -sf ../../../SDK/Extras/QuesaBench/Source Benchmark
+ln -sf ../../../SDK/Extras/TexturePrepTest/Source TexturePrepTest
+
 mkdir Examples
 pushd Examples
 
@@ -79,6 +79,7 @@
 #include "E3GeometryTriangle.h"
 #include "E3GeometryTriGrid.h"
 #include "E3GeometryTriMesh.h"
+#include "E3Profile.h"
 
 
 
@@ -607,6 +608,8 @@ e3geometry_cache_update(TQ3ViewObject theView,
 						TQ3ObjectType objectType, TQ3GeometryObject theGeom,
 						const void   *geomData,   TQ3Object         *cachedGeom)
 	{
+	Q3_PROFILE_SCOPE( "e3geometry_cache_update" ) ;
+	Q3_PROFILE_COUNT( "Geometry cache rebuilds", 1 ) ;
 
 
 
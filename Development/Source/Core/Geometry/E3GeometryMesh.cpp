@@ -49,6 +49,13 @@
 #include "E3GeometryMesh.h"
 #include "E3ArrayOrList.h"
 #include "E3Pool.h"
+#include "E3Tessellate.h"
+#include "E3GeometryTriMesh.h"
+#include "E3Utils.h"
+
+#include <stdint.h>
+#include <vector>
+#include <unordered_map>
 
 
 
@@ -214,6 +221,43 @@ public :
 	TE3MeshData			instanceData ; // N.B. NOT TQ3MeshData
 
 	} ;
+
+
+
+// Largest single-contour face which is ear-clipped rather than handed to the
+// tessellator; ear clipping is quadratic in the number of vertices.
+const TQ3Uns32 kE3MeshEarClipMaxVertices					= 64;
+
+
+
+// Working state for decomposing a mesh into a single TriMesh
+struct TE3MeshTriMeshBuilder {
+	// TriMesh points, and a reference to each point's attribute set
+	std::vector<TQ3Point3D>							points;
+	std::vector<TQ3AttributeSet>					pointAttributes;
+	
+	// TriMesh point for each vertex without a corner, or each corner
+	std::unordered_map<const void*, TQ3Uns32>		pointIndices;
+
+	// Triangles, and the attribute set of the face each came from
+	std::vector<TQ3TriMeshTriangleData>				triangles;
+	std::vector<TQ3AttributeSet>					triangleAttributes;
+	std::vector<TQ3TriMeshEdgeData>					edges;
+	
+	// Reference to the set used for the triangles of each face attribute set,
+	// which inherits from the mesh attribute set if there is one
+	std::unordered_map<TQ3AttributeSet, TQ3AttributeSet>	faceSets;
+
+	// Scratch space for the current face
+	TQ3AttributeSet									faceAttributes;
+	std::vector<TQ3Vertex3D>						faceVertices;
+	std::vector<TQ3Uns32>							facePoints;
+	std::vector<TQ3GeneralPolygonContourData>		faceContours;
+	std::vector<TQ3Point2D>							facePoints2D;
+	std::vector<TQ3Uns32>							faceRing;
+	std::unordered_map<const TQ3Vertex3D*, TQ3Uns32>	tessellatedPoints;
+	std::unordered_map<uint64_t, TQ3Uns32>			faceEdgeTriangles;
+};
 	
 
 //=============================================================================
@@ -3672,6 +3716,946 @@ cleanup:
 
 
 
+//=============================================================================
+//      e3meshTriMesh_DisposeBuilder : Release the references in a builder.
+//-----------------------------------------------------------------------------
+static
+void
+e3meshTriMesh_DisposeBuilder(
+	TE3MeshTriMeshBuilder* builderPtr)
+{
+	for (TQ3Uns32 n = 0; n < builderPtr->pointAttributes.size(); ++n)
+		{
+		if (builderPtr->pointAttributes[n] != nullptr)
+			Q3Object_Dispose(builderPtr->pointAttributes[n]);
+		}
+
+	for (auto theEntry = builderPtr->faceSets.begin(); theEntry != builderPtr->faceSets.end(); ++theEntry)
+		{
+		if (theEntry->second != nullptr)
+			Q3Object_Dispose(theEntry->second);
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      e3meshTriMesh_PointIndex : Return the TriMesh point for a face vertex.
+//-----------------------------------------------------------------------------
+//		Note :	Faces share a point unless they have different corners at
+//				the vertex. The point's attributes are the vertex attributes
+//				overridden by any corner attributes.
+//-----------------------------------------------------------------------------
+static
+TQ3Uns32
+e3meshTriMesh_PointIndex(
+	TE3MeshTriMeshBuilder* builderPtr,
+	const TE3MeshVertexData* vertexPtr,
+	const TE3MeshFaceData* facePtr)
+{
+	const TE3MeshCornerData* cornerPtr = e3meshVertex_FaceCorner(vertexPtr, facePtr);
+	const void* theKey = (cornerPtr != nullptr) ? (const void*) cornerPtr : (const void*) vertexPtr;
+
+
+
+	// Reuse the point if we have already seen this vertex or corner
+	auto thePoint = builderPtr->pointIndices.find(theKey);
+	if (thePoint != builderPtr->pointIndices.end())
+		return(thePoint->second);
+
+
+
+	// Otherwise work out its attributes, and add it
+	TQ3AttributeSet theAttributes = nullptr;
+	
+	if (cornerPtr == nullptr || cornerPtr->attributeSet == nullptr)
+		{
+		if (vertexPtr->attributeSet != nullptr)
+			theAttributes = Q3Shared_GetReference(vertexPtr->attributeSet);
+		}
+	else if (vertexPtr->attributeSet == nullptr)
+		theAttributes = Q3Shared_GetReference(cornerPtr->attributeSet);
+	else
+		{
+		theAttributes = Q3AttributeSet_New();
+		if (theAttributes != nullptr)
+			Q3AttributeSet_Inherit(vertexPtr->attributeSet, cornerPtr->attributeSet, theAttributes);
+		}
+
+	TQ3Uns32 theIndex = static_cast<TQ3Uns32>(builderPtr->points.size());
+	builderPtr->points.push_back(vertexPtr->point);
+	builderPtr->pointAttributes.push_back(theAttributes);
+	builderPtr->pointIndices[theKey] = theIndex;
+
+	return(theIndex);
+}
+
+
+
+
+
+//=============================================================================
+//      e3meshTriMesh_AddTriangle : Add a triangle for the current face.
+//-----------------------------------------------------------------------------
+static
+void
+e3meshTriMesh_AddTriangle(
+	TE3MeshTriMeshBuilder* builderPtr,
+	TQ3Uns32 point0,
+	TQ3Uns32 point1,
+	TQ3Uns32 point2)
+{
+	TQ3TriMeshTriangleData	theTriangle;
+
+
+
+	theTriangle.pointIndices[0] = point0;
+	theTriangle.pointIndices[1] = point1;
+	theTriangle.pointIndices[2] = point2;
+
+	builderPtr->triangles.push_back(theTriangle);
+	builderPtr->triangleAttributes.push_back(builderPtr->faceAttributes);
+}
+
+
+
+
+
+//=============================================================================
+//      e3meshTriMesh_Cross2D : Return the turn at b on the path a, b, c.
+//-----------------------------------------------------------------------------
+static inline
+float
+e3meshTriMesh_Cross2D(
+	const TQ3Point2D& a,
+	const TQ3Point2D& b,
+	const TQ3Point2D& c)
+{
+	return((b.x - a.x) * (c.y - b.y) - (b.y - a.y) * (c.x - b.x));
+}
+
+
+
+
+
+//=============================================================================
+//      e3meshTriMesh_ProjectContour : Project a contour onto a plane.
+//-----------------------------------------------------------------------------
+//		Note :	Fills facePoints2D by dropping the dominant axis of the
+//				contour's Newell normal, and returns twice the signed area of
+//				the projected contour.
+//-----------------------------------------------------------------------------
+static
+float
+e3meshTriMesh_ProjectContour(
+	TE3MeshTriMeshBuilder* builderPtr,
+	TQ3Uns32 firstVertex,
+	TQ3Uns32 numVertices)
+{
+	const TQ3Vertex3D*	theVertices = &builderPtr->faceVertices[firstVertex];
+	TQ3Vector3D			theNormal = { 0.0f, 0.0f, 0.0f };
+	TQ3Uns32			n;
+
+
+
+	// Find the contour normal
+	for (n = 0; n < numVertices; ++n)
+		{
+		const TQ3Point3D& thisPoint = theVertices[n].point;
+		const TQ3Point3D& nextPoint = theVertices[(n + 1) % numVertices].point;
+
+		theNormal.x += (thisPoint.y - nextPoint.y) * (thisPoint.z + nextPoint.z);
+		theNormal.y += (thisPoint.z - nextPoint.z) * (thisPoint.x + nextPoint.x);
+		theNormal.z += (thisPoint.x - nextPoint.x) * (thisPoint.y + nextPoint.y);
+		}
+
+
+
+	// Project onto the plane of the two minor axes, keeping the winding
+	float absX = E3Float_Abs(theNormal.x);
+	float absY = E3Float_Abs(theNormal.y);
+	float absZ = E3Float_Abs(theNormal.z);
+
+	builderPtr->facePoints2D.resize(numVertices);
+	
+	for (n = 0; n < numVertices; ++n)
+		{
+		const TQ3Point3D& thePoint = theVertices[n].point;
+		TQ3Point2D& projPoint      = builderPtr->facePoints2D[n];
+
+		if (absX >= absY && absX >= absZ)
+			{
+			projPoint.x = (theNormal.x > 0.0f) ? thePoint.y : thePoint.z;
+			projPoint.y = (theNormal.x > 0.0f) ? thePoint.z : thePoint.y;
+			}
+		else if (absY >= absZ)
+			{
+			projPoint.x = (theNormal.y > 0.0f) ? thePoint.z : thePoint.x;
+			projPoint.y = (theNormal.y > 0.0f) ? thePoint.x : thePoint.z;
+			}
+		else
+			{
+			projPoint.x = (theNormal.z > 0.0f) ? thePoint.x : thePoint.y;
+			projPoint.y = (theNormal.z > 0.0f) ? thePoint.y : thePoint.x;
+			}
+		}
+
+
+
+	// Find the signed area
+	float theArea = 0.0f;
+	
+	for (n = 0; n < numVertices; ++n)
+		{
+		const TQ3Point2D& thisPoint = builderPtr->facePoints2D[n];
+		const TQ3Point2D& nextPoint = builderPtr->facePoints2D[(n + 1) % numVertices];
+		
+		theArea += thisPoint.x * nextPoint.y - nextPoint.x * thisPoint.y;
+		}
+
+	return(theArea);
+}
+
+
+
+
+
+//=============================================================================
+//      e3meshTriMesh_IsConvex : Is the projected contour convex?
+//-----------------------------------------------------------------------------
+//		Note :	As well as turning the same way at every vertex, the contour
+//				must wind around only once, which rules out star shapes.
+//-----------------------------------------------------------------------------
+static
+TQ3Boolean
+e3meshTriMesh_IsConvex(
+	const std::vector<TQ3Point2D>& thePoints,
+	float theSign)
+{
+	TQ3Uns32	numPoints = static_cast<TQ3Uns32>(thePoints.size());
+	TQ3Uns32	numFlips  = 0;
+	float		lastDX    = 0.0f;
+	TQ3Uns32	n;
+
+
+
+	for (n = 0; n < numPoints; ++n)
+		{
+		const TQ3Point2D& p0 = thePoints[n];
+		const TQ3Point2D& p1 = thePoints[(n + 1) % numPoints];
+		const TQ3Point2D& p2 = thePoints[(n + 2) % numPoints];
+
+		if (e3meshTriMesh_Cross2D(p0, p1, p2) * theSign < 0.0f)
+			return(kQ3False);
+
+		float theDX = p1.x - p0.x;
+		if (theDX != 0.0f)
+			{
+			if (lastDX != 0.0f && (theDX > 0.0f) != (lastDX > 0.0f))
+				++numFlips;
+			lastDX = theDX;
+			}
+		}
+
+	// The first edge with a non-zero x extent was compared with nothing, so
+	// close the loop by comparing it with the last one
+	for (n = 0; n < numPoints; ++n)
+		{
+		float theDX = thePoints[(n + 1) % numPoints].x - thePoints[n].x;
+		if (theDX != 0.0f)
+			{
+			if ((theDX > 0.0f) != (lastDX > 0.0f))
+				++numFlips;
+			break;
+			}
+		}
+
+	return((TQ3Boolean) (numFlips <= 2));
+}
+
+
+
+
+
+//=============================================================================
+//      e3meshTriMesh_EarClip : Triangulate a projected simple contour.
+//-----------------------------------------------------------------------------
+//		Note :	Returns false if no ear can be found, which happens if the
+//				contour intersects itself.
+//-----------------------------------------------------------------------------
+static
+TQ3Boolean
+e3meshTriMesh_EarClip(
+	TE3MeshTriMeshBuilder* builderPtr,
+	const TQ3Uns32* thePointIndices,
+	float theSign)
+{
+	const std::vector<TQ3Point2D>&	thePoints = builderPtr->facePoints2D;
+	std::vector<TQ3Uns32>&			theRing   = builderPtr->faceRing;
+	TQ3Uns32						numPoints = static_cast<TQ3Uns32>(thePoints.size());
+	TQ3Uns32						n, k, m;
+
+
+
+	theRing.resize(numPoints);
+	for (n = 0; n < numPoints; ++n)
+		theRing[n] = n;
+
+	while (theRing.size() > 3)
+		{
+		TQ3Uns32	ringSize  = static_cast<TQ3Uns32>(theRing.size());
+		TQ3Uns32	clipIndex = kQ3ArrayIndexNULL;
+		TQ3Uns32	flatIndex = kQ3ArrayIndexNULL;
+		
+		for (k = 0; k < ringSize && clipIndex == kQ3ArrayIndexNULL; ++k)
+			{
+			const TQ3Point2D& p0 = thePoints[theRing[(k + ringSize - 1) % ringSize]];
+			const TQ3Point2D& p1 = thePoints[theRing[k]];
+			const TQ3Point2D& p2 = thePoints[theRing[(k + 1) % ringSize]];
+			
+			float theTurn = e3meshTriMesh_Cross2D(p0, p1, p2) * theSign;
+			if (theTurn <= 0.0f)
+				{
+				if (theTurn == 0.0f && flatIndex == kQ3ArrayIndexNULL)
+					flatIndex = k;
+				continue;
+				}
+
+
+			// An ear must not contain any other vertex of the contour
+			TQ3Boolean isEar = kQ3True;
+			
+			for (m = 0; m < ringSize && isEar; ++m)
+				{
+				const TQ3Point2D& q = thePoints[theRing[m]];
+				
+				if ((q.x == p0.x && q.y == p0.y) ||
+					(q.x == p1.x && q.y == p1.y) ||
+					(q.x == p2.x && q.y == p2.y))
+					continue;
+				
+				if (e3meshTriMesh_Cross2D(p0, p1, q) * theSign >= 0.0f &&
+					e3meshTriMesh_Cross2D(p1, p2, q) * theSign >= 0.0f &&
+					e3meshTriMesh_Cross2D(p2, p0, q) * theSign >= 0.0f)
+					isEar = kQ3False;
+				}
+			
+			if (isEar)
+				clipIndex = k;
+			}
+
+
+		// Clip the ear, or failing that drop a vertex that lies on the line
+		// between its neighbours, which adds no area
+		if (clipIndex != kQ3ArrayIndexNULL)
+			{
+			e3meshTriMesh_AddTriangle(builderPtr,
+				thePointIndices[theRing[(clipIndex + ringSize - 1) % ringSize]],
+				thePointIndices[theRing[clipIndex]],
+				thePointIndices[theRing[(clipIndex + 1) % ringSize]]);
+			}
+		else if (flatIndex != kQ3ArrayIndexNULL)
+			clipIndex = flatIndex;
+		else
+			return(kQ3False);
+
+		theRing.erase(theRing.begin() + clipIndex);
+		}
+
+	e3meshTriMesh_AddTriangle(builderPtr, thePointIndices[theRing[0]],
+								thePointIndices[theRing[1]], thePointIndices[theRing[2]]);
+
+	return(kQ3True);
+}
+
+
+
+
+
+//=============================================================================
+//      e3meshTriMesh_TriangulateContour : Triangulate a single contour face.
+//-----------------------------------------------------------------------------
+//		Note :	Handles convex and simple concave contours. Returns false
+//				without adding any triangles if the contour needs the
+//				tessellator.
+//-----------------------------------------------------------------------------
+static
+TQ3Boolean
+e3meshTriMesh_TriangulateContour(
+	TE3MeshTriMeshBuilder* builderPtr,
+	TQ3Uns32 numVertices)
+{
+	const TQ3Uns32*	thePointIndices = &builderPtr->facePoints[0];
+	TQ3Uns32		n;
+
+
+
+	// Triangles need no work
+	if (numVertices == 3)
+		{
+		e3meshTriMesh_AddTriangle(builderPtr, thePointIndices[0], thePointIndices[1], thePointIndices[2]);
+		return(kQ3True);
+		}
+
+
+
+	// Otherwise work in the plane of the contour
+	float theArea = e3meshTriMesh_ProjectContour(builderPtr, 0, numVertices);
+	if (theArea == 0.0f)
+		return(kQ3False);
+		
+	float theSign = (theArea > 0.0f) ? 1.0f : -1.0f;
+
+
+
+	// Convex contours become a fan
+	if (e3meshTriMesh_IsConvex(builderPtr->facePoints2D, theSign))
+		{
+		for (n = 1; n + 1 < numVertices; ++n)
+			e3meshTriMesh_AddTriangle(builderPtr, thePointIndices[0], thePointIndices[n], thePointIndices[n + 1]);
+
+		return(kQ3True);
+		}
+
+
+
+	// Small concave contours are ear clipped
+	if (numVertices > kE3MeshEarClipMaxVertices)
+		return(kQ3False);
+
+	size_t numTriangles = builderPtr->triangles.size();
+	
+	if (!e3meshTriMesh_EarClip(builderPtr, thePointIndices, theSign))
+		{
+		builderPtr->triangles.resize(numTriangles);
+		builderPtr->triangleAttributes.resize(numTriangles);
+		return(kQ3False);
+		}
+
+	return(kQ3True);
+}
+
+
+
+
+
+//=============================================================================
+//      e3meshTriMesh_TessellatedTriangle : Add a triangle from the tessellator.
+//-----------------------------------------------------------------------------
+static
+void
+e3meshTriMesh_TessellatedTriangle(
+	void* userData,
+	const TQ3Vertex3D* const* theVertices)
+{
+	TE3MeshTriMeshBuilder*	builderPtr = (TE3MeshTriMeshBuilder*) userData;
+	const TQ3Vertex3D*		faceVertices = &builderPtr->faceVertices[0];
+	TQ3Uns32				numFaceVertices = static_cast<TQ3Uns32>(builderPtr->faceVertices.size());
+	TQ3Uns32				thePoints[3];
+
+
+
+	for (TQ3Uns32 n = 0; n < 3; ++n)
+		{
+		const TQ3Vertex3D* theVertex = theVertices[n];
+		
+		// Vertices of the face map straight back to their points
+		if (theVertex >= faceVertices && theVertex < faceVertices + numFaceVertices)
+			{
+			thePoints[n] = builderPtr->facePoints[ theVertex - faceVertices ];
+			continue;
+			}
+		
+		
+		// Vertices made where contours cross are only valid during the
+		// tessellation, so copy them
+		auto theEntry = builderPtr->tessellatedPoints.find(theVertex);
+		if (theEntry != builderPtr->tessellatedPoints.end())
+			{
+			thePoints[n] = theEntry->second;
+			continue;
+			}
+		
+		thePoints[n] = static_cast<TQ3Uns32>(builderPtr->points.size());
+		builderPtr->points.push_back(theVertex->point);
+		builderPtr->pointAttributes.push_back( (theVertex->attributeSet != nullptr) ?
+			Q3Shared_GetReference(theVertex->attributeSet) : nullptr );
+		builderPtr->tessellatedPoints[theVertex] = thePoints[n];
+		}
+
+	e3meshTriMesh_AddTriangle(builderPtr, thePoints[0], thePoints[1], thePoints[2]);
+}
+
+
+
+
+
+//=============================================================================
+//      e3meshTriMesh_FaceAttributes : Find the triangle attributes of a face.
+//-----------------------------------------------------------------------------
+//		Note :	Returns false if the face set holds attributes which can not
+//				be expressed per triangle, in which case the mesh can not be
+//				decomposed to a single TriMesh.
+//-----------------------------------------------------------------------------
+static
+TQ3Boolean
+e3meshTriMesh_FaceAttributes(
+	TE3MeshTriMeshBuilder* builderPtr,
+	TQ3AttributeSet meshAttributes,
+	TQ3AttributeSet faceAttributes)
+{
+	// Faces without attributes just use the mesh attributes
+	if (faceAttributes == nullptr)
+		{
+		builderPtr->faceAttributes = meshAttributes;
+		return(kQ3True);
+		}
+
+
+
+	// Faces often share attribute sets, so reuse the set we found before
+	auto theEntry = builderPtr->faceSets.find(faceAttributes);
+	if (theEntry != builderPtr->faceSets.end())
+		{
+		builderPtr->faceAttributes = theEntry->second;
+		return(kQ3True);
+		}
+
+
+
+	// Check that each attribute can be held per triangle. Face normals are
+	// allowed but ignored, as the tessellated polygons always ignored them.
+	TQ3AttributeType theType = kQ3AttributeTypeNone;
+	
+	while (Q3AttributeSet_GetNextAttributeType(faceAttributes, &theType) == kQ3Success &&
+			theType != kQ3AttributeTypeNone)
+		{
+		switch (theType)
+			{
+			case kQ3AttributeTypeNormal:
+			case kQ3AttributeTypeAmbientCoefficient:
+			case kQ3AttributeTypeDiffuseColor:
+			case kQ3AttributeTypeSpecularColor:
+			case kQ3AttributeTypeSpecularControl:
+			case kQ3AttributeTypeTransparencyColor:
+			case kQ3AttributeTypeHighlightState:
+			case kQ3AttributeTypeSurfaceShader:
+			case kQ3AttributeTypeEmissiveColor:
+				break;
+			
+			default:
+				return(kQ3False);
+			}
+		}
+
+
+
+	// Let the face attributes override the mesh attributes
+	TQ3AttributeSet theSet;
+	
+	if (meshAttributes == nullptr)
+		theSet = Q3Shared_GetReference(faceAttributes);
+	else
+		{
+		theSet = Q3AttributeSet_New();
+		if (theSet == nullptr)
+			return(kQ3False);
+
+		Q3AttributeSet_Inherit(meshAttributes, faceAttributes, theSet);
+		}
+
+	builderPtr->faceSets[faceAttributes] = theSet;
+	builderPtr->faceAttributes = theSet;
+
+	return(kQ3True);
+}
+
+
+
+
+
+//=============================================================================
+//      e3meshTriMesh_EdgeKey : Key for an edge, whichever way it runs.
+//-----------------------------------------------------------------------------
+static
+uint64_t
+e3meshTriMesh_EdgeKey(
+	TQ3Uns32 pointA,
+	TQ3Uns32 pointB)
+{
+	if (pointA > pointB)
+		std::swap(pointA, pointB);
+
+	return((((uint64_t) pointA) << 32) | pointB);
+}
+
+
+
+
+
+//=============================================================================
+//      e3meshTriMesh_AddFace : Add the triangles and edges for a face.
+//-----------------------------------------------------------------------------
+static
+TQ3Boolean
+e3meshTriMesh_AddFace(
+	TE3MeshTriMeshBuilder* builderPtr,
+	const TE3MeshData* meshPtr,
+	const TE3MeshFaceData* facePtr)
+{
+	const TE3MeshContourData* 		contourPtr;
+	const TE3MeshVertexPtr* 		vertexHdl;
+	TQ3GeneralPolygonContourData	theContour;
+	TQ3Vertex3D						theVertex;
+	TQ3Uns32						n, m, firstVertex;
+
+
+
+	// Find the face attributes
+	if (!e3meshTriMesh_FaceAttributes(builderPtr, meshPtr->attributeSet, facePtr->attributeSet))
+		return(kQ3False);
+
+
+
+	// Collect the contours
+	builderPtr->faceVertices.clear();
+	builderPtr->facePoints.clear();
+	builderPtr->faceContours.clear();
+
+	for (contourPtr = e3meshContourArrayOrList_FirstItemConst(&facePtr->contourArrayOrList);
+		contourPtr != nullptr;
+		contourPtr = e3meshContourArrayOrList_NextItemConst(&facePtr->contourArrayOrList, contourPtr))
+		{
+		theContour.numVertices = e3meshContour_NumVertices(contourPtr);
+		theContour.vertices    = nullptr;
+		builderPtr->faceContours.push_back(theContour);
+
+		for (vertexHdl = e3meshVertexPtrArray_FirstItemConst(&contourPtr->vertexPtrArray);
+			vertexHdl != nullptr;
+			vertexHdl = e3meshVertexPtrArray_NextItemConst(&contourPtr->vertexPtrArray, vertexHdl))
+			{
+			TQ3Uns32 thePoint = e3meshTriMesh_PointIndex(builderPtr, *vertexHdl, facePtr);
+			
+			theVertex.point        = builderPtr->points[thePoint];
+			theVertex.attributeSet = builderPtr->pointAttributes[thePoint];
+
+			builderPtr->faceVertices.push_back(theVertex);
+			builderPtr->facePoints.push_back(thePoint);
+			}
+		}
+
+	if (builderPtr->faceVertices.empty())
+		return(kQ3True);
+
+	for (n = 0, firstVertex = 0; n < builderPtr->faceContours.size(); ++n)
+		{
+		builderPtr->faceContours[n].vertices = &builderPtr->faceVertices[firstVertex];
+		firstVertex += builderPtr->faceContours[n].numVertices;
+		}
+
+
+
+	// Triangulate the face. Faces with holes, and contours which are too
+	// complex for ear clipping, go through the tessellator.
+	TQ3Uns32 firstTriangle = static_cast<TQ3Uns32>(builderPtr->triangles.size());
+	
+	if (builderPtr->faceContours.size() != 1 ||
+		!e3meshTriMesh_TriangulateContour(builderPtr, builderPtr->faceContours[0].numVertices))
+		{
+		builderPtr->tessellatedPoints.clear();
+		
+		E3Tessellate_ContoursToTriangles(static_cast<TQ3Uns32>(builderPtr->faceContours.size()),
+										 &builderPtr->faceContours[0],
+										 e3meshTriMesh_TessellatedTriangle, builderPtr);
+		}
+
+	if (builderPtr->triangles.size() == firstTriangle)
+		return(kQ3True);
+
+
+
+	// Find the triangle of the face that owns each triangle edge, keyed by
+	// the points of the edge in either order
+	builderPtr->faceEdgeTriangles.clear();
+	
+	for (TQ3Uns32 t = firstTriangle; t < builderPtr->triangles.size(); ++t)
+		{
+		const TQ3Uns32* triPoints = builderPtr->triangles[t].pointIndices;
+		
+		for (m = 0; m < 3; ++m)
+			{
+			TQ3Uns32 pointA = triPoints[m];
+			TQ3Uns32 pointB = triPoints[(m + 1) % 3];
+			
+			builderPtr->faceEdgeTriangles.insert( { e3meshTriMesh_EdgeKey(pointA, pointB), t } );
+			}
+		}
+
+
+
+	// Add the contour edges. An edge that the tessellator split where
+	// contours cross has no single owner, so falls back to the first
+	// triangle of the face.
+	for (n = 0, firstVertex = 0; n < builderPtr->faceContours.size(); ++n)
+		{
+		TQ3Uns32 numVertices = builderPtr->faceContours[n].numVertices;
+		
+		for (m = 0; m < numVertices; ++m)
+			{
+			TQ3TriMeshEdgeData theEdge;
+			
+			theEdge.pointIndices[0]    = builderPtr->facePoints[firstVertex + m];
+			theEdge.pointIndices[1]    = builderPtr->facePoints[firstVertex + (m + 1) % numVertices];
+			theEdge.triangleIndices[0] = firstTriangle;
+			theEdge.triangleIndices[1] = kQ3ArrayIndexNULL;
+			
+			auto theOwner = builderPtr->faceEdgeTriangles.find(
+				e3meshTriMesh_EdgeKey(theEdge.pointIndices[0], theEdge.pointIndices[1]) );
+			if (theOwner != builderPtr->faceEdgeTriangles.end())
+				theEdge.triangleIndices[0] = theOwner->second;
+			
+			builderPtr->edges.push_back(theEdge);
+			}
+		
+		firstVertex += numVertices;
+		}
+
+	return(kQ3True);
+}
+
+
+
+
+
+//=============================================================================
+//      e3meshTriMesh_GatherPointAttributes : Gather TriMesh point attributes.
+//-----------------------------------------------------------------------------
+static
+TQ3AttributeSet
+e3meshTriMesh_GatherPointAttributes(
+	const void* userData,
+	TQ3Uns32 setIndex)
+{
+	return(((const TE3MeshTriMeshBuilder*) userData)->pointAttributes[setIndex]);
+}
+
+
+
+
+
+//=============================================================================
+//      e3meshTriMesh_GatherTriangleAttributes : Gather triangle attributes.
+//-----------------------------------------------------------------------------
+static
+TQ3AttributeSet
+e3meshTriMesh_GatherTriangleAttributes(
+	const void* userData,
+	TQ3Uns32 setIndex)
+{
+	return(((const TE3MeshTriMeshBuilder*) userData)->triangleAttributes[setIndex]);
+}
+
+
+
+
+
+//=============================================================================
+//      e3meshTriMesh_FreeAttributeArrays : Free gathered attribute arrays.
+//-----------------------------------------------------------------------------
+static
+void
+e3meshTriMesh_FreeAttributeArrays(
+	TQ3Uns32 numTypes,
+	TQ3Uns32 numElements,
+	TQ3TriMeshAttributeData* theAttributes)
+{
+	for (TQ3Uns32 n = 0; n < numTypes; ++n)
+		{
+		// Gathering surface shaders took a reference to each
+		if (theAttributes[n].attributeType == kQ3AttributeTypeSurfaceShader)
+			{
+			TQ3Object* theShaders = (TQ3Object*) theAttributes[n].data;
+			
+			for (TQ3Uns32 m = 0; m < numElements; ++m)
+				Q3Object_CleanDispose(&theShaders[m]);
+			}
+
+		Q3Memory_Free(&theAttributes[n].data);
+		Q3Memory_Free(&theAttributes[n].attributeUseArray);
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      e3meshTriMesh_Create : Create the TriMesh from a builder.
+//-----------------------------------------------------------------------------
+static
+TQ3GeometryObject
+e3meshTriMesh_Create(
+	TE3MeshTriMeshBuilder* builderPtr,
+	TQ3AttributeSet meshAttributes,
+	TQ3OrientationStyle theOrientation)
+{
+	static const TQ3AttributeType kVertexTypes[] = {
+		kQ3AttributeTypeSurfaceUV,
+		kQ3AttributeTypeShadingUV,
+		kQ3AttributeTypeNormal,
+		kQ3AttributeTypeAmbientCoefficient,
+		kQ3AttributeTypeDiffuseColor,
+		kQ3AttributeTypeSpecularColor,
+		kQ3AttributeTypeSpecularControl,
+		kQ3AttributeTypeTransparencyColor,
+		kQ3AttributeTypeSurfaceTangent,
+		kQ3AttributeTypeHighlightState,
+		kQ3AttributeTypeSurfaceShader,
+		kQ3AttributeTypeEmissiveColor
+	};
+	static const TQ3AttributeType kTriangleTypes[] = {
+		kQ3AttributeTypeAmbientCoefficient,
+		kQ3AttributeTypeDiffuseColor,
+		kQ3AttributeTypeSpecularColor,
+		kQ3AttributeTypeSpecularControl,
+		kQ3AttributeTypeTransparencyColor,
+		kQ3AttributeTypeHighlightState,
+		kQ3AttributeTypeSurfaceShader,
+		kQ3AttributeTypeEmissiveColor
+	};
+	TQ3TriMeshAttributeData		vertexAttributes[kQ3AttributeTypeNumTypes];
+	TQ3TriMeshAttributeData		triangleAttributes[kQ3AttributeTypeNumTypes];
+	TQ3Uns32					numVertexTypes   = 0;
+	TQ3Uns32					numTriangleTypes = 0;
+	TQ3Uns32					numPoints        = static_cast<TQ3Uns32>(builderPtr->points.size());
+	TQ3Uns32					numTriangles     = static_cast<TQ3Uns32>(builderPtr->triangles.size());
+	TQ3GeometryObject			theTriMesh       = nullptr;
+	TQ3Boolean					canCreate        = kQ3True;
+	TQ3TriMeshData				triMeshData;
+	TQ3Uns32					n;
+
+
+
+	// Gather the vertex attributes, with surface UVs taking precedence
+	for (n = 0; n < sizeof(kVertexTypes) / sizeof(kVertexTypes[0]); ++n)
+		{
+		if (kVertexTypes[n] == kQ3AttributeTypeShadingUV && numVertexTypes != 0 &&
+			vertexAttributes[numVertexTypes - 1].attributeType == kQ3AttributeTypeSurfaceUV)
+			continue;
+		
+		if (E3TriMeshAttribute_GatherArray(numPoints, e3meshTriMesh_GatherPointAttributes, builderPtr,
+											&vertexAttributes[numVertexTypes], kVertexTypes[n]))
+			numVertexTypes++;
+		}
+
+
+
+	// Gather the face attributes. Renderers do not honour a use array for
+	// triangle attributes, so a type set on only some faces would lose the
+	// inherited value on the others; leave those meshes to the slow path.
+	for (n = 0; n < sizeof(kTriangleTypes) / sizeof(kTriangleTypes[0]) && canCreate; ++n)
+		{
+		if (E3TriMeshAttribute_GatherArray(numTriangles, e3meshTriMesh_GatherTriangleAttributes, builderPtr,
+											&triangleAttributes[numTriangleTypes], kTriangleTypes[n]))
+			{
+			if (triangleAttributes[numTriangleTypes].attributeUseArray != nullptr)
+				canCreate = kQ3False;
+
+			numTriangleTypes++;
+			}
+		}
+
+
+
+	// Create the TriMesh
+	if (canCreate)
+		{
+		triMeshData.triMeshAttributeSet       = meshAttributes;
+		triMeshData.numTriangles              = numTriangles;
+		triMeshData.triangles                 = &builderPtr->triangles[0];
+		triMeshData.numTriangleAttributeTypes = numTriangleTypes;
+		triMeshData.triangleAttributeTypes    = (numTriangleTypes != 0) ? triangleAttributes : nullptr;
+		triMeshData.numEdges                  = static_cast<TQ3Uns32>(builderPtr->edges.size());
+		triMeshData.edges                     = builderPtr->edges.empty() ? nullptr : &builderPtr->edges[0];
+		triMeshData.numEdgeAttributeTypes     = 0;
+		triMeshData.edgeAttributeTypes        = nullptr;
+		triMeshData.numPoints                 = numPoints;
+		triMeshData.points                    = &builderPtr->points[0];
+		triMeshData.numVertexAttributeTypes   = numVertexTypes;
+		triMeshData.vertexAttributeTypes      = (numVertexTypes != 0) ? vertexAttributes : nullptr;
+
+		Q3BoundingBox_SetFromPoints3D(&triMeshData.bBox, triMeshData.points, numPoints, sizeof(TQ3Point3D));
+
+		theTriMesh = Q3TriMesh_New(&triMeshData);
+		if (theTriMesh != nullptr)
+			E3TriMesh_AddTriangleNormals(theTriMesh, theOrientation);
+		}
+
+
+
+	// Clean up
+	e3meshTriMesh_FreeAttributeArrays(numVertexTypes,   numPoints,    vertexAttributes);
+	e3meshTriMesh_FreeAttributeArrays(numTriangleTypes, numTriangles, triangleAttributes);
+
+	return(theTriMesh);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_mesh_cache_new_as_trimesh : Mesh cache new method.
+//-----------------------------------------------------------------------------
+//		Note :	Decomposes the whole mesh into a single TriMesh, keeping the
+//				vertex, corner, and face attributes. Returns nullptr if the
+//				mesh has face attributes that a TriMesh can not represent.
+//-----------------------------------------------------------------------------
+static
+TQ3GeometryObject
+e3geom_mesh_cache_new_as_trimesh(
+	TQ3ViewObject theView,
+	const TE3MeshData* meshPtr)
+{
+	const TE3MeshFaceData* 		facePtr;
+	TE3MeshTriMeshBuilder		theBuilder;
+	TQ3GeometryObject			theTriMesh = nullptr;
+	TQ3Boolean					canBuild   = kQ3True;
+
+
+
+	// Add the faces
+	theBuilder.points.reserve(e3mesh_NumVertices(meshPtr) + meshPtr->numCorners);
+	theBuilder.triangles.reserve(2 * e3mesh_NumFaces(meshPtr));
+	
+	for (facePtr = e3meshFaceArrayOrList_FirstItemConst(&meshPtr->faceArrayOrList);
+		facePtr != nullptr && canBuild;
+		facePtr = e3meshFaceArrayOrList_NextItemConst(&meshPtr->faceArrayOrList, facePtr))
+		{
+		canBuild = e3meshTriMesh_AddFace(&theBuilder, meshPtr, facePtr);
+		}
+
+
+
+	// Create the TriMesh
+	if (canBuild && !theBuilder.triangles.empty())
+		theTriMesh = e3meshTriMesh_Create(&theBuilder, meshPtr->attributeSet,
+										  E3View_State_GetStyleOrientation(theView));
+
+
+
+	// Clean up
+	e3meshTriMesh_DisposeBuilder(&theBuilder);
+
+	return(theTriMesh);
+}
+
+
+
+
+
 //=============================================================================
 //      e3geom_mesh_cache_new : Mesh cache new method.
 //-----------------------------------------------------------------------------
@@ -3680,7 +4664,6 @@ e3geom_mesh_cache_new(TQ3ViewObject view, TQ3GeometryObject meshObject, const vo
 {
 	const TE3MeshData* meshPtr = (const TE3MeshData*) geomData;
 #pragma unused(meshObject)
-#pragma unused(view)
 
 
 
@@ -3689,10 +4672,13 @@ e3geom_mesh_cache_new(TQ3ViewObject view, TQ3GeometryObject meshObject, const vo
 		return nullptr;
 
 
-	// Create an appropriate representation
-	TQ3Object theGroup = e3geom_mesh_cache_new_as_polys(meshPtr);
+	// Create an appropriate representation, preferring a single TriMesh
+	TQ3Object theCache = e3geom_mesh_cache_new_as_trimesh(view, meshPtr);
+	
+	if (theCache == nullptr)
+		theCache = e3geom_mesh_cache_new_as_polys(meshPtr);
 
-	return(theGroup);
+	return(theCache);
 }
 
 
@@ -3804,6 +4790,10 @@ e3geom_mesh_metahandler(
 		case kQ3XMethodTypeGeomGetAttribute:
 			theMethod = (TQ3XFunctionPointer) e3geom_mesh_get_attribute;
 			break;
+
+		case kQ3XMethodTypeGeomUsesOrientation:
+			theMethod = (TQ3XFunctionPointer) kQ3True;
+			break;
 		}
 
 	return(theMethod);
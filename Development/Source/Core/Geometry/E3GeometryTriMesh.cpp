@@ -58,6 +58,7 @@
 
 #include <cstring>
 #include <utility>
+#include <vector>
 
 
 
@@ -81,6 +82,7 @@ typedef struct {
 	TQ3Uns32			theFlags;
 	TQ3Uns32			lockCount;
 	TQ3TriMeshData		geomData;
+	TE3TriMeshSoA*		soaCache;
 } TQ3TriMeshInstanceData;
 
 
@@ -630,6 +632,123 @@ e3geom_trimesh_validate( TQ3TriMeshData *theTriMesh )
 }
 
 
+//=============================================================================
+//      e3geom_trimesh_soa_build : Build the structure-of-arrays view.
+//-----------------------------------------------------------------------------
+static void
+e3geom_trimesh_soa_build( const TQ3TriMeshData& inData, TE3TriMeshSoA& outSoA )
+{
+	const TQ3Uns32 numPoints = inData.numPoints;
+	const TQ3Uns32 numFaces  = inData.numTriangles;
+	TQ3Uns32 n;
+
+
+
+	// Split the points into streams, padded to a multiple of 4
+	outSoA.numPoints    = numPoints;
+	outSoA.numTriangles = numFaces;
+
+	const TQ3Uns32 paddedPoints = (numPoints + 3) & ~3U;
+	outSoA.pointX.assign( paddedPoints, 0.0f );
+	outSoA.pointY.assign( paddedPoints, 0.0f );
+	outSoA.pointZ.assign( paddedPoints, 0.0f );
+
+	for (n = 0; n < numPoints; ++n)
+	{
+		outSoA.pointX[n] = inData.points[n].x;
+		outSoA.pointY[n] = inData.points[n].y;
+		outSoA.pointZ[n] = inData.points[n].z;
+	}
+
+
+
+	// Bounds of the points, taken stream by stream
+	if (numPoints == 0)
+	{
+		Q3Memory_Clear( &outSoA.bounds, sizeof(outSoA.bounds) );
+		outSoA.bounds.isEmpty = kQ3True;
+	}
+	else
+	{
+		const float* streams[3] = { &outSoA.pointX[0], &outSoA.pointY[0], &outSoA.pointZ[0] };
+		float minVal[3], maxVal[3];
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const float* s = streams[axis];
+			float lo = s[0], hi = s[0];
+			for (n = 1; n < numPoints; ++n)
+			{
+				lo = (s[n] < lo) ? s[n] : lo;
+				hi = (s[n] > hi) ? s[n] : hi;
+			}
+			minVal[axis] = lo;
+			maxVal[axis] = hi;
+		}
+		outSoA.bounds.min.x = minVal[0];
+		outSoA.bounds.min.y = minVal[1];
+		outSoA.bounds.min.z = minVal[2];
+		outSoA.bounds.max.x = maxVal[0];
+		outSoA.bounds.max.y = maxVal[1];
+		outSoA.bounds.max.z = maxVal[2];
+		outSoA.bounds.isEmpty = kQ3False;
+	}
+
+
+
+	// Face normals and planes
+	const TQ3Uns32 paddedFaces = (numFaces + 3) & ~3U;
+	outSoA.faceNormalX.assign( paddedFaces, 0.0f );
+	outSoA.faceNormalY.assign( paddedFaces, 0.0f );
+	outSoA.faceNormalZ.assign( paddedFaces, 0.0f );
+	outSoA.facePlane.assign( paddedFaces, 0.0f );
+
+	for (n = 0; n < numFaces; ++n)
+	{
+		const TQ3Uns32* v = inData.triangles[n].pointIndices;
+		const TQ3Point3D& p0( inData.points[ v[0] ] );
+		const TQ3Point3D& p1( inData.points[ v[1] ] );
+		const TQ3Point3D& p2( inData.points[ v[2] ] );
+
+		TQ3Vector3D normal = Q3Cross3D( p1 - p0, p2 - p0 );
+		outSoA.faceNormalX[n] = normal.x;
+		outSoA.faceNormalY[n] = normal.y;
+		outSoA.faceNormalZ[n] = normal.z;
+		outSoA.facePlane[n]   = normal.x * p0.x + normal.y * p0.y + normal.z * p0.z;
+	}
+
+
+
+	// Resolve the attributes that consumers look for
+	TQ3TriMeshAttributeData* attr;
+
+	attr = e3geom_trimesh_attribute_find( inData.numVertexAttributeTypes,
+		inData.vertexAttributeTypes, kQ3AttributeTypeNormal );
+	outSoA.vertexNormals = (attr != nullptr) ? (const TQ3Vector3D*) attr->data : nullptr;
+
+	attr = e3geom_trimesh_attribute_find( inData.numVertexAttributeTypes,
+		inData.vertexAttributeTypes, kQ3AttributeTypeSurfaceUV );
+	if (attr == nullptr)
+		attr = e3geom_trimesh_attribute_find( inData.numVertexAttributeTypes,
+			inData.vertexAttributeTypes, kQ3AttributeTypeShadingUV );
+	outSoA.vertexUVs = (attr != nullptr) ? (const TQ3Param2D*) attr->data : nullptr;
+
+	attr = e3geom_trimesh_attribute_find( inData.numVertexAttributeTypes,
+		inData.vertexAttributeTypes, kQ3AttributeTypeDiffuseColor );
+	outSoA.vertexColors = (attr != nullptr) ? (const TQ3ColorRGB*) attr->data : nullptr;
+
+	attr = e3geom_trimesh_attribute_find( inData.numTriangleAttributeTypes,
+		inData.triangleAttributeTypes, kQ3AttributeTypeNormal );
+	outSoA.triangleNormals = (attr != nullptr) ? (const TQ3Vector3D*) attr->data : nullptr;
+
+	attr = e3geom_trimesh_attribute_find( inData.numTriangleAttributeTypes,
+		inData.triangleAttributeTypes, kQ3AttributeTypeDiffuseColor );
+	outSoA.triangleColors = (attr != nullptr) ? (const TQ3ColorRGB*) attr->data : nullptr;
+}
+
+
+
+
+
 //=============================================================================
 //      e3geom_nakedtrimesh_new : TriMesh new method.
 //-----------------------------------------------------------------------------
@@ -644,6 +763,7 @@ e3geom_nakedtrimesh_new(TQ3Object theObject, void *privateData, const void *para
 
 	// Initialise the TriMesh, then optimise it
 	instanceData->theFlags = kTriMeshNone;
+	instanceData->soaCache = nullptr;
 	qd3dStatus = e3geom_nakedtrimesh_copydata( trimeshData, &instanceData->geomData );
 	
 	if (qd3dStatus == kQ3Success)
@@ -698,6 +818,7 @@ e3geom_nakedtrimesh_new_nocopy(TQ3Object theObject, void *privateData, const voi
 
 	// Initialise the TriMesh, then optimise it
 	instanceData->theFlags = kTriMeshNone;
+	instanceData->soaCache = nullptr;
 
 	Q3Memory_Copy( trimeshData, &instanceData->geomData, sizeof(TQ3TriMeshData) );
 	
@@ -750,6 +871,7 @@ e3geom_nakedtrimesh_delete(TQ3Object theObject, void *privateData)
 
 	// Dispose of our instance data
 	e3geom_trimesh_disposedata(&instanceData->geomData);
+	delete instanceData->soaCache;
 }
 
 
@@ -778,6 +900,7 @@ e3geom_nakedtrimesh_duplicate(TQ3Object fromObject, const void *fromPrivateData,
 
 	// Initialise the instance data of the new object
 	toData->theFlags = fromData->theFlags;
+	toData->soaCache = nullptr;
 	qd3dStatus       = e3geom_nakedtrimesh_copydata( &fromData->geomData, &toData->geomData );
 
 	return(qd3dStatus);
@@ -846,6 +969,12 @@ e3geom_trimesh_duplicate(TQ3Object fromObject, const void *fromPrivateData,
 //=============================================================================
 //      e3geom_trimesh_triangle_new : Retrieve a triangle from the TriMesh.
 //-----------------------------------------------------------------------------
+//		Note :	The attribute sets are reference counted objects, and can not
+//				come from the view's frame scratch memory.  The cached form
+//				keeps them in Triangle objects for the life of the TriMesh,
+//				and picking, which also calls this, never resets the scratch
+//				memory, as only E3View_StartRendering does that.
+//-----------------------------------------------------------------------------
 static void
 e3geom_trimesh_triangle_new(TQ3ViewObject theView, const TQ3TriMeshData *theTriMesh, TQ3Uns32 theIndex, TQ3TriangleData *theTriangle)
 {	TQ3Uns32				n, m, i0, i1, i2, vertIndex, attrSize;
@@ -1171,7 +1300,21 @@ e3geom_trimesh_pick_with_ray( TQ3ViewObject				theView,
 			// The ray misses the bounds, so it misses the mesh.
 			return kQ3Success;
 		}
+		
+		// If only the nearest hit is wanted, and the whole mesh is further
+		// away than the nearest hit so far, it can't be hit.
+		if (E3Pick_IsBeyondClosestHit( thePick, theView, &worldBounds ))
+		{
+			return kQ3Success;
+		}
 	}
+	
+	
+	// If only the nearest hit is wanted, triangles whose hits are no nearer
+	// than the nearest so far can be skipped before building the hit.
+	TQ3Point3D closestOrigin;
+	bool isClosestHit = (E3Pick_GetClosestHitOrigin( thePick, theView, &closestOrigin ) == kQ3True);
+	float closestDistance = E3Pick_GetClosestHitDistance( thePick );
 
 
 	// Transform our points from local to world coordinates
@@ -1254,6 +1397,15 @@ e3geom_trimesh_pick_with_ray( TQ3ViewObject				theView,
 				p0, p1, p2, cullBackface, theHit );
 		}
 
+		if (didHit && isClosestHit)
+		{
+			TQ3Point3D triHitPt = (1.0f - theHit.u - theHit.v) * p0 +
+				theHit.u * p1 + theHit.v * p2;
+			
+			if (Q3FastPoint3D_Distance( &triHitPt, &closestOrigin ) >= closestDistance)
+				didHit = kQ3False;
+		}
+
 		if (didHit)
 		{
 			// Create the triangle, and update the vertices to the transformed coordinates
@@ -1273,6 +1425,7 @@ e3geom_trimesh_pick_with_ray( TQ3ViewObject				theView,
 			// Record the hit
 			qd3dStatus = E3Pick_RecordHit(thePick, theView, &hitXYZ, &hitNormal,
 				resultUV, nullptr, &theHit, n );
+			closestDistance = E3Pick_GetClosestHitDistance( thePick );
 
 
 			// Clean up
@@ -1570,6 +1723,116 @@ e3geom_trimesh_pick_world_ray(TQ3ViewObject theView, TQ3PickObject thePick, cons
 
 
 
+//=============================================================================
+//      e3geom_trimesh_pick_world_ray_batch : TriMesh world-ray batch picking.
+//-----------------------------------------------------------------------------
+//		Note :	Rays are tested a packet at a time, and only for exact hits;
+//				the face tolerance does not apply to batch picks.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_trimesh_pick_world_ray_batch(TQ3ViewObject theView, TQ3PickObject thePick, const TQ3TriMeshData *geomData)
+{	TQ3Uns32						n, p, numPackets, v0, v1, v2;
+	TQ3Boolean						cullBackface;
+	TQ3BackfacingStyle				backfacingStyle;
+	TQ3Point3D						*worldPoints;
+	TQ3Status						qd3dStatus;
+	TQ3BoundingBox					worldBounds;
+	TQ3Param3D						theHits[kE3RayPacketSize];
+
+
+
+	// Find the rays which hit the bounding box, as a first approximation
+	TE3RayPacket* thePackets = E3WorldRayBatchPick_AccessPackets( thePick, &numPackets );
+	const TQ3Matrix4x4* localToWorld = E3View_State_GetMatrixLocalToWorld(theView);
+	E3BoundingBox_Transform( &geomData->bBox, localToWorld, &worldBounds );
+
+	std::vector<TQ3Uns32> laneMasks( numPackets );
+	bool anyHit = false;
+	for (p = 0; p < numPackets; ++p)
+	{
+		laneMasks[p] = E3RayPacket_IntersectBoundingBox( thePackets[p], worldBounds );
+		anyHit = anyHit || (laneMasks[p] != 0);
+	}
+
+	if (! anyHit)
+		return kQ3Success;
+
+
+
+	// Transform our points from local to world coordinates
+	worldPoints = (TQ3Point3D *) Q3Memory_Allocate(static_cast<TQ3Uns32>(geomData->numPoints * sizeof(TQ3Point3D)));
+	if (worldPoints == nullptr)
+		return(kQ3Failure);
+
+	Q3Point3D_To3DTransformArray(geomData->points,
+								 localToWorld,
+								 worldPoints,
+								 geomData->numPoints,
+								 sizeof(TQ3Point3D),
+								 sizeof(TQ3Point3D));
+
+
+
+	// Determine if we should cull back-facing triangles or not
+	qd3dStatus   = E3View_GetBackfacingStyleState(theView, &backfacingStyle);
+	cullBackface = (TQ3Boolean)(qd3dStatus == kQ3Success && backfacingStyle == kQ3BackfacingStyleRemove);
+	bool isOrientationReversing = E3Matrix4x4_Determinant( localToWorld ) < 0.0f;
+
+
+
+	// Test every triangle against the packets whose rays hit the bounds
+	for (n = 0; n < geomData->numTriangles; ++n)
+	{
+		v0 = geomData->triangles[n].pointIndices[0];
+		v1 = geomData->triangles[n].pointIndices[1];
+		v2 = geomData->triangles[n].pointIndices[2];
+		Q3_ASSERT(v0 >= 0 && v0 < geomData->numPoints);
+		Q3_ASSERT(v1 >= 0 && v1 < geomData->numPoints);
+		Q3_ASSERT(v2 >= 0 && v2 < geomData->numPoints);
+
+		if (cullBackface && isOrientationReversing)
+		{
+			std::swap( v1, v2 );
+		}
+
+		const TQ3Point3D& p0( worldPoints[v0] );
+		const TQ3Point3D& p1( worldPoints[v1] );
+		const TQ3Point3D& p2( worldPoints[v2] );
+
+		for (p = 0; p < numPackets; ++p)
+		{
+			if (laneMasks[p] == 0)
+				continue;
+
+			TQ3Uns32 hitMask = E3RayPacket_IntersectTriangle( thePackets[p], laneMasks[p],
+				p0, p1, p2, cullBackface, theHits );
+
+			for (TQ3Uns32 lane = 0; hitMask != 0; ++lane, hitMask >>= 1)
+			{
+				if ((hitMask & 1) == 0)
+					continue;
+
+				const TQ3Param3D& theHit( theHits[lane] );
+				TQ3Point3D hitXYZ = (1.0f - theHit.u - theHit.v) * p0 +
+					theHit.u * p1 + theHit.v * p2;
+
+				E3WorldRayBatchPick_RecordHit( thePick, theView, p * kE3RayPacketSize + lane,
+					theHit, hitXYZ, Q3Cross3D( p1 - p0, p2 - p0 ), n );
+			}
+		}
+	}
+
+
+	// Clean up
+	Q3Memory_Free(&worldPoints);
+
+	return(kQ3Success);
+}
+
+
+
+
+
 //=============================================================================
 //      e3geom_trimesh_pick : TriMesh picking method.
 //-----------------------------------------------------------------------------
@@ -1604,6 +1867,10 @@ e3geom_trimesh_pick(TQ3ViewObject theView, TQ3ObjectType objectType, TQ3Object t
 			qd3dStatus = e3geom_trimesh_pick_world_ray(theView, thePick, geomData);
 			break;
 
+		case kQ3PickTypeWorldRayBatch:
+			qd3dStatus = e3geom_trimesh_pick_world_ray_batch(theView, thePick, geomData);
+			break;
+
 		default:
 			qd3dStatus = kQ3Failure;
 			break;
@@ -1850,6 +2117,23 @@ E3TriMesh_New(const TQ3TriMeshData *triMeshData)
 
 
 
+//=============================================================================
+//      E3TriMesh_ValidateData : Check TriMesh data for bad indices.
+//-----------------------------------------------------------------------------
+//		Note :	E3TriMesh_New_NoCopy does not check its data, so callers that
+//				build TriMesh data from untrusted sources should check it
+//				with this first.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3TriMesh_ValidateData(TQ3TriMeshData *triMeshData)
+{
+	return e3geom_trimesh_validate( triMeshData );
+}
+
+
+
+
+
 TQ3GeometryObject
 E3TriMesh_New_NoCopy(const TQ3TriMeshData *triMeshData)
 {
@@ -2176,6 +2460,7 @@ E3TriMesh_AddTriangleNormals(TQ3GeometryObject theTriMesh, TQ3OrientationStyle t
 
 
 	// Clean up
+	Q3Shared_Edited ( nakedTriMesh ) ;
 	Q3Shared_Edited ( triMesh ) ;
 
 	if ( qd3dStatus == kQ3Failure )
@@ -2196,3 +2481,79 @@ void	E3TriMesh_SetNakedGeometry( TQ3GeometryObject inTriMesh,
 	E3TriMesh* triMesh = (E3TriMesh*) inTriMesh;
 	E3Shared_Replace( (TQ3Object*) &triMesh->instanceData.nakedTriMesh, inNaked );
 }
+
+
+
+
+
+//=============================================================================
+//      E3TriMesh_GetSoA : Get the structure-of-arrays view of a TriMesh.
+//-----------------------------------------------------------------------------
+//		Note :	The view is cached with the naked TriMesh, and rebuilt if its
+//				edit index has changed. Returns nullptr while the TriMesh is
+//				locked for writing, since its data may be in flux.
+//
+//				The result remains valid until the TriMesh is next edited.
+//-----------------------------------------------------------------------------
+const TE3TriMeshSoA*
+E3TriMesh_GetSoA( TQ3GeometryObject inTriMesh )
+{
+	Q3_ASSERT( Q3_OBJECT_IS_CLASS( inTriMesh, E3TriMesh ) );
+	E3TriMesh* triMesh = (E3TriMesh*) inTriMesh;
+	E3NakedTriMesh* nakedTriMesh = triMesh->instanceData.nakedTriMesh;
+	TQ3TriMeshInstanceData& nakedData( nakedTriMesh->instanceData );
+
+
+
+	// Don't look at data that may be being written
+	if ( (nakedData.lockCount > 0) &&
+		(! E3Bit_IsSet( nakedData.theFlags, kTriMeshLockedReadOnly )) )
+		return nullptr;
+
+
+
+	// Rebuild the view if the TriMesh has changed since we last built it
+	TQ3Uns32 editIndex = nakedTriMesh->GetEditIndex();
+	if ( (nakedData.soaCache == nullptr) || (nakedData.soaCache->editIndex != editIndex) )
+	{
+		if (nakedData.soaCache == nullptr)
+			nakedData.soaCache = new TE3TriMeshSoA;
+
+		e3geom_trimesh_soa_build( nakedData.geomData, *nakedData.soaCache );
+		nakedData.soaCache->editIndex = editIndex;
+	}
+
+	return nakedData.soaCache;
+}
+
+
+
+
+
+//=============================================================================
+//      E3TriMeshSoA_FacesToward : Find which faces face toward a point.
+//-----------------------------------------------------------------------------
+//		Note :	inPoint is a point if w is 1, or a direction if w is 0. A face
+//				faces toward it if the dot product of its normal with the
+//				vector from the face to the point is positive, which is
+//				
+//					dot(normal, (x, y, z)) - w * dot(normal, vertex0) > 0.
+//
+//				Sets outFacing[i] to 1 or 0 for each of the numTriangles faces.
+//-----------------------------------------------------------------------------
+void
+E3TriMeshSoA_FacesToward( const TE3TriMeshSoA& inSoA,
+						const TQ3RationalPoint4D& inPoint,
+						TQ3Uns8* outFacing )
+{
+	const float* nx = inSoA.faceNormalX.data();
+	const float* ny = inSoA.faceNormalY.data();
+	const float* nz = inSoA.faceNormalZ.data();
+	const float* d  = inSoA.facePlane.data();
+	const float x = inPoint.x, y = inPoint.y, z = inPoint.z, w = inPoint.w;
+	
+	for (TQ3Uns32 n = 0; n < inSoA.numTriangles; ++n)
+	{
+		outFacing[n] = (nx[n] * x + ny[n] * y + nz[n] * z - w * d[n]) > 0.0f;
+	}
+}
@@ -45,7 +45,55 @@
 //=============================================================================
 //      Include files
 //-----------------------------------------------------------------------------
-// Include files go here
+#include <vector>
+
+
+
+
+
+//=============================================================================
+//      Types
+//-----------------------------------------------------------------------------
+/*!
+	@struct		TE3TriMeshSoA
+	@abstract	Structure-of-arrays view of a TriMesh.
+	@discussion	Points and face data are held as separate float streams so
+				that kernels can process several points or triangles at once.
+				Each stream is padded with zeros to a multiple of 4 entries.
+				
+				Face normals are the unnormalized cross products of the
+				triangle edges, in counterclockwise order, and facePlane holds
+				the dot product of each face normal with the first vertex.
+				
+				The attribute pointers refer to the TriMesh's own arrays, and
+				are nullptr if the TriMesh lacks that attribute.
+				
+				The view is built on demand by E3TriMesh_GetSoA, and rebuilt
+				whenever the edit index of the naked TriMesh changes.
+*/
+struct TE3TriMeshSoA
+{
+	TQ3Uns32					editIndex;
+	TQ3Uns32					numPoints;
+	TQ3Uns32					numTriangles;
+	
+	std::vector<float>			pointX;
+	std::vector<float>			pointY;
+	std::vector<float>			pointZ;
+	
+	std::vector<float>			faceNormalX;
+	std::vector<float>			faceNormalY;
+	std::vector<float>			faceNormalZ;
+	std::vector<float>			facePlane;
+	
+	TQ3BoundingBox				bounds;
+	
+	const TQ3Vector3D*			vertexNormals;
+	const TQ3Param2D*			vertexUVs;
+	const TQ3ColorRGB*			vertexColors;
+	const TQ3Vector3D*			triangleNormals;
+	const TQ3ColorRGB*			triangleColors;
+};
 
 
 
@@ -70,6 +118,7 @@ TQ3Status			E3GeometryTriMesh_UnregisterClass(void);
 
 TQ3GeometryObject	E3TriMesh_New(const TQ3TriMeshData *triMeshData);
 TQ3GeometryObject	E3TriMesh_New_NoCopy(const TQ3TriMeshData *triMeshData);
+TQ3Status			E3TriMesh_ValidateData(TQ3TriMeshData *triMeshData);
 TQ3Status			E3TriMesh_Submit(const TQ3TriMeshData *triMeshData, TQ3ViewObject theView);
 TQ3Status			E3TriMesh_SetData(TQ3GeometryObject triMesh, const TQ3TriMeshData *triMeshData);
 TQ3Status			E3TriMesh_GetData(TQ3GeometryObject triMesh, TQ3TriMeshData *triMeshData);
@@ -83,6 +132,11 @@ TQ3GeometryObject	E3TriMesh_GetNakedGeometry( TQ3GeometryObject inGeom );
 void				E3TriMesh_SetNakedGeometry( TQ3GeometryObject inTriMesh,
 												TQ3GeometryObject inNaked );
 
+const TE3TriMeshSoA*	E3TriMesh_GetSoA( TQ3GeometryObject inTriMesh );
+void				E3TriMeshSoA_FacesToward( const TE3TriMeshSoA& inSoA,
+												const TQ3RationalPoint4D& inPoint,
+												TQ3Uns8* outFacing );
+
 
 
 //=============================================================================
@@ -235,6 +235,18 @@ e3geom_triangle_pick_with_ray(  TQ3ViewObject		theView,
 			worldPoints[0], worldPoints[1], worldPoints[2], cullBackface, theHit );
 	}
 	
+	// If only the nearest hit is wanted, skip a hit which is no nearer than
+	// the nearest so far before building it
+	TQ3Point3D closestOrigin;
+	if (didHit && E3Pick_GetClosestHitOrigin( thePick, theView, &closestOrigin ))
+	{
+		TQ3Point3D triHitPt = (1.0f - theHit.u - theHit.v) * worldPoints[0] +
+			theHit.u * worldPoints[1] + theHit.v * worldPoints[2];
+		
+		if (Q3FastPoint3D_Distance( &triHitPt, &closestOrigin ) >= E3Pick_GetClosestHitDistance( thePick ))
+			didHit = kQ3False;
+	}
+	
 	if (didHit)
 	{
 		// Set up a temporary triangle that holds the world points
@@ -361,6 +373,64 @@ e3geom_triangle_pick_world_ray(TQ3ViewObject theView, TQ3PickObject thePick, TQ3
 
 
 
+//=============================================================================
+//      e3geom_triangle_pick_world_ray_batch : Triangle world-ray batch picking.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_triangle_pick_world_ray_batch(TQ3ViewObject theView, TQ3PickObject thePick, TQ3Object theObject, const void *objectData)
+{	const TQ3TriangleData		*instanceData = (const TQ3TriangleData *) objectData;
+	TQ3Boolean					cullBackface;
+	TQ3BackfacingStyle			backfacingStyle;
+	TQ3Point3D					worldPoints[3];
+	TQ3Param3D					theHits[kE3RayPacketSize];
+	TQ3Status					qd3dStatus;
+	TQ3Uns32					n, p, numPackets;
+
+
+
+	// Transform our points
+	for (n = 0; n < 3; n++)
+		Q3View_TransformLocalToWorld(theView, &instanceData->vertices[n].point,
+			&worldPoints[n]);
+
+
+
+	// Determine if we should cull back-facing triangles or not
+	qd3dStatus   = E3View_GetBackfacingStyleState(theView, &backfacingStyle);
+	cullBackface = (TQ3Boolean)(qd3dStatus == kQ3Success && backfacingStyle == kQ3BackfacingStyleRemove);
+
+
+
+	// Test each packet of rays, and record the hits
+	TE3RayPacket* thePackets = E3WorldRayBatchPick_AccessPackets( thePick, &numPackets );
+	TQ3Vector3D faceNormal = Q3Cross3D( worldPoints[1] - worldPoints[0], worldPoints[2] - worldPoints[0] );
+
+	for (p = 0; p < numPackets; ++p)
+	{
+		TQ3Uns32 hitMask = E3RayPacket_IntersectTriangle( thePackets[p], (1U << thePackets[p].numRays) - 1,
+			worldPoints[0], worldPoints[1], worldPoints[2], cullBackface, theHits );
+
+		for (TQ3Uns32 lane = 0; hitMask != 0; ++lane, hitMask >>= 1)
+		{
+			if ((hitMask & 1) == 0)
+				continue;
+
+			const TQ3Param3D& theHit( theHits[lane] );
+			TQ3Point3D hitXYZ = (1.0f - theHit.u - theHit.v) * worldPoints[0] +
+				theHit.u * worldPoints[1] + theHit.v * worldPoints[2];
+
+			E3WorldRayBatchPick_RecordHit( thePick, theView, p * kE3RayPacketSize + lane,
+				theHit, hitXYZ, faceNormal, kQ3ArrayIndexNULL );
+		}
+	}
+
+	return(kQ3Success);
+}
+
+
+
+
+
 //=============================================================================
 //      e3geom_triangle_pick : Triangle picking method.
 //-----------------------------------------------------------------------------
@@ -386,6 +456,10 @@ e3geom_triangle_pick(TQ3ViewObject theView, TQ3ObjectType objectType, TQ3Object
 			qd3dStatus = e3geom_triangle_pick_world_ray(theView, thePick, theObject, objectData);
 			break;
 
+		case kQ3PickTypeWorldRayBatch:
+			qd3dStatus = e3geom_triangle_pick_world_ray_batch(theView, thePick, theObject, objectData);
+			break;
+
 		default:
 			qd3dStatus = kQ3Failure;
 			break;
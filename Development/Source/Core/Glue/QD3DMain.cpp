@@ -49,6 +49,7 @@
 #include "E3CustomElements.h"
 #include "E3Set.h"
 #include "E3View.h"
+#include "E3Profile.h"
 
 
 extern int gDebugMode;
@@ -251,6 +252,55 @@ Q3SetDebugMode( int inMode )
 
 
 
+
+//=============================================================================
+//      Q3Profile_SetCapture : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Profile_SetCapture( TQ3Boolean inCapture )
+{
+
+
+	// Release build checks
+
+
+
+	// Debug build checks
+
+
+
+	// Call our implementation
+	return(E3Profile_SetCapture(inCapture));
+}
+
+
+
+
+
+//=============================================================================
+//      Q3Profile_WriteLastFrame : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Profile_WriteLastFrame( const char* inPath )
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(inPath), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call our implementation
+	return(E3Profile_WriteLastFrame(inPath));
+}
+
+
+
+
 //=============================================================================
 //      Q3ObjectHierarchy_GetTypeFromString : Quesa API entry point.
 //-----------------------------------------------------------------------------
@@ -969,6 +969,133 @@ Q3WorldRayPick_SetData(TQ3PickObject pick, const TQ3WorldRayPickData *data)
 
 
 
+#pragma mark -
+
+//=============================================================================
+//      Q3WorldRayBatchPick_New : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3PickObject
+Q3WorldRayBatchPick_New(const TQ3WorldRayBatchPickData *data)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(data), nullptr);
+	Q3_REQUIRE_OR_RESULT(data->numRays == 0 || Q3_VALID_PTR(data->rays), nullptr);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3WorldRayBatchPick_New(data));
+}
+
+
+
+
+
+//=============================================================================
+//      Q3WorldRayBatchPick_GetNumRays : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3WorldRayBatchPick_GetNumRays(TQ3PickObject pick, TQ3Uns32 *numRays)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3Pick_IsOfMyClass ( pick ), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3Object_IsType(pick, kQ3PickTypeWorldRayBatch), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(numRays), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3WorldRayBatchPick_GetNumRays(pick, numRays));
+}
+
+
+
+
+
+//=============================================================================
+//      Q3WorldRayBatchPick_SetRays : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3WorldRayBatchPick_SetRays(TQ3PickObject pick, TQ3Uns32 numRays, const TQ3Ray3D *rays)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3Pick_IsOfMyClass ( pick ), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3Object_IsType(pick, kQ3PickTypeWorldRayBatch), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(numRays == 0 || Q3_VALID_PTR(rays), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3WorldRayBatchPick_SetRays(pick, numRays, rays));
+}
+
+
+
+
+
+//=============================================================================
+//      Q3WorldRayBatchPick_GetHits : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3WorldRayBatchPick_GetHits(TQ3PickObject pick, TQ3WorldRayBatchHit *hits)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3Pick_IsOfMyClass ( pick ), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3Object_IsType(pick, kQ3PickTypeWorldRayBatch), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(hits), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3WorldRayBatchPick_GetHits(pick, hits));
+}
+
+
+
 #pragma mark -
 
 //=============================================================================
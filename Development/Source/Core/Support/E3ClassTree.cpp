@@ -62,6 +62,7 @@
 #include "E3ClassTree.h"
 #include "E3HashTable.h"
 #include "E3Set.h"
+#include "E3Profile.h"
 
 #include <time.h>
 #include <stdio.h>
@@ -301,6 +302,7 @@ E3ClassInfo::Find_Method ( TQ3XMethodType methodType, TQ3Boolean canInherit )
 	{
 	// Validate our parameters
 	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(this), nullptr);
+	Q3_PROFILE_COUNT( "Find_Method lookups", 1 ) ;
 
 
 
@@ -0,0 +1,188 @@
+/*  NAME:
+        E3FrameArena.cpp
+
+    DESCRIPTION:
+        Per-frame bump allocator for scratch memory.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3FrameArena.h"
+#include "E3Utils.h"
+
+#include <atomic>
+
+
+
+
+
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+namespace
+{
+	const TQ3Uns32	kAlignment			= 16;
+	const TQ3Uns32	kMinChunkCapacity	= 64 * 1024;
+}
+
+
+
+
+
+//=============================================================================
+//      Internal static variables
+//-----------------------------------------------------------------------------
+static std::atomic_uint32_t		sArenaAllocCount( 0 );
+static std::atomic_int64_t		sArenaReservedBytes( 0 );
+
+
+
+
+
+//=============================================================================
+//      Internal functions
+//-----------------------------------------------------------------------------
+static inline TQ3Uns32 RoundUpToAlignment( TQ3Uns32 inSize )
+{
+	return (inSize + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+
+
+
+
+//=============================================================================
+//      Public functions
+//-----------------------------------------------------------------------------
+E3FrameArena::E3FrameArena()
+	: mChunks( nullptr )
+{
+}
+
+E3FrameArena::~E3FrameArena()
+{
+	FreeChunks();
+}
+
+TQ3Uns32	E3FrameArena::HeaderSize()
+{
+	// Keep the data that follows the header aligned.
+	return RoundUpToAlignment( sizeof(Chunk) );
+}
+
+E3FrameArena::Chunk*	E3FrameArena::NewChunk( TQ3Uns32 inCapacity )
+{
+	Chunk* theChunk = static_cast<Chunk*>( Q3Memory_Allocate(
+		HeaderSize() + inCapacity ) );
+	
+	if (theChunk != nullptr)
+	{
+		theChunk->capacity = inCapacity;
+		theChunk->used = 0;
+		theChunk->next = mChunks;
+		mChunks = theChunk;
+		sArenaReservedBytes += inCapacity;
+	}
+	
+	return theChunk;
+}
+
+void	E3FrameArena::FreeChunks()
+{
+	while (mChunks != nullptr)
+	{
+		Chunk* theChunk = mChunks;
+		mChunks = theChunk->next;
+		sArenaReservedBytes -= theChunk->capacity;
+		Q3Memory_Free( &theChunk );
+	}
+}
+
+void*	E3FrameArena::Allocate( TQ3Uns32 inSize )
+{
+	TQ3Uns32 theSize = RoundUpToAlignment( E3Num_Max( inSize, 1U ) );
+	
+	if ( (mChunks == nullptr) || (mChunks->capacity - mChunks->used < theSize) )
+	{
+		TQ3Uns32 newCapacity = kMinChunkCapacity;
+		if (mChunks != nullptr)
+		{
+			newCapacity = E3Num_Max( newCapacity, 2 * mChunks->capacity );
+		}
+		newCapacity = E3Num_Max( newCapacity, theSize );
+		
+		if (NewChunk( newCapacity ) == nullptr)
+		{
+			return nullptr;
+		}
+	}
+	
+	TQ3Uns8* thePtr = reinterpret_cast<TQ3Uns8*>( mChunks ) +
+		HeaderSize() + mChunks->used;
+	mChunks->used += theSize;
+	sArenaAllocCount += 1;
+	
+	return thePtr;
+}
+
+void	E3FrameArena::Reset()
+{
+	if ( (mChunks != nullptr) && (mChunks->next != nullptr) )
+	{
+		// Consolidate into one chunk that could have held the whole frame.
+		TQ3Uns32 totalCapacity = 0;
+		for (Chunk* aChunk = mChunks; aChunk != nullptr; aChunk = aChunk->next)
+		{
+			totalCapacity += aChunk->capacity;
+		}
+		FreeChunks();
+		NewChunk( totalCapacity );
+	}
+	else if (mChunks != nullptr)
+	{
+		mChunks->used = 0;
+	}
+}
+
+void	E3FrameArena_GetStatistics( TQ3Uns32& outAllocations,
+									int64_t& outReservedBytes )
+{
+	outAllocations = sArenaAllocCount;
+	outReservedBytes = sArenaReservedBytes;
+}
@@ -0,0 +1,144 @@
+/*  NAME:
+        E3FrameArena.h
+
+    DESCRIPTION:
+        Header file for E3FrameArena.cpp.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+#ifndef E3FRAMEARENA_HDR
+#define E3FRAMEARENA_HDR
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3Prefix.h"
+
+#include <stdint.h>
+
+
+
+
+
+//=============================================================================
+//      Class declaration
+//-----------------------------------------------------------------------------
+/*!
+	@class		E3FrameArena
+	
+	@abstract	Bump allocator for scratch memory that only needs to live
+				until the end of a frame.
+	
+	@discussion	Allocation just advances a pointer within a chunk, and there
+				is no way to free an individual allocation.  Reset makes all
+				the memory available again at once.  If a frame needed more
+				than one chunk, Reset replaces them with one chunk big enough
+				for the whole frame, so that a steady scene settles down to
+				no heap allocations per frame.
+				
+				Allocations are aligned to 16 bytes.  The memory is not
+				initialized, and destructors are never run, so this is only
+				suitable for plain data.
+*/
+class E3FrameArena
+{
+public:
+							E3FrameArena();
+							~E3FrameArena();
+	
+	/*!
+		@function	Allocate
+		@abstract	Allocate scratch memory, valid until the next Reset.
+		@param		inSize		Number of bytes needed.
+		@result		Pointer to memory, or nullptr if out of memory.
+	*/
+	void*					Allocate( TQ3Uns32 inSize );
+	
+	/*!
+		@function	AllocateArray
+		@abstract	Typed convenience wrapper for Allocate.
+	*/
+	template <typename T>
+	T*						AllocateArray( TQ3Uns32 inCount )
+							{
+								return static_cast<T*>( Allocate(
+									static_cast<TQ3Uns32>( inCount * sizeof(T) ) ) );
+							}
+	
+	/*!
+		@function	Reset
+		@abstract	Invalidate all previous allocations.
+	*/
+	void					Reset();
+
+private:
+	struct Chunk
+	{
+		Chunk*				next;
+		TQ3Uns32			capacity;
+		TQ3Uns32			used;
+	};
+	
+	static TQ3Uns32			HeaderSize();
+	Chunk*					NewChunk( TQ3Uns32 inCapacity );
+	void					FreeChunks();
+	
+							E3FrameArena( const E3FrameArena& );
+	E3FrameArena&			operator=( const E3FrameArena& );
+	
+	Chunk*					mChunks;	// current chunk at head of list
+};
+
+
+
+
+
+//=============================================================================
+//      Function prototypes
+//-----------------------------------------------------------------------------
+/*!
+	@function	E3FrameArena_GetStatistics
+	@abstract	Get totals across all frame arenas.
+	@param		outAllocations		Receives the number of allocations served
+									by frame arenas since Quesa was loaded.
+	@param		outReservedBytes	Receives the number of bytes currently
+									held by frame arenas.
+*/
+void		E3FrameArena_GetStatistics( TQ3Uns32& outAllocations,
+										int64_t& outReservedBytes );
+
+#endif
+
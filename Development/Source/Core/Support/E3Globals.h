@@ -180,6 +180,7 @@ extern "C" {
 #define kQ3ClassNamePickWindowPoint					"WindowPointPick"
 #define kQ3ClassNamePickWindowRect					"WindowRectPick"
 #define kQ3ClassNamePickWorldRay					"WorldRayPick"
+#define kQ3ClassNamePickWorldRayBatch				"WorldRayBatchPick"
 #define kQ3ClassNameRenderer						"Renderer"
 #define kQ3ClassNameRendererGeneric					"GenericRenderer"
 #define kQ3ClassNameRendererInteractive				"InteractiveRenderer"
@@ -244,6 +245,7 @@ extern "C" {
 #define kQ3ClassNameStorageWin32					"Win32Storage"
 #define kQ3ClassNameAttributeSetList				"AttributeSetList"
 #define kQ3ClassNameAttributeArray					"AttributeArray"
+#define kQ3ClassNameCompressedTriMesh				"CompressedTriMesh"
 #define kQ3ClassNameAttributeSetListGeometry		"GeometryAttributeSetList"
 #define kQ3ClassNameAttributeSetListFace			"FaceAttributeSetList"
 #define kQ3ClassNameAttributeSetListVertex			"VertexAttributeSetList"
@@ -345,6 +347,7 @@ extern "C" {
 #define kQ3ObjectTypeAttributeSetListFace			Q3_OBJECT_TYPE('f', 'a', 's', 'l')
 #define kQ3ObjectTypeAttributeSetListGeometry		Q3_OBJECT_TYPE('g', 'a', 's', 'l')
 #define kQ3ObjectTypeAttributeSetListVertex			Q3_OBJECT_TYPE('v', 'a', 's', 'l')
+#define kQ3ObjectTypeCompressedTriMesh				Q3_OBJECT_TYPE('c', 't', 'r', 'i')
 #define kQ3ObjectTypeDisplayGroupState				Q3_OBJECT_TYPE('d', 'g', 's', 't')
 #define kQ3ObjectTypeDisplayGroupBBox				Q3_OBJECT_TYPE('d', 'g', 'b', 'b')
 #define kQ3ObjectTypeGeneralPolygonHint				Q3_OBJECT_TYPE('g', 'p', 'l', 'h')
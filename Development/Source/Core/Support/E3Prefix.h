@@ -50,6 +50,11 @@
 	#define QUESA_ALLOW_INLINE_APIS								1
 #endif
 
+// Leave out the frame profiler unless this is a profile build
+#ifndef Q3_PROFILE
+	#define Q3_PROFILE											0
+#endif
+
 
 
 
@@ -183,6 +188,19 @@
 #endif
 
 
+// Should the math routines use SSE/NEON vector kernels?
+//
+// The NEON kernels have not yet been built and checked against the scalar
+// code, so AArch64 builds must opt in by defining this as 1.
+#ifndef QUESA_USE_SIMD_MATH
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+		#define QUESA_USE_SIMD_MATH								1
+	#else
+		#define QUESA_USE_SIMD_MATH								0
+	#endif
+#endif
+
+
 // Are C++ exceptions enabled?
 #ifndef QUESA_USE_EXCEPTIONS
 	#ifdef __MWERKS__
@@ -0,0 +1,466 @@
+/*  NAME:
+        E3Profile.cpp
+
+    DESCRIPTION:
+        Frame profiler for the view pipeline.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3Profile.h"
+
+#if Q3_PROFILE
+	#include <chrono>
+	#include <memory>
+	#include <mutex>
+	#include <stdio.h>
+	#include <vector>
+#endif
+
+
+
+
+
+#if Q3_PROFILE
+//=============================================================================
+//      Internal types
+//-----------------------------------------------------------------------------
+namespace
+{
+	// A timed scope, in nanoseconds since the profiler's clock epoch
+	struct TE3ProfileEvent
+	{
+		const char*		name;
+		int64_t			start;
+		int64_t			duration;
+		TQ3Uns32		threadID;
+	};
+	
+	// Events recorded by one thread during the open frame.  The mutex is
+	// only contended when a frame is being closed.
+	struct TE3ProfileThread
+	{
+		std::mutex						mutex;
+		std::vector<TE3ProfileEvent>	events;
+		TQ3Uns32						threadID;
+	};
+	
+	// Everything recorded during the last completed frame
+	struct TE3ProfileFrame
+	{
+		bool											isValid;
+		int64_t											start;
+		int64_t											end;
+		TQ3Uns32										threadID;
+		std::vector<TE3ProfileEvent>					events;
+		std::vector< std::pair<const char*, int64_t> >	counts;
+	};
+}
+
+
+
+
+
+//=============================================================================
+//      Internal static variables
+//-----------------------------------------------------------------------------
+namespace
+{
+	std::atomic<bool>								sIsCapturing( false );
+	
+	// Guards everything below, except the per-thread event lists
+	std::mutex										sProfileMutex;
+	std::vector< std::unique_ptr<TE3ProfileThread> >	sThreads;
+	E3ProfileCounter*								sCounters = nullptr;
+	bool											sIsInFrame = false;
+	int64_t											sFrameStart = 0;
+	TQ3Uns32										sFrameThreadID = 0;
+	TE3ProfileFrame									sLastFrame = { false, 0, 0, 0, {}, {} };
+	
+	thread_local TE3ProfileThread*					tThreadEvents = nullptr;
+}
+
+
+
+
+
+//=============================================================================
+//      Internal functions
+//-----------------------------------------------------------------------------
+//      e3profile_now : Current time in nanoseconds.
+//-----------------------------------------------------------------------------
+static int64_t
+e3profile_now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+
+
+
+
+//=============================================================================
+//      e3profile_thread_events : Get the event list of this thread.
+//-----------------------------------------------------------------------------
+//		Note :	The list is created on first use, and kept until Quesa is
+//				unloaded so that a frame can still be closed after the thread
+//				has gone.  Returns nullptr if memory is exhausted.
+//-----------------------------------------------------------------------------
+static TE3ProfileThread*
+e3profile_thread_events()
+{
+	if (tThreadEvents == nullptr)
+	{
+		try
+		{
+			std::unique_ptr<TE3ProfileThread>	newThread( new TE3ProfileThread );
+			
+			std::lock_guard<std::mutex>	lock( sProfileMutex );
+			newThread->threadID = static_cast<TQ3Uns32>( sThreads.size() + 1 );
+			sThreads.push_back( std::move( newThread ) );
+			tThreadEvents = sThreads.back().get();
+		}
+		catch (...)
+		{
+		}
+	}
+	
+	return tThreadEvents;
+}
+
+
+
+
+
+//=============================================================================
+//      e3profile_discard_events : Drop events and counts of an unfinished frame.
+//-----------------------------------------------------------------------------
+//		Note :	Called with sProfileMutex held.
+//-----------------------------------------------------------------------------
+static void
+e3profile_discard_events()
+{
+	for (std::unique_ptr<TE3ProfileThread>& theThread : sThreads)
+	{
+		std::lock_guard<std::mutex>	lock( theThread->mutex );
+		theThread->events.clear();
+	}
+	
+	for (E3ProfileCounter* theCounter = sCounters; theCounter != nullptr;
+		theCounter = theCounter->Next())
+	{
+		theCounter->Collect();
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      e3profile_write_string : Write a JSON string.
+//-----------------------------------------------------------------------------
+static void
+e3profile_write_string( FILE* theFile, const char* inString )
+{
+	fputc( '"', theFile );
+	
+	for (const char* c = inString; *c != '\0'; ++c)
+	{
+		if ( (*c == '"') || (*c == '\\') )
+			fprintf( theFile, "\\%c", *c );
+		else if (static_cast<unsigned char>(*c) < 0x20)
+			fprintf( theFile, "\\u%04x", static_cast<unsigned char>(*c) );
+		else
+			fputc( *c, theFile );
+	}
+	
+	fputc( '"', theFile );
+}
+
+
+
+
+
+//=============================================================================
+//      E3ProfileScope::E3ProfileScope : Constructor.
+//-----------------------------------------------------------------------------
+E3ProfileScope::E3ProfileScope( const char* inName )
+	: mName( nullptr )
+	, mStart( 0 )
+{
+	if (sIsCapturing.load( std::memory_order_relaxed ))
+	{
+		mName = inName;
+		mStart = e3profile_now();
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      E3ProfileScope::~E3ProfileScope : Destructor.
+//-----------------------------------------------------------------------------
+E3ProfileScope::~E3ProfileScope()
+{
+	if (mName != nullptr)
+	{
+		TE3ProfileThread*	theThread = e3profile_thread_events();
+		
+		if (theThread != nullptr)
+		{
+			TE3ProfileEvent	theEvent = { mName, mStart, e3profile_now() - mStart,
+				theThread->threadID };
+			
+			try
+			{
+				std::lock_guard<std::mutex>	lock( theThread->mutex );
+				theThread->events.push_back( theEvent );
+			}
+			catch (...)
+			{
+			}
+		}
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      E3ProfileCounter::E3ProfileCounter : Constructor.
+//-----------------------------------------------------------------------------
+E3ProfileCounter::E3ProfileCounter( const char* inName )
+	: mName( inName )
+	, mValue( 0 )
+	, mNext( nullptr )
+{
+	std::lock_guard<std::mutex>	lock( sProfileMutex );
+	mNext = sCounters;
+	sCounters = this;
+}
+
+
+
+
+
+//=============================================================================
+//      E3ProfileCounter::Add : Add to the count of the open frame.
+//-----------------------------------------------------------------------------
+void
+E3ProfileCounter::Add( int64_t inAmount )
+{
+	if (sIsCapturing.load( std::memory_order_relaxed ))
+		mValue.fetch_add( inAmount, std::memory_order_relaxed );
+}
+
+#endif // Q3_PROFILE
+
+
+
+
+
+//=============================================================================
+//      Public functions
+//-----------------------------------------------------------------------------
+//      E3Profile_BeginFrame : Note that a frame has started.
+//-----------------------------------------------------------------------------
+//		Note :	Anything recorded since the last frame ended is dropped, so
+//				that each frame holds only its own work.
+//-----------------------------------------------------------------------------
+void
+E3Profile_BeginFrame( void )
+{
+#if Q3_PROFILE
+	if (sIsCapturing.load( std::memory_order_relaxed ))
+	{
+		TE3ProfileThread*	theThread = e3profile_thread_events();
+		
+		std::lock_guard<std::mutex>	lock( sProfileMutex );
+		if (! sIsInFrame)
+		{
+			e3profile_discard_events();
+			sIsInFrame = true;
+			sFrameStart = e3profile_now();
+			sFrameThreadID = (theThread != nullptr) ? theThread->threadID : 0;
+		}
+	}
+#endif
+}
+
+
+
+
+
+//=============================================================================
+//      E3Profile_EndFrame : Close the open frame.
+//-----------------------------------------------------------------------------
+void
+E3Profile_EndFrame( void )
+{
+#if Q3_PROFILE
+	std::lock_guard<std::mutex>	lock( sProfileMutex );
+	if (! sIsInFrame)
+		return;
+	
+	sIsInFrame = false;
+	
+	try
+	{
+		sLastFrame.isValid = false;
+		sLastFrame.start = sFrameStart;
+		sLastFrame.end = e3profile_now();
+		sLastFrame.threadID = sFrameThreadID;
+		sLastFrame.events.clear();
+		sLastFrame.counts.clear();
+		
+		for (std::unique_ptr<TE3ProfileThread>& theThread : sThreads)
+		{
+			std::lock_guard<std::mutex>	threadLock( theThread->mutex );
+			sLastFrame.events.insert( sLastFrame.events.end(),
+				theThread->events.begin(), theThread->events.end() );
+			theThread->events.clear();
+		}
+		
+		for (E3ProfileCounter* theCounter = sCounters; theCounter != nullptr;
+			theCounter = theCounter->Next())
+		{
+			sLastFrame.counts.push_back( std::make_pair( theCounter->Name(),
+				theCounter->Collect() ) );
+		}
+		
+		sLastFrame.isValid = true;
+	}
+	catch (...)
+	{
+		e3profile_discard_events();
+	}
+#endif
+}
+
+
+
+
+
+//=============================================================================
+//      E3Profile_SetCapture : Start or stop recording events.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Profile_SetCapture( TQ3Boolean inCapture )
+{
+#if Q3_PROFILE
+	std::lock_guard<std::mutex>	lock( sProfileMutex );
+	
+	sIsCapturing.store( inCapture == kQ3True );
+	if (inCapture == kQ3False)
+	{
+		sIsInFrame = false;
+		e3profile_discard_events();
+	}
+	
+	return kQ3Success;
+#else
+	#pragma unused( inCapture )
+	return kQ3Failure;
+#endif
+}
+
+
+
+
+
+//=============================================================================
+//      E3Profile_WriteLastFrame : Export the last frame as a Chrome trace.
+//-----------------------------------------------------------------------------
+//		Note :	Times are written in microseconds from the start of the
+//				frame, as complete ("X") events, with the frame itself as the
+//				outermost event.  Counts are written as counter ("C") events.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Profile_WriteLastFrame( const char* inPath )
+{
+#if Q3_PROFILE
+	std::lock_guard<std::mutex>	lock( sProfileMutex );
+	if (! sLastFrame.isValid)
+		return kQ3Failure;
+	
+	FILE*	theFile = fopen( inPath, "w" );
+	if (theFile == nullptr)
+		return kQ3Failure;
+	
+	const double	kNanoToMicro = 0.001;
+	
+	fprintf( theFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+	fprintf( theFile, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Quesa\"}},\n" );
+	fprintf( theFile, "{\"name\":\"Frame\",\"cat\":\"quesa\",\"ph\":\"X\",\"ts\":0,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+		(sLastFrame.end - sLastFrame.start) * kNanoToMicro, sLastFrame.threadID );
+	
+	for (const TE3ProfileEvent& theEvent : sLastFrame.events)
+	{
+		fprintf( theFile, ",\n{\"name\":" );
+		e3profile_write_string( theFile, theEvent.name );
+		fprintf( theFile, ",\"cat\":\"quesa\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+			(theEvent.start - sLastFrame.start) * kNanoToMicro,
+			theEvent.duration * kNanoToMicro, theEvent.threadID );
+	}
+	
+	for (const std::pair<const char*, int64_t>& theCount : sLastFrame.counts)
+	{
+		fprintf( theFile, ",\n{\"name\":" );
+		e3profile_write_string( theFile, theCount.first );
+		fprintf( theFile, ",\"cat\":\"quesa\",\"ph\":\"C\",\"ts\":0,\"pid\":1,\"args\":{\"count\":%lld}}",
+			static_cast<long long>( theCount.second ) );
+	}
+	
+	fprintf( theFile, "\n]}\n" );
+	
+	bool	didWrite = (ferror( theFile ) == 0);
+	if (fclose( theFile ) != 0)
+		didWrite = false;
+	
+	return didWrite ? kQ3Success : kQ3Failure;
+#else
+	#pragma unused( inPath )
+	return kQ3Failure;
+#endif
+}
@@ -0,0 +1,187 @@
+/*  NAME:
+        E3Profile.h
+
+    DESCRIPTION:
+        Header file for E3Profile.cpp.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+#ifndef E3PROFILE_HDR
+#define E3PROFILE_HDR
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3Prefix.h"
+
+#if Q3_PROFILE
+	#include <atomic>
+	#include <stdint.h>
+#endif
+
+
+
+
+
+//=============================================================================
+//      Macros
+//-----------------------------------------------------------------------------
+// Instrumentation points, which compile to nothing unless Q3_PROFILE is set.
+//
+// Q3_PROFILE_SCOPE times the rest of the enclosing block, and Q3_PROFILE_COUNT
+// adds to a per-frame counter.  Names must be string literals, or other
+// strings that outlive the profiler, such as class names.
+#if Q3_PROFILE
+	#define Q3_PROFILE_SCOPE( _name )							\
+				E3ProfileScope	e3ProfileScope_( _name )
+
+	#define Q3_PROFILE_COUNT( _name, _amount )					\
+				do												\
+					{											\
+					static E3ProfileCounter	sCounter_( _name );	\
+					sCounter_.Add( _amount );					\
+					}											\
+				while (0)
+#else
+	#define Q3_PROFILE_SCOPE( _name )			do { } while (0)
+	#define Q3_PROFILE_COUNT( _name, _amount )	do { } while (0)
+#endif
+
+
+
+
+
+//=============================================================================
+//      Class declarations
+//-----------------------------------------------------------------------------
+#if Q3_PROFILE
+
+/*!
+	@class		E3ProfileScope
+	
+	@abstract	Records the time spent between construction and destruction.
+	
+	@discussion	While no capture is running, this costs one relaxed atomic
+				load.  Events are kept per thread, so scopes may be used on
+				worker threads as well as the rendering thread.
+*/
+class E3ProfileScope
+{
+public:
+	explicit				E3ProfileScope( const char* inName );
+							~E3ProfileScope();
+
+private:
+							E3ProfileScope( const E3ProfileScope& );
+	E3ProfileScope&			operator=( const E3ProfileScope& );
+	
+	const char*				mName;		// nullptr if not capturing
+	int64_t					mStart;
+};
+
+
+
+/*!
+	@class		E3ProfileCounter
+	
+	@abstract	A named count, reported and reset at the end of each frame.
+	
+	@discussion	Counters are meant to be static objects, created by the
+				Q3_PROFILE_COUNT macro, which register themselves with the
+				profiler when first used.
+*/
+class E3ProfileCounter
+{
+public:
+	explicit				E3ProfileCounter( const char* inName );
+	
+	void					Add( int64_t inAmount );
+	
+	const char*				Name() const { return mName; }
+	int64_t					Collect() { return mValue.exchange( 0 ); }
+	E3ProfileCounter*		Next() const { return mNext; }
+
+private:
+							E3ProfileCounter( const E3ProfileCounter& );
+	E3ProfileCounter&		operator=( const E3ProfileCounter& );
+	
+	const char*				mName;
+	std::atomic<int64_t>	mValue;
+	E3ProfileCounter*		mNext;
+};
+
+#endif // Q3_PROFILE
+
+
+
+
+
+//=============================================================================
+//      Function prototypes
+//-----------------------------------------------------------------------------
+/*!
+	@function	E3Profile_BeginFrame
+	@abstract	Note that a frame has started, if one is not already open.
+*/
+void		E3Profile_BeginFrame( void );
+
+
+/*!
+	@function	E3Profile_EndFrame
+	@abstract	Close the open frame, keeping its events for export.
+*/
+void		E3Profile_EndFrame( void );
+
+
+/*!
+	@function	E3Profile_SetCapture
+	@abstract	Start or stop recording events.
+	@result		kQ3Failure if Quesa was built without Q3_PROFILE.
+*/
+TQ3Status	E3Profile_SetCapture( TQ3Boolean inCapture );
+
+
+/*!
+	@function	E3Profile_WriteLastFrame
+	@abstract	Write the events of the last completed frame to a file, in
+				the Chrome trace event format.
+	@param		inPath		Path of the file to create.
+	@result		kQ3Failure if there is no frame, or the file can not be
+				written, or Quesa was built without Q3_PROFILE.
+*/
+TQ3Status	E3Profile_WriteLastFrame( const char* inPath );
+
+#endif
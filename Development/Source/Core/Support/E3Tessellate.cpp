@@ -53,6 +53,11 @@
 
 #include "glu-mesa.h"
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
 
 //=============================================================================
 //      Internal types
@@ -102,6 +107,45 @@ typedef struct E3CombinedAttribute {
 
 
 
+// Node in a contour ring for the native tessellator
+typedef struct E3TessellateNode {
+	TQ3Uns32					vertexIndex;	// index into E3TessellateWorkspace::vertices
+	double						x, y;			// projected position
+	TQ3Uns32					z;				// z-order curve value
+	struct E3TessellateNode		*prev, *next;	// ring order
+	struct E3TessellateNode		*prevZ, *nextZ;	// z-order, used for large contours
+	bool						steiner;		// single-point hole, never filtered
+} E3TessellateNode;
+
+
+// Scratch space for the native tessellator, kept per thread so that it is
+// allocated once rather than on every call
+typedef struct E3TessellateWorkspace {
+	std::vector<const TQ3Vertex3D*>	vertices;		// all contour vertices, in order
+	std::vector<double>				projected;		// x, y for each vertex
+	std::vector<TQ3Uns32>			nextVertex;		// next vertex on the same contour
+	std::vector<TQ3Uns32>			contourStart;	// first vertex of each contour
+	std::vector<TQ3Uns32>			contourSize;
+	std::vector<TQ3Uns32>			contourDepth;	// number of contours enclosing it
+	std::vector<E3TessellateNode>	nodes;
+	std::vector<E3TessellateNode*>	holes;
+	std::vector<TQ3Uns32>			sweepOrder;
+	std::vector<TQ3Uns32>			sweepActive;
+	std::vector<TQ3Uns32>			triangles;		// three vertex indices each
+	std::vector<TQ3Uns32>			vertexRemap;
+} E3TessellateWorkspace;
+
+
+// GLU tessellator, created once per thread
+struct E3GLUTessellator {
+	GLUtriangulatorObj*		tess;
+
+							E3GLUTessellator() : tess( nullptr ) {}
+							~E3GLUTessellator() { if (tess != nullptr) gluDeleteTess( tess ); }
+};
+
+
+
 
 
 //=============================================================================
@@ -871,92 +915,1458 @@ e3tessellate_dispose_state(E3TessellateState *theState)
 
 
 //=============================================================================
-//      Public functions
-//-----------------------------------------------------------------------------
-//      E3Tessellate_Contours : Tessellate a list of contours into one TriMesh.
+//      Native tessellator
 //-----------------------------------------------------------------------------
-//		Note :	Contours form a planar polygon, with each contour defined by
-//				one or more lists of vertices. Contours may be concave or
-//				convex, and may be nested and overlapping.
+//		The native tessellator handles contours which do not cross, which
+//		covers nearly every polygon in practice.  A single convex contour
+//		becomes a fan.  Anything else is ear clipped, after joining each
+//		hole to its enclosing contour with a bridge; large contours keep a
+//		z-order index so that ear tests only visit nearby vertices.  This is
+//		the approach taken by the earcut library.
 //
-//				Overlapping contours form holes, with the even-odd rule used to
-//				determine which portion of the polygon is to be removed.
+//		Crossing contours need new vertices where they cross, which only the
+//		GLU tessellator can make, so a sweep over the edges detects them and
+//		the caller falls back to GLU.
 //-----------------------------------------------------------------------------
-TQ3Object
-E3Tessellate_Contours(TQ3Uns32 numContours,
-		const TQ3GeneralPolygonContourData *theContours,
-		TQ3AttributeSet theAttributes )
+//      e3tessellate_workspace : Get the native tessellator's scratch space.
+//-----------------------------------------------------------------------------
+static E3TessellateWorkspace&
+e3tessellate_workspace(void)
 {
-	// Validate our parameters
-	Q3_REQUIRE_OR_RESULT(numContours >= 1,          nullptr);
-	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(theContours), nullptr);
+	static thread_local E3TessellateWorkspace tWorkspace;
+
+	return(tWorkspace);
+}
+
 
-	GLdouble				vertCoords[3];
-	TQ3Vertex3D				*theVertex;
-	TQ3GeometryObject		theTriMesh;
-	GLUtriangulatorObj		*theTess;
-	E3TessellateState		theState;
-	TQ3Uns32				n, m;
 
 
 
+//=============================================================================
+//      e3tessellate_area : Signed area of a triangle of nodes.
+//-----------------------------------------------------------------------------
+//		Note :	Negative for a counter-clockwise triangle.
+//-----------------------------------------------------------------------------
+static inline double
+e3tessellate_area(const E3TessellateNode *p, const E3TessellateNode *q, const E3TessellateNode *r)
+{
+	return((q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y));
+}
 
 
 
-	// Create the tessellator
-	theTess = gluNewTess();
-	if (theTess == nullptr)
+
+
+//=============================================================================
+//      e3tessellate_equals : Do two nodes lie at the same point?
+//-----------------------------------------------------------------------------
+static inline bool
+e3tessellate_equals(const E3TessellateNode *p, const E3TessellateNode *q)
+{
+	return(p->x == q->x && p->y == q->y);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_point_in_triangle : Is a point within a triangle?
+//-----------------------------------------------------------------------------
+//		Note :	The triangle is counter-clockwise, and its edges count as
+//				being inside.
+//-----------------------------------------------------------------------------
+static inline bool
+e3tessellate_point_in_triangle(double ax, double ay, double bx, double by,
+								double cx, double cy, double px, double py)
+{
+	return((cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+		   (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+		   (bx - px) * (cy - py) >= (cx - px) * (by - py));
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_insert_node : Add a node after another in a ring.
+//-----------------------------------------------------------------------------
+static E3TessellateNode *
+e3tessellate_insert_node(E3TessellateWorkspace &theWorkspace, TQ3Uns32 vertexIndex, E3TessellateNode *lastNode)
+{	E3TessellateNode		theNode;
+
+
+
+	// The ring links point into the node array, so it must never grow
+	Q3_ASSERT(theWorkspace.nodes.size() < theWorkspace.nodes.capacity());
+
+	theNode.vertexIndex = vertexIndex;
+	theNode.x           = theWorkspace.projected[2 * vertexIndex];
+	theNode.y           = theWorkspace.projected[2 * vertexIndex + 1];
+	theNode.z           = 0;
+	theNode.prevZ       = nullptr;
+	theNode.nextZ       = nullptr;
+	theNode.steiner     = false;
+
+	theWorkspace.nodes.push_back(theNode);
+	E3TessellateNode *newNode = &theWorkspace.nodes.back();
+
+	if (lastNode == nullptr)
 		{
-		E3ErrorManager_PostError(kQ3ErrorOutOfMemory, kQ3False);
-		return(nullptr);
+		newNode->prev = newNode;
+		newNode->next = newNode;
+		}
+	else
+		{
+		newNode->next        = lastNode->next;
+		newNode->prev        = lastNode;
+		lastNode->next->prev = newNode;
+		lastNode->next       = newNode;
 		}
 
-	// Set it up
-	gluTessProperty(theTess, GLU_TESS_WINDING_RULE,   GLU_TESS_WINDING_ODD);
-	gluTessCallback(theTess, GLU_TESS_BEGIN_DATA,     (_GLUfuncptr) e3tessellate_callback_begin);
-	gluTessCallback(theTess, GLU_TESS_END_DATA,       (_GLUfuncptr) e3tessellate_callback_end);
-	gluTessCallback(theTess, GLU_TESS_EDGE_FLAG_DATA, (_GLUfuncptr) e3tessellate_callback_edge);
-	gluTessCallback(theTess, GLU_TESS_VERTEX_DATA,    (_GLUfuncptr) e3tessellate_callback_vertex);
-	gluTessCallback(theTess, GLU_TESS_ERROR_DATA,     (_GLUfuncptr) e3tessellate_callback_error);
-	gluTessCallback(theTess, GLU_TESS_COMBINE_DATA,   (_GLUfuncptr) e3tessellate_callback_combine);
+	return(newNode);
+}
 
 
 
-	// Set up our state
-	Q3Memory_Clear(&theState, sizeof(theState));
-	theTriMesh = nullptr;
 
 
+//=============================================================================
+//      e3tessellate_remove_node : Unlink a node from its ring.
+//-----------------------------------------------------------------------------
+static void
+e3tessellate_remove_node(E3TessellateNode *theNode)
+{
+	theNode->next->prev = theNode->prev;
+	theNode->prev->next = theNode->next;
+
+	if (theNode->prevZ != nullptr)
+		theNode->prevZ->nextZ = theNode->nextZ;
+
+	if (theNode->nextZ != nullptr)
+		theNode->nextZ->prevZ = theNode->prevZ;
+}
 
-	// Feed the contours into the tessellator
-	gluTessBeginPolygon(theTess, &theState);
-	for (n = 0; n < numContours; n++)
+
+
+
+
+//=============================================================================
+//      e3tessellate_linked_list : Build the ring for a contour.
+//-----------------------------------------------------------------------------
+//		Note :	The ring is counter-clockwise if isCCW is true, and
+//				clockwise otherwise, whatever the order of the contour.
+//-----------------------------------------------------------------------------
+static E3TessellateNode *
+e3tessellate_linked_list(E3TessellateWorkspace &theWorkspace, TQ3Uns32 theContour, bool isCCW)
+{	TQ3Uns32				firstVertex = theWorkspace.contourStart[theContour];
+	TQ3Uns32				numVertices = theWorkspace.contourSize[theContour];
+	const double			*thePoints  = &theWorkspace.projected[2 * firstVertex];
+	E3TessellateNode		*lastNode   = nullptr;
+	double					theArea     = 0.0;
+	TQ3Uns32				n, prev;
+
+
+
+	// Find the orientation of the contour
+	for (n = 0, prev = numVertices - 1; n < numVertices; prev = n++)
+		theArea += (thePoints[2 * prev] - thePoints[2 * n]) * (thePoints[2 * n + 1] + thePoints[2 * prev + 1]);
+
+
+
+	// Link up the nodes in the right order
+	if (isCCW == (theArea > 0.0))
 		{
-         gluTessBeginContour(theTess);
-         for (m = 0; m < theContours[n].numVertices; m++)
-         	{
-         	theVertex     = &theContours[n].vertices[m];
-         	vertCoords[0] = (GLdouble) theVertex->point.x;
-         	vertCoords[1] = (GLdouble) theVertex->point.y;
-         	vertCoords[2] = (GLdouble) theVertex->point.z;
+		for (n = 0; n < numVertices; ++n)
+			lastNode = e3tessellate_insert_node(theWorkspace, firstVertex + n, lastNode);
+		}
+	else
+		{
+		for (n = numVertices; n > 0; --n)
+			lastNode = e3tessellate_insert_node(theWorkspace, firstVertex + n - 1, lastNode);
+		}
 
-			gluTessVertex(theTess, vertCoords, theVertex);
+	if (lastNode != nullptr && e3tessellate_equals(lastNode, lastNode->next))
+		{
+		e3tessellate_remove_node(lastNode);
+		lastNode = lastNode->next;
+		}
+
+	return(lastNode);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_filter_points : Remove duplicate and collinear nodes.
+//-----------------------------------------------------------------------------
+static E3TessellateNode *
+e3tessellate_filter_points(E3TessellateNode *startNode, E3TessellateNode *endNode)
+{	E3TessellateNode		*p;
+	bool					again;
+
+
+
+	if (startNode == nullptr)
+		return(startNode);
+
+	if (endNode == nullptr)
+		endNode = startNode;
+
+	p = startNode;
+	do
+		{
+		again = false;
+
+		if (!p->steiner && (e3tessellate_equals(p, p->next) || e3tessellate_area(p->prev, p, p->next) == 0.0))
+			{
+			e3tessellate_remove_node(p);
+			p = endNode = p->prev;
+			if (p == p->next)
+				break;
+			again = true;
 			}
-		gluTessEndContour(theTess);
+		else
+			p = p->next;
 		}
-	gluTessEndPolygon(theTess);
+	while (again || p != endNode);
 
+	return(endNode);
+}
 
 
-	// Create the TriMesh if all went well
-	if ( (theState.errorState == GL_NO_ERROR) && (theState.numTriMeshVertices > 0) )
-		theTriMesh = e3tessellate_create_trimesh(&theState, theAttributes);
 
 
 
-	// Clean up
-	e3tessellate_dispose_state(&theState);
-	gluDeleteTess(theTess);
-	
-	return(theTriMesh);
+//=============================================================================
+//      e3tessellate_z_order : Position of a point on a z-order curve.
+//-----------------------------------------------------------------------------
+static TQ3Uns32
+e3tessellate_z_order(double x, double y, double minX, double minY, double invSize)
+{
+	// Scale to 15 bits, then interleave the bits of x and y
+	TQ3Uns32 ix = static_cast<TQ3Uns32>((x - minX) * invSize);
+	TQ3Uns32 iy = static_cast<TQ3Uns32>((y - minY) * invSize);
+
+	ix = (ix | (ix << 8)) & 0x00FF00FF;
+	ix = (ix | (ix << 4)) & 0x0F0F0F0F;
+	ix = (ix | (ix << 2)) & 0x33333333;
+	ix = (ix | (ix << 1)) & 0x55555555;
+
+	iy = (iy | (iy << 8)) & 0x00FF00FF;
+	iy = (iy | (iy << 4)) & 0x0F0F0F0F;
+	iy = (iy | (iy << 2)) & 0x33333333;
+	iy = (iy | (iy << 1)) & 0x55555555;
+
+	return(ix | (iy << 1));
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_sort_linked : Sort the z-order links of a ring.
+//-----------------------------------------------------------------------------
+//		Note :	A bottom-up merge sort, which needs no extra storage.
+//-----------------------------------------------------------------------------
+static void
+e3tessellate_sort_linked(E3TessellateNode *theList)
+{	E3TessellateNode		*p, *q, *e, *tail;
+	TQ3Uns32				n, numMerges, pSize, qSize, inSize = 1;
+
+
+
+	do
+		{
+		p         = theList;
+		theList   = nullptr;
+		tail      = nullptr;
+		numMerges = 0;
+
+		while (p != nullptr)
+			{
+			numMerges++;
+			q     = p;
+			pSize = 0;
+			for (n = 0; n < inSize; ++n)
+				{
+				pSize++;
+				q = q->nextZ;
+				if (q == nullptr)
+					break;
+				}
+
+			qSize = inSize;
+
+			while (pSize > 0 || (qSize > 0 && q != nullptr))
+				{
+				if (pSize != 0 && (qSize == 0 || q == nullptr || p->z <= q->z))
+					{
+					e = p;
+					p = p->nextZ;
+					pSize--;
+					}
+				else
+					{
+					e = q;
+					q = q->nextZ;
+					qSize--;
+					}
+
+				if (tail != nullptr)
+					tail->nextZ = e;
+				else
+					theList = e;
+
+				e->prevZ = tail;
+				tail     = e;
+				}
+
+			p = q;
+			}
+
+		tail->nextZ = nullptr;
+		inSize *= 2;
+		}
+	while (numMerges > 1);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_index_curve : Link the nodes of a ring in z-order.
+//-----------------------------------------------------------------------------
+static void
+e3tessellate_index_curve(E3TessellateNode *startNode, double minX, double minY, double invSize)
+{	E3TessellateNode		*p = startNode;
+
+
+
+	do
+		{
+		p->z     = e3tessellate_z_order(p->x, p->y, minX, minY, invSize);
+		p->prevZ = p->prev;
+		p->nextZ = p->next;
+		p        = p->next;
+		}
+	while (p != startNode);
+
+	p->prevZ->nextZ = nullptr;
+	p->prevZ        = nullptr;
+
+	e3tessellate_sort_linked(p);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_is_ear : Can this node be clipped off as an ear?
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_is_ear(const E3TessellateNode *theEar)
+{	const E3TessellateNode	*a = theEar->prev;
+	const E3TessellateNode	*b = theEar;
+	const E3TessellateNode	*c = theEar->next;
+
+
+
+	// Reflex nodes can't be ears
+	if (e3tessellate_area(a, b, c) >= 0.0)
+		return(false);
+
+
+
+	// Make sure no other reflex node lies inside the ear
+	double x0 = E3Num_Min(a->x, E3Num_Min(b->x, c->x));
+	double y0 = E3Num_Min(a->y, E3Num_Min(b->y, c->y));
+	double x1 = E3Num_Max(a->x, E3Num_Max(b->x, c->x));
+	double y1 = E3Num_Max(a->y, E3Num_Max(b->y, c->y));
+
+	for (const E3TessellateNode *p = c->next; p != a; p = p->next)
+		{
+		if (p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 &&
+			e3tessellate_point_in_triangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) &&
+			e3tessellate_area(p->prev, p, p->next) >= 0.0)
+			return(false);
+		}
+
+	return(true);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_blocks_ear : Does a node stop a z-indexed ear?
+//-----------------------------------------------------------------------------
+static inline bool
+e3tessellate_blocks_ear(const E3TessellateNode *p, const E3TessellateNode *a,
+						const E3TessellateNode *b, const E3TessellateNode *c,
+						double x0, double y0, double x1, double y1)
+{
+	return(p != a && p != c &&
+		   p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 &&
+		   e3tessellate_point_in_triangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) &&
+		   e3tessellate_area(p->prev, p, p->next) >= 0.0);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_is_ear_hashed : Ear test using the z-order index.
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_is_ear_hashed(const E3TessellateNode *theEar, double minX, double minY, double invSize)
+{	const E3TessellateNode	*a = theEar->prev;
+	const E3TessellateNode	*b = theEar;
+	const E3TessellateNode	*c = theEar->next;
+
+
+
+	// Reflex nodes can't be ears
+	if (e3tessellate_area(a, b, c) >= 0.0)
+		return(false);
+
+
+
+	// Only nodes within the z-order range of the ear's bounds can be inside it
+	double x0 = E3Num_Min(a->x, E3Num_Min(b->x, c->x));
+	double y0 = E3Num_Min(a->y, E3Num_Min(b->y, c->y));
+	double x1 = E3Num_Max(a->x, E3Num_Max(b->x, c->x));
+	double y1 = E3Num_Max(a->y, E3Num_Max(b->y, c->y));
+
+	TQ3Uns32 minZ = e3tessellate_z_order(x0, y0, minX, minY, invSize);
+	TQ3Uns32 maxZ = e3tessellate_z_order(x1, y1, minX, minY, invSize);
+
+	const E3TessellateNode *p = theEar->prevZ;
+	const E3TessellateNode *n = theEar->nextZ;
+
+	while (p != nullptr && p->z >= minZ && n != nullptr && n->z <= maxZ)
+		{
+		if (e3tessellate_blocks_ear(p, a, b, c, x0, y0, x1, y1))
+			return(false);
+		p = p->prevZ;
+
+		if (e3tessellate_blocks_ear(n, a, b, c, x0, y0, x1, y1))
+			return(false);
+		n = n->nextZ;
+		}
+
+	while (p != nullptr && p->z >= minZ)
+		{
+		if (e3tessellate_blocks_ear(p, a, b, c, x0, y0, x1, y1))
+			return(false);
+		p = p->prevZ;
+		}
+
+	while (n != nullptr && n->z <= maxZ)
+		{
+		if (e3tessellate_blocks_ear(n, a, b, c, x0, y0, x1, y1))
+			return(false);
+		n = n->nextZ;
+		}
+
+	return(true);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_ear_clip : Triangulate a ring by clipping ears.
+//-----------------------------------------------------------------------------
+//		Note :	Returns false if the ring can not be fully triangulated,
+//				which means it crosses itself.
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_ear_clip(E3TessellateWorkspace &theWorkspace, E3TessellateNode *theEar,
+						double minX, double minY, double invSize)
+{	E3TessellateNode		*stopNode, *prevNode, *nextNode;
+	bool					wasFiltered = false;
+
+
+
+	if (theEar == nullptr)
+		return(true);
+
+	if (invSize != 0.0)
+		e3tessellate_index_curve(theEar, minX, minY, invSize);
+
+	stopNode = theEar;
+
+	while (theEar->prev != theEar->next)
+		{
+		prevNode = theEar->prev;
+		nextNode = theEar->next;
+
+		if (invSize != 0.0 ? e3tessellate_is_ear_hashed(theEar, minX, minY, invSize) : e3tessellate_is_ear(theEar))
+			{
+			theWorkspace.triangles.push_back(prevNode->vertexIndex);
+			theWorkspace.triangles.push_back(theEar->vertexIndex);
+			theWorkspace.triangles.push_back(nextNode->vertexIndex);
+
+			e3tessellate_remove_node(theEar);
+
+			// Skipping the next node leaves fewer sliver triangles
+			theEar   = nextNode->next;
+			stopNode = nextNode->next;
+			continue;
+			}
+
+		theEar = nextNode;
+
+
+		// If we went all the way round without finding an ear, drop any
+		// degenerate nodes and try once more
+		if (theEar == stopNode)
+			{
+			if (wasFiltered)
+				return(false);
+
+			theEar      = e3tessellate_filter_points(theEar, nullptr);
+			stopNode    = theEar;
+			wasFiltered = true;
+			}
+		}
+
+	return(true);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_locally_inside : Is a diagonal locally inside the ring?
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_locally_inside(const E3TessellateNode *a, const E3TessellateNode *b)
+{
+	if (e3tessellate_area(a->prev, a, a->next) < 0.0)
+		return(e3tessellate_area(a, b, a->next) >= 0.0 && e3tessellate_area(a, a->prev, b) >= 0.0);
+
+	return(e3tessellate_area(a, b, a->prev) < 0.0 || e3tessellate_area(a, a->next, b) < 0.0);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_sector_contains_sector : Compare two bridge candidates.
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_sector_contains_sector(const E3TessellateNode *m, const E3TessellateNode *p)
+{
+	return(e3tessellate_area(m->prev, m, p->prev) < 0.0 && e3tessellate_area(p->next, m, m->next) < 0.0);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_find_hole_bridge : Find where a hole can join its outer.
+//-----------------------------------------------------------------------------
+//		Note :	theHole is the leftmost node of the hole. Returns the outer
+//				node to bridge to, or nullptr if none was found.
+//-----------------------------------------------------------------------------
+static E3TessellateNode *
+e3tessellate_find_hole_bridge(const E3TessellateNode *theHole, E3TessellateNode *outerNode)
+{	E3TessellateNode		*p = outerNode, *m = nullptr;
+	double					hx = theHole->x, hy = theHole->y;
+	double					qx = -DBL_MAX;
+
+
+
+	// Find the nearest outer edge crossed by a ray to the left of the hole;
+	// its endpoint with the lesser x is a candidate for the bridge
+	do
+		{
+		if (hy <= p->y && hy >= p->next->y && p->next->y != p->y)
+			{
+			double x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+			if (x <= hx && x > qx)
+				{
+				qx = x;
+				m  = (p->x < p->next->x) ? p : p->next;
+				if (x == hx)
+					return(m);
+				}
+			}
+		p = p->next;
+		}
+	while (p != outerNode);
+
+	if (m == nullptr)
+		return(nullptr);
+
+
+
+	// If any node lies within the triangle of the hole point, the crossing
+	// and the candidate, the bridge would cross the outer; use the node
+	// making the smallest angle with the ray instead
+	const E3TessellateNode	*stopNode = m;
+	double					mx = m->x, my = m->y;
+	double					tanMin = DBL_MAX;
+
+	p = m;
+	do
+		{
+		if (hx >= p->x && p->x >= mx && hx != p->x &&
+			e3tessellate_point_in_triangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y))
+			{
+			double theTan = std::fabs(hy - p->y) / (hx - p->x);
+
+			if (e3tessellate_locally_inside(p, theHole) &&
+				(theTan < tanMin || (theTan == tanMin && (p->x > m->x ||
+					(p->x == m->x && e3tessellate_sector_contains_sector(m, p))))))
+				{
+				m      = p;
+				tanMin = theTan;
+				}
+			}
+		p = p->next;
+		}
+	while (p != stopNode);
+
+	return(m);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_split_polygon : Join two nodes with a two-way bridge.
+//-----------------------------------------------------------------------------
+//		Note :	Returns the copy of b, on the far side of the bridge.
+//-----------------------------------------------------------------------------
+static E3TessellateNode *
+e3tessellate_split_polygon(E3TessellateWorkspace &theWorkspace, E3TessellateNode *a, E3TessellateNode *b)
+{
+	E3TessellateNode *a2 = e3tessellate_insert_node(theWorkspace, a->vertexIndex, nullptr);
+	E3TessellateNode *b2 = e3tessellate_insert_node(theWorkspace, b->vertexIndex, nullptr);
+	E3TessellateNode *an = a->next;
+	E3TessellateNode *bp = b->prev;
+
+	a->next  = b;
+	b->prev  = a;
+
+	a2->next = an;
+	an->prev = a2;
+
+	b2->next = a2;
+	a2->prev = b2;
+
+	bp->next = b2;
+	b2->prev = bp;
+
+	return(b2);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_get_leftmost : Find the leftmost node of a ring.
+//-----------------------------------------------------------------------------
+static E3TessellateNode *
+e3tessellate_get_leftmost(E3TessellateNode *startNode)
+{	E3TessellateNode		*p = startNode, *leftmost = startNode;
+
+
+
+	do
+		{
+		if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y))
+			leftmost = p;
+		p = p->next;
+		}
+	while (p != startNode);
+
+	return(leftmost);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_eliminate_holes : Bridge each hole into its outer ring.
+//-----------------------------------------------------------------------------
+//		Note :	The holes are the leftmost nodes in theWorkspace.holes.
+//				Returns the joined ring, or nullptr if a hole could not be
+//				bridged.
+//-----------------------------------------------------------------------------
+static E3TessellateNode *
+e3tessellate_eliminate_holes(E3TessellateWorkspace &theWorkspace, E3TessellateNode *outerNode)
+{
+	// Bridge holes from left to right, so that each bridge can only cross
+	// holes which have already been joined to the outer ring
+	std::sort(theWorkspace.holes.begin(), theWorkspace.holes.end(),
+		[]( const E3TessellateNode* a, const E3TessellateNode* b )
+		{
+			return (a->x < b->x) || (a->x == b->x && a->y < b->y);
+		} );
+
+	for (size_t n = 0; n < theWorkspace.holes.size(); ++n)
+		{
+		E3TessellateNode *theHole = theWorkspace.holes[n];
+		E3TessellateNode *theBridge = e3tessellate_find_hole_bridge(theHole, outerNode);
+		if (theBridge == nullptr)
+			return(nullptr);
+
+		E3TessellateNode *bridgeReverse = e3tessellate_split_polygon(theWorkspace, theBridge, theHole);
+
+		// Filter collinear points around the cuts
+		e3tessellate_filter_points(bridgeReverse, bridgeReverse->next);
+		outerNode = e3tessellate_filter_points(theBridge, theBridge->next);
+		}
+
+	return(outerNode);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_project : Project the contours onto a plane.
+//-----------------------------------------------------------------------------
+//		Note :	The plane is chosen from the largest contour, and that
+//				contour is counter-clockwise in the projection, so triangles
+//				which are counter-clockwise in the projection keep its
+//				winding.  Returns false if the contours have no area.
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_project(E3TessellateWorkspace &theWorkspace)
+{	TQ3Vector3D				theNormal = { 0.0f, 0.0f, 0.0f };
+	float					bestLength = 0.0f;
+	TQ3Uns32				c, n;
+
+
+
+	// Find the normal of the largest contour
+	for (c = 0; c < theWorkspace.contourStart.size(); ++c)
+		{
+		TQ3Uns32		firstVertex = theWorkspace.contourStart[c];
+		TQ3Uns32		numVertices = theWorkspace.contourSize[c];
+		TQ3Vector3D		contourNormal = { 0.0f, 0.0f, 0.0f };
+
+		for (n = 0; n < numVertices; ++n)
+			{
+			const TQ3Point3D& thisPoint = theWorkspace.vertices[firstVertex + n]->point;
+			const TQ3Point3D& nextPoint = theWorkspace.vertices[firstVertex + (n + 1) % numVertices]->point;
+
+			contourNormal.x += (thisPoint.y - nextPoint.y) * (thisPoint.z + nextPoint.z);
+			contourNormal.y += (thisPoint.z - nextPoint.z) * (thisPoint.x + nextPoint.x);
+			contourNormal.z += (thisPoint.x - nextPoint.x) * (thisPoint.y + nextPoint.y);
+			}
+
+		float theLength = Q3FastVector3D_LengthSquared(&contourNormal);
+		if (theLength > bestLength)
+			{
+			bestLength = theLength;
+			theNormal  = contourNormal;
+			}
+		}
+
+	if (bestLength == 0.0f)
+		return(false);
+
+
+
+	// Drop the dominant axis, ordering the others to keep the winding
+	float absX = E3Float_Abs(theNormal.x);
+	float absY = E3Float_Abs(theNormal.y);
+	float absZ = E3Float_Abs(theNormal.z);
+	TQ3Uns32 numVertices = static_cast<TQ3Uns32>(theWorkspace.vertices.size());
+
+	theWorkspace.projected.resize(2 * numVertices);
+
+	for (n = 0; n < numVertices; ++n)
+		{
+		const TQ3Point3D& thePoint = theWorkspace.vertices[n]->point;
+		double *projPoint = &theWorkspace.projected[2 * n];
+
+		if (absX >= absY && absX >= absZ)
+			{
+			projPoint[0] = (theNormal.x > 0.0f) ? thePoint.y : thePoint.z;
+			projPoint[1] = (theNormal.x > 0.0f) ? thePoint.z : thePoint.y;
+			}
+		else if (absY >= absZ)
+			{
+			projPoint[0] = (theNormal.y > 0.0f) ? thePoint.z : thePoint.x;
+			projPoint[1] = (theNormal.y > 0.0f) ? thePoint.x : thePoint.z;
+			}
+		else
+			{
+			projPoint[0] = (theNormal.z > 0.0f) ? thePoint.x : thePoint.y;
+			projPoint[1] = (theNormal.z > 0.0f) ? thePoint.y : thePoint.x;
+			}
+		}
+
+	return(true);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_is_convex : Is a single projected contour convex?
+//-----------------------------------------------------------------------------
+//		Note :	As well as turning left at every vertex, the contour must
+//				wind around only once, which rules out star shapes.
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_is_convex(const E3TessellateWorkspace &theWorkspace)
+{	TQ3Uns32				numPoints = theWorkspace.contourSize[0];
+	const double			*thePoints = &theWorkspace.projected[0];
+	TQ3Uns32				numFlips = 0;
+	double					firstDX = 0.0, lastDX = 0.0;
+	TQ3Uns32				n;
+
+
+
+	for (n = 0; n < numPoints; ++n)
+		{
+		const double *p0 = &thePoints[2 * n];
+		const double *p1 = &thePoints[2 * ((n + 1) % numPoints)];
+		const double *p2 = &thePoints[2 * ((n + 2) % numPoints)];
+
+		double theTurn = (p1[0] - p0[0]) * (p2[1] - p1[1]) - (p1[1] - p0[1]) * (p2[0] - p1[0]);
+		if (theTurn < 0.0)
+			return(false);
+
+		double theDX = p1[0] - p0[0];
+		if (theDX != 0.0)
+			{
+			if (lastDX == 0.0)
+				firstDX = theDX;
+			else if ((theDX > 0.0) != (lastDX > 0.0))
+				++numFlips;
+
+			lastDX = theDX;
+			}
+		}
+
+	if (lastDX != 0.0 && (firstDX > 0.0) != (lastDX > 0.0))
+		++numFlips;
+
+	return(numFlips <= 2);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_contours_cross : Do any two contour edges cross?
+//-----------------------------------------------------------------------------
+//		Note :	Sweeps across the edges in order of their leftmost x,
+//				testing each edge against those whose x ranges overlap it.
+//				Edges which only touch are allowed, since ear clipping copes
+//				with them; edges which cross or overlap are not.
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_contours_cross(E3TessellateWorkspace &theWorkspace)
+{	const double			*thePoints  = &theWorkspace.projected[0];
+	TQ3Uns32				numEdges    = static_cast<TQ3Uns32>(theWorkspace.vertices.size());
+	std::vector<TQ3Uns32>	&theOrder   = theWorkspace.sweepOrder;
+	std::vector<TQ3Uns32>	&theActive  = theWorkspace.sweepActive;
+	TQ3Uns32				n, m;
+
+
+
+	// Edge n runs from vertex n to the next vertex on its contour
+	theOrder.resize(numEdges);
+	for (n = 0; n < numEdges; ++n)
+		theOrder[n] = n;
+
+	std::sort(theOrder.begin(), theOrder.end(),
+		[thePoints, &theWorkspace]( TQ3Uns32 a, TQ3Uns32 b )
+		{
+			double minA = E3Num_Min(thePoints[2 * a], thePoints[2 * theWorkspace.nextVertex[a]]);
+			double minB = E3Num_Min(thePoints[2 * b], thePoints[2 * theWorkspace.nextVertex[b]]);
+			return minA < minB;
+		} );
+
+	theActive.clear();
+
+	for (n = 0; n < numEdges; ++n)
+		{
+		TQ3Uns32		edgeA = theOrder[n];
+		TQ3Uns32		endA  = theWorkspace.nextVertex[edgeA];
+		const double	*a0   = &thePoints[2 * edgeA];
+		const double	*a1   = &thePoints[2 * endA];
+		double			minX  = E3Num_Min(a0[0], a1[0]);
+
+		for (m = 0; m < theActive.size(); )
+			{
+			TQ3Uns32		edgeB = theActive[m];
+			TQ3Uns32		endB  = theWorkspace.nextVertex[edgeB];
+			const double	*b0   = &thePoints[2 * edgeB];
+			const double	*b1   = &thePoints[2 * endB];
+
+
+			// Retire edges which end before this one starts
+			if (E3Num_Max(b0[0], b1[0]) < minX)
+				{
+				theActive[m] = theActive.back();
+				theActive.pop_back();
+				continue;
+				}
+			++m;
+
+
+			// Neighbouring edges share a vertex
+			if (endA == edgeB || endB == edgeA)
+				continue;
+
+			double o1 = (a1[0] - a0[0]) * (b0[1] - a0[1]) - (a1[1] - a0[1]) * (b0[0] - a0[0]);
+			double o2 = (a1[0] - a0[0]) * (b1[1] - a0[1]) - (a1[1] - a0[1]) * (b1[0] - a0[0]);
+			double o3 = (b1[0] - b0[0]) * (a0[1] - b0[1]) - (b1[1] - b0[1]) * (a0[0] - b0[0]);
+			double o4 = (b1[0] - b0[0]) * (a1[1] - b0[1]) - (b1[1] - b0[1]) * (a1[0] - b0[0]);
+
+			if (((o1 > 0.0 && o2 < 0.0) || (o1 < 0.0 && o2 > 0.0)) &&
+				((o3 > 0.0 && o4 < 0.0) || (o3 < 0.0 && o4 > 0.0)))
+				return(true);
+
+
+			// Collinear edges may overlap along their length
+			if (o1 == 0.0 && o2 == 0.0)
+				{
+				int		axis = (a0[0] != a1[0]) ? 0 : 1;
+				double	aMin = E3Num_Min(a0[axis], a1[axis]), aMax = E3Num_Max(a0[axis], a1[axis]);
+				double	bMin = E3Num_Min(b0[axis], b1[axis]), bMax = E3Num_Max(b0[axis], b1[axis]);
+
+				if (E3Num_Min(aMax, bMax) > E3Num_Max(aMin, bMin))
+					return(true);
+				}
+			}
+
+		theActive.push_back(edgeA);
+		}
+
+	return(false);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_contour_contains : Is a point inside a projected contour?
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_contour_contains(const E3TessellateWorkspace &theWorkspace, TQ3Uns32 theContour,
+								double px, double py)
+{	TQ3Uns32				firstVertex = theWorkspace.contourStart[theContour];
+	TQ3Uns32				numVertices = theWorkspace.contourSize[theContour];
+	const double			*thePoints  = &theWorkspace.projected[2 * firstVertex];
+	bool					isInside    = false;
+	TQ3Uns32				n, prev;
+
+
+
+	for (n = 0, prev = numVertices - 1; n < numVertices; prev = n++)
+		{
+		double xi = thePoints[2 * n],    yi = thePoints[2 * n + 1];
+		double xj = thePoints[2 * prev], yj = thePoints[2 * prev + 1];
+
+		if (((yi > py) != (yj > py)) && (px < (xj - xi) * (py - yi) / (yj - yi) + xi))
+			isInside = !isInside;
+		}
+
+	return(isInside);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_native_triangles : Triangulate with the native tessellator.
+//-----------------------------------------------------------------------------
+//		Note :	Fills theWorkspace.triangles, and returns false if the
+//				contours must be left to the GLU tessellator.
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_native_triangles(E3TessellateWorkspace &theWorkspace)
+{	TQ3Uns32				numContours = static_cast<TQ3Uns32>(theWorkspace.contourStart.size());
+	TQ3Uns32				numVertices = static_cast<TQ3Uns32>(theWorkspace.vertices.size());
+	TQ3Uns32				c, h, n;
+
+
+
+	// Convex contours are just a fan
+	if (numContours == 1 && e3tessellate_is_convex(theWorkspace))
+		{
+		for (n = 1; n + 1 < numVertices; ++n)
+			{
+			theWorkspace.triangles.push_back(0);
+			theWorkspace.triangles.push_back(n);
+			theWorkspace.triangles.push_back(n + 1);
+			}
+		return(true);
+		}
+
+
+
+	// Anything else can only be ear clipped if no edges cross
+	if (e3tessellate_contours_cross(theWorkspace))
+		return(false);
+
+
+
+	// Find how deeply each contour is nested. Under the odd winding rule,
+	// contours at an even depth bound filled regions, and contours at an
+	// odd depth are holes in the contour which immediately encloses them.
+	theWorkspace.contourDepth.assign(numContours, 0);
+	
+	for (c = 0; c < numContours; ++c)
+		{
+		const double *testPoint = &theWorkspace.projected[2 * theWorkspace.contourStart[c]];
+		
+		for (h = 0; h < numContours; ++h)
+			{
+			if (h != c && e3tessellate_contour_contains(theWorkspace, h, testPoint[0], testPoint[1]))
+				theWorkspace.contourDepth[c]++;
+			}
+		}
+
+
+
+	// Ear clip each filled region, with its holes
+	theWorkspace.nodes.clear();
+	theWorkspace.nodes.reserve(numVertices + 2 * numContours);
+
+	for (c = 0; c < numContours; ++c)
+		{
+		if ((theWorkspace.contourDepth[c] & 1) != 0)
+			continue;
+
+		E3TessellateNode *outerNode = e3tessellate_linked_list(theWorkspace, c, true);
+		if (outerNode == nullptr || outerNode->next == outerNode->prev)
+			continue;
+
+
+		// Collect the holes whose enclosing contour is this one
+		theWorkspace.holes.clear();
+		
+		for (h = 0; h < numContours; ++h)
+			{
+			if (theWorkspace.contourDepth[h] != theWorkspace.contourDepth[c] + 1)
+				continue;
+
+			const double *testPoint = &theWorkspace.projected[2 * theWorkspace.contourStart[h]];
+			if (!e3tessellate_contour_contains(theWorkspace, c, testPoint[0], testPoint[1]))
+				continue;
+
+			E3TessellateNode *holeNode = e3tessellate_linked_list(theWorkspace, h, false);
+			if (holeNode == nullptr)
+				continue;
+
+			if (holeNode == holeNode->next)
+				holeNode->steiner = true;
+
+			theWorkspace.holes.push_back(e3tessellate_get_leftmost(holeNode));
+			}
+
+		if (!theWorkspace.holes.empty())
+			{
+			outerNode = e3tessellate_eliminate_holes(theWorkspace, outerNode);
+			if (outerNode == nullptr)
+				return(false);
+			}
+
+
+		// Index large regions by z-order, so ear tests stay local
+		double minX = 0.0, minY = 0.0, invSize = 0.0;
+		
+		if (theWorkspace.contourSize[c] > 80 || !theWorkspace.holes.empty())
+			{
+			double maxX, maxY;
+			
+			minX = maxX = outerNode->x;
+			minY = maxY = outerNode->y;
+			
+			for (E3TessellateNode *p = outerNode->next; p != outerNode; p = p->next)
+				{
+				minX = E3Num_Min(minX, p->x);
+				minY = E3Num_Min(minY, p->y);
+				maxX = E3Num_Max(maxX, p->x);
+				maxY = E3Num_Max(maxY, p->y);
+				}
+			
+			invSize = E3Num_Max(maxX - minX, maxY - minY);
+			invSize = (invSize != 0.0) ? (32767.0 / invSize) : 0.0;
+			}
+
+		if (!e3tessellate_ear_clip(theWorkspace, outerNode, minX, minY, invSize))
+			return(false);
+		}
+
+	return(true);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_native : Tessellate contours without GLU.
+//-----------------------------------------------------------------------------
+//		Note :	Fills theState as the GLU callbacks would, and returns
+//				kQ3Failure if the contours must be left to GLU.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3tessellate_native(TQ3Uns32 numContours,
+		const TQ3GeneralPolygonContourData *theContours,
+		E3TessellateState *theState)
+{	E3TessellateWorkspace	&theWorkspace = e3tessellate_workspace();
+	TQ3Uns32				c, n, m;
+
+
+
+	// Gather the vertices, skipping contours which can't enclose anything
+	theWorkspace.vertices.clear();
+	theWorkspace.nextVertex.clear();
+	theWorkspace.contourStart.clear();
+	theWorkspace.contourSize.clear();
+	theWorkspace.triangles.clear();
+
+	for (c = 0; c < numContours; ++c)
+		{
+		TQ3Uns32 numVertices = theContours[c].numVertices;
+		if (numVertices < 3)
+			continue;
+
+		TQ3Uns32 firstVertex = static_cast<TQ3Uns32>(theWorkspace.vertices.size());
+		theWorkspace.contourStart.push_back(firstVertex);
+		theWorkspace.contourSize.push_back(numVertices);
+
+		for (n = 0; n < numVertices; ++n)
+			{
+			theWorkspace.vertices.push_back(&theContours[c].vertices[n]);
+			theWorkspace.nextVertex.push_back(firstVertex + (n + 1) % numVertices);
+			}
+		}
+
+	if (theWorkspace.contourStart.empty() || !e3tessellate_project(theWorkspace))
+		return(kQ3Failure);
+
+
+
+	// Triangulate
+	if (!e3tessellate_native_triangles(theWorkspace) || theWorkspace.triangles.empty())
+		return(kQ3Failure);
+
+
+
+	// Number the vertices which were used
+	TQ3Uns32 numVertices  = static_cast<TQ3Uns32>(theWorkspace.vertices.size());
+	TQ3Uns32 numTriangles = static_cast<TQ3Uns32>(theWorkspace.triangles.size() / 3);
+	TQ3Uns32 numUsed      = 0;
+	TQ3Uns32 numEdges     = 0;
+
+	theWorkspace.vertexRemap.assign(numVertices, kQ3ArrayIndexNULL);
+
+	for (n = 0; n < 3 * numTriangles; ++n)
+		{
+		TQ3Uns32 theVertex = theWorkspace.triangles[n];
+		if (theWorkspace.vertexRemap[theVertex] == kQ3ArrayIndexNULL)
+			theWorkspace.vertexRemap[theVertex] = numUsed++;
+		}
+
+
+
+	// Triangle sides which join neighbours on a contour are boundary edges
+	for (n = 0; n < numTriangles; ++n)
+		{
+		for (m = 0; m < 3; ++m)
+			{
+			TQ3Uns32 v0 = theWorkspace.triangles[3 * n + m];
+			TQ3Uns32 v1 = theWorkspace.triangles[3 * n + (m + 1) % 3];
+			
+			if (theWorkspace.nextVertex[v0] == v1 || theWorkspace.nextVertex[v1] == v0)
+				numEdges++;
+			}
+		}
+
+
+
+	// Fill in the state
+	theState->triMeshVertexList     = (TQ3Vertex3D **)            Q3Memory_Allocate(static_cast<TQ3Uns32>(numUsed      * sizeof(TQ3Vertex3D*)));
+	theState->triMeshData.triangles = (TQ3TriMeshTriangleData *) Q3Memory_Allocate(static_cast<TQ3Uns32>(numTriangles * sizeof(TQ3TriMeshTriangleData)));
+	theState->triMeshData.edges     = (numEdges == 0) ? nullptr :
+									  (TQ3TriMeshEdgeData *)     Q3Memory_Allocate(static_cast<TQ3Uns32>(numEdges     * sizeof(TQ3TriMeshEdgeData)));
+
+	if (theState->triMeshVertexList == nullptr || theState->triMeshData.triangles == nullptr ||
+		(numEdges != 0 && theState->triMeshData.edges == nullptr))
+		return(kQ3Failure);
+
+	for (n = 0; n < numVertices; ++n)
+		{
+		if (theWorkspace.vertexRemap[n] != kQ3ArrayIndexNULL)
+			theState->triMeshVertexList[theWorkspace.vertexRemap[n]] = const_cast<TQ3Vertex3D*>(theWorkspace.vertices[n]);
+		}
+
+	for (n = 0; n < numTriangles; ++n)
+		{
+		TQ3TriMeshTriangleData& theTriangle = theState->triMeshData.triangles[n];
+		
+		for (m = 0; m < 3; ++m)
+			{
+			TQ3Uns32 v0 = theWorkspace.triangles[3 * n + m];
+			TQ3Uns32 v1 = theWorkspace.triangles[3 * n + (m + 1) % 3];
+			
+			theTriangle.pointIndices[m] = theWorkspace.vertexRemap[v0];
+			
+			if (theWorkspace.nextVertex[v0] == v1 || theWorkspace.nextVertex[v1] == v0)
+				{
+				TQ3TriMeshEdgeData& theEdge = theState->triMeshData.edges[theState->triMeshData.numEdges++];
+				
+				theEdge.pointIndices[0]    = theWorkspace.vertexRemap[v0];
+				theEdge.pointIndices[1]    = theWorkspace.vertexRemap[v1];
+				theEdge.triangleIndices[0] = n;
+				theEdge.triangleIndices[1] = kQ3ArrayIndexNULL;
+				}
+			}
+		}
+
+	theState->numTriMeshVertices       = numUsed;
+	theState->triMeshData.numTriangles = numTriangles;
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_glu : Get this thread's GLU tessellator.
+//-----------------------------------------------------------------------------
+//		Note :	The tessellator is created and set up on first use, then
+//				kept for the life of the thread.
+//-----------------------------------------------------------------------------
+static GLUtriangulatorObj *
+e3tessellate_glu(void)
+{	static thread_local E3GLUTessellator	tGLU;
+	GLUtriangulatorObj						*theTess;
+
+
+
+	// Return the existing tessellator
+	if (tGLU.tess != nullptr)
+		return(tGLU.tess);
+
+
+
+	// Create the tessellator
+	theTess = gluNewTess();
+	if (theTess == nullptr)
+		{
+		E3ErrorManager_PostError(kQ3ErrorOutOfMemory, kQ3False);
+		return(nullptr);
+		}
+
+	// Set it up
+	gluTessProperty(theTess, GLU_TESS_WINDING_RULE,   GLU_TESS_WINDING_ODD);
+	gluTessCallback(theTess, GLU_TESS_BEGIN_DATA,     (_GLUfuncptr) e3tessellate_callback_begin);
+	gluTessCallback(theTess, GLU_TESS_END_DATA,       (_GLUfuncptr) e3tessellate_callback_end);
+	gluTessCallback(theTess, GLU_TESS_EDGE_FLAG_DATA, (_GLUfuncptr) e3tessellate_callback_edge);
+	gluTessCallback(theTess, GLU_TESS_VERTEX_DATA,    (_GLUfuncptr) e3tessellate_callback_vertex);
+	gluTessCallback(theTess, GLU_TESS_ERROR_DATA,     (_GLUfuncptr) e3tessellate_callback_error);
+	gluTessCallback(theTess, GLU_TESS_COMBINE_DATA,   (_GLUfuncptr) e3tessellate_callback_combine);
+
+	tGLU.tess = theTess;
+
+	return(theTess);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_run : Run the tessellator over a set of contours.
+//-----------------------------------------------------------------------------
+//		Note :	On success the triangles are left in theState, indexing its
+//				triMeshVertexList. The caller must dispose of theState.
+//
+//				The native tessellator is tried first, with GLU used for
+//				contours it can't handle.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3tessellate_run(TQ3Uns32 numContours,
+		const TQ3GeneralPolygonContourData *theContours,
+		E3TessellateState *theState)
+{	GLdouble				vertCoords[3];
+	TQ3Vertex3D				*theVertex;
+	GLUtriangulatorObj		*theTess;
+	TQ3Uns32				n, m;
+
+
+
+	// Set up our state
+	Q3Memory_Clear(theState, sizeof(E3TessellateState));
+
+
+
+	// Try the native tessellator
+	if (e3tessellate_native(numContours, theContours, theState) == kQ3Success)
+		return(kQ3Success);
+
+	e3tessellate_dispose_state(theState);
+	Q3Memory_Clear(theState, sizeof(E3TessellateState));
+
+
+
+	// Get the GLU tessellator
+	theTess = e3tessellate_glu();
+	if (theTess == nullptr)
+		return(kQ3Failure);
+
+
+
+	// Feed the contours into the tessellator
+	gluTessBeginPolygon(theTess, theState);
+	for (n = 0; n < numContours; n++)
+		{
+         gluTessBeginContour(theTess);
+         for (m = 0; m < theContours[n].numVertices; m++)
+         	{
+         	theVertex     = &theContours[n].vertices[m];
+         	vertCoords[0] = (GLdouble) theVertex->point.x;
+         	vertCoords[1] = (GLdouble) theVertex->point.y;
+         	vertCoords[2] = (GLdouble) theVertex->point.z;
+
+			gluTessVertex(theTess, vertCoords, theVertex);
+			}
+		gluTessEndContour(theTess);
+		}
+	gluTessEndPolygon(theTess);
+
+
+
+	// Report whether all went well
+	if ( (theState->errorState != GL_NO_ERROR) || (theState->numTriMeshVertices == 0) )
+		return(kQ3Failure);
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      Public functions
+//-----------------------------------------------------------------------------
+//      E3Tessellate_Contours : Tessellate a list of contours into one TriMesh.
+//-----------------------------------------------------------------------------
+//		Note :	Contours form a planar polygon, with each contour defined by
+//				one or more lists of vertices. Contours may be concave or
+//				convex, and may be nested and overlapping.
+//
+//				Overlapping contours form holes, with the even-odd rule used to
+//				determine which portion of the polygon is to be removed.
+//-----------------------------------------------------------------------------
+TQ3Object
+E3Tessellate_Contours(TQ3Uns32 numContours,
+		const TQ3GeneralPolygonContourData *theContours,
+		TQ3AttributeSet theAttributes )
+{
+	// Validate our parameters
+	Q3_REQUIRE_OR_RESULT(numContours >= 1,          nullptr);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(theContours), nullptr);
+
+	E3TessellateState		theState;
+	TQ3GeometryObject		theTriMesh = nullptr;
+
+
+
+	// Tessellate, and create the TriMesh if all went well
+	if (e3tessellate_run(numContours, theContours, &theState) == kQ3Success)
+		theTriMesh = e3tessellate_create_trimesh(&theState, theAttributes);
+
+
+
+	// Clean up
+	e3tessellate_dispose_state(&theState);
+	
+	return(theTriMesh);
+}
+
+
+
+
+
+//=============================================================================
+//      E3Tessellate_ContoursToTriangles : Tessellate contours into triangles.
+//-----------------------------------------------------------------------------
+//		Note :	Contours are interpreted as for E3Tessellate_Contours, but
+//				rather than building a TriMesh the triangles are passed to
+//				theProc in turn.
+//
+//				Each triangle vertex is either one of the vertices in
+//				theContours, or a vertex created where contours intersect.
+//				Created vertices, and their attribute sets, are only valid
+//				until this function returns; callers that need to keep them
+//				must copy the point and take a reference to the set.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Tessellate_ContoursToTriangles(TQ3Uns32 numContours,
+		const TQ3GeneralPolygonContourData *theContours,
+		E3TessellateTriangleProc theProc,
+		void *userData )
+{
+	// Validate our parameters
+	Q3_REQUIRE_OR_RESULT(numContours >= 1,          kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(theContours), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(theProc),     kQ3Failure);
+
+	E3TessellateState		theState;
+	const TQ3Vertex3D		*theVertices[3];
+	TQ3Uns32				n, m;
+
+
+
+	// Tessellate, and pass back the triangles if all went well
+	TQ3Status qd3dStatus = e3tessellate_run(numContours, theContours, &theState);
+	
+	if (qd3dStatus == kQ3Success)
+		{
+		for (n = 0; n < theState.triMeshData.numTriangles; n++)
+			{
+			for (m = 0; m < 3; m++)
+				theVertices[m] = theState.triMeshVertexList[ theState.triMeshData.triangles[n].pointIndices[m] ];
+			
+			theProc(userData, theVertices);
+			}
+		}
+
+
+
+	// Clean up
+	e3tessellate_dispose_state(&theState);
+	
+	return(qd3dStatus);
 }
@@ -62,6 +62,18 @@ extern "C" {
 
 
 
+//=============================================================================
+//      Types
+//-----------------------------------------------------------------------------
+// Receives the three vertices of each triangle from E3Tessellate_ContoursToTriangles
+typedef void (*E3TessellateTriangleProc)(
+				void * _Nullable userData,
+				const TQ3Vertex3D * _Nonnull const * _Nonnull theVertices );
+
+
+
+
+
 //=============================================================================
 //      Function prototypes
 //-----------------------------------------------------------------------------
@@ -70,6 +82,12 @@ TQ3Object _Nullable	E3Tessellate_Contours(
 				const TQ3GeneralPolygonContourData * _Nonnull theContours,
 				TQ3AttributeSet _Nullable theAttributes );
 
+TQ3Status			E3Tessellate_ContoursToTriangles(
+				TQ3Uns32 numContours,
+				const TQ3GeneralPolygonContourData * _Nonnull theContours,
+				E3TessellateTriangleProc _Nonnull theProc,
+				void * _Nullable userData );
+
 
 
 
@@ -51,6 +51,23 @@
 #include "E3Renderer.h"
 #include "E3Style.h"
 #include "E3Main.h"
+#include "E3Math.h"
+#include "E3Pick.h"
+#include "E3FastArray.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+
+
+
+
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+// Number of per-type counts remembered between group edits
+const TQ3Uns32 kGroupCountMemoSize							= 4;
 
 
 
@@ -59,7 +76,64 @@
 //=============================================================================
 //      Internal types
 //-----------------------------------------------------------------------------
+// Contiguous snapshot of a group's members.
+//
+// Walking the position list touches one heap node per member, and the generic
+// iterate methods add a virtual call and a GetPositionObject for each one.
+// The snapshot lets submission and counting walk a flat array instead. It is
+// rebuilt lazily after the group is edited, but never while a submit is
+// walking it, so that the array stays valid for the duration of the walk.
+struct E3GroupChildCache
+{
+	E3FastArray<TQ3Object>		children;
+	TQ3Boolean					childrenValid;
+	TQ3Uns32					editStamp;
+	TQ3Uns32					submitDepth;
+	
+	TQ3Uns32					numCounts;
+	TQ3Uns32					nextCountSlot;
+	TQ3ObjectType				countTypes[ kGroupCountMemoSize ];
+	TQ3Uns32					countValues[ kGroupCountMemoSize ];
+	
+	// Members registered in sBoundsWatchers, see E3Group::WatchBounds
+	E3FastArray<TQ3Object>		boundsMembers;
+	TQ3Boolean					boundsWatched;
+	
+	// Set once an edit has been passed up to the groups above, and cleared
+	// when a bounds computation next reaches the group
+	TQ3Boolean					boundsStale;
 	
+								E3GroupChildCache()
+									: childrenValid( kQ3False )
+									, editStamp( 0 )
+									, submitDepth( 0 )
+									, numCounts( 0 )
+									, nextCountSlot( 0 )
+									, boundsWatched( kQ3False )
+									, boundsStale( kQ3False ) {}
+};
+	
+
+
+//=============================================================================
+//      Internal globals
+//-----------------------------------------------------------------------------
+// Groups whose bounds depend on each object.  A display group's automatic
+// bounds register the group with its members, and any group traversed while
+// computing them does the same, so an edit can be passed up to every display
+// group above the edited object.
+//
+// The map is shared by every group, whichever thread uses it, so it is only
+// touched with sBoundsWatchersLock held.  The lock is recursive because
+// passing an edit up the scene takes it again at each level.
+static std::unordered_multimap<TQ3Object, E3Group*>	sBoundsWatchers;
+static std::recursive_mutex							sBoundsWatchersLock;
+
+// Views currently computing automatic bounds on this thread, innermost last
+static thread_local std::vector<TQ3ViewObject>		sAutoBoundsViews;
+
+
+
 
 
 class E3LightGroup : public E3Group // This is a leaf class so no other classes use this,
@@ -197,6 +271,7 @@ e3group_new(TQ3Object theObject, void *privateData, const void *paramData)
 	instanceData->groupData.listHead.prev        = &instanceData->groupData.listHead;
 	instanceData->groupData.listHead.object      = theObject; // points to itself but never used
 	instanceData->groupData.groupPositionSize    = sizeof( TQ3GroupPosition );
+	instanceData->groupData.childCache           = nullptr;
 
 	return kQ3Success ;
 	}
@@ -217,12 +292,258 @@ e3group_delete(TQ3Object theObject, void *privateData)
 
 	// Empty the group
 	Q3Group_EmptyObjects(theObject);
+	
+	( (E3Group*) theObject )->DisposeChildCache();
 }
 
 
 
 
 
+//=============================================================================
+//      e3group_is_auto_bounds_view : Is a view computing automatic bounds?
+//-----------------------------------------------------------------------------
+static bool
+e3group_is_auto_bounds_view ( TQ3ViewObject theView )
+	{
+	return ( ! sAutoBoundsViews.empty () ) && ( sAutoBoundsViews.back () == theView ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3group_bounds_changed : Note that the bounds of a group are stale.
+//-----------------------------------------------------------------------------
+//		Note :	Drops the automatic bounds of the group, then of every display
+//				group above it.  Only the ancestors are visited, so the cost
+//				of an edit depends on the depth of the scene, not its size.
+//
+//				A group that has already passed an edit up, and has not been
+//				reached by a bounds computation since, is skipped, along with
+//				the groups above it.  Whether its automatic bounds are valid
+//				is no guide to this, since inline display groups, and groups
+//				of other types, never have valid automatic bounds.
+//-----------------------------------------------------------------------------
+static void
+e3group_bounds_changed ( E3Group* theGroup )
+	{
+	E3GroupChildCache* theCache = theGroup->groupData.childCache ;
+	if ( theCache != nullptr )
+		{
+		if ( theCache->boundsStale )
+			return ;
+		
+		theCache->boundsStale = kQ3True ;
+		}
+	
+	if ( E3Object_IsType ( theGroup, kQ3GroupTypeDisplay ) )
+		( (E3DisplayGroup*) theGroup )->displayGroupData.autoBBoxValid = kQ3False ;
+	
+	E3Group_BoundsMemberEdited ( theGroup ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3Group::GetChildCache : Get the member snapshot, creating if needed.
+//-----------------------------------------------------------------------------
+//		Note :	The returned record may hold a stale member array; callers
+//				that need the members should use e3group_childcache_update.
+//				Returns nullptr if memory is exhausted.
+//-----------------------------------------------------------------------------
+E3GroupChildCache*
+E3Group::GetChildCache ( void )
+	{
+	if ( groupData.childCache == nullptr )
+		groupData.childCache = new ( std::nothrow ) E3GroupChildCache ;
+	
+	return groupData.childCache ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3Group::InvalidateChildCache : Note that the members have changed.
+//-----------------------------------------------------------------------------
+void
+E3Group::InvalidateChildCache ( void )
+	{
+	E3GroupChildCache* theCache = groupData.childCache ;
+	
+	if ( theCache != nullptr )
+		{
+		theCache->childrenValid = kQ3False ;
+		theCache->editStamp    += 1 ;
+		theCache->numCounts     = 0 ;
+		theCache->nextCountSlot = 0 ;
+		
+		// The members are about to change, so the bounds of this group and
+		// of any group above it are stale
+		if ( theCache->boundsWatched )
+			{
+			UnwatchBounds () ;
+			e3group_bounds_changed ( this ) ;
+			}
+		}
+	}
+
+
+
+
+
+//=============================================================================
+//      E3Group::DisposeChildCache : Release the member snapshot.
+//-----------------------------------------------------------------------------
+void
+E3Group::DisposeChildCache ( void )
+	{
+	UnwatchBounds () ;
+	delete groupData.childCache ;
+	groupData.childCache = nullptr ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3Group::WatchBounds : Register the group with its members.
+//-----------------------------------------------------------------------------
+//		Note :	Once watched, an edit to any member marks the bounds of this
+//				group, and of the display groups above it, as stale.  The
+//				registration lasts until the members change.  Returns false
+//				if memory is exhausted, in which case nothing is registered.
+//-----------------------------------------------------------------------------
+bool
+E3Group::WatchBounds ( void )
+	{
+	E3GroupChildCache* theCache = GetChildCache () ;
+	if ( theCache == nullptr )
+		return false ;
+	
+	// A bounds computation has reached us, so later edits must be passed up
+	theCache->boundsStale = kQ3False ;
+	
+	if ( theCache->boundsWatched )
+		return true ;
+	
+	std::lock_guard<std::recursive_mutex> lock ( sBoundsWatchersLock ) ;
+	
+	try
+		{
+		TQ3GroupPosition thePosition = nullptr ;
+		GetFirstPosition ( &thePosition ) ;
+		while ( thePosition != nullptr )
+			{
+			TQ3Object theMember = ( (TQ3XGroupPosition*) thePosition )->object ;
+			
+			theCache->boundsMembers.push_back ( theMember ) ;
+			sBoundsWatchers.insert ( std::make_pair ( theMember, this ) ) ;
+			( (E3Shared*) theMember )->sharedData.numBoundsWatchers += 1 ;
+			
+			GetNextPosition ( &thePosition ) ;
+			}
+		}
+	catch (...)
+		{
+		theCache->boundsWatched = kQ3True ;
+		UnwatchBounds () ;
+		return false ;
+		}
+	
+	theCache->boundsWatched = kQ3True ;
+	
+	return true ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3Group::UnwatchBounds : Undo E3Group::WatchBounds.
+//-----------------------------------------------------------------------------
+void
+E3Group::UnwatchBounds ( void )
+	{
+	E3GroupChildCache* theCache = groupData.childCache ;
+	if ( ( theCache == nullptr ) || ! theCache->boundsWatched )
+		return ;
+	
+	std::lock_guard<std::recursive_mutex> lock ( sBoundsWatchersLock ) ;
+	
+	for ( TQ3Uns32 i = 0 ; i < theCache->boundsMembers.size() ; ++i )
+		{
+		TQ3Object theMember = theCache->boundsMembers[ i ] ;
+		auto theRange = sBoundsWatchers.equal_range ( theMember ) ;
+		
+		for ( auto it = theRange.first ; it != theRange.second ; ++it )
+			{
+			if ( it->second == this )
+				{
+				sBoundsWatchers.erase ( it ) ;
+				( (E3Shared*) theMember )->sharedData.numBoundsWatchers -= 1 ;
+				break ;
+				}
+			}
+		}
+	
+	theCache->boundsMembers.clear () ;
+	theCache->boundsWatched = kQ3False ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3group_childcache_update : Bring the member array up to date.
+//-----------------------------------------------------------------------------
+//		Note :	The array is filled through the class's position methods, so
+//				it follows the iteration order of subclasses such as ordered
+//				display groups.  Returns false if the array is stale and can
+//				not be rebuilt because a submit is still walking it.
+//-----------------------------------------------------------------------------
+static bool
+e3group_childcache_update ( E3Group* theGroup, E3GroupChildCache* theCache )
+	{
+	if ( theCache->childrenValid )
+		return true ;
+	
+	if ( theCache->submitDepth != 0 )
+		return false ;
+	
+	theCache->children.clear() ;
+	
+	TQ3GroupPosition thePosition = nullptr ;
+	theGroup->GetFirstPosition( &thePosition ) ;
+	while ( thePosition != nullptr )
+		{
+		// The group keeps its own reference, so the array need not hold one
+		TQ3Object theMember = nullptr ;
+		if ( theGroup->GetPositionObject( thePosition, &theMember ) == kQ3Success )
+			{
+			theCache->children.push_back( theMember ) ;
+			Q3Object_Dispose( theMember ) ;
+			}
+		theGroup->GetNextPosition( &thePosition ) ;
+		}
+	
+	theCache->childrenValid = kQ3True ;
+	
+	return true ;
+	}
+
+
+
+
+
 //=============================================================================
 //      e3group_acceptobject : Group accept object method.
 //-----------------------------------------------------------------------------
@@ -619,7 +940,13 @@ E3Group::countobjects ( TQ3ObjectType isType, TQ3Uns32 *number )
 	
 	if (groupData.listHead.next != &groupData.listHead)
 	{
-		if (isType == kQ3ObjectTypeShared)
+		if ( (isType == kQ3ObjectTypeShared) && (groupData.childCache != nullptr) &&
+			groupData.childCache->childrenValid )
+		{
+			// Optimization: the member snapshot already knows the count
+			*number = groupData.childCache->children.size();
+		}
+		else if (isType == kQ3ObjectTypeShared)
 		{
 			// Optimization: all members of a group are shared
 			for ( TQ3XGroupPosition* pos = groupData.listHead.next; pos != &groupData.listHead;
@@ -1034,6 +1361,70 @@ e3group_enditerate(TQ3GroupObject group, TQ3GroupPosition *iterator, TQ3Object *
 
 
 
+//=============================================================================
+//      e3group_find_position : Find the position of a member of a group.
+//-----------------------------------------------------------------------------
+//		Note :	Returns nullptr if the object is no longer in the group.
+//-----------------------------------------------------------------------------
+static TQ3GroupPosition
+e3group_find_position ( E3Group* theGroup, TQ3Object theMember )
+	{
+	TQ3GroupPosition thePosition = nullptr ;
+	theGroup->GetFirstPosition( &thePosition ) ;
+	while ( thePosition != nullptr )
+		{
+		TQ3Object theObject = nullptr ;
+		if ( theGroup->GetPositionObject( thePosition, &theObject ) == kQ3Success )
+			{
+			Q3Object_Dispose( theObject ) ;
+			if ( theObject == theMember )
+				break ;
+			}
+		theGroup->GetNextPosition( &thePosition ) ;
+		}
+	
+	return thePosition ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3group_submit_iterate : Submit a group through its iterate methods.
+//-----------------------------------------------------------------------------
+//		Note :	Starts from subObject, the object at thePosition, which the
+//				caller has already obtained from the start iterate method or
+//				with a reference of its own.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3group_submit_iterate ( TQ3ViewObject theView, E3Group* theObject,
+						TQ3GroupPosition thePosition, TQ3Object subObject )
+{
+	E3GroupInfo* groupClass = theObject->GetClass () ;
+	TQ3Status qd3dStatus = kQ3Success ;
+
+	while ( subObject != nullptr ) // If that was the last object, stop
+	{
+		// Submit the object, ignore errors
+		E3View_SubmitRetained( theView, subObject );
+
+
+
+		// Get the next object	
+		qd3dStatus = groupClass->endIterateMethod ( theObject, &thePosition, &subObject, theView ) ;
+		if ( qd3dStatus == kQ3Failure )
+			return kQ3Failure ;
+
+	}
+
+	return qd3dStatus ;
+}
+
+
+
+
+
 //=============================================================================
 //      e3group_submit_contents : Group general submit method.
 //-----------------------------------------------------------------------------
@@ -1047,28 +1438,98 @@ e3group_submit_contents(TQ3ViewObject theView, TQ3ObjectType objectType, E3Group
 	E3GroupInfo* groupClass = theObject->GetClass () ;
 
 
+	// Fast path: when the class uses the standard iteration, walk the
+	// contiguous member snapshot rather than the position list.
+	if ( ( groupClass->startIterateMethod == e3group_startiterate ) &&
+		 ( groupClass->endIterateMethod   == e3group_enditerate ) )
+	{
+		E3GroupChildCache* theCache = theObject->GetChildCache() ;
+		if ( ( theCache != nullptr ) && e3group_childcache_update( theObject, theCache ) )
+		{
+			const TQ3Uns32 editStamp  = theCache->editStamp ;
+			const TQ3Uns32 numMembers = theCache->children.size() ;
+			E3Shared* editedAt = nullptr ;
+			
+			theCache->submitDepth += 1 ;
+			
+			for ( TQ3Uns32 i = 0 ; i < numMembers ; ++i )
+			{
+				// Hold a reference while submitting, as the iterate methods do
+				E3Shared* subObject = ( (E3Shared*) theCache->children[ i ] )->GetReference() ;
+				
+				// Submit the object, ignore errors
+				E3View_SubmitRetained( theView, subObject ) ;
+				
+				// If the submit edited this group, later entries may have been
+				// released, so keep our reference and leave the snapshot
+				if ( theCache->editStamp != editStamp )
+				{
+					editedAt = subObject ;
+					break ;
+				}
+				
+				E3Shared_Dispose( subObject ) ;
+			}
+			
+			theCache->submitDepth -= 1 ;
+			
+			if ( editedAt == nullptr )
+				return kQ3Success ;
+			
+			
+			
+			// Carry on along the position list after the member we just
+			// submitted.  If that member was removed there is nowhere to
+			// continue from, and the rest of the group is not submitted.
+			TQ3GroupPosition thePosition = e3group_find_position( theObject, editedAt ) ;
+			if ( thePosition == nullptr )
+			{
+				E3Shared_Dispose( editedAt ) ;
+				return kQ3Success ;
+			}
+			
+			TQ3Object subObject = editedAt ;
+			TQ3Status qd3dStatus = groupClass->endIterateMethod ( theObject, &thePosition, &subObject, theView ) ;
+			if ( qd3dStatus == kQ3Failure )
+				return kQ3Failure ;
+			
+			return e3group_submit_iterate ( theView, theObject, thePosition, subObject ) ;
+		}
+	}
+
+
+
 	// Submit the contents of the group
 	TQ3GroupPosition thePosition ;
 	TQ3Object subObject ;
 	TQ3Status qd3dStatus = groupClass->startIterateMethod ( theObject, &thePosition, &subObject, theView ) ;
-	if ( qd3dStatus != kQ3Failure )
-	{
-		while ( subObject != nullptr ) // If that was the last object, stop
-		{
-			// Submit the object, ignore errors
-			E3View_SubmitRetained( theView, subObject );
+	if ( qd3dStatus == kQ3Failure )
+		return qd3dStatus ;
 
+	return e3group_submit_iterate ( theView, theObject, thePosition, subObject ) ;
+}
 
 
-			// Get the next object	
-			qd3dStatus = groupClass->endIterateMethod ( theObject, &thePosition, &subObject, theView ) ;
-			if ( qd3dStatus == kQ3Failure )
-				return kQ3Failure ;
 
-		}
-	}
 
-	return qd3dStatus ;
+
+//=============================================================================
+//      e3group_submit_bounds : Group submit for bounding method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3group_submit_bounds(TQ3ViewObject theView, TQ3ObjectType objectType, E3Group* theObject, const void *objectData)
+{
+
+
+	// If automatic bounds are being computed, watch our members so that an
+	// edit to them reaches the display groups above us
+	if ( e3group_is_auto_bounds_view ( theView ) )
+		theObject->WatchBounds () ;
+
+
+
+	// Submit the contents of the group
+	return e3group_submit_contents ( theView, objectType, theObject, objectData ) ;
 }
 
 
@@ -1282,6 +1743,9 @@ e3group_metahandler(TQ3XMethodType methodType)
 			break;
 
 		case kQ3XMethodTypeObjectSubmitBounds:
+			theMethod = (TQ3XFunctionPointer) e3group_submit_bounds;
+			break;
+
 		case kQ3XMethodTypeObjectSubmitRender:
 			theMethod = (TQ3XFunctionPointer) e3group_submit_contents;
 			break;
@@ -1324,6 +1788,9 @@ e3group_display_new(TQ3Object theObject, void *privateData, const void *paramDat
 	instanceData->displayGroupData.bBox.max.z   = 0.0f;
 	instanceData->displayGroupData.bBox.isEmpty = kQ3True;
 
+	instanceData->displayGroupData.autoBBox      = instanceData->displayGroupData.bBox;
+	instanceData->displayGroupData.autoBBoxValid = kQ3False;
+
 	return kQ3Success ;
 	}
 
@@ -1354,7 +1821,7 @@ e3group_display_submit_render(TQ3ViewObject theView, TQ3ObjectType objectType,
 	if ( shouldSubmit &&
 		E3Bit_IsSet( theState, kQ3DisplayGroupStateMaskUseBoundingBox ) &&
 		E3View_IsGroupCullingAllowed( theView ) &&
-		(kQ3Success == ((E3DisplayGroup*)theObject)->GetBoundingBox( &theBBox )) )
+		(kQ3Success == ((E3DisplayGroup*)theObject)->GetCullingBoundingBox( &theBBox )) )
 	{
 		shouldSubmit = E3Renderer_Method_IsBBoxVisible( theView, &theBBox );
 	}
@@ -1390,6 +1857,114 @@ e3group_display_submit_render(TQ3ViewObject theView, TQ3ObjectType objectType,
 
 
 
+//=============================================================================
+//      e3group_display_auto_bounds_valid : Are the automatic bounds current?
+//-----------------------------------------------------------------------------
+//		Note :	The bounds are only kept current while the group watches its
+//				members, which a duplicated group does not.
+//-----------------------------------------------------------------------------
+static bool
+e3group_display_auto_bounds_valid ( E3DisplayGroup* theGroup )
+	{
+	const E3GroupChildCache* theCache = theGroup->groupData.childCache ;
+	
+	return ( theGroup->displayGroupData.autoBBoxValid == kQ3True ) &&
+		( theCache != nullptr ) && ( theCache->boundsWatched == kQ3True ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3group_display_update_auto_bounds : Recompute stale automatic bounds.
+//-----------------------------------------------------------------------------
+//		Note :	The bounds are found in the group's own coordinates, by
+//				submitting its contents to a private view.  Display groups
+//				inside it contribute their own automatic bounds, so after an
+//				edit only the groups above the edited object are resubmitted.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3group_display_update_auto_bounds ( E3DisplayGroup* theGroup )
+	{
+	TQ3SubdivisionStyleData	subData = {
+		kQ3SubdivisionMethodConstant,
+		20.0f, 20.0f
+	};
+	TQ3ViewStatus			viewStatus = kQ3ViewStatusError ;
+	TQ3BoundingBox			theBBox ;
+
+
+
+	if ( e3group_display_auto_bounds_valid ( theGroup ) )
+		return kQ3Success ;
+
+
+
+	// Register with our members before submitting them, and mark the bounds
+	// as valid up front, so that an edit made while we are busy clears it
+	if ( ! theGroup->WatchBounds () )
+		return kQ3Failure ;
+	
+	theGroup->displayGroupData.autoBBoxValid = kQ3True ;
+
+
+
+	// Bound our contents
+	TQ3ViewObject theView = Q3View_New () ;
+	if ( theView == nullptr )
+		{
+		theGroup->displayGroupData.autoBBoxValid = kQ3False ;
+		return kQ3Failure ;
+		}
+	
+	try
+		{
+		sAutoBoundsViews.push_back ( theView ) ;
+		}
+	catch (...)
+		{
+		Q3Object_Dispose ( theView ) ;
+		theGroup->displayGroupData.autoBBoxValid = kQ3False ;
+		return kQ3Failure ;
+		}
+
+	TQ3Status qd3dStatus = Q3View_StartBoundingBox ( theView, kQ3ComputeBoundsExact ) ;
+	if ( qd3dStatus != kQ3Failure )
+		{
+		do
+			{
+			// Submit a subdivision style, because some geometries do not
+			// implement the default screen space subdivision.
+			E3SubdivisionStyle_Submit ( &subData, theView ) ;
+			
+			qd3dStatus = e3group_submit_contents ( theView, kQ3GroupTypeDisplay, theGroup, nullptr ) ;
+			viewStatus = Q3View_EndBoundingBox ( theView, &theBBox ) ;
+			}
+		while ( viewStatus == kQ3ViewStatusRetraverse ) ;
+		}
+
+	sAutoBoundsViews.pop_back () ;
+	Q3Object_Dispose ( theView ) ;
+
+
+
+	// Save the result
+	if ( ( qd3dStatus == kQ3Failure ) || ( viewStatus != kQ3ViewStatusDone ) )
+		{
+		theGroup->displayGroupData.autoBBoxValid = kQ3False ;
+		return kQ3Failure ;
+		}
+	
+	theGroup->displayGroupData.autoBBox = theBBox ;
+	
+	return kQ3Success ;
+	}
+
+
+
+
+
 //=============================================================================
 //      e3group_display_submit_bounds : Display group submit for bounding method.
 //-----------------------------------------------------------------------------
@@ -1413,6 +1988,30 @@ e3group_display_submit_bounds(TQ3ViewObject theView, TQ3ObjectType objectType,
 	{
 		// If the group isn't inline, push the view state and reset the matrix
 		TQ3Boolean isInline = E3Bit_AnySet(theState, kQ3DisplayGroupStateMaskIsInline);
+		
+		
+		// While automatic bounds are being computed, a group which can't
+		// pass state on to its siblings contributes its own automatic bounds
+		// rather than its contents.  Other groups watch their members, so
+		// that edits inside them reach the groups above.
+		if ( e3group_is_auto_bounds_view ( theView ) )
+		{
+			E3DisplayGroup* theGroup = (E3DisplayGroup*) theObject ;
+			if ( ! isInline && e3group_display_update_auto_bounds ( theGroup ) == kQ3Success )
+			{
+				if ( ! theGroup->displayGroupData.autoBBox.isEmpty )
+				{
+					TQ3Point3D theCorners[8] ;
+					E3BoundingBox_GetCorners ( &theGroup->displayGroupData.autoBBox, theCorners ) ;
+					E3View_UpdateBounds ( theView, 8, sizeof(TQ3Point3D), theCorners ) ;
+				}
+				return kQ3Success ;
+			}
+			
+			theGroup->WatchBounds () ;
+		}
+		
+		
 		if ( ! isInline )
 			qd3dStatus = E3Push_Submit ( theView ) ;
 
@@ -1454,6 +2053,21 @@ e3group_display_submit_pick(TQ3ViewObject theView, TQ3ObjectType objectType,
 
 
 
+	// If the pick only wants its nearest hit, skip the group if its bounds
+	// are further away than the nearest hit so far
+	TQ3BoundingBox	theBBox ;
+	if ( shouldSubmit &&
+		E3Bit_IsSet( theState, kQ3DisplayGroupStateMaskUseBoundingBox ) &&
+		(kQ3Success == ((E3DisplayGroup*)theObject)->GetCullingBoundingBox( &theBBox )) )
+	{
+		TQ3BoundingBox	worldBBox ;
+		E3BoundingBox_Transform( &theBBox, E3View_State_GetMatrixLocalToWorld( theView ), &worldBBox ) ;
+		if ( E3Pick_IsBeyondClosestHit( E3View_AccessPick( theView ), theView, &worldBBox ) )
+			shouldSubmit = kQ3False ;
+	}
+
+
+
 	// If we need to submit the group, do so
 	if ( shouldSubmit )
 	{
@@ -2857,6 +3471,8 @@ E3Group_GetType(TQ3GroupObject group)
 TQ3GroupPosition
 E3Group::AddObject ( TQ3Object object )
 	{
+	InvalidateChildCache () ;
+
 	// Call the method
 	return GetClass ()->addObjectMethod ( this, object ) ;
 	}
@@ -2893,6 +3509,8 @@ TQ3GroupPosition
 E3Group::AddObjectBefore ( TQ3GroupPosition position, TQ3Object object )
 	{
 	
+	InvalidateChildCache () ;
+
 	// Call the method
 	return GetClass ()->addObjectBeforeMethod ( this, position, object ) ;
 	}
@@ -2907,6 +3525,8 @@ E3Group::AddObjectBefore ( TQ3GroupPosition position, TQ3Object object )
 TQ3GroupPosition
 E3Group::AddObjectAfter ( TQ3GroupPosition position, TQ3Object object )
 	{
+	InvalidateChildCache () ;
+
 	// Call the method
 	return GetClass ()->addObjectAfterMethod ( this, position, object ) ;
 	}
@@ -2947,6 +3567,8 @@ E3Group::GetPositionObject ( TQ3GroupPosition position, TQ3Object *object )
 TQ3Status
 E3Group::SetPositionObject ( TQ3GroupPosition position, TQ3Object object )
 	{
+	InvalidateChildCache () ;
+
 	// Call the method
 	TQ3Status result = GetClass ()->setPositionObjectMethod ( this, position, object ) ;
 
@@ -2965,6 +3587,8 @@ E3Group::SetPositionObject ( TQ3GroupPosition position, TQ3Object object )
 TQ3Object
 E3Group::RemovePosition ( TQ3GroupPosition position )
 	{
+	InvalidateChildCache () ;
+
 	// Call the method
 	return GetClass ()->removePositionMethod ( this, position ) ;
 	}
@@ -3035,8 +3659,7 @@ E3Group::GetPreviousPosition ( TQ3GroupPosition* position )
 TQ3Status
 E3Group::CountObjects ( TQ3Uns32* nObjects )
 	{
-	// Call the method
-	return GetClass ()->countObjectsOfTypeMethod ( this, kQ3ObjectTypeShared, nObjects ) ;
+	return CountObjectsOfType ( kQ3ObjectTypeShared, nObjects ) ;
 	}
 
 
@@ -3049,6 +3672,8 @@ E3Group::CountObjects ( TQ3Uns32* nObjects )
 TQ3Status
 E3Group::EmptyObjects ( void )
 	{
+	InvalidateChildCache () ;
+
 	// Call the method
 	return GetClass ()->emptyObjectsOfTypeMethod ( this, kQ3ObjectTypeShared ) ;
 	}
@@ -3119,8 +3744,38 @@ E3Group::GetPreviousPositionOfType ( TQ3ObjectType isType, TQ3GroupPosition* pos
 TQ3Status
 E3Group::CountObjectsOfType ( TQ3ObjectType isType, TQ3Uns32* nObjects )
 	{
+	// Counts are remembered until the group is next edited, since callers
+	// often count the same types repeatedly while walking a scene.
+	E3GroupChildCache* theCache = GetChildCache () ;
+	
+	if ( theCache != nullptr )
+		{
+		for ( TQ3Uns32 i = 0 ; i < theCache->numCounts ; ++i )
+			{
+			if ( theCache->countTypes[ i ] == isType )
+				{
+				*nObjects = theCache->countValues[ i ] ;
+				return kQ3Success ;
+				}
+			}
+		}
+	
+	
+	
 	// Call the method
-	return GetClass ()->countObjectsOfTypeMethod ( this, isType, nObjects ) ;
+	TQ3Status result = GetClass ()->countObjectsOfTypeMethod ( this, isType, nObjects ) ;
+	
+	if ( ( result == kQ3Success ) && ( theCache != nullptr ) )
+		{
+		theCache->countTypes[ theCache->nextCountSlot ]  = isType ;
+		theCache->countValues[ theCache->nextCountSlot ] = *nObjects ;
+		theCache->nextCountSlot = ( theCache->nextCountSlot + 1 ) % kGroupCountMemoSize ;
+		
+		if ( theCache->numCounts < kGroupCountMemoSize )
+			theCache->numCounts += 1 ;
+		}
+	
+	return result ;
 	}
 
 
@@ -3133,6 +3788,8 @@ E3Group::CountObjectsOfType ( TQ3ObjectType isType, TQ3Uns32* nObjects )
 TQ3Status
 E3Group::EmptyObjectsOfType ( TQ3ObjectType isType )
 	{
+	InvalidateChildCache () ;
+
 	// Call the method
 	return GetClass ()->emptyObjectsOfTypeMethod ( this, isType ) ;
 	}
@@ -3386,6 +4043,38 @@ E3DisplayGroup::CalcAndUseBoundingBox ( TQ3ComputeBounds computeBounds, TQ3ViewO
 
 
 
+
+//=============================================================================
+//      E3DisplayGroup::GetCullingBoundingBox : Get the bounds to cull with.
+//-----------------------------------------------------------------------------
+//		Note :	A bounding box set by the application takes precedence.
+//				Otherwise a group which uses a bounding box gets automatic
+//				bounds, recomputed if anything inside it has been edited.
+//				Inline groups get no automatic bounds, since culling them
+//				would also lose the state they pass on to their siblings.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3DisplayGroup::GetCullingBoundingBox ( TQ3BoundingBox *pBBox )
+	{
+	if ( E3Bit_IsSet( displayGroupData.state, kQ3DisplayGroupStateMaskHasBoundingBox ) )
+		return GetBoundingBox ( pBBox ) ;
+	
+	if ( E3Bit_IsNotSet( displayGroupData.state, kQ3DisplayGroupStateMaskUseBoundingBox ) ||
+		 E3Bit_IsSet( displayGroupData.state, kQ3DisplayGroupStateMaskIsInline ) )
+		return kQ3Failure ;
+	
+	if ( e3group_display_update_auto_bounds ( this ) == kQ3Failure )
+		return kQ3Failure ;
+	
+	*pBBox = displayGroupData.autoBBox ;
+	
+	return kQ3Success ;
+	}
+
+
+
+
+
 //=============================================================================
 //      E3LightGroup_New : Creates a new light group.
 //-----------------------------------------------------------------------------
@@ -3484,3 +4173,25 @@ E3XGroup_GetPositionPrivate(TQ3GroupObject group, TQ3GroupPosition position)
 
 	return position;
 }
+
+
+
+
+
+//=============================================================================
+//      E3Group_BoundsMemberEdited : An object inside some group bounds changed.
+//-----------------------------------------------------------------------------
+//		Note :	Called by E3Shared::Edited for objects which have been
+//				registered by E3Group::WatchBounds.
+//-----------------------------------------------------------------------------
+void
+E3Group_BoundsMemberEdited(TQ3Object theMember)
+{
+	if (( (E3Shared*) theMember )->sharedData.numBoundsWatchers == 0)
+		return;
+
+	std::lock_guard<std::recursive_mutex> lock( sBoundsWatchersLock );
+	auto theRange = sBoundsWatchers.equal_range( theMember );
+	for (auto it = theRange.first; it != theRange.second; ++it)
+		e3group_bounds_changed( it->second );
+}
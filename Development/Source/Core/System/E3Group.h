@@ -175,10 +175,17 @@ public :
 
 
 
+struct E3GroupChildCache ;
+
 struct E3GroupData
 {
 	TQ3XGroupPosition						listHead ;
 	TQ3Uns32								groupPositionSize ;
+	
+	// Contiguous snapshot of the members, built on demand by the submit and
+	// count paths and invalidated by every mutation.  The linked list above
+	// remains the authority, so TQ3GroupPosition handles stay stable.
+	E3GroupChildCache*						childCache ;
 };
 
 
@@ -215,6 +222,13 @@ public :
 	TQ3Status								getnextobjectposition ( TQ3Object object, TQ3GroupPosition *position ) ;		
 	TQ3Status								getprevobjectposition ( TQ3Object object, TQ3GroupPosition *position ) ;
 
+	E3GroupChildCache*						GetChildCache ( void ) ;
+	void									InvalidateChildCache ( void ) ;
+	void									DisposeChildCache ( void ) ;
+
+	bool									WatchBounds ( void ) ;
+	void									UnwatchBounds ( void ) ;
+
 	TQ3GroupPosition						AddObject ( TQ3Object object ) ;
 
 	TQ3GroupPosition						AddObjectAndDispose ( TQ3Object *theObject ) ;
@@ -253,6 +267,12 @@ struct E3DisplayGroupData
 {
 	TQ3DisplayGroupState	state ;
 	TQ3BoundingBox			bBox ;
+	
+	// Bounds computed by Quesa, used for culling when the group has
+	// kQ3DisplayGroupStateMaskUseBoundingBox but no bounding box of its own.
+	// Dropped whenever anything inside the group is edited.
+	TQ3BoundingBox			autoBBox ;
+	TQ3Boolean				autoBBoxValid ;
 };
 
 
@@ -263,7 +283,7 @@ Q3_CLASS_ENUMS ( kQ3GroupTypeDisplay, E3DisplayGroup, E3Group )
 
 public :
 
-// 32 bytes + 16 bytes = 48 bytes overhead per display group
+// 32 bytes + 16 bytes + 32 bytes = 80 bytes overhead per display group
 // initialised in e3group_display_new
 	E3DisplayGroupData		displayGroupData;
 	
@@ -275,6 +295,7 @@ public :
 	TQ3Status				GetBoundingBox ( TQ3BoundingBox *pBBox ) ;
 	TQ3Status				RemoveBoundingBox ( void ) ;
 	TQ3Status				CalcAndUseBoundingBox ( TQ3ComputeBounds computeBounds, TQ3ViewObject view ) ;
+	TQ3Status				GetCullingBoundingBox ( TQ3BoundingBox *pBBox ) ;
 
 
 	friend TQ3Status		e3group_display_new(TQ3Object theObject,
@@ -353,6 +374,8 @@ TQ3GroupObject		E3IOProxyDisplayGroup_New(void);
 
 void				*E3XGroup_GetPositionPrivate(TQ3GroupObject group, TQ3GroupPosition position);
 
+void				E3Group_BoundsMemberEdited(TQ3Object theMember);
+
 
 
 
@@ -575,9 +575,12 @@ E3File::Close ( void )
 		closeFormat ( instanceData.format, kQ3False ) ;
 
 
-	// close the storage
+	// close the storage. Buffered data is written to disk at this point, so
+	// a full disk or I/O error may only show up here.
+	TQ3Status status = kQ3Success ;
+	
 	if ( closeStorage != nullptr )
-		closeStorage ( instanceData.storage ) ;
+		status = closeStorage ( instanceData.storage ) ;
 
 
 
@@ -587,7 +590,7 @@ E3File::Close ( void )
 	instanceData.status = kE3_File_Status_Closed ;
 	instanceData.reason = kE3_File_Reason_OK ;
 
-	return kQ3Success ;
+	return status ;
 	}
 
 
@@ -237,6 +237,7 @@ e3shared_new ( TQ3Object inObject, void *privateData, const void *paramData )
 	// Initialise our instance data
 	theObject->sharedData.refCount  = 1 ;
 	theObject->sharedData.editIndex = 1 ;
+	theObject->sharedData.numBoundsWatchers = 0 ;
 
 #if Q3_DEBUG
 	theObject->sharedData.logRefs = kQ3False;
@@ -339,6 +340,7 @@ e3shared_duplicate(TQ3Object fromObject,     const void *fromPrivateData,
 	// Initialise the instance data of the new object
 	instanceData->sharedData.refCount  = 1;
 	instanceData->sharedData.editIndex = E3Integer_Abs( fromInstanceData->sharedData.editIndex );
+	instanceData->sharedData.numBoundsWatchers = 0;
 
 #if Q3_DEBUG
 	instanceData->sharedData.logRefs = kQ3False;
@@ -1009,6 +1011,11 @@ E3Exit(void)
 
 
 
+		// Give back the memory pools, now that nothing should be using them
+		E3Memory_ReleasePools();
+
+
+
 		// Set our flag
 		theGlobals->systemInitialised = kQ3False;
 		}
@@ -2062,6 +2069,10 @@ E3Shared::Edited ( void )
 	{
 		// Increment the edit index
 		++sharedData.editIndex ;
+		
+		// Any group bounds which include this object are now stale
+		if (sharedData.numBoundsWatchers != 0)
+			E3Group_BoundsMemberEdited( this );
 	}
 	
 	return kQ3Success ;
@@ -308,6 +308,7 @@ struct E3SharedData
 {
 	TQ3Uns32		refCount;
 	TQ3Int32		editIndex;	// normally positive, negative means "locked"
+	TQ3Uns32		numBoundsWatchers;	// groups caching bounds that include this object
 #if Q3_DEBUG
 	TQ3Boolean		logRefs;
 #endif
@@ -52,6 +52,14 @@
 #include <limits>
 #include <cstring>
 
+#if QUESA_USE_SIMD_MATH
+	#if defined(__ARM_NEON)
+		#include <arm_neon.h>
+	#else
+		#include <emmintrin.h>
+	#endif
+#endif
+
 
 
 //=============================================================================
@@ -140,6 +148,130 @@ inline void AdvanceConstPointer( const T*& ioPtr, TQ3Uns32 inCount )
 	ioPtr = reinterpret_cast<const T*>( ptr );
 }
 
+
+
+
+//=============================================================================
+//		4-wide float helpers
+//-----------------------------------------------------------------------------
+//		When QUESA_USE_SIMD_MATH is set (see E3Prefix.h), the hot matrix,
+//		quaternion and transform-array routines use these to work on a whole
+//		matrix row at a time. The selection is made at compile time: SSE2 is
+//		part of the baseline for x86-64, as NEON is for AArch64, so there is
+//		nothing to gain from dispatching at runtime.
+//
+//		The kernels perform the same multiplies and adds, in the same order,
+//		as the scalar code they replace, and never fuse a multiply with an
+//		add. They only match the scalar code bit for bit when the compiler
+//		does not fuse it either, as on x86-64 without FMA. Clang's default
+//		of -ffp-contract=on turns the scalar a*b + c into a fused
+//		multiply-add on AArch64, so there the last bit of a result may differ.
+//		The scalar versions remain the fallback on other processors.
+//-----------------------------------------------------------------------------
+#if QUESA_USE_SIMD_MATH
+
+#if defined(__ARM_NEON)
+
+typedef float32x4_t		E3Float4;
+
+static inline E3Float4 e3float4_load( const float* p )				{ return vld1q_f32( p ); }
+static inline void     e3float4_store( float* p, E3Float4 v )		{ vst1q_f32( p, v ); }
+static inline E3Float4 e3float4_splat( float f )					{ return vdupq_n_f32( f ); }
+static inline E3Float4 e3float4_add( E3Float4 a, E3Float4 b )		{ return vaddq_f32( a, b ); }
+static inline E3Float4 e3float4_sub( E3Float4 a, E3Float4 b )		{ return vsubq_f32( a, b ); }
+static inline E3Float4 e3float4_mul( E3Float4 a, E3Float4 b )		{ return vmulq_f32( a, b ); }
+static inline E3Float4 e3float4_div( E3Float4 a, E3Float4 b )		{ return vdivq_f32( a, b ); }
+
+static inline E3Float4 e3float4_set( float a, float b, float c, float d )
+{
+	const float	f[4] = { a, b, c, d };
+	return vld1q_f32( f );
+}
+
+#else
+
+typedef __m128			E3Float4;
+
+static inline E3Float4 e3float4_load( const float* p )				{ return _mm_loadu_ps( p ); }
+static inline void     e3float4_store( float* p, E3Float4 v )		{ _mm_storeu_ps( p, v ); }
+static inline E3Float4 e3float4_splat( float f )					{ return _mm_set1_ps( f ); }
+static inline E3Float4 e3float4_add( E3Float4 a, E3Float4 b )		{ return _mm_add_ps( a, b ); }
+static inline E3Float4 e3float4_sub( E3Float4 a, E3Float4 b )		{ return _mm_sub_ps( a, b ); }
+static inline E3Float4 e3float4_mul( E3Float4 a, E3Float4 b )		{ return _mm_mul_ps( a, b ); }
+static inline E3Float4 e3float4_div( E3Float4 a, E3Float4 b )		{ return _mm_div_ps( a, b ); }
+
+static inline E3Float4 e3float4_set( float a, float b, float c, float d )
+{
+	return _mm_setr_ps( a, b, c, d );
+}
+
+#endif
+
+
+
+
+
+//=============================================================================
+//		e3float4_transform_vector : Return x*r0 + y*r1 + z*r2.
+//-----------------------------------------------------------------------------
+//		Note :	The rows are those of a TQ3Matrix4x4, so these routines form the
+//				product of a row vector with the matrix.
+//-----------------------------------------------------------------------------
+static inline E3Float4
+e3float4_transform_vector( float x, float y, float z, const E3Float4* inRows )
+{
+	E3Float4	v = e3float4_mul( e3float4_splat( x ), inRows[0] );
+	v = e3float4_add( v, e3float4_mul( e3float4_splat( y ), inRows[1] ) );
+	v = e3float4_add( v, e3float4_mul( e3float4_splat( z ), inRows[2] ) );
+	return v;
+}
+
+
+
+
+
+//=============================================================================
+//		e3float4_transform_point : Return x*r0 + y*r1 + z*r2 + r3.
+//-----------------------------------------------------------------------------
+static inline E3Float4
+e3float4_transform_point( float x, float y, float z, const E3Float4* inRows )
+{
+	return e3float4_add( e3float4_transform_vector( x, y, z, inRows ), inRows[3] );
+}
+
+
+
+
+
+//=============================================================================
+//		e3float4_transform_rational : Return x*r0 + y*r1 + z*r2 + w*r3.
+//-----------------------------------------------------------------------------
+static inline E3Float4
+e3float4_transform_rational( float x, float y, float z, float w,
+							const E3Float4* inRows )
+{
+	return e3float4_add( e3float4_transform_vector( x, y, z, inRows ),
+		e3float4_mul( e3float4_splat( w ), inRows[3] ) );
+}
+
+
+
+
+
+//=============================================================================
+//		e3float4_load_rows : Load the rows of a 4x4 matrix.
+//-----------------------------------------------------------------------------
+static inline void
+e3float4_load_rows( const TQ3Matrix4x4& inMatrix, E3Float4* outRows )
+{
+	outRows[0] = e3float4_load( inMatrix.value[0] );
+	outRows[1] = e3float4_load( inMatrix.value[1] );
+	outRows[2] = e3float4_load( inMatrix.value[2] );
+	outRows[3] = e3float4_load( inMatrix.value[3] );
+}
+
+#endif // QUESA_USE_SIMD_MATH
+
 //=============================================================================
 //		e3matrix4x4_extract3x3 : Select the upper left 3x3 of a 4x4 matrix
 //-----------------------------------------------------------------------------
@@ -557,8 +689,14 @@ e3matrix4x4_invert(TQ3Matrix4x4* a)
         // If necessary, exchange rows to put pivot element on diagonal
         if (irow != icol)
         {
+#if QUESA_USE_SIMD_MATH
+            E3Float4 rowI = e3float4_load(a->value[irow]);
+            e3float4_store(a->value[irow], e3float4_load(a->value[icol]));
+            e3float4_store(a->value[icol], rowI);
+#else
             for (j = 0; j < 4; ++j)
                 E3Float_Swap(A(irow,j), A(icol,j));
+#endif
         }
 
         // Divide pivot row by pivot element
@@ -569,8 +707,13 @@ e3matrix4x4_invert(TQ3Matrix4x4* a)
         // to pay for the extra floating-point operation.
         element = A(icol,icol);
         A(icol,icol) = 1.0f;    // overwrite original matrix with inverse
+#if QUESA_USE_SIMD_MATH
+        E3Float4 pivotRow = e3float4_div(e3float4_load(a->value[icol]), e3float4_splat(element));
+        e3float4_store(a->value[icol], pivotRow);
+#else
         for (j = 0; j < 4; ++j)
             A(icol,j) /= element;
+#endif
 
         // Reduce other rows
         for (i = 0; i < 4; ++i)
@@ -580,8 +723,13 @@ e3matrix4x4_invert(TQ3Matrix4x4* a)
 
             element = A(i,icol);
             A(i,icol) = 0.0f; // overwrite original matrix with inverse
+#if QUESA_USE_SIMD_MATH
+            e3float4_store(a->value[i], e3float4_sub(e3float4_load(a->value[i]),
+                e3float4_mul(pivotRow, e3float4_splat(element))));
+#else
             for (j = 0; j < 4; ++j)
                 A(i,j) -= A(icol,j)*element;
+#endif
         }
     }
     
@@ -2353,6 +2501,23 @@ E3Vector3D_To3DTransformArray(const TQ3Vector3D		*inVectors3D,
 {
 	TQ3Uns32 i;
 	
+#if QUESA_USE_SIMD_MATH
+	E3Float4	rows[4];
+	float		v[4];
+	e3float4_load_rows( *matrix4x4, rows );
+
+	for (i = 0; i < numVectors; ++i)
+	{
+		e3float4_store( v, e3float4_transform_vector( inVectors3D->x,
+			inVectors3D->y, inVectors3D->z, rows ) );
+		outVectors3D->x = v[0];
+		outVectors3D->y = v[1];
+		outVectors3D->z = v[2];
+
+		AdvanceConstPointer( inVectors3D, inStructSize );
+		AdvancePointer( outVectors3D, outStructSize );
+	}
+#else
 	for (i = 0; i < numVectors; ++i)
 	{
 		E3Vector3D_Transform(inVectors3D, matrix4x4, outVectors3D);
@@ -2360,6 +2525,7 @@ E3Vector3D_To3DTransformArray(const TQ3Vector3D		*inVectors3D,
 		AdvanceConstPointer( inVectors3D, inStructSize );
 		AdvancePointer( outVectors3D, outStructSize );
 	}
+#endif
 
 	return(kQ3Success);
 }
@@ -2484,6 +2650,23 @@ E3Point3D_To3DTransformArray(const TQ3Point3D		*inPoints3D,
 		(matrix4x4->value[1][3] == 0.0f) &&
 		(matrix4x4->value[2][3] == 0.0f) )
 	{
+#if QUESA_USE_SIMD_MATH
+		E3Float4	rows[4];
+		float		v[4];
+		e3float4_load_rows( *matrix4x4, rows );
+
+		for (i = 0; i < numPoints; ++i)
+		{
+			e3float4_store( v, e3float4_transform_point( inPoints3D->x,
+				inPoints3D->y, inPoints3D->z, rows ) );
+			outPoints3D->x = v[0];
+			outPoints3D->y = v[1];
+			outPoints3D->z = v[2];
+
+			AdvanceConstPointer( inPoints3D, inStructSize );
+			AdvancePointer( outPoints3D, outStructSize );
+		}
+#else
 		for (i = 0; i < numPoints; ++i)
 		{
 			E3Point3D_TransformAffine( inPoints3D, matrix4x4, outPoints3D );
@@ -2491,9 +2674,43 @@ E3Point3D_To3DTransformArray(const TQ3Point3D		*inPoints3D,
 			AdvanceConstPointer( inPoints3D, inStructSize );
 			AdvancePointer( outPoints3D, outStructSize );
 		}
+#endif
 	}
 	else
 	{
+#if QUESA_USE_SIMD_MATH
+		E3Float4	rows[4];
+		float		v[4];
+		e3float4_load_rows( *matrix4x4, rows );
+
+		// Transform the points, dividing through by w as E3Point3D_Transform does
+		for (i = 0; i < numPoints; ++i)
+		{
+			e3float4_store( v, e3float4_transform_point( inPoints3D->x,
+				inPoints3D->y, inPoints3D->z, rows ) );
+
+			if (v[3] == 0.0f)
+			{
+				E3ErrorManager_PostError( kQ3ErrorInfiniteRationalPoint, kQ3False );
+				v[3] = 1.0f;
+			}
+
+			if (v[3] != 1.0f)
+			{
+				float invw = 1.0f / v[3];
+				v[0] *= invw;
+				v[1] *= invw;
+				v[2] *= invw;
+			}
+
+			outPoints3D->x = v[0];
+			outPoints3D->y = v[1];
+			outPoints3D->z = v[2];
+
+			AdvanceConstPointer( inPoints3D, inStructSize );
+			AdvancePointer( outPoints3D, outStructSize );
+		}
+#else
 		// Transform the points - will be in-lined in release builds
 		for (i = 0; i < numPoints; ++i)
 		{
@@ -2502,6 +2719,7 @@ E3Point3D_To3DTransformArray(const TQ3Point3D		*inPoints3D,
 			AdvanceConstPointer( inPoints3D, inStructSize );
 			AdvancePointer( outPoints3D, outStructSize );
 		}
+#endif
 	}
 
 	return(kQ3Success);
@@ -2525,6 +2743,19 @@ E3Point3D_To4DTransformArray(const TQ3Point3D		*inPoints3D,
 {
 	TQ3Uns32 i;
 	
+#if QUESA_USE_SIMD_MATH
+	E3Float4	rows[4];
+	e3float4_load_rows( *matrix4x4, rows );
+
+	for (i = 0; i < numPoints; ++i)
+	{
+		e3float4_store( &outRationalPoints4D->x, e3float4_transform_point(
+			inPoints3D->x, inPoints3D->y, inPoints3D->z, rows ) );
+
+		AdvanceConstPointer( inPoints3D, inStructSize );
+		AdvancePointer( outRationalPoints4D, outStructSize );
+	}
+#else
 	for (i = 0; i < numPoints; ++i)
 	{
 		#define M(x,y) matrix4x4->value[x][y]
@@ -2537,6 +2768,7 @@ E3Point3D_To4DTransformArray(const TQ3Point3D		*inPoints3D,
 		AdvanceConstPointer( inPoints3D, inStructSize );
 		AdvancePointer( outRationalPoints4D, outStructSize );
 	}
+#endif
 
 	return(kQ3Success);
 }
@@ -2561,6 +2793,20 @@ E3RationalPoint4D_To4DTransformArray(const TQ3RationalPoint4D	*inRationalPoints4
 {
 	TQ3Uns32 i;
 	
+#if QUESA_USE_SIMD_MATH
+	E3Float4	rows[4];
+	e3float4_load_rows( *matrix4x4, rows );
+
+	for (i = 0; i < numPoints; ++i)
+	{
+		e3float4_store( &outRationalPoints4D->x, e3float4_transform_rational(
+			inRationalPoints4D->x, inRationalPoints4D->y,
+			inRationalPoints4D->z, inRationalPoints4D->w, rows ) );
+		
+		AdvanceConstPointer( inRationalPoints4D, inStructSize );
+		AdvancePointer( outRationalPoints4D, outStructSize );
+	}
+#else
 	for (i = 0; i < numPoints; ++i)
 	{
 		E3RationalPoint4D_Transform(inRationalPoints4D, matrix4x4, outRationalPoints4D);
@@ -2568,6 +2814,7 @@ E3RationalPoint4D_To4DTransformArray(const TQ3RationalPoint4D	*inRationalPoints4
 		AdvanceConstPointer( inRationalPoints4D, inStructSize );
 		AdvancePointer( outRationalPoints4D, outStructSize );
 	}
+#endif
 
 	return(kQ3Success);
 }
@@ -3592,6 +3839,18 @@ E3Matrix4x4_Multiply(const TQ3Matrix4x4 *m1, const TQ3Matrix4x4 *m2, TQ3Matrix4x
 	TQ3Matrix4x4 temp;
 	TQ3Matrix4x4* output = (result == m1 || result == m2 ? &temp : result);
 	
+#if QUESA_USE_SIMD_MATH
+	// Each row of the product is the corresponding row of m1 times m2
+	E3Float4	rows[4];
+	e3float4_load_rows( *m2, rows );
+	
+	for (int i = 0; i < 4; ++i)
+	{
+		e3float4_store( output->value[i], e3float4_transform_rational(
+			m1->value[i][0], m1->value[i][1], m1->value[i][2], m1->value[i][3],
+			rows ) );
+	}
+#else
 	#define A(x,y)	m1->value[x][y]
 	#define B(x,y)	m2->value[x][y]
 	#define M(x,y)	output->value[x][y]
@@ -3619,6 +3878,7 @@ E3Matrix4x4_Multiply(const TQ3Matrix4x4 *m1, const TQ3Matrix4x4 *m2, TQ3Matrix4x
 	#undef A
 	#undef B
 	#undef M
+#endif
 
 	if (output == &temp)
 		*result = temp;
@@ -4075,10 +4335,31 @@ E3Quaternion_Multiply(const TQ3Quaternion *q1, const TQ3Quaternion *q2, TQ3Quate
     */
 
 	// Reverse multiplication (q2 * q1)
+#if QUESA_USE_SIMD_MATH
+	// Lanes are (w, x, y, z), matching the layout of TQ3Quaternion. The
+	// sign of the second and fourth products is flipped in the w lane only;
+	// negation is exact, so this rounds just like the scalar expressions.
+	const E3Float4	wSign = e3float4_set( -1.0f, 1.0f, 1.0f, 1.0f );
+	
+	E3Float4	t0 = e3float4_mul( e3float4_splat( q1->w ),
+					e3float4_load( &q2->w ) );
+	E3Float4	t1 = e3float4_mul( e3float4_set( q1->x, q1->x, q1->y, q1->z ),
+					e3float4_set( q2->x, q2->w, q2->w, q2->w ) );
+	E3Float4	t2 = e3float4_mul( e3float4_set( q1->y, q1->y, q1->z, q1->x ),
+					e3float4_set( q2->y, q2->z, q2->x, q2->y ) );
+	E3Float4	t3 = e3float4_mul( e3float4_set( q1->z, q1->z, q1->x, q1->y ),
+					e3float4_set( q2->z, q2->y, q2->z, q2->x ) );
+	
+	E3Float4	v = e3float4_add( t0, e3float4_mul( t1, wSign ) );
+	v = e3float4_sub( v, t2 );
+	v = e3float4_add( v, e3float4_mul( t3, wSign ) );
+	e3float4_store( &output->w, v );
+#else
 	output->w = q1->w*q2->w - q1->x*q2->x - q1->y*q2->y - q1->z*q2->z;
 	output->x = q1->w*q2->x + q1->x*q2->w - q1->y*q2->z + q1->z*q2->y;
 	output->y = q1->w*q2->y + q1->y*q2->w - q1->z*q2->x + q1->x*q2->z;
 	output->z = q1->w*q2->z + q1->z*q2->w - q1->x*q2->y + q1->y*q2->x;
+#endif
 	
 	if (output == &temp)
 		*result = temp;
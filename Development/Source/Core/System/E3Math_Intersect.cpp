@@ -3312,3 +3312,172 @@ bool	E3BoundingBox_Intersect( const TQ3BoundingBox& inBox1,
 	
 	return outSect.isEmpty == kQ3False;
 }
+
+
+/*!
+	@function	E3RayPacket_Set
+	@abstract	Fill a ray packet from an array of rays.
+	@param		outPacket		Receives the rays, with tMax set to kQ3MaxFloat.
+	@param		numRays			The number of rays, at most kE3RayPacketSize.
+	@param		theRays			The rays.
+*/
+void			E3RayPacket_Set( TE3RayPacket& outPacket,
+								TQ3Uns32 numRays,
+								const TQ3Ray3D* theRays )
+{
+	Q3_ASSERT( numRays <= kE3RayPacketSize );
+	outPacket.numRays = numRays;
+	
+	for (TQ3Uns32 i = 0; i < kE3RayPacketSize; ++i)
+	{
+		// Unused lanes repeat the first ray, so they never produce NaNs
+		const TQ3Ray3D& theRay( theRays[ (i < numRays)? i : 0 ] );
+		
+		outPacket.originX[i] = theRay.origin.x;
+		outPacket.originY[i] = theRay.origin.y;
+		outPacket.originZ[i] = theRay.origin.z;
+		
+		outPacket.directionX[i] = theRay.direction.x;
+		outPacket.directionY[i] = theRay.direction.y;
+		outPacket.directionZ[i] = theRay.direction.z;
+		
+		// A huge finite value stands in for the reciprocal of zero, so that
+		// a ray lying in a slab plane gives 0 rather than NaN
+		outPacket.invDirectionX[i] = (theRay.direction.x != 0.0f)? 1.0f / theRay.direction.x : kQ3MaxFloat;
+		outPacket.invDirectionY[i] = (theRay.direction.y != 0.0f)? 1.0f / theRay.direction.y : kQ3MaxFloat;
+		outPacket.invDirectionZ[i] = (theRay.direction.z != 0.0f)? 1.0f / theRay.direction.z : kQ3MaxFloat;
+		
+		outPacket.tMax[i] = kQ3MaxFloat;
+	}
+}
+
+
+/*!
+	@function	E3RayPacket_IntersectBoundingBox
+	@abstract	Find which rays of a packet hit a bounding box.
+	@discussion	Uses the slab method on every lane at once.
+	@param		inPacket		A ray packet.
+	@param		inBounds		A bounding box.
+	@result		A mask with bit n set if ray n hits the box.
+*/
+TQ3Uns32		E3RayPacket_IntersectBoundingBox( const TE3RayPacket& inPacket,
+								const TQ3BoundingBox& inBounds )
+{
+	if (inBounds.isEmpty)
+		return 0;
+	
+	TQ3Uns32	hitMask = 0;
+	
+	for (TQ3Uns32 i = 0; i < kE3RayPacketSize; ++i)
+	{
+		float t1 = (inBounds.min.x - inPacket.originX[i]) * inPacket.invDirectionX[i];
+		float t2 = (inBounds.max.x - inPacket.originX[i]) * inPacket.invDirectionX[i];
+		float tNear = E3Num_Min( t1, t2 );
+		float tFar = E3Num_Max( t1, t2 );
+		
+		t1 = (inBounds.min.y - inPacket.originY[i]) * inPacket.invDirectionY[i];
+		t2 = (inBounds.max.y - inPacket.originY[i]) * inPacket.invDirectionY[i];
+		tNear = E3Num_Max( tNear, E3Num_Min( t1, t2 ) );
+		tFar = E3Num_Min( tFar, E3Num_Max( t1, t2 ) );
+		
+		t1 = (inBounds.min.z - inPacket.originZ[i]) * inPacket.invDirectionZ[i];
+		t2 = (inBounds.max.z - inPacket.originZ[i]) * inPacket.invDirectionZ[i];
+		tNear = E3Num_Max( tNear, E3Num_Min( t1, t2 ) );
+		tFar = E3Num_Min( tFar, E3Num_Max( t1, t2 ) );
+		
+		TQ3Uns32 didHit = (tNear <= tFar) & (tFar >= 0.0f) & (tNear <= inPacket.tMax[i]);
+		hitMask |= didHit << i;
+	}
+	
+	return hitMask & ((1U << inPacket.numRays) - 1);
+}
+
+
+/*!
+	@function	E3RayPacket_IntersectTriangle
+	@abstract	Find which rays of a packet hit a triangle.
+	@discussion	Follows E3Ray3D_IntersectTriangle step for step, but works
+				out every lane before masking off the misses.
+	@param		inPacket		A ray packet.
+	@param		inLaneMask		Mask of the rays to test.
+	@param		point1			A point (a vertex of a triangle).
+	@param		point2			A point (a vertex of a triangle).
+	@param		point3			A point (a vertex of a triangle).
+	@param		cullBackfacing	Whether to omit a hit on the back face.
+	@param		outHits			Receives intersection data for each ray
+								which hits.
+	@result		A mask with bit n set if ray n hits the triangle.
+*/
+TQ3Uns32		E3RayPacket_IntersectTriangle( const TE3RayPacket& inPacket,
+								TQ3Uns32 inLaneMask,
+								const TQ3Point3D& point1,
+								const TQ3Point3D& point2,
+								const TQ3Point3D& point3,
+								TQ3Boolean cullBackfacing,
+								TQ3Param3D outHits[kE3RayPacketSize] )
+{
+	// Calculate the two edges which share vertex 1
+	const TQ3Vector3D edge1 = point2 - point1;
+	const TQ3Vector3D edge2 = point3 - point1;
+	
+	
+	// E3Ray3D_IntersectTriangle falls back to the determinant against the
+	// unit face normal when the raw determinant is tiny.  Since that is
+	// the raw determinant divided by the length of the face normal, we
+	// only need the reciprocal of that length.
+	const float normalLength = Q3Length3D( Q3Cross3D( edge2, edge1 ) );
+	if (normalLength == 0.0f)
+		return 0;
+	const float invNormalLength = 1.0f / normalLength;
+	
+	
+	float		u[kE3RayPacketSize], v[kE3RayPacketSize], w[kE3RayPacketSize];
+	TQ3Uns32	hitMask = 0;
+	
+	for (TQ3Uns32 i = 0; i < kE3RayPacketSize; ++i)
+	{
+		// pvec = direction x edge2
+		float pX = inPacket.directionY[i] * edge2.z - inPacket.directionZ[i] * edge2.y;
+		float pY = inPacket.directionZ[i] * edge2.x - inPacket.directionX[i] * edge2.z;
+		float pZ = inPacket.directionX[i] * edge2.y - inPacket.directionY[i] * edge2.x;
+		
+		float det = edge1.x * pX + edge1.y * pY + edge1.z * pZ;
+		float testDet = (fabsf( det ) < kQ3RealZero)? det * invNormalLength : det;
+		float invDet = 1.0f / det;
+		
+		// tvec = origin - point1
+		float tX = inPacket.originX[i] - point1.x;
+		float tY = inPacket.originY[i] - point1.y;
+		float tZ = inPacket.originZ[i] - point1.z;
+		
+		// qvec = tvec x edge1
+		float qX = tY * edge1.z - tZ * edge1.y;
+		float qY = tZ * edge1.x - tX * edge1.z;
+		float qZ = tX * edge1.y - tY * edge1.x;
+		
+		u[i] = (tX * pX + tY * pY + tZ * pZ) * invDet;
+		v[i] = (inPacket.directionX[i] * qX + inPacket.directionY[i] * qY + inPacket.directionZ[i] * qZ) * invDet;
+		w[i] = (edge2.x * qX + edge2.y * qY + edge2.z * qZ) * invDet;
+		
+		TQ3Uns32 facesRay = cullBackfacing? (testDet >= kQ3RealZero) :
+			((testDet <= -kQ3RealZero) | (testDet >= kQ3RealZero));
+		
+		TQ3Uns32 didHit = facesRay & (u[i] >= 0.0f) & (v[i] >= 0.0f) & (u[i] + v[i] <= 1.0f) &
+			(w[i] >= 0.0f) & (w[i] < inPacket.tMax[i]);
+		hitMask |= didHit << i;
+	}
+	
+	hitMask &= inLaneMask & ((1U << inPacket.numRays) - 1);
+	
+	for (TQ3Uns32 i = 0; i < kE3RayPacketSize; ++i)
+	{
+		if ((hitMask & (1U << i)) != 0)
+		{
+			outHits[i].u = u[i];
+			outHits[i].v = v[i];
+			outHits[i].w = w[i];
+		}
+	}
+	
+	return hitMask;
+}
@@ -368,4 +368,88 @@ bool	E3BoundingBox_Intersect( const TQ3BoundingBox& inBox1,
 								const TQ3BoundingBox& inBox2,
 								TQ3BoundingBox& outSect );
 
+
+
+/*!
+	@constant	kE3RayPacketSize
+	@abstract	Number of rays tested together in a TE3RayPacket.
+*/
+#define kE3RayPacketSize		8
+
+
+/*!
+	@struct		TE3RayPacket
+	@abstract	A group of rays, stored a component at a time.
+	@discussion	Laid out so that the packet tests below run the same
+				arithmetic across every ray, which compilers turn into vector
+				code.  Lanes at and beyond numRays are unused.
+				
+				tMax holds, for each ray, the distance beyond which hits are
+				of no interest; callers shrink it as nearer hits are found.
+*/
+typedef struct TE3RayPacket {
+	TQ3Uns32		numRays;
+	float			originX[kE3RayPacketSize];
+	float			originY[kE3RayPacketSize];
+	float			originZ[kE3RayPacketSize];
+	float			directionX[kE3RayPacketSize];
+	float			directionY[kE3RayPacketSize];
+	float			directionZ[kE3RayPacketSize];
+	float			invDirectionX[kE3RayPacketSize];
+	float			invDirectionY[kE3RayPacketSize];
+	float			invDirectionZ[kE3RayPacketSize];
+	float			tMax[kE3RayPacketSize];
+} TE3RayPacket;
+
+
+/*!
+	@function	E3RayPacket_Set
+	@abstract	Fill a ray packet from an array of rays.
+	@param		outPacket		Receives the rays, with tMax set to kQ3MaxFloat.
+	@param		numRays			The number of rays, at most kE3RayPacketSize.
+	@param		theRays			The rays.
+*/
+void			E3RayPacket_Set( TE3RayPacket& outPacket,
+								TQ3Uns32 numRays,
+								const TQ3Ray3D* theRays );
+
+
+/*!
+	@function	E3RayPacket_IntersectBoundingBox
+	@abstract	Find which rays of a packet hit a bounding box.
+	@discussion	The packet form of E3Ray3D_IntersectBoundingBox.  A ray hits
+				if it enters the box at a distance no greater than its tMax;
+				rays starting inside the box always hit.
+	@param		inPacket		A ray packet.
+	@param		inBounds		A bounding box.
+	@result		A mask with bit n set if ray n hits the box.
+*/
+TQ3Uns32		E3RayPacket_IntersectBoundingBox( const TE3RayPacket& inPacket,
+								const TQ3BoundingBox& inBounds );
+
+
+/*!
+	@function	E3RayPacket_IntersectTriangle
+	@abstract	Find which rays of a packet hit a triangle.
+	@discussion	The packet form of E3Ray3D_IntersectTriangle, giving the same
+				results for each ray.  Hits at or beyond a ray's tMax are
+				ignored.
+	@param		inPacket		A ray packet.
+	@param		inLaneMask		Mask of the rays to test.
+	@param		point1			A point (a vertex of a triangle).
+	@param		point2			A point (a vertex of a triangle).
+	@param		point3			A point (a vertex of a triangle).
+	@param		cullBackfacing	Whether to omit a hit on the back face.
+	@param		outHits			Receives intersection data for each ray
+								which hits, as for E3Ray3D_IntersectTriangle.
+	@result		A mask with bit n set if ray n hits the triangle.
+*/
+TQ3Uns32		E3RayPacket_IntersectTriangle( const TE3RayPacket& inPacket,
+								TQ3Uns32 inLaneMask,
+								const TQ3Point3D& point1,
+								const TQ3Point3D& point2,
+								const TQ3Point3D& point3,
+								TQ3Boolean cullBackfacing,
+								TQ3Param3D outHits[kE3RayPacketSize] );
+
 #endif
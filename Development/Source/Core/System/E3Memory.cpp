@@ -54,6 +54,8 @@
 #include "E3Memory.h"
 #include "E3StackCrawl.h"
 #include "E3String.h"
+#include "E3FrameArena.h"
+#include "E3MemoryPool.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -86,6 +88,12 @@
 #define Q3_MIN_SIZE_TO_LOG		5000000UL
 
 
+// Serve small blocks from the size-class pools in E3MemoryPool.cpp
+#ifndef Q3_MEMORY_POOLS
+	#define Q3_MEMORY_POOLS									0
+#endif
+
+
 // Slab threshold
 const TQ3Uns32 kSlabSmallItemSize						= 256;
 const TQ3Uns32 kSlabSmallGrowSize						= 16 * 1024;
@@ -135,8 +143,11 @@ public :
 //-----------------------------------------------------------------------------
 static std::atomic_int32_t		sActiveAllocCount( 0 );
 static std::atomic_int32_t		sMaxAllocCount( 0 );
+static std::atomic_uint32_t		sTotalAllocCount( 0 );
 static std::atomic_int64_t		sActiveAllocBytes( 0 );
 static std::atomic_int64_t		sMaxAllocBytes( 0 );
+static std::atomic_int64_t		sPoolAllocBytes( 0 );
+static std::atomic_int64_t		sMaxPoolAllocBytes( 0 );
 
 
 
@@ -252,6 +263,13 @@ e3Int64_Max( const TQ3Int64& a, const TQ3Int64& b )
 static TQ3Uns32 e3memGetSize( const void* inMemBlock )
 {
 	TQ3Uns32 theSize = 0;
+#if Q3_MEMORY_POOLS
+	if (E3MemoryPool_Owns( inMemBlock ))
+	{
+		theSize = E3MemoryPool_GetBlockSize( inMemBlock );
+	}
+	else
+#endif
 	if (inMemBlock != nullptr)
 	{
 #if QUESA_OS_MACINTOSH
@@ -267,6 +285,56 @@ static TQ3Uns32 e3memGetSize( const void* inMemBlock )
 
 
 
+#if Q3_MEMORY_DEBUG
+//=============================================================================
+//      e3memNoteAllocation : Update statistics for a new block.
+//-----------------------------------------------------------------------------
+static void e3memNoteAllocation( const void* inMemBlock )
+{
+	TQ3Uns32 theSize = e3memGetSize( inMemBlock );
+	
+	sActiveAllocCount += 1;
+	sTotalAllocCount += 1;
+	sMaxAllocCount = E3Num_Max( static_cast<int32_t>(sMaxAllocCount), static_cast<int32_t>(sActiveAllocCount) );
+	sActiveAllocBytes += theSize;
+	sMaxAllocBytes = E3Num_Max( static_cast<int64_t>(sMaxAllocBytes), static_cast<int64_t>(sActiveAllocBytes) );
+
+#if Q3_MEMORY_POOLS
+	if (E3MemoryPool_Owns( inMemBlock ))
+	{
+		sPoolAllocBytes += theSize;
+		sMaxPoolAllocBytes = E3Num_Max( static_cast<int64_t>(sMaxPoolAllocBytes), static_cast<int64_t>(sPoolAllocBytes) );
+	}
+#endif
+}
+
+
+
+
+
+//=============================================================================
+//      e3memNoteFree : Update statistics for a block about to be freed.
+//-----------------------------------------------------------------------------
+static void e3memNoteFree( const void* inMemBlock )
+{
+	TQ3Uns32 theSize = e3memGetSize( inMemBlock );
+	
+	sActiveAllocCount -= 1;
+	sActiveAllocBytes -= theSize;
+
+#if Q3_MEMORY_POOLS
+	if (E3MemoryPool_Owns( inMemBlock ))
+	{
+		sPoolAllocBytes -= theSize;
+	}
+#endif
+}
+#endif
+
+
+
+
+
 #if Q3_DEBUG
 //=============================================================================
 //      SetDirectoryForDump : If a plain file name was passed to
@@ -345,6 +413,25 @@ E3Memory_UnregisterClass(void)
 
 
 
+//=============================================================================
+//      E3Memory_ReleasePools : Return the small-block pools to the system.
+//-----------------------------------------------------------------------------
+//		Note :	Called by Q3Exit once everything else has been torn down. If
+//				any pooled block is still in use, e.g., a leaked object, the
+//				pools are kept.
+//-----------------------------------------------------------------------------
+void
+E3Memory_ReleasePools(void)
+{
+#if Q3_MEMORY_POOLS
+	E3MemoryPool_Release();
+#endif
+}
+
+
+
+
+
 //=============================================================================
 //      E3Memory_Allocate : Allocate an uninitialised block of memory.
 //-----------------------------------------------------------------------------
@@ -361,23 +448,21 @@ E3Memory_Allocate(TQ3Uns32 theSize)
 	}
 	else
 	{
-		// Allocate the memory and a header to hold the size
-		thePtr = malloc( theSize );
+		// Small blocks come from the pools, anything else from the system
+#if Q3_MEMORY_POOLS
+		thePtr = E3MemoryPool_Allocate( theSize );
+		if (thePtr == nullptr)
+#endif
+			thePtr = malloc( theSize );
 		if (thePtr == nullptr)
 			E3ErrorManager_PostError(kQ3ErrorOutOfMemory, kQ3False);
 	}
 
 
-	// If memory debugging is active, save the size and scrub the block
+	// If memory debugging is active, update statistics
 #if Q3_MEMORY_DEBUG
 	if (thePtr != nullptr)
-	{
-		// Update statistics
-		sActiveAllocCount += 1;
-		sMaxAllocCount = E3Num_Max( static_cast<int32_t>(sMaxAllocCount), static_cast<int32_t>(sActiveAllocCount) );
-		sActiveAllocBytes += e3memGetSize( thePtr );
-		sMaxAllocBytes = E3Num_Max( static_cast<int64_t>(sMaxAllocBytes), static_cast<int64_t>(sActiveAllocBytes) );
-	}
+		e3memNoteAllocation( thePtr );
 #endif
 
 #if Q3_MEMORY_DEBUG
@@ -411,22 +496,28 @@ E3Memory_AllocateClear(TQ3Uns32 theSize)
 	//
 	// These platforms can allocate pages in an uninitialised state, and only
 	// clear them to 0 if an application attempts to read before writing.
-	thePtr = calloc( 1, theSize );
+	//
+	// That does not apply to small blocks, which come from the pools.
+	thePtr = nullptr;
+#if Q3_MEMORY_POOLS
+	if (theSize != 0)
+	{
+		thePtr = E3MemoryPool_Allocate( theSize );
+		if (thePtr != nullptr)
+			memset( thePtr, 0, theSize );
+	}
+	if (thePtr == nullptr)
+#endif
+		thePtr = calloc( 1, theSize );
 	if (thePtr == nullptr)
 		E3ErrorManager_PostError(kQ3ErrorOutOfMemory, kQ3False);
 
 
 
-	// If memory debugging is active, save the size
+	// If memory debugging is active, update statistics
 #if Q3_MEMORY_DEBUG
 	if (thePtr != nullptr)
-		{
-		// Update statistics
-		sActiveAllocCount += 1;
-		sMaxAllocCount = E3Num_Max( static_cast<int32_t>(sMaxAllocCount), static_cast<int32_t>(sActiveAllocCount) );
-		sActiveAllocBytes += e3memGetSize( thePtr );
-		sMaxAllocBytes = E3Num_Max( static_cast<int64_t>(sMaxAllocBytes), static_cast<int64_t>(sActiveAllocBytes) );
-		}
+		e3memNoteAllocation( thePtr );
 #endif
 
 #if Q3_MEMORY_DEBUG
@@ -471,12 +562,16 @@ E3Memory_Free(void **thePtr)
 
 #if Q3_MEMORY_DEBUG
 		// Update statistics
-		sActiveAllocCount -= 1;
-		sActiveAllocBytes -= e3memGetSize( realPtr );
+		e3memNoteFree( realPtr );
 #endif
 
 		// Free the pointer
-		free(realPtr);
+#if Q3_MEMORY_POOLS
+		if (E3MemoryPool_Owns( realPtr ))
+			E3MemoryPool_Free( realPtr );
+		else
+#endif
+			free(realPtr);
 		*thePtr = nullptr;
 	}
 }
@@ -523,6 +618,28 @@ E3Memory_Reallocate(void **thePtr, TQ3Uns32 newSize)
 		qd3dStatus = kQ3Success;
 	}
 	
+#if Q3_MEMORY_POOLS
+	else if ( (realPtr != nullptr) && E3MemoryPool_Owns( realPtr ) )
+	{
+		// A pooled block can stay put if it is still big enough, otherwise
+		// it moves to a block of another size class or to the system heap.
+		TQ3Uns32 blockSize = E3MemoryPool_GetBlockSize( realPtr );
+		qd3dStatus = kQ3Success;
+		if (newSize > blockSize)
+		{
+			newPtr = E3Memory_Allocate( newSize );
+			if (newPtr != nullptr)
+			{
+				memcpy( newPtr, realPtr, blockSize );
+				E3Memory_Free( thePtr );
+				*thePtr = newPtr;
+			}
+			else
+				qd3dStatus = kQ3Failure;
+		}
+	}
+#endif
+
 	else	// newSize != 0
 	{
 	#if Q3_MEMORY_DEBUG
@@ -554,6 +671,7 @@ E3Memory_Reallocate(void **thePtr, TQ3Uns32 newSize)
 			if (realPtr == nullptr) // actually an allocation?
 			{
 				sActiveAllocCount += 1;
+				sTotalAllocCount += 1;
 				if (actualNewSize > Q3_MIN_SIZE_TO_LOG)
 				{
 					Q3_MESSAGE_FMT("Realloced ptr %p of size %lu", realPtr, (unsigned long)actualNewSize );
@@ -936,7 +1054,8 @@ TQ3Status		E3Memory_GetStatistics( TQ3MemoryStatistics* info )
 	#if Q3_MEMORY_DEBUG
 		TQ3Status	theResult;
 
-		if (info->structureVersion == kQ3MemoryStatisticsStructureVersion)
+		if ( (info->structureVersion >= 1) &&
+			(info->structureVersion <= kQ3MemoryStatisticsStructureVersion) )
 		{
 			info->currentAllocations = sActiveAllocCount;
 			int64_t activeAllocBytes = sActiveAllocBytes;
@@ -947,6 +1066,33 @@ TQ3Status		E3Memory_GetStatistics( TQ3MemoryStatistics* info )
 			info->maxBytes.hi = (maxAllocBytes >> 32);
 			info->maxAllocations = sMaxAllocCount;
 			
+			if (info->structureVersion >= 2)
+			{
+				info->totalAllocations = sTotalAllocCount;
+				int64_t scratchBytes;
+				E3FrameArena_GetStatistics( info->frameScratchAllocations,
+					scratchBytes );
+				info->frameScratchBytes.lo = scratchBytes & 0xFFFFFFFF;
+				info->frameScratchBytes.hi = (scratchBytes >> 32);
+			}
+			
+			if (info->structureVersion >= 3)
+			{
+			#if Q3_MEMORY_POOLS
+				int64_t poolReserved = E3MemoryPool_GetReservedBytes();
+			#else
+				int64_t poolReserved = 0;
+			#endif
+				info->poolReservedBytes.lo = poolReserved & 0xFFFFFFFF;
+				info->poolReservedBytes.hi = (poolReserved >> 32);
+				int64_t poolBytes = sPoolAllocBytes;
+				info->poolBytes.lo = poolBytes & 0xFFFFFFFF;
+				info->poolBytes.hi = (poolBytes >> 32);
+				int64_t maxPoolBytes = sMaxPoolAllocBytes;
+				info->maxPoolBytes.lo = maxPoolBytes & 0xFFFFFFFF;
+				info->maxPoolBytes.hi = (maxPoolBytes >> 32);
+			}
+			
 			theResult = kQ3Success;
 		}
 		else
@@ -75,6 +75,7 @@ extern "C" {
 //-----------------------------------------------------------------------------
 TQ3Status	E3Memory_RegisterClass(void);
 TQ3Status	E3Memory_UnregisterClass(void);
+void		E3Memory_ReleasePools(void);
 
 void		*E3Memory_Allocate(TQ3Uns32 theSize);
 void		*E3Memory_AllocateClear(TQ3Uns32 theSize);
@@ -0,0 +1,606 @@
+/*  NAME:
+        E3MemoryPool.cpp
+
+    DESCRIPTION:
+        Thread-caching size-class allocator for small blocks.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3MemoryPool.h"
+
+#include <atomic>
+#include <mutex>
+#include <stdlib.h>
+
+
+
+
+
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+namespace
+{
+	const uintptr_t	kSpanSize			= 64 * 1024;
+	const uintptr_t	kSpanMask			= ~(kSpanSize - 1);
+	const TQ3Uns32	kSpansPerSuperblock	= 16;
+	const TQ3Uns32	kSpanHeaderSize		= 16;
+	const TQ3Uns32	kSpanMagic			= 0x51335370;	// 'Q3Sp'
+	
+	// Size of the table of span addresses.  Must be a power of 2, and allows
+	// for at most half that many spans, i.e., 2 GB of pooled memory.
+	const TQ3Uns32	kSpanTableSize		= 64 * 1024;
+	const TQ3Uns32	kMaxSpans			= kSpanTableSize / 2;
+	const TQ3Uns32	kMaxSuperblocks		= kMaxSpans / kSpansPerSuperblock;
+	
+	// Number of blocks moved between a thread cache and the depot at once.
+	const TQ3Uns32	kTransferBatch		= 32;
+	
+	const TQ3Uns32	kClassSizes[] =
+	{
+		16, 32, 48, 64, 80, 96, 112, 128,
+		160, 192, 224, 256,
+		320, 384, 448, 512
+	};
+	const TQ3Uns32	kNumClasses = sizeof(kClassSizes) / sizeof(kClassSizes[0]);
+}
+
+
+
+
+
+//=============================================================================
+//      Internal types
+//-----------------------------------------------------------------------------
+namespace
+{
+	struct FreeBlock
+	{
+		FreeBlock*		next;
+	};
+	
+	struct SpanHeader
+	{
+		TQ3Uns32		magic;
+		TQ3Uns32		classIndex;
+	};
+	
+	// Blocks not cached by any thread, for one size class.
+	struct ClassDepot
+	{
+		std::mutex		lock;
+		FreeBlock*		freeList;
+		TQ3Uns32		freeCount;
+		
+		// Uncarved remainder of the newest span of this class
+		TQ3Uns8*		carveNext;
+		TQ3Uns8*		carveEnd;
+	};
+	
+	struct ThreadCache
+	{
+						ThreadCache();
+						~ThreadCache();
+		
+		FreeBlock*		freeList[ kNumClasses ];
+		TQ3Uns32		freeCount[ kNumClasses ];
+		TQ3Uns32		generation;		// pools the lists belong to
+	};
+	
+	struct PoolGlobals
+	{
+		ClassDepot				depots[ kNumClasses ];
+		
+		std::mutex				spanLock;
+		TQ3Uns8*				superNext;		// next unused span
+		TQ3Uns32				superRemaining;	// spans left in superblock
+		TQ3Uns32				numSpans;
+		std::atomic<uintptr_t>	spanTable[ kSpanTableSize ];
+		std::atomic<int64_t>	reservedBytes;
+		
+		// Blocks from malloc, so that E3MemoryPool_Release can free them
+		TQ3Uns8*				superBlocks[ kMaxSuperblocks ];
+		TQ3Uns32				numSuperBlocks;
+		
+		// Blocks handed out and not yet freed
+		std::atomic<int64_t>	liveBlocks;
+		
+		// Bumped when the pools are released, so that thread caches know
+		// to drop their lists
+		std::atomic<TQ3Uns32>	generation;
+	};
+}
+
+
+
+
+
+//=============================================================================
+//      Internal static variables
+//-----------------------------------------------------------------------------
+// Lifetime of the thread cache.  Blocks freed after the cache is destroyed,
+// during thread or process teardown, go straight to the depot.
+enum ECacheState
+{
+	kCacheNotMade,
+	kCacheAlive,
+	kCacheDestroyed
+};
+static thread_local ECacheState		tCacheState = kCacheNotMade;
+
+
+
+
+
+//=============================================================================
+//      Internal functions
+//-----------------------------------------------------------------------------
+//		Globals are created on first use and never destroyed, since blocks may
+//		be freed by static destructors in any order.
+//-----------------------------------------------------------------------------
+static PoolGlobals& GetGlobals()
+{
+	static PoolGlobals* sGlobals = []()
+	{
+		PoolGlobals* theGlobals = new PoolGlobals;
+		for (ClassDepot& depot : theGlobals->depots)
+		{
+			depot.freeList = nullptr;
+			depot.freeCount = 0;
+			depot.carveNext = nullptr;
+			depot.carveEnd = nullptr;
+		}
+		theGlobals->superNext = nullptr;
+		theGlobals->superRemaining = 0;
+		theGlobals->numSpans = 0;
+		for (std::atomic<uintptr_t>& entry : theGlobals->spanTable)
+		{
+			entry.store( 0, std::memory_order_relaxed );
+		}
+		theGlobals->reservedBytes.store( 0 );
+		theGlobals->numSuperBlocks = 0;
+		theGlobals->liveBlocks.store( 0 );
+		theGlobals->generation.store( 0 );
+		return theGlobals;
+	}();
+	return *sGlobals;
+}
+
+static inline TQ3Uns32 SpanHash( uintptr_t inSpanBase )
+{
+	return static_cast<TQ3Uns32>( (inSpanBase / kSpanSize) * 2654435761U ) &
+		(kSpanTableSize - 1);
+}
+
+static inline TQ3Uns32 SizeToClass( TQ3Uns32 inSize )
+{
+	if (inSize <= 128)
+	{
+		return (inSize == 0)? 0 : (inSize - 1) / 16;
+	}
+	else if (inSize <= 256)
+	{
+		return 8 + (inSize - 129) / 32;
+	}
+	else
+	{
+		return 12 + (inSize - 257) / 64;
+	}
+}
+
+static const SpanHeader* FindSpan( const void* inBlock )
+{
+	uintptr_t	spanBase = reinterpret_cast<uintptr_t>( inBlock ) & kSpanMask;
+	
+	// A block never starts at the span base, since the header is there.
+	if ( (inBlock == nullptr) || (spanBase == reinterpret_cast<uintptr_t>( inBlock )) )
+	{
+		return nullptr;
+	}
+	
+	PoolGlobals&	globals( GetGlobals() );
+	TQ3Uns32		slot = SpanHash( spanBase );
+	
+	for (;;)
+	{
+		uintptr_t entry = globals.spanTable[ slot ].load( std::memory_order_acquire );
+		if (entry == spanBase)
+		{
+			return reinterpret_cast<const SpanHeader*>( spanBase );
+		}
+		if (entry == 0)
+		{
+			return nullptr;
+		}
+		slot = (slot + 1) & (kSpanTableSize - 1);
+	}
+}
+
+static TQ3Uns8* NewSpan( TQ3Uns32 inClassIndex )
+{
+	PoolGlobals&				globals( GetGlobals() );
+	std::lock_guard<std::mutex>	guard( globals.spanLock );
+	
+	if (globals.numSpans >= kMaxSpans)
+	{
+		return nullptr;
+	}
+	
+	if (globals.superRemaining == 0)
+	{
+		// Over-allocate so that the spans can be aligned to their size.
+		const size_t kSuperSize = (kSpansPerSuperblock + 1) * kSpanSize;
+		TQ3Uns8* superBlock = static_cast<TQ3Uns8*>( malloc( kSuperSize ) );
+		if (superBlock == nullptr)
+		{
+			return nullptr;
+		}
+		globals.superBlocks[ globals.numSuperBlocks++ ] = superBlock;
+		globals.reservedBytes += kSuperSize;
+		uintptr_t aligned = (reinterpret_cast<uintptr_t>( superBlock ) +
+			kSpanSize - 1) & kSpanMask;
+		globals.superNext = reinterpret_cast<TQ3Uns8*>( aligned );
+		globals.superRemaining = kSpansPerSuperblock;
+	}
+	
+	TQ3Uns8* theSpan = globals.superNext;
+	globals.superNext += kSpanSize;
+	globals.superRemaining -= 1;
+	globals.numSpans += 1;
+	
+	SpanHeader* header = reinterpret_cast<SpanHeader*>( theSpan );
+	header->magic = kSpanMagic;
+	header->classIndex = inClassIndex;
+	
+	// Publish the span so that E3MemoryPool_Owns can find it.
+	uintptr_t	spanBase = reinterpret_cast<uintptr_t>( theSpan );
+	TQ3Uns32	slot = SpanHash( spanBase );
+	while (globals.spanTable[ slot ].load( std::memory_order_relaxed ) != 0)
+	{
+		slot = (slot + 1) & (kSpanTableSize - 1);
+	}
+	globals.spanTable[ slot ].store( spanBase, std::memory_order_release );
+	
+	return theSpan;
+}
+
+/*!
+	@function	FetchBlocks
+	@abstract	Take up to inMaxCount blocks of a size class from the depot,
+				carving a new span if the depot is empty.
+	@result		Linked list of blocks, or nullptr.
+*/
+static FreeBlock* FetchBlocks( TQ3Uns32 inClassIndex, TQ3Uns32 inMaxCount,
+								TQ3Uns32& outCount )
+{
+	ClassDepot&					depot( GetGlobals().depots[ inClassIndex ] );
+	std::lock_guard<std::mutex>	guard( depot.lock );
+	const TQ3Uns32				kBlockSize = kClassSizes[ inClassIndex ];
+	FreeBlock*					theList = nullptr;
+	
+	outCount = 0;
+	
+	while ( (outCount < inMaxCount) && (depot.freeList != nullptr) )
+	{
+		FreeBlock* theBlock = depot.freeList;
+		depot.freeList = theBlock->next;
+		depot.freeCount -= 1;
+		theBlock->next = theList;
+		theList = theBlock;
+		outCount += 1;
+	}
+	
+	while (outCount < inMaxCount)
+	{
+		if (depot.carveEnd - depot.carveNext < static_cast<ptrdiff_t>(kBlockSize))
+		{
+			TQ3Uns8* theSpan = NewSpan( inClassIndex );
+			if (theSpan == nullptr)
+			{
+				break;
+			}
+			depot.carveNext = theSpan + kSpanHeaderSize;
+			depot.carveEnd = theSpan + kSpanSize;
+		}
+		
+		FreeBlock* theBlock = reinterpret_cast<FreeBlock*>( depot.carveNext );
+		depot.carveNext += kBlockSize;
+		theBlock->next = theList;
+		theList = theBlock;
+		outCount += 1;
+	}
+	
+	return theList;
+}
+
+static void ReturnBlocks( TQ3Uns32 inClassIndex, FreeBlock* inFirst,
+							FreeBlock* inLast, TQ3Uns32 inCount )
+{
+	ClassDepot&					depot( GetGlobals().depots[ inClassIndex ] );
+	std::lock_guard<std::mutex>	guard( depot.lock );
+	
+	inLast->next = depot.freeList;
+	depot.freeList = inFirst;
+	depot.freeCount += inCount;
+}
+
+/*!
+	@function	GetThreadCache
+	@abstract	Get the cache of the current thread, emptying it first if the
+				pools were released since it was last used.
+*/
+static ThreadCache& GetThreadCache()
+{
+	static thread_local ThreadCache tCache;
+	
+	TQ3Uns32 theGeneration = GetGlobals().generation.load( std::memory_order_acquire );
+	if (tCache.generation != theGeneration)
+	{
+		for (TQ3Uns32 i = 0; i < kNumClasses; ++i)
+		{
+			tCache.freeList[i] = nullptr;
+			tCache.freeCount[i] = 0;
+		}
+		tCache.generation = theGeneration;
+	}
+	return tCache;
+}
+
+ThreadCache::ThreadCache()
+{
+	for (TQ3Uns32 i = 0; i < kNumClasses; ++i)
+	{
+		freeList[i] = nullptr;
+		freeCount[i] = 0;
+	}
+	generation = GetGlobals().generation.load( std::memory_order_acquire );
+	tCacheState = kCacheAlive;
+}
+
+ThreadCache::~ThreadCache()
+{
+	tCacheState = kCacheDestroyed;
+	
+	// Lists from pools that have since been released point at freed memory
+	if (generation != GetGlobals().generation.load( std::memory_order_acquire ))
+	{
+		return;
+	}
+	
+	for (TQ3Uns32 i = 0; i < kNumClasses; ++i)
+	{
+		if (freeList[i] != nullptr)
+		{
+			FreeBlock* lastBlock = freeList[i];
+			while (lastBlock->next != nullptr)
+			{
+				lastBlock = lastBlock->next;
+			}
+			ReturnBlocks( i, freeList[i], lastBlock, freeCount[i] );
+		}
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      Public functions
+//-----------------------------------------------------------------------------
+//      E3MemoryPool_Allocate : Allocate a small block from the pools.
+//-----------------------------------------------------------------------------
+void *
+E3MemoryPool_Allocate( TQ3Uns32 inSize )
+{
+	if ( (inSize > kE3MemoryPoolMaxBlockSize) || (tCacheState == kCacheDestroyed) )
+	{
+		return nullptr;
+	}
+	
+	TQ3Uns32		classIndex = SizeToClass( inSize );
+	ThreadCache&	theCache( GetThreadCache() );
+	FreeBlock*		theBlock = theCache.freeList[ classIndex ];
+	
+	if (theBlock == nullptr)
+	{
+		TQ3Uns32 theCount;
+		theBlock = FetchBlocks( classIndex, kTransferBatch, theCount );
+		if (theBlock == nullptr)
+		{
+			return nullptr;
+		}
+		theCache.freeCount[ classIndex ] = theCount;
+	}
+	
+	theCache.freeList[ classIndex ] = theBlock->next;
+	theCache.freeCount[ classIndex ] -= 1;
+	
+	GetGlobals().liveBlocks.fetch_add( 1, std::memory_order_relaxed );
+	
+	return theBlock;
+}
+
+
+
+
+
+//=============================================================================
+//      E3MemoryPool_Free : Return a block to the pools.
+//-----------------------------------------------------------------------------
+//		Note :	The block must be one for which E3MemoryPool_Owns is true.
+//-----------------------------------------------------------------------------
+void
+E3MemoryPool_Free( void* inBlock )
+{
+	const SpanHeader* theSpan = FindSpan( inBlock );
+	Q3_ASSERT( (theSpan != nullptr) && (theSpan->magic == kSpanMagic) );
+	TQ3Uns32	classIndex = theSpan->classIndex;
+	FreeBlock*	theBlock = static_cast<FreeBlock*>( inBlock );
+	
+	GetGlobals().liveBlocks.fetch_sub( 1, std::memory_order_relaxed );
+	
+	if (tCacheState == kCacheDestroyed)
+	{
+		theBlock->next = nullptr;
+		ReturnBlocks( classIndex, theBlock, theBlock, 1 );
+		return;
+	}
+	
+	ThreadCache& theCache( GetThreadCache() );
+	theBlock->next = theCache.freeList[ classIndex ];
+	theCache.freeList[ classIndex ] = theBlock;
+	theCache.freeCount[ classIndex ] += 1;
+	
+	// Do not let one thread hoard blocks that others could use.
+	if (theCache.freeCount[ classIndex ] >= 2 * kTransferBatch)
+	{
+		FreeBlock* firstBlock = theCache.freeList[ classIndex ];
+		FreeBlock* lastBlock = firstBlock;
+		for (TQ3Uns32 i = 1; i < kTransferBatch; ++i)
+		{
+			lastBlock = lastBlock->next;
+		}
+		theCache.freeList[ classIndex ] = lastBlock->next;
+		theCache.freeCount[ classIndex ] -= kTransferBatch;
+		ReturnBlocks( classIndex, firstBlock, lastBlock, kTransferBatch );
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      E3MemoryPool_Owns : Test whether a block came from the pools.
+//-----------------------------------------------------------------------------
+bool
+E3MemoryPool_Owns( const void* inBlock )
+{
+	return FindSpan( inBlock ) != nullptr;
+}
+
+
+
+
+
+//=============================================================================
+//      E3MemoryPool_GetBlockSize : Usable size of a pooled block.
+//-----------------------------------------------------------------------------
+TQ3Uns32
+E3MemoryPool_GetBlockSize( const void* inBlock )
+{
+	const SpanHeader* theSpan = FindSpan( inBlock );
+	return (theSpan == nullptr)? 0 : kClassSizes[ theSpan->classIndex ];
+}
+
+
+
+
+
+//=============================================================================
+//      E3MemoryPool_GetReservedBytes : Bytes obtained from the system.
+//-----------------------------------------------------------------------------
+int64_t
+E3MemoryPool_GetReservedBytes()
+{
+	return GetGlobals().reservedBytes.load();
+}
+
+
+
+
+
+//=============================================================================
+//      E3MemoryPool_Release : Return the pools to the system.
+//-----------------------------------------------------------------------------
+//		Note :	Does nothing, and returns false, if any pooled block is still
+//				in use.  No other thread may use the pools during the call.
+//-----------------------------------------------------------------------------
+bool
+E3MemoryPool_Release()
+{
+	PoolGlobals&	globals( GetGlobals() );
+	bool			didRelease = false;
+	
+	// Lock in the same order as FetchBlocks, depots before spans
+	for (ClassDepot& depot : globals.depots)
+	{
+		depot.lock.lock();
+	}
+	globals.spanLock.lock();
+	
+	if (globals.liveBlocks.load() == 0)
+	{
+		for (TQ3Uns32 i = 0; i < globals.numSuperBlocks; ++i)
+		{
+			free( globals.superBlocks[i] );
+		}
+		globals.numSuperBlocks = 0;
+		
+		for (std::atomic<uintptr_t>& entry : globals.spanTable)
+		{
+			entry.store( 0, std::memory_order_relaxed );
+		}
+		globals.superNext = nullptr;
+		globals.superRemaining = 0;
+		globals.numSpans = 0;
+		globals.reservedBytes.store( 0 );
+		
+		for (ClassDepot& depot : globals.depots)
+		{
+			depot.freeList = nullptr;
+			depot.freeCount = 0;
+			depot.carveNext = nullptr;
+			depot.carveEnd = nullptr;
+		}
+		
+		globals.generation.fetch_add( 1, std::memory_order_release );
+		didRelease = true;
+	}
+	
+	globals.spanLock.unlock();
+	for (ClassDepot& depot : globals.depots)
+	{
+		depot.lock.unlock();
+	}
+	
+	return didRelease;
+}
@@ -0,0 +1,92 @@
+/*  NAME:
+        E3MemoryPool.h
+
+    DESCRIPTION:
+        Header file for E3MemoryPool.cpp.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+#ifndef E3MEMORYPOOL_HDR
+#define E3MEMORYPOOL_HDR
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3Prefix.h"
+
+#include <stdint.h>
+
+
+
+
+
+//=============================================================================
+//      Constants
+//-----------------------------------------------------------------------------
+//		Allocations up to this size are served from size-class pools by
+//		E3MemoryPool_Allocate.  Larger requests must go to the system.
+//-----------------------------------------------------------------------------
+const TQ3Uns32 kE3MemoryPoolMaxBlockSize	= 512;
+
+
+
+
+
+//=============================================================================
+//      Function prototypes
+//-----------------------------------------------------------------------------
+//		The pools carve 64K spans into blocks of one of a small set of size
+//		classes.  Each thread keeps its own free lists, and trades blocks with
+//		a shared depot in batches, so most allocations and frees take no lock.
+//		Freed blocks are kept for later allocations of the same size class
+//		rather than returned to the system.  E3MemoryPool_Release frees all
+//		of the spans once no pooled block is in use; Quesa calls it from
+//		Q3Exit.
+//
+//		E3MemoryPool_Allocate returns nullptr if the size is too big for a
+//		size class or the pools cannot grow, in which case the caller should
+//		fall back to the system allocator.  Use E3MemoryPool_Owns to find out
+//		which allocator a block came from.
+//-----------------------------------------------------------------------------
+void *		E3MemoryPool_Allocate( TQ3Uns32 inSize );
+void		E3MemoryPool_Free( void* inBlock );
+bool		E3MemoryPool_Owns( const void* inBlock );
+TQ3Uns32	E3MemoryPool_GetBlockSize( const void* inBlock );
+int64_t		E3MemoryPool_GetReservedBytes();
+bool		E3MemoryPool_Release();
+
+#endif
+
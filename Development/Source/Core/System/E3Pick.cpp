@@ -48,6 +48,7 @@
 #include "E3View.h"
 #include "E3Group.h"
 #include "E3Pick.h"
+#include "E3Math_Intersect.h"
 #include "CQ3ObjectRef.h"
 #include "QuesaMathOperators.hpp"
 
@@ -99,6 +100,13 @@ struct TQ3WorldRayPickSpecificData
 	TQ3Ray3D	ray;
 };
 
+struct TQ3WorldRayBatchPickSpecificData
+{
+	std::vector<TQ3Ray3D>*				rays;
+	std::vector<TE3RayPacket>*			packets;	// rays in groups, with their nearest hits
+	std::vector<TQ3WorldRayBatchHit>*	hits;		// one per ray
+};
+
 struct TQ3WindowRectPickSpecificData
 {
 	TQ3Area		rect;
@@ -110,6 +118,7 @@ struct TQ3PickBaseData
 	TQ3PickData							commonData;
 	std::vector<TQ3PickHit*>*			pickHits;
 	bool								isSorted;
+	float								closestDistance;	// nearest hit so far
 	float								vertexTolerance;
 	float								edgeTolerance;
 	float								faceTolerance;
@@ -180,6 +189,19 @@ public :
 	
 
 
+class E3WorldRayBatchPick : public E3Pick  // This is a leaf class so no other classes use this,
+								// so it can be here in the .c file rather than in
+								// the .h file, hence all the fields can be public
+								// as nobody should be including this file
+{
+Q3_CLASS_ENUMS ( kQ3PickTypeWorldRayBatch, E3WorldRayBatchPick, E3Pick )
+public :
+
+	TQ3WorldRayBatchPickSpecificData	instanceData ;
+} ;
+	
+
+
 class E3ShapePart : public E3Shared // This is not a leaf class, but only classes in this,
 								// file inherit from it, so it can be declared here in
 								// the .c file rather than in the .h file, hence all
@@ -328,6 +350,57 @@ e3pick_hit_duplicate_path(TQ3HitPath *pickedPath, TQ3HitPath *newPath)
 
 
 
+//=============================================================================
+//      e3pick_is_closest_hit : Does a pick only want the nearest hit?
+//-----------------------------------------------------------------------------
+static bool
+e3pick_is_closest_hit(const TQ3PickBaseData *pickInstanceData)
+{
+	return(pickInstanceData->commonData.numHitsToReturn == 1 &&
+		   pickInstanceData->commonData.sort == kQ3PickSortNearToFar);
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_hit_origin : Get the point hit distances are measured from.
+//-----------------------------------------------------------------------------
+//		Note :	This is the ray origin for world-ray picks, and the camera
+//				location for window picks. Returns false if the view has no
+//				camera, in which case all distances are treated as zero.
+//-----------------------------------------------------------------------------
+static bool
+e3pick_hit_origin(TQ3PickObject thePick, TQ3ViewObject theView, TQ3Point3D *theOrigin)
+{	TQ3CameraPlacement		cameraPlacement;
+	TQ3CameraObject			theCamera;
+	TQ3Ray3D				pickRay;
+
+
+
+	if (Q3Pick_GetType( thePick ) == kQ3PickTypeWorldRay)
+		{
+		Q3WorldRayPick_GetRay( thePick, &pickRay );
+		*theOrigin = pickRay.origin;
+		return(true);
+		}
+
+	if (Q3View_GetCamera(theView, &theCamera) == kQ3Success)
+		{
+		Q3Camera_GetPlacement(theCamera, &cameraPlacement);
+		*theOrigin = cameraPlacement.cameraLocation;
+		Q3Object_Dispose(theCamera);
+		return(true);
+		}
+
+	return(false);
+}
+
+
+
+
+
 //=============================================================================
 //      e3pick_hit_initialise : Initialise a TQ3PickHit.
 //-----------------------------------------------------------------------------
@@ -340,15 +413,12 @@ e3pick_hit_initialise(TQ3PickHit				*theHit,
 						const TQ3Param2D		*hitUV,
 						TQ3ShapePartObject		hitShape,
 						const TQ3Param3D*		hitBarycentric,
-						TQ3Uns32				hitFaceIndex )
-{	TQ3CameraPlacement		cameraPlacement;
-	TQ3HitPath				*currentPath;
+						TQ3Uns32				hitFaceIndex,
+						float					hitDistance )
+{	TQ3HitPath				*currentPath;
 	TQ3Status				qd3dStatus;
-	TQ3CameraObject			theCamera;
-	TQ3Vector3D				eyeVector = { 0.0f, 0.0f, 0.0f };
 	TQ3PickData				pickData;
 	TQ3ObjectType			theType;
-	TQ3Ray3D				pickRay;
 
 
 
@@ -419,23 +489,7 @@ e3pick_hit_initialise(TQ3PickHit				*theHit,
 	// Save the distance to the viewer
 	if (E3Bit_IsSet(pickData.mask, kQ3PickDetailMaskDistance) && hitXYZ != nullptr)
 		{
-		if (Q3Pick_GetType( thePick ) == kQ3PickTypeWorldRay)
-			{
-			Q3WorldRayPick_GetRay( thePick, &pickRay );
-			Q3Point3D_Subtract(hitXYZ, &pickRay.origin, &eyeVector);
-			}
-		else
-			{
-			qd3dStatus = Q3View_GetCamera(theView, &theCamera);
-			if (qd3dStatus == kQ3Success)
-				{
-				Q3Camera_GetPlacement(theCamera, &cameraPlacement);
-				Q3Point3D_Subtract(hitXYZ, &cameraPlacement.cameraLocation, &eyeVector);
-				Q3Object_Dispose(theCamera);
-
-				}
-			}
-		theHit->hitDistance = Q3Vector3D_Length(&eyeVector);
+		theHit->hitDistance = hitDistance;
 		theHit->validMask  |= kQ3PickDetailMaskDistance;
 		}
 
@@ -624,6 +678,7 @@ e3pick_new(TQ3Object theObject, void *privateData, const void *paramData)
 	instanceData->pickHits = new std::vector<TQ3PickHit*>;
 	instanceData->commonData = *pickData;
 	instanceData->isSorted = false;
+	instanceData->closestDistance = kQ3MaxFloat;
 	instanceData->vertexTolerance = 0.0f;
 	instanceData->edgeTolerance = 0.0f;
 	instanceData->faceTolerance = 0.0f;
@@ -871,6 +926,160 @@ e3pick_worldray_metahandler(TQ3XMethodType methodType)
 
 
 
+//=============================================================================
+//      e3pick_worldraybatch_empty_hits : Empty a world ray batch pick's hits.
+//-----------------------------------------------------------------------------
+static void
+e3pick_worldraybatch_empty_hits(TQ3WorldRayBatchPickSpecificData *instanceData)
+{
+	// Release the hit objects, and mark every ray as a miss
+	for (TQ3WorldRayBatchHit& theHit : *instanceData->hits)
+		{
+		if (theHit.pickedObject != nullptr)
+			Q3Object_Dispose(theHit.pickedObject);
+
+		Q3Memory_Clear(&theHit, sizeof(theHit));
+		theHit.triMeshFaceIndex = kQ3ArrayIndexNULL;
+		}
+
+
+
+	// Let hits at any distance through again
+	for (TE3RayPacket& thePacket : *instanceData->packets)
+		{
+		for (TQ3Uns32 n = 0; n < kE3RayPacketSize; ++n)
+			thePacket.tMax[n] = kQ3MaxFloat;
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_worldraybatch_set_rays : Set a world ray batch pick's rays.
+//-----------------------------------------------------------------------------
+static void
+e3pick_worldraybatch_set_rays(TQ3WorldRayBatchPickSpecificData *instanceData,
+								TQ3Uns32 numRays, const TQ3Ray3D *theRays)
+{	TQ3WorldRayBatchHit		missHit;
+
+
+
+	// Dispose of the old hits
+	e3pick_worldraybatch_empty_hits(instanceData);
+
+
+
+	// Save the rays, and group them into packets
+	instanceData->rays->assign(theRays, theRays + numRays);
+	instanceData->packets->resize((numRays + kE3RayPacketSize - 1) / kE3RayPacketSize);
+
+	for (TQ3Uns32 n = 0; n < instanceData->packets->size(); ++n)
+		{
+		TQ3Uns32 firstRay = n * kE3RayPacketSize;
+		E3RayPacket_Set((*instanceData->packets)[n],
+						E3Num_Min(numRays - firstRay, static_cast<TQ3Uns32>(kE3RayPacketSize)),
+						theRays + firstRay);
+		}
+
+
+
+	// Start with every ray a miss
+	Q3Memory_Clear(&missHit, sizeof(missHit));
+	missHit.triMeshFaceIndex = kQ3ArrayIndexNULL;
+
+	instanceData->hits->assign(numRays, missHit);
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_worldraybatch_new : World ray batch pick new method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3pick_worldraybatch_new(TQ3Object theObject, void *privateData, const void *paramData)
+{
+	TQ3WorldRayBatchPickSpecificData* instanceData = (TQ3WorldRayBatchPickSpecificData *) privateData;
+	const TQ3WorldRayBatchPickData	*pickData     = (const TQ3WorldRayBatchPickData *) paramData;
+#pragma unused(theObject)
+
+
+
+	// Initialise our instance data. Each ray keeps only its nearest hit.
+	try
+		{
+		instanceData->rays    = new std::vector<TQ3Ray3D>;
+		instanceData->packets = new std::vector<TE3RayPacket>;
+		instanceData->hits    = new std::vector<TQ3WorldRayBatchHit>;
+
+		e3pick_worldraybatch_set_rays(instanceData, pickData->numRays, pickData->rays);
+		}
+	catch (...)
+		{
+		E3ErrorManager_PostError( kQ3ErrorOutOfMemory, kQ3False );
+		return(kQ3Failure);
+		}
+	
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_worldraybatch_delete : World ray batch pick delete method.
+//-----------------------------------------------------------------------------
+static void
+e3pick_worldraybatch_delete(TQ3Object theObject, void *privateData)
+{
+	TQ3WorldRayBatchPickSpecificData* instanceData = (TQ3WorldRayBatchPickSpecificData *) privateData;
+
+
+
+	// Dispose of our instance data
+	if (instanceData->hits != nullptr && instanceData->packets != nullptr)
+		e3pick_worldraybatch_empty_hits(instanceData);
+
+	delete instanceData->rays;
+	delete instanceData->packets;
+	delete instanceData->hits;
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_worldraybatch_metahandler : World ray batch pick metahandler.
+//-----------------------------------------------------------------------------
+static TQ3XFunctionPointer
+e3pick_worldraybatch_metahandler(TQ3XMethodType methodType)
+{	TQ3XFunctionPointer		theMethod = nullptr;
+
+
+
+	// Return our methods
+	switch (methodType) {
+		case kQ3XMethodTypeObjectNew:
+			theMethod = (TQ3XFunctionPointer) e3pick_worldraybatch_new;
+			break;
+
+		case kQ3XMethodTypeObjectDelete:
+			theMethod = (TQ3XFunctionPointer) e3pick_worldraybatch_delete;
+			break;
+		}
+	
+	return(theMethod);
+}
+
+
+
+
+
 //=============================================================================
 //      e3shapepart_new : Shape part new method.
 //-----------------------------------------------------------------------------
@@ -1146,6 +1355,11 @@ E3Pick_RegisterClass(void)
 		qd3dStatus = Q3_REGISTER_CLASS (	kQ3ClassNamePickWorldRay,
 											e3pick_worldray_metahandler,
 											E3WorldRayPick ) ;
+
+	if (qd3dStatus == kQ3Success)
+		qd3dStatus = Q3_REGISTER_CLASS (	kQ3ClassNamePickWorldRayBatch,
+											e3pick_worldraybatch_metahandler,
+											E3WorldRayBatchPick ) ;
 	
 	//----------------------------------------------------------------------------------
 	
@@ -1203,6 +1417,7 @@ E3Pick_UnregisterClass(void)
 	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3ShapePartTypeMeshPart,		kQ3True)) && succeeded;
 	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3SharedTypeShapePart,		kQ3True)) && succeeded;
 
+	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3PickTypeWorldRayBatch,	kQ3True)) && succeeded;
 	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3PickTypeWorldRay,			kQ3True)) && succeeded;
 	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3PickTypeWindowRect,		kQ3True)) && succeeded;
 	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3PickTypeWindowPoint,		kQ3True)) && succeeded;
@@ -1412,6 +1627,17 @@ E3Pick_GetNumHits(TQ3PickObject inPick, TQ3Uns32 *numHits)
 
 
 
+	// Batch picks count the rays which hit
+	if (E3Pick_GetType(inPick) == kQ3PickTypeWorldRayBatch)
+	{
+		const std::vector<TQ3WorldRayBatchHit>& theHits( *((E3WorldRayBatchPick*) inPick)->instanceData.hits );
+		*numHits = static_cast<TQ3Uns32>(std::count_if( theHits.begin(), theHits.end(),
+			[]( const TQ3WorldRayBatchHit& inHit ) { return inHit.didHit == kQ3True; } ));
+		return(kQ3Success);
+	}
+
+
+
 	// Get the field, clamping it if a limit was supplied
 	*numHits = static_cast<TQ3Uns32>(instanceData->pickHits->size());
 	
@@ -1449,6 +1675,12 @@ E3Pick_EmptyHitList(TQ3PickObject inPick)
 	}
 	
 	instanceData->pickHits->clear();
+	instanceData->closestDistance = kQ3MaxFloat;
+
+
+	// Dispose of any batch hits
+	if (E3Pick_GetType(inPick) == kQ3PickTypeWorldRayBatch)
+		e3pick_worldraybatch_empty_hits( &((E3WorldRayBatchPick*) inPick)->instanceData );
 
 	return(kQ3Success);
 }
@@ -1623,16 +1855,43 @@ E3Pick_RecordHit(TQ3PickObject				inPick,
 	}
 	
 	
+	// Find the distance to the hit, if it will be needed
+	float hitDistance = 0.0f;
+	bool isClosestHit = e3pick_is_closest_hit( instanceData );
+	if ( (hitXYZ != nullptr) and
+		(isClosestHit or E3Bit_IsSet(instanceData->commonData.mask, kQ3PickDetailMaskDistance)) )
+	{
+		TQ3Point3D hitOrigin;
+		if (e3pick_hit_origin( thePick, theView, &hitOrigin ))
+			hitDistance = Q3FastPoint3D_Distance( hitXYZ, &hitOrigin );
+	}
+	
+	
+	// If only the nearest hit is wanted, drop this hit unless it is nearer
+	// than any we have, in which case it replaces them. This avoids building
+	// a hit record, and copying the hit path, for every hit.
+	if (isClosestHit)
+	{
+		if ( (! instanceData->pickHits->empty()) and (hitDistance >= instanceData->closestDistance) )
+			return theStatus;
+		
+		E3Pick_EmptyHitList( thePick );
+	}
+	
+	
 	try
 	{
-		// Allocate another hit record
+		// Allocate another hit record.  This can not use the view's frame
+		// scratch memory, since the hit list belongs to the pick object and
+		// is read by the application after the picking loop has ended.
 		std::unique_ptr<TQ3PickHit>	theHit( new TQ3PickHit );
 
 
 
 		// Fill out the data for the hit
 		e3pick_hit_initialise( theHit.get(), thePick, theView, hitXYZ,
-			hitNormal, hitUV, hitShape, hitBarycentric, hitTriMeshFaceIndex);
+			hitNormal, hitUV, hitShape, hitBarycentric, hitTriMeshFaceIndex,
+			hitDistance );
 
 
 
@@ -1643,6 +1902,12 @@ E3Pick_RecordHit(TQ3PickObject				inPick,
 		
 		// The hit is now owned by pickHits
 		theHit.release();
+		
+		
+		
+		// Remember the nearest hit, for pruning
+		if (hitDistance < instanceData->closestDistance)
+			instanceData->closestDistance = hitDistance;
 	}
 	catch (...)
 	{
@@ -1657,6 +1922,102 @@ E3Pick_RecordHit(TQ3PickObject				inPick,
 
 
 
+//=============================================================================
+//      E3Pick_GetClosestHitOrigin : Get the origin for closest-hit pruning.
+//-----------------------------------------------------------------------------
+//		Note :	Returns kQ3False unless the pick only wants its nearest hit,
+//				in which case theOrigin receives the point that hit distances
+//				are measured from. Pickers can then skip any candidate which
+//				is no nearer to it than E3Pick_GetClosestHitDistance.
+//-----------------------------------------------------------------------------
+TQ3Boolean
+E3Pick_GetClosestHitOrigin(TQ3PickObject inPick, TQ3ViewObject theView, TQ3Point3D *theOrigin)
+{
+	E3Pick* thePick = (E3Pick*) inPick;
+
+	TQ3PickBaseData	*instanceData = (TQ3PickBaseData *) &thePick->baseInstanceData;
+
+
+
+	if (!e3pick_is_closest_hit(instanceData))
+		return(kQ3False);
+
+	if (!e3pick_hit_origin(thePick, theView, theOrigin))
+		return(kQ3False);
+
+	return(kQ3True);
+}
+
+
+
+
+
+//=============================================================================
+//      E3Pick_GetClosestHitDistance : Get the distance to the nearest hit.
+//-----------------------------------------------------------------------------
+//		Note :	Returns kQ3MaxFloat if there have been no hits.
+//-----------------------------------------------------------------------------
+float
+E3Pick_GetClosestHitDistance(TQ3PickObject inPick)
+{
+	E3Pick* thePick = (E3Pick*) inPick;
+
+	TQ3PickBaseData	*instanceData = (TQ3PickBaseData *) &thePick->baseInstanceData;
+
+
+
+	if (instanceData->pickHits->empty())
+		return(kQ3MaxFloat);
+
+	return(instanceData->closestDistance);
+}
+
+
+
+
+
+//=============================================================================
+//      E3Pick_IsBeyondClosestHit : Can a bounded object be skipped?
+//-----------------------------------------------------------------------------
+//		Note :	Returns kQ3True if the pick only wants its nearest hit and
+//				every point of the world-space bounds is further away than
+//				the nearest hit so far, so nothing inside could replace it.
+//-----------------------------------------------------------------------------
+TQ3Boolean
+E3Pick_IsBeyondClosestHit(TQ3PickObject inPick, TQ3ViewObject theView, const TQ3BoundingBox *worldBounds)
+{
+	E3Pick* thePick = (E3Pick*) inPick;
+
+	TQ3PickBaseData	*instanceData = (TQ3PickBaseData *) &thePick->baseInstanceData;
+	TQ3Point3D		theOrigin, nearestPoint;
+
+
+
+	// Check we have something to compare against
+	if (!e3pick_is_closest_hit(instanceData) || instanceData->pickHits->empty() ||
+		worldBounds->isEmpty)
+		return(kQ3False);
+
+	if (!e3pick_hit_origin(thePick, theView, &theOrigin))
+		return(kQ3False);
+
+
+
+	// Find the nearest point of the bounds to the origin
+	nearestPoint.x = E3Num_Max(worldBounds->min.x, E3Num_Min(theOrigin.x, worldBounds->max.x));
+	nearestPoint.y = E3Num_Max(worldBounds->min.y, E3Num_Min(theOrigin.y, worldBounds->max.y));
+	nearestPoint.z = E3Num_Max(worldBounds->min.z, E3Num_Min(theOrigin.z, worldBounds->max.z));
+
+	if (Q3FastPoint3D_Distance(&theOrigin, &nearestPoint) > instanceData->closestDistance)
+		return(kQ3True);
+
+	return(kQ3False);
+}
+
+
+
+
+
 //=============================================================================
 //      E3WindowPointPick_New : Creates a new window point pick.
 //-----------------------------------------------------------------------------
@@ -1921,6 +2282,148 @@ E3WorldRayPick_SetData(TQ3PickObject thePick, const TQ3WorldRayPickData *data)
 
 
 
+//=============================================================================
+//      E3WorldRayBatchPick_New : Creates a new world ray batch pick.
+//-----------------------------------------------------------------------------
+#pragma mark -
+TQ3PickObject
+E3WorldRayBatchPick_New(const TQ3WorldRayBatchPickData *data)
+{
+	// Create the object
+	return E3ClassTree::CreateInstance( kQ3PickTypeWorldRayBatch, kQ3True, data );
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_GetNumRays : Gets the number of rays.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3WorldRayBatchPick_GetNumRays(TQ3PickObject thePick, TQ3Uns32 *numRays)
+{
+	// Get the field
+	*numRays = static_cast<TQ3Uns32>( ( (E3WorldRayBatchPick*) thePick )->instanceData.rays->size() );
+	return kQ3Success ;
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_SetRays : Sets the rays, emptying the hits.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3WorldRayBatchPick_SetRays(TQ3PickObject thePick, TQ3Uns32 numRays, const TQ3Ray3D *rays)
+{
+	// Set the field
+	try
+	{
+		e3pick_worldraybatch_set_rays( &( (E3WorldRayBatchPick*) thePick )->instanceData, numRays, rays );
+	}
+	catch (...)
+	{
+		E3ErrorManager_PostError( kQ3ErrorOutOfMemory, kQ3False );
+		return kQ3Failure ;
+	}
+	
+	return kQ3Success ;
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_GetHits : Gets the nearest hit for every ray.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3WorldRayBatchPick_GetHits(TQ3PickObject thePick, TQ3WorldRayBatchHit *hits)
+{
+	const std::vector<TQ3WorldRayBatchHit>& theHits( *( (E3WorldRayBatchPick*) thePick )->instanceData.hits );
+
+
+
+	// Copy the hits
+	std::copy( theHits.begin(), theHits.end(), hits );
+	return kQ3Success ;
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_AccessPackets : Get the rays of a batch pick.
+//-----------------------------------------------------------------------------
+//		Note :	Pickers test the rays a packet at a time. The tMax of each
+//				ray is the distance to its nearest hit so far, so hits at or
+//				beyond it can be skipped.
+//-----------------------------------------------------------------------------
+TE3RayPacket *
+E3WorldRayBatchPick_AccessPackets(TQ3PickObject thePick, TQ3Uns32 *numPackets)
+{
+	std::vector<TE3RayPacket>& thePackets( *( (E3WorldRayBatchPick*) thePick )->instanceData.packets );
+
+
+
+	*numPackets = static_cast<TQ3Uns32>( thePackets.size() );
+	return thePackets.empty()? nullptr : &thePackets[0];
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_RecordHit : Record a hit for one ray.
+//-----------------------------------------------------------------------------
+//		Note :	The hit must be nearer than the ray's tMax, which it then
+//				replaces.
+//-----------------------------------------------------------------------------
+void
+E3WorldRayBatchPick_RecordHit(TQ3PickObject			thePick,
+								TQ3ViewObject		theView,
+								TQ3Uns32			rayIndex,
+								const TQ3Param3D&	hitParam,
+								const TQ3Point3D&	hitXYZ,
+								const TQ3Vector3D&	faceNormal,
+								TQ3Uns32			hitTriMeshFaceIndex)
+{
+	TQ3WorldRayBatchPickSpecificData& instanceData( ( (E3WorldRayBatchPick*) thePick )->instanceData );
+	TE3RayPacket&			thePacket( (*instanceData.packets)[ rayIndex / kE3RayPacketSize ] );
+	TQ3WorldRayBatchHit&	theHit( (*instanceData.hits)[ rayIndex ] );
+	TQ3Uns32				theLane = rayIndex % kE3RayPacketSize;
+
+
+
+	// Shrink the ray
+	Q3_ASSERT( hitParam.w < thePacket.tMax[ theLane ] );
+	thePacket.tMax[ theLane ] = hitParam.w;
+
+
+
+	// Replace the previous hit
+	if (theHit.pickedObject != nullptr)
+		Q3Object_Dispose( theHit.pickedObject );
+
+	theHit.didHit           = kQ3True;
+	theHit.hitDistance      = hitParam.w;
+	theHit.hitXYZ           = hitXYZ;
+	theHit.hitNormal        = Q3Normalize3D( faceNormal );
+	theHit.triMeshFaceIndex = hitTriMeshFaceIndex;
+	theHit.pickedObject     = E3View_PickStack_GetPickedObject( theView );
+
+	if (E3View_GetPickIDStyleState( theView, &theHit.pickedID ) != kQ3Success)
+		theHit.pickedID = 0;
+}
+
+
+
+
+
 //=============================================================================
 //      E3ShapePart_New : Creates a new shape part.
 //		(Semi-private, no access to the 3rd party programmer)
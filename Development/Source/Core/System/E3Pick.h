@@ -92,6 +92,9 @@ TQ3Status				E3Pick_RecordHit(TQ3PickObject        		thePick,
 											TQ3ShapePartObject		hitShape,
 											const TQ3Param3D*		hitBarycentric = nullptr,
 											TQ3Uns32				hitTriMeshFaceIndex = kQ3ArrayIndexNULL );
+TQ3Boolean				E3Pick_GetClosestHitOrigin(TQ3PickObject thePick, TQ3ViewObject theView, TQ3Point3D *theOrigin);
+float					E3Pick_GetClosestHitDistance(TQ3PickObject thePick);
+TQ3Boolean				E3Pick_IsBeyondClosestHit(TQ3PickObject thePick, TQ3ViewObject theView, const TQ3BoundingBox *worldBounds);
 
 TQ3PickObject			E3WindowPointPick_New(const TQ3WindowPointPickData *data);
 TQ3Status				E3WindowPointPick_GetPoint(TQ3PickObject thePick, TQ3Point2D *point);
@@ -111,6 +114,19 @@ TQ3Status				E3WorldRayPick_SetRay(TQ3PickObject thePick, const TQ3Ray3D *ray);
 TQ3Status				E3WorldRayPick_GetData(TQ3PickObject thePick, TQ3WorldRayPickData *data);
 TQ3Status				E3WorldRayPick_SetData(TQ3PickObject thePick, const TQ3WorldRayPickData *data);
 
+TQ3PickObject			E3WorldRayBatchPick_New(const TQ3WorldRayBatchPickData *data);
+TQ3Status				E3WorldRayBatchPick_GetNumRays(TQ3PickObject thePick, TQ3Uns32 *numRays);
+TQ3Status				E3WorldRayBatchPick_SetRays(TQ3PickObject thePick, TQ3Uns32 numRays, const TQ3Ray3D *rays);
+TQ3Status				E3WorldRayBatchPick_GetHits(TQ3PickObject thePick, TQ3WorldRayBatchHit *hits);
+struct TE3RayPacket		*E3WorldRayBatchPick_AccessPackets(TQ3PickObject thePick, TQ3Uns32 *numPackets);
+void					E3WorldRayBatchPick_RecordHit(TQ3PickObject			thePick,
+											TQ3ViewObject		theView,
+											TQ3Uns32			rayIndex,
+											const TQ3Param3D&	hitParam,
+											const TQ3Point3D&	hitXYZ,
+											const TQ3Vector3D&	faceNormal,
+											TQ3Uns32			hitTriMeshFaceIndex);
+
 TQ3MeshPartObject		E3MeshPart_New(const TQ3MeshComponent data);
 TQ3ObjectType			E3MeshPart_GetType(TQ3MeshPartObject meshPartObject);
 TQ3Status				E3MeshPart_GetComponent(TQ3MeshPartObject meshPartObject, TQ3MeshComponent *component);
@@ -65,6 +65,7 @@
 #include "E3View.h"
 #include "E3IOFileFormat.h"
 #include "E3Main.h"
+#include "E3Profile.h"
 
 
 
@@ -74,6 +75,7 @@
 //      Internal constants
 //-----------------------------------------------------------------------------
 const TQ3Uns32 kSetTableSize									= 8;
+const TQ3Uns32 kInheritLocalDataSize							= 64;
 
 
 
@@ -786,11 +788,21 @@ e3attributeset_iterator_inherit(TQ3SetData *instanceData, TQ3ObjectType theType,
 			if (inheritMethod == kQ3True)
 				{
 				// Use the copy inherit method to copy the attribute
+				//
+				// The copy is only needed until Add has copied it in turn.  There
+				// is no view here, so it can not come from the frame scratch
+				// memory, but small attributes are copied on the stack.
 				TQ3XAttributeCopyInheritMethod copyInheritMethod = (TQ3XAttributeCopyInheritMethod) theElement->GetMethod ( kQ3XMethodTypeAttributeCopyInherit ) ;
 				if (copyInheritMethod != nullptr)
 					{
 					qd3dStatus    = kQ3Failure;
-					void* attributeData = Q3Memory_AllocateClear ( theElement->GetClass ()->GetInstanceSize () ) ;
+					alignas(16) TQ3Uns8 localData[ kInheritLocalDataSize ] ;
+					TQ3Uns32 dataSize = theElement->GetClass ()->GetInstanceSize () ;
+					void* attributeData = localData ;
+					if (dataSize <= kInheritLocalDataSize)
+						Q3Memory_Clear ( localData, dataSize ) ;
+					else
+						attributeData = Q3Memory_AllocateClear ( dataSize ) ;
 	
 					if (attributeData != nullptr)
 						qd3dStatus = copyInheritMethod( theElement->FindLeafInstanceData (), attributeData); 
@@ -798,7 +810,8 @@ e3attributeset_iterator_inherit(TQ3SetData *instanceData, TQ3ObjectType theType,
 					if (qd3dStatus == kQ3Success)
 						qd3dStatus = ( (E3Set*) theResult )->Add ( theType, attributeData ) ;
 	
-					Q3Memory_Free(&attributeData);
+					if (attributeData != localData)
+						Q3Memory_Free(&attributeData);
 					}
 	
 	
@@ -2793,6 +2806,8 @@ E3AttributeSet_Inherit(TQ3AttributeSet parent, TQ3AttributeSet child, TQ3Attribu
 	{
 	TQ3AttributeSetInheritParamInfo		paramInfo ;
 	TQ3Status qd3dStatus = kQ3Success ;
+	Q3_PROFILE_SCOPE( "E3AttributeSet_Inherit" ) ;
+	Q3_PROFILE_COUNT( "Attribute set inherits", 1 ) ;
 
 	// Find the instance data
 	E3Set* resultSet = (E3Set*) result ;
@@ -62,6 +62,7 @@
 //-----------------------------------------------------------------------------
 #define kE3MemoryStorageDefaultGrowSize					1024
 #define kE3MemoryStorageMinimumGrowSize					32
+#define kE3StorageWriteBufferSize						(64 * 1024)
 
 
 
@@ -106,6 +107,112 @@ e3storage_new_class_info (
 
 
 
+//=============================================================================
+//      e3storage_writebuffer_flush : Write out any buffered data.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_writebuffer_flush ( TE3StorageWriteBuffer& ioBuffer, FILE* theFile )
+	{
+	TQ3Status	status = kQ3Success ;
+	
+	if ( ioBuffer.size != 0 )
+		{
+		if ( fseek ( theFile, (long) ioBuffer.offset, SEEK_SET ) ||
+			( fwrite ( ioBuffer.data, 1, ioBuffer.size, theFile ) != ioBuffer.size ) )
+			status = kQ3Failure ;
+		
+		ioBuffer.size = 0 ;
+		}
+	
+	return status ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_writebuffer_free : Flush and release the buffer.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_writebuffer_free ( TE3StorageWriteBuffer& ioBuffer, FILE* theFile )
+	{
+	TQ3Status	status = kQ3Success ;
+	
+	if ( theFile != nullptr )
+		status = e3storage_writebuffer_flush ( ioBuffer, theFile ) ;
+	
+	Q3Memory_Free ( &ioBuffer.data ) ;
+	ioBuffer.size = 0 ;
+	
+	return status ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_writebuffer_write : Write data through the buffer.
+//-----------------------------------------------------------------------------
+//		The 3DMF writer emits a long run of small contiguous writes, so we
+//		collect them and pass them to the C library in large blocks.  A write
+//		that does not follow on from the buffered data, such as the final
+//		patch of the TOC location, flushes the buffer first.
+//
+//		Since buffered data reaches the file later, a write error may only be
+//		reported by a later write, read, or close.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_writebuffer_write ( TE3StorageWriteBuffer& ioBuffer, FILE* theFile,
+								TQ3Uns32 offset, TQ3Uns32 dataSize,
+								const unsigned char *data, TQ3Uns32 *sizeWritten )
+	{
+	// Flush the buffer if the new data is not contiguous or will not fit
+	if ( ( ioBuffer.size != 0 ) &&
+		( ( offset != ioBuffer.offset + ioBuffer.size ) ||
+		( ioBuffer.size + dataSize > kE3StorageWriteBufferSize ) ) )
+		{
+		if ( e3storage_writebuffer_flush ( ioBuffer, theFile ) != kQ3Success )
+			return kQ3Failure ;
+		}
+
+
+
+	// Large writes go straight to the file
+	if ( dataSize >= kE3StorageWriteBufferSize )
+		{
+		if ( fseek ( theFile, (long) offset, SEEK_SET ) )
+			return kQ3Failure ;
+		
+		*sizeWritten = static_cast<TQ3Uns32>(fwrite ( data, 1, dataSize, theFile ));
+		return kQ3Success ;
+		}
+
+
+
+	// Otherwise append to the buffer
+	if ( ioBuffer.data == nullptr )
+		{
+		ioBuffer.data = (TQ3Uns8 *) Q3Memory_Allocate ( kE3StorageWriteBufferSize ) ;
+		if ( ioBuffer.data == nullptr )
+			return kQ3Failure ;
+		}
+	
+	if ( ioBuffer.size == 0 )
+		ioBuffer.offset = offset ;
+	
+	Q3Memory_Copy ( data, ioBuffer.data + ioBuffer.size, dataSize ) ;
+	ioBuffer.size += dataSize ;
+	*sizeWritten = dataSize ;
+
+	return kQ3Success ;
+	}
+
+
+
+
+
 //=============================================================================
 //      e3storage_memory_read : Read data from the storage object.
 //-----------------------------------------------------------------------------
@@ -459,7 +566,6 @@ e3storage_path_new(TQ3Object theObject, void *privateData, const void *paramData
 static void
 e3storage_path_delete(TQ3Object storage, void *privateData)
 {	TQ3PathStorageData		*instanceData = (TQ3PathStorageData *) privateData;
-#pragma unused(storage)
 
 
 
@@ -467,6 +573,9 @@ e3storage_path_delete(TQ3Object storage, void *privateData)
 	if (instanceData->theFile != nullptr)
 		E3ErrorManager_PostError(kQ3ErrorFileIsOpen, kQ3False);
 
+	(void) e3storage_writebuffer_free( ((E3PathStorage*) storage)->writeBuffer,
+		instanceData->theFile );
+
 
 	// If this is an owned path, reduce the owner count
 	if (instanceData->ownerCount != nullptr)
@@ -584,11 +693,15 @@ e3storage_path_close ( TQ3StorageObject inStorage )
 
 
 
-	// Close the file		
-	fclose ( storage->pathDetails.theFile ) ;
+	// Write out any buffered data, and close the file
+	TQ3Status status = e3storage_writebuffer_free ( storage->writeBuffer,
+		storage->pathDetails.theFile ) ;
+
+	if ( fclose ( storage->pathDetails.theFile ) != 0 )
+		status = kQ3Failure ;
 	storage->pathDetails.theFile = nullptr ;
 
-	return kQ3Success ;
+	return status ;
 }
 
 
@@ -634,6 +747,12 @@ e3storage_path_getsize ( TQ3StorageObject inStorage, TQ3Uns32 *size )
 
 
 
+	// Make sure any buffered data is counted
+	if ( e3storage_writebuffer_flush ( storage->writeBuffer, storage->pathDetails.theFile ) != kQ3Success )
+		return kQ3Failure ;
+
+
+
 	// Get the current position in the file
 	if ( fgetpos ( storage->pathDetails.theFile, &oldPos ) )
 		return kQ3Failure ;
@@ -667,8 +786,6 @@ e3storage_path_getsize ( TQ3StorageObject inStorage, TQ3Uns32 *size )
 //=============================================================================
 //      e3storage_path_read : Read data from the storage object.
 //-----------------------------------------------------------------------------
-//		Note : Currently unbuffered - may cause performance problems.
-//-----------------------------------------------------------------------------
 TQ3Status
 e3storage_path_read ( TQ3StorageObject inStorage, TQ3Uns32 offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead )
 {
@@ -682,6 +799,12 @@ e3storage_path_read ( TQ3StorageObject inStorage, TQ3Uns32 offset, TQ3Uns32 data
 
 
 
+	// Make sure we read back anything we have written
+	if ( e3storage_writebuffer_flush ( storage->writeBuffer, storage->pathDetails.theFile ) != kQ3Success )
+		return kQ3Failure ;
+
+
+
 	// Seek to the offset, and read the data
 	// (The ftell is needed because in the Windows version of
 	// CodeWarrior's standard library, fseek always flushes the buffer.)
@@ -703,7 +826,7 @@ e3storage_path_read ( TQ3StorageObject inStorage, TQ3Uns32 offset, TQ3Uns32 data
 //=============================================================================
 //      e3storage_path_write : Write data to the storage object.
 //-----------------------------------------------------------------------------
-//		Note : Currently unbuffered - may cause performance problems.
+//		Note : Buffered until the storage is closed or read.
 //-----------------------------------------------------------------------------
 TQ3Status
 e3storage_path_write ( E3PathStorage* storage, TQ3Uns32 offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten )
@@ -717,13 +840,9 @@ e3storage_path_write ( E3PathStorage* storage, TQ3Uns32 offset, TQ3Uns32 dataSiz
 
 
 
-	// Seek to the offset, and write the data
-	if ( fseek ( storage->pathDetails.theFile, (long)offset, SEEK_SET ) )
-		return kQ3Failure ;
-
-	*sizeWritten = static_cast<TQ3Uns32>(fwrite( data, 1, dataSize, storage->pathDetails.theFile ));
-
-	return kQ3Success ;
+	// Write the data
+	return e3storage_writebuffer_write ( storage->writeBuffer,
+		storage->pathDetails.theFile, offset, dataSize, data, sizeWritten ) ;
 	}
 
 
@@ -804,6 +923,42 @@ e3storage_stream_new(TQ3Object theObject, void *privateData, const void *paramDa
 
 
 
+//=============================================================================
+//      e3storage_stream_delete : Stream storage delete method.
+//-----------------------------------------------------------------------------
+static void
+e3storage_stream_delete(TQ3Object theObject, void *privateData)
+{
+#pragma unused(privateData)
+	E3FileStreamStorage* storage = (E3FileStreamStorage*) theObject;
+	
+	(void) e3storage_writebuffer_free( storage->mWriteBuffer, storage->mStream );
+}
+
+
+
+
+
+//=============================================================================
+//      e3storage_stream_close : Write out any buffered data.
+//-----------------------------------------------------------------------------
+//		The stream belongs to the caller, so we do not close it.
+//-----------------------------------------------------------------------------
+TQ3Status
+e3storage_stream_close( TQ3StorageObject inStorage )
+{
+	E3FileStreamStorage* storage = (E3FileStreamStorage*) inStorage;
+	
+	if ( storage->mStream == nullptr )
+		return kQ3Success;
+	
+	return e3storage_writebuffer_free( storage->mWriteBuffer, storage->mStream );
+}
+
+
+
+
+
 //=============================================================================
 //      e3storage_stream_getsize : Get the size of the storage object.
 //-----------------------------------------------------------------------------
@@ -824,6 +979,12 @@ e3storage_stream_getsize ( TQ3StorageObject inStorage, TQ3Uns32 *size )
 
 
 
+	// Make sure any buffered data is counted
+	if ( e3storage_writebuffer_flush( storage->mWriteBuffer, storage->mStream ) != kQ3Success )
+		return kQ3Failure;
+
+
+
 	// Get the current position in the file
 	if ( fgetpos( storage->mStream, &oldPos ) )
 		return kQ3Failure;
@@ -857,8 +1018,6 @@ e3storage_stream_getsize ( TQ3StorageObject inStorage, TQ3Uns32 *size )
 //=============================================================================
 //      e3storage_stream_read : Read data from the storage object.
 //-----------------------------------------------------------------------------
-//		Note : Currently unbuffered - may cause performance problems.
-//-----------------------------------------------------------------------------
 TQ3Status
 e3storage_stream_read( TQ3StorageObject inStorage, TQ3Uns32 offset,
 						TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead )
@@ -873,6 +1032,12 @@ e3storage_stream_read( TQ3StorageObject inStorage, TQ3Uns32 offset,
 
 
 
+	// Make sure we read back anything we have written
+	if ( e3storage_writebuffer_flush( storage->mWriteBuffer, storage->mStream ) != kQ3Success )
+		return kQ3Failure;
+
+
+
 	// Seek to the offset, and read the data
 	// (The ftell is needed because in the Windows version of
 	// CodeWarrior's standard library, fseek always flushes the buffer.)
@@ -894,7 +1059,7 @@ e3storage_stream_read( TQ3StorageObject inStorage, TQ3Uns32 offset,
 //=============================================================================
 //      e3storage_stream_write : Write data to the storage object.
 //-----------------------------------------------------------------------------
-//		Note : Currently unbuffered - may cause performance problems.
+//		Note : Buffered until the storage is closed or read.
 //-----------------------------------------------------------------------------
 TQ3Status
 e3storage_stream_write( E3FileStreamStorage* storage, TQ3Uns32 offset,
@@ -910,13 +1075,9 @@ e3storage_stream_write( E3FileStreamStorage* storage, TQ3Uns32 offset,
 
 
 
-	// Seek to the offset, and write the data
-	if ( fseek( storage->mStream, (long)offset, SEEK_SET ) )
-		return kQ3Failure;
-
-	*sizeWritten = static_cast<TQ3Uns32>(fwrite( data, 1, dataSize, storage->mStream ));
-
-	return kQ3Success ;
+	// Write the data
+	return e3storage_writebuffer_write( storage->mWriteBuffer, storage->mStream,
+		offset, dataSize, data, sizeWritten );
 }
 
 
@@ -937,6 +1098,14 @@ e3storage_stream_metahandler(TQ3XMethodType methodType)
 			theMethod = (TQ3XFunctionPointer) e3storage_stream_new;
 			break;
 
+		case kQ3XMethodTypeObjectDelete:
+			theMethod = (TQ3XFunctionPointer) e3storage_stream_delete;
+			break;
+
+		case kQ3XMethodTypeStorageClose:
+			theMethod = (TQ3XFunctionPointer) e3storage_stream_close;
+			break;
+
 		case kQ3XMethodTypeStorageGetSize:
 			theMethod = (TQ3XFunctionPointer) e3storage_stream_getsize;
 			break;
@@ -1528,6 +1697,9 @@ E3FileStreamStorage_New(FILE *stream)
 void
 E3FileStreamStorage::Set( FILE* stream )
 {
+	if ( mStream != nullptr )
+		(void) e3storage_writebuffer_flush( mWriteBuffer, mStream );
+	
 	mStream = stream;
 }
 
@@ -76,6 +76,14 @@ typedef struct TE3_MemoryStorageData {
 } TE3_MemoryStorageData;
 
 
+// Write-combining buffer for file-based storage
+typedef struct TE3StorageWriteBuffer {
+	TQ3Uns8			*data;
+	TQ3Uns32		offset;
+	TQ3Uns32		size;
+} TE3StorageWriteBuffer;
+
+
 // Path storage
 typedef struct TQ3PathStorageData {
 	char		*thePath;
@@ -154,6 +162,7 @@ Q3_CLASS_ENUMS ( kQ3StorageTypePath, E3PathStorage, E3Storage )
 
 public :
 	TQ3PathStorageData		pathDetails ;
+	TE3StorageWriteBuffer	writeBuffer ;
 	
 	TQ3Status					Set ( const char* pathName ) ;
 	TQ3Status					Get ( char* pathName)  ;
@@ -175,7 +184,8 @@ class E3FileStreamStorage : public E3Storage
 Q3_CLASS_ENUMS ( kQ3StorageTypeFileStream, E3FileStreamStorage, E3Storage )
 	
 public:
-	FILE*		mStream;
+	FILE*					mStream;
+	TE3StorageWriteBuffer	mWriteBuffer;
 
 	void						Set( FILE* stream );
 	FILE*						Get();
@@ -183,6 +193,7 @@ public:
 	friend TQ3Status			e3storage_stream_getsize ( TQ3StorageObject inStorage, TQ3Uns32 *size ) ;
 	friend TQ3Status			e3storage_stream_read ( TQ3StorageObject inStorage, TQ3Uns32 offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead ) ;
 	friend TQ3Status			e3storage_stream_write ( E3FileStreamStorage* storage, TQ3Uns32 offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten ) ;
+	friend TQ3Status			e3storage_stream_close ( TQ3StorageObject inStorage ) ;
 };
 
 
@@ -55,6 +55,8 @@
 #include "E3View.h"
 #include "E3Math_Intersect.h"
 #include "E3FastArray.h"
+#include "E3FrameArena.h"
+#include "E3Profile.h"
 #include "E3Math.h"
 #include "QuesaMathOperators.hpp"
 
@@ -203,6 +205,10 @@ typedef struct TQ3ViewData {
 	E3FastArray<TQ3Point3D>*	boundingPointsArray;
 	
 	
+	// Scratch memory for the current frame, see E3View_AllocateFrameScratch
+	E3FrameArena*				frameArena;
+	
+	
 	// Derived cached matrices
 	TQ3Matrix4x4				matrixLocalToFrustum;
 	bool						isLocalToFrustumValid;
@@ -1170,6 +1176,7 @@ e3view_submit_retained_render ( TQ3Object theView, TQ3Object theObject)
 	{
 	TQ3Status qd3dStatus = kQ3Success ;
 	E3Root* theClass = (E3Root*) theObject->GetClass () ;
+	Q3_PROFILE_SCOPE( theClass->GetName () ) ;
 
 
 
@@ -1860,6 +1867,7 @@ e3view_delete ( TQ3ViewObject view, void *privateData )
 	Q3Object_CleanDispose(&instanceData->defaultAttributeSet);
 	Q3Object_CleanDispose(&instanceData->boundingPointsSlab);
 	delete instanceData->boundingPointsArray;
+	delete instanceData->frameArena;
 
 	e3view_stack_pop_clean ( (E3View*) view ) ;
 	
@@ -3996,6 +4004,8 @@ TQ3Status
 E3View_StartRendering(TQ3ViewObject theView)
 	{
 	TQ3DrawContextData		drawContextData;
+	E3Profile_BeginFrame () ;
+	Q3_PROFILE_SCOPE( "E3View_StartRendering" ) ;
 
 
 
@@ -4034,6 +4044,12 @@ E3View_StartRendering(TQ3ViewObject theView)
 
 
 
+	// Scratch memory from the previous pass or frame is no longer in use
+	if ( ( (E3View*) theView )->instanceData.frameArena != nullptr )
+		( (E3View*) theView )->instanceData.frameArena->Reset () ;
+
+
+
 	// Start the submit loop
 	TQ3Status qd3dStatus = e3view_submit_begin ( (E3View*) theView, kQ3ViewModeDrawing ) ;
 	if (qd3dStatus == kQ3Failure)
@@ -4112,6 +4128,29 @@ E3View_StartRendering(TQ3ViewObject theView)
 
 
 
+//=============================================================================
+//      E3View_AllocateFrameScratch : Allocate memory valid until next pass.
+//-----------------------------------------------------------------------------
+//		Note :	The memory comes from a per-view arena that is reset by
+//				E3View_StartRendering, so it must not be kept beyond the
+//				current rendering pass, and must not be freed.  It is meant
+//				for temporary buffers that renderers need during a submit.
+//-----------------------------------------------------------------------------
+void *
+E3View_AllocateFrameScratch(TQ3ViewObject theView, TQ3Uns32 theSize)
+	{
+	TQ3ViewData& instanceData( ( (E3View*) theView )->instanceData ) ;
+
+	if ( instanceData.frameArena == nullptr )
+		instanceData.frameArena = new E3FrameArena ;
+
+	return instanceData.frameArena->Allocate ( theSize ) ;
+	}
+
+
+
+
+
 //=============================================================================
 //      E3View_EndRendering : End a rendering loop.
 //-----------------------------------------------------------------------------
@@ -4119,6 +4158,9 @@ TQ3ViewStatus
 E3View_EndRendering(TQ3ViewObject theView)
 	{
 	TQ3ViewStatus viewStatus = kQ3ViewStatusDone ;
+	
+	{
+	Q3_PROFILE_SCOPE( "E3View_EndRendering" ) ;
 
 
 
@@ -4129,7 +4171,16 @@ E3View_EndRendering(TQ3ViewObject theView)
 
 
 	// End the submit loop
-	return e3view_submit_end ( (E3View*) theView, viewStatus ) ;
+	viewStatus = e3view_submit_end ( (E3View*) theView, viewStatus ) ;
+	}
+
+
+
+	// The frame is over once the renderer needs no more passes
+	if ( viewStatus != kQ3ViewStatusRetraverse )
+		E3Profile_EndFrame () ;
+	
+	return viewStatus ;
 	}
 
 
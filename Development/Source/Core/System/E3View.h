@@ -189,6 +189,7 @@ TQ3Status				E3View_SetRenderer(TQ3ViewObject theView, TQ3RendererObject theRend
 TQ3Status				E3View_GetRenderer(TQ3ViewObject theView, TQ3RendererObject *theRenderer);
 TQ3Status				E3View_StartRendering(TQ3ViewObject theView);
 TQ3ViewStatus			E3View_EndRendering(TQ3ViewObject theView);
+void*					E3View_AllocateFrameScratch(TQ3ViewObject theView, TQ3Uns32 theSize);
 TQ3Status				E3View_Flush(TQ3ViewObject theView);
 TQ3Status				E3View_Sync(TQ3ViewObject theView);
 TQ3Status				E3View_StartBoundingBox(TQ3ViewObject theView, TQ3ComputeBounds computeBounds);
@@ -52,6 +52,7 @@
 #include "E3FFR_3DMF_Bin.h"
 #include "E3FFR_3DMF_Text.h"
 #include "E3FFR_3DMF_Geometry.h"
+#include "E3FFR_3DMF_CompressedTriMesh.h"
 
 #include "E3FFW_3DMFBin_Geometry.h"
 #include "E3FFW_3DMFBin_Register.h"
@@ -159,6 +160,19 @@ public :
 	
 
 
+class E3CompressedTriMesh : public OpaqueTQ3Object  // This is a leaf class so no other classes use this,
+								// so it can be here in the .c file rather than in
+								// the .h file, hence all the fields can be public
+								// as nobody should be including this file
+	{
+Q3_CLASS_ENUMS ( kQ3ObjectTypeCompressedTriMesh, E3CompressedTriMesh, OpaqueTQ3Object )
+public :
+
+	// There is no extra data for this class, its read method makes a TriMesh
+	} ;
+	
+
+
 class E3TopCapSet : public OpaqueTQ3Object  // This is a leaf class so no other classes use this,
 								// so it can be here in the .c file rather than in
 								// the .h file, hence all the fields can be public
@@ -1858,11 +1872,11 @@ e3fformat_3dmf_vertexattributesetlist_metahandler(TQ3XMethodType methodType)
 
 
 //=============================================================================
-//      e3fformat_3dmf_normalarray_validate : validate an array of normal vectors,
+//      E3FFormat_3DMF_NormalArray_Validate : validate an array of normal vectors,
 //											reporting any too weird to normalize
 //-----------------------------------------------------------------------------
-static void
-e3fformat_3dmf_normalarray_validate( TQ3Uns32 numVectors, TQ3Vector3D* normals )
+void
+E3FFormat_3DMF_NormalArray_Validate( TQ3Uns32 numVectors, TQ3Vector3D* normals )
 {
 	float		maxComponent;
 	float		minComponent;
@@ -2010,7 +2024,7 @@ e3fformat_3dmf_attributearray_read ( TQ3FileObject inFile )
 				Q3Memory_Free( &theAttribute->data );
 				return nullptr;
 				}
-			e3fformat_3dmf_normalarray_validate( numElems, (TQ3Vector3D*)theAttribute->data );
+			E3FFormat_3DMF_NormalArray_Validate( numElems, (TQ3Vector3D*)theAttribute->data );
 			break;
 			
 		case kQ3AttributeTypeAmbientCoefficient:// float
@@ -2187,6 +2201,34 @@ e3fformat_3dmf_attributearray_metahandler(TQ3XMethodType methodType)
 
 
 
+//=============================================================================
+//      e3fformat_3dmf_compressedtrimesh_metahandler : CompressedTriMesh metahandler.
+//-----------------------------------------------------------------------------
+static TQ3XFunctionPointer
+e3fformat_3dmf_compressedtrimesh_metahandler(TQ3XMethodType methodType)
+{	TQ3XFunctionPointer		theMethod = nullptr;
+
+
+
+	// Return our methods
+	switch (methodType) {
+
+		case kQ3XMethodTypeObjectRead:
+			theMethod = (TQ3XFunctionPointer) E3Read_3DMF_Geom_CompressedTriMesh;
+			break;
+
+		case kQ3XMethodTypeObjectWrite:
+			theMethod = (TQ3XFunctionPointer) E3FFormat_3DMF_CompressedTriMesh_Write;
+			break;
+		}
+	
+	return(theMethod);
+}
+
+
+
+
+
 //=============================================================================
 //      e3fformat_3dmf_cameraplacement_read : Camera placement read object method.
 //-----------------------------------------------------------------------------
@@ -2663,6 +2705,11 @@ E3FFormat_3DMF_Reader_RegisterClass(void)
 											e3fformat_3dmf_attributearray_metahandler,
 											E3AttributeArray ) ;
 
+	if (qd3dStatus == kQ3Success)
+		qd3dStatus = Q3_REGISTER_CLASS_NO_DATA	(	kQ3ClassNameCompressedTriMesh,
+											e3fformat_3dmf_compressedtrimesh_metahandler,
+											E3CompressedTriMesh ) ;
+
 	if (qd3dStatus == kQ3Success)
 		qd3dStatus = Q3_REGISTER_CLASS	(	kQ3ClassNameTopCapAttributeSet,
 											nullptr,
@@ -2981,6 +3028,7 @@ E3FFormat_3DMF_Reader_UnregisterClass(void)
 
 
 	E3ClassTree::UnregisterClass(kQ3SharedTypeEndGroup,					kQ3True);
+	E3ClassTree::UnregisterClass(kQ3ObjectTypeCompressedTriMesh,		kQ3True);
 	E3ClassTree::UnregisterClass(kQ3ObjectTypeAttributeArray,			kQ3True);
 	E3ClassTree::UnregisterClass(kQ3ObjectTypeAttributeSetListVertex,	kQ3True);
 	E3ClassTree::UnregisterClass(kQ3ObjectTypeAttributeSetListFace,		kQ3True);
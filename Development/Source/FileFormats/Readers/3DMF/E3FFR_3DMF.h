@@ -101,12 +101,26 @@ typedef struct TQ33DMFWStackItem {
 	TQ3XDataDeleteMethod 			deleteData;
 } TQ33DMFWStackItem;
 
-typedef std::map< TQ3Object, TQ3Uns32 > TE3FFormatW3DMF_Map;
+// An object known to the writer.  The object is held by a strong reference,
+// or by a zeroing weak reference in streaming mode.
+typedef struct TE3FFormatW3DMF_MapEntry {
+	TQ3Uns32						tocIndex;
+	TQ3Object						object;
+} TE3FFormatW3DMF_MapEntry;
+
+typedef std::map< TQ3Object, TE3FFormatW3DMF_MapEntry > TE3FFormatW3DMF_Map;
+
+// content hash -> index entry, used by kQ3FilePropertyMergeIdenticalObjects
+typedef std::multimap< uint64_t, TE3FFormatW3DMF_Map::iterator > TE3FFormatW3DMF_ContentMap;
 
 typedef struct TE3FFormatW3DMF_Data {
 	TQ3FFormatBaseData				baseData;
 	TE3FFormat3DMF_TOC				*toc;
 	TE3FFormatW3DMF_Map				*index;
+	TE3FFormatW3DMF_ContentMap		*contentIndex;
+	TQ3Boolean						mergeIdentical;
+	TQ3Boolean						streaming;
+	TQ3Uns32						triMeshPositionBits;
 	TQ3FileMode						fileMode;
 	TQ3ObjectType					lastObjectType;
 	TQ3Object						lastObject;
@@ -202,6 +216,7 @@ TQ3DisplayGroupState		E3FFormat_3DMF_DisplayGroupState_Get(TQ3Object theObject);
 TQ3AttributeSet				E3FFormat_3DMF_CapsAttributes_Get(TQ3Object theObject);
 
 TQ3Status               	E3FFormat_3DMF_ReadFlag(TQ3Uns32* flag,TQ3FileObject theFile, TQ3ObjectType hint);
+void						E3FFormat_3DMF_NormalArray_Validate(TQ3Uns32 numVectors, TQ3Vector3D* normals);
 
 
 
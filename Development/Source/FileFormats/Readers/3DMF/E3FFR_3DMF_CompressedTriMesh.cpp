@@ -0,0 +1,1206 @@
+/*  NAME:
+        E3FFR_3DMF_CompressedTriMesh.cpp
+
+    DESCRIPTION:
+        Compressed TriMesh storage for 3DMF files.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3Prefix.h"
+#include "E3FFR_3DMF_CompressedTriMesh.h"
+#include "E3FFR_3DMF.h"
+
+#include <stdint.h>
+#include <vector>
+
+
+
+
+
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+#define kLZHashBits									14
+#define kLZMinMatch									4
+#define kLZMaxOffset								0xFFFFU
+#define kLZSlack									16
+#define kOctahedralMax								0xFFFFU
+
+// Most bytes that one byte of LZ data can expand to.  A sequence with a
+// match of n extension bytes takes 3 + n bytes and yields at most
+// 4 + 15 + 255 * n literal and match bytes, and a sequence with only
+// literals yields fewer bytes than it takes, so no block expands by more.
+#define kLZMaxExpansion								255
+
+
+
+
+
+//=============================================================================
+//      Internal types
+//-----------------------------------------------------------------------------
+// Cursor over the decompressed block.  Reads past the end clear isValid.
+struct TE3CompressedTriMeshCursor
+{
+	const TQ3Uns8*	next;
+	const TQ3Uns8*	end;
+	bool			isValid;
+};
+
+
+
+
+
+//=============================================================================
+//      Internal functions
+//-----------------------------------------------------------------------------
+//      e3ffformat_3dmf_zigzag : Map a signed difference to an unsigned value.
+//-----------------------------------------------------------------------------
+static inline TQ3Uns32
+e3ffformat_3dmf_zigzag( TQ3Uns32 inDelta )
+{
+	return (inDelta << 1) ^ (0U - (inDelta >> 31));
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffformat_3dmf_unzigzag : Inverse of e3ffformat_3dmf_zigzag.
+//-----------------------------------------------------------------------------
+static inline TQ3Uns32
+e3ffformat_3dmf_unzigzag( TQ3Uns32 inValue )
+{
+	return (inValue >> 1) ^ (0U - (inValue & 1U));
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffformat_3dmf_put_varint : Append a variable-length integer.
+//-----------------------------------------------------------------------------
+static inline void
+e3ffformat_3dmf_put_varint( std::vector<TQ3Uns8>& ioBytes, TQ3Uns32 inValue )
+{
+	while (inValue >= 0x80U)
+	{
+		ioBytes.push_back( (TQ3Uns8)(inValue | 0x80U) );
+		inValue >>= 7;
+	}
+	ioBytes.push_back( (TQ3Uns8) inValue );
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffformat_3dmf_put_delta : Append the difference from the previous
+//									value, and update the previous value.
+//-----------------------------------------------------------------------------
+static inline void
+e3ffformat_3dmf_put_delta( std::vector<TQ3Uns8>& ioBytes, TQ3Uns32& ioPrevious,
+							TQ3Uns32 inValue )
+{
+	e3ffformat_3dmf_put_varint( ioBytes, e3ffformat_3dmf_zigzag( inValue - ioPrevious ) );
+	ioPrevious = inValue;
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffformat_3dmf_get_varint : Read a variable-length integer.
+//-----------------------------------------------------------------------------
+static inline TQ3Uns32
+e3ffformat_3dmf_get_varint( TE3CompressedTriMeshCursor& ioCursor )
+{
+	TQ3Uns32	theValue = 0;
+	
+	// Most values take one or two bytes, and away from the end of the block
+	// they can be read without checking the bounds
+	if (ioCursor.end - ioCursor.next >= 2)
+	{
+		TQ3Uns32	theByte = ioCursor.next[0];
+		if ((theByte & 0x80U) == 0)
+		{
+			ioCursor.next += 1;
+			return theByte;
+		}
+		
+		theValue = (theByte & 0x7FU) | ((TQ3Uns32) ioCursor.next[1] << 7);
+		if ((ioCursor.next[1] & 0x80U) == 0)
+		{
+			ioCursor.next += 2;
+			return theValue;
+		}
+		theValue = 0;
+	}
+	
+	for (TQ3Uns32 shift = 0; (shift <= 28) && (ioCursor.next < ioCursor.end); shift += 7)
+	{
+		TQ3Uns32	theByte = *ioCursor.next++;
+		theValue |= (theByte & 0x7FU) << shift;
+		if ((theByte & 0x80U) == 0)
+			return theValue;
+	}
+	
+	ioCursor.isValid = false;
+	return 0;
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffformat_3dmf_get_delta : Read a difference written by
+//									e3ffformat_3dmf_put_delta.
+//-----------------------------------------------------------------------------
+static inline TQ3Uns32
+e3ffformat_3dmf_get_delta( TE3CompressedTriMeshCursor& ioCursor, TQ3Uns32& ioPrevious )
+{
+	ioPrevious += e3ffformat_3dmf_unzigzag( e3ffformat_3dmf_get_varint( ioCursor ) );
+	return ioPrevious;
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffformat_3dmf_float_bits : Get the bit pattern of a float.
+//-----------------------------------------------------------------------------
+static inline TQ3Uns32
+e3ffformat_3dmf_float_bits( float inValue )
+{
+	TQ3Uns32	theBits;
+	memcpy( &theBits, &inValue, sizeof(theBits) );
+	return theBits;
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffformat_3dmf_bits_float : Inverse of e3ffformat_3dmf_float_bits.
+//-----------------------------------------------------------------------------
+static inline float
+e3ffformat_3dmf_bits_float( TQ3Uns32 inBits )
+{
+	float	theValue;
+	memcpy( &theValue, &inBits, sizeof(theValue) );
+	return theValue;
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffformat_3dmf_octahedral_encode : Map a normal to the octahedral
+//											square, quantized to 16 bits.
+//-----------------------------------------------------------------------------
+static void
+e3ffformat_3dmf_octahedral_encode( const TQ3Vector3D& inNormal,
+									TQ3Uns32& outU, TQ3Uns32& outV )
+{
+	float	u = 0.0f;
+	float	v = 0.0f;
+	float	sum = fabsf( inNormal.x ) + fabsf( inNormal.y ) + fabsf( inNormal.z );
+	
+	if (sum > 0.0f)
+	{
+		u = inNormal.x / sum;
+		v = inNormal.y / sum;
+		
+		// Fold the lower hemisphere over the diagonals
+		if (inNormal.z < 0.0f)
+		{
+			float	foldU = (1.0f - fabsf( v )) * ((u >= 0.0f) ? 1.0f : -1.0f);
+			float	foldV = (1.0f - fabsf( u )) * ((v >= 0.0f) ? 1.0f : -1.0f);
+			u = foldU;
+			v = foldV;
+		}
+	}
+	
+	outU = (TQ3Uns32) E3Num_Clamp( (u * 0.5f + 0.5f) * kOctahedralMax + 0.5f,
+		0.0f, (float) kOctahedralMax );
+	outV = (TQ3Uns32) E3Num_Clamp( (v * 0.5f + 0.5f) * kOctahedralMax + 0.5f,
+		0.0f, (float) kOctahedralMax );
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffformat_3dmf_octahedral_decode : Inverse of
+//											e3ffformat_3dmf_octahedral_encode.
+//-----------------------------------------------------------------------------
+static void
+e3ffformat_3dmf_octahedral_decode( TQ3Uns32 inU, TQ3Uns32 inV, TQ3Vector3D& outNormal )
+{
+	float	u = (float) inU * (2.0f / kOctahedralMax) - 1.0f;
+	float	v = (float) inV * (2.0f / kOctahedralMax) - 1.0f;
+	float	z = 1.0f - fabsf( u ) - fabsf( v );
+	
+	if (z < 0.0f)
+	{
+		float	foldU = (1.0f - fabsf( v )) * ((u >= 0.0f) ? 1.0f : -1.0f);
+		float	foldV = (1.0f - fabsf( u )) * ((v >= 0.0f) ? 1.0f : -1.0f);
+		u = foldU;
+		v = foldV;
+	}
+	
+	float	scale = 1.0f / sqrtf( u * u + v * v + z * z );
+	outNormal.x = u * scale;
+	outNormal.y = v * scale;
+	outNormal.z = z * scale;
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffformat_3dmf_lz_put_length : Append the extension of a length that
+//										did not fit in its token nibble.
+//-----------------------------------------------------------------------------
+static inline void
+e3ffformat_3dmf_lz_put_length( std::vector<TQ3Uns8>& ioBytes, TQ3Uns32 inLength )
+{
+	while (inLength >= 255)
+	{
+		ioBytes.push_back( 255 );
+		inLength -= 255;
+	}
+	ioBytes.push_back( (TQ3Uns8) inLength );
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffformat_3dmf_lz_put_sequence : Append literals and a match.
+//-----------------------------------------------------------------------------
+//		Note :	Each sequence is a token byte holding the literal length and
+//				the match length less kLZMinMatch, 15 in either nibble meaning
+//				that more length bytes follow, then the literals, then the
+//				match offset as 2 little-endian bytes.  The last sequence has
+//				only literals.
+//-----------------------------------------------------------------------------
+static void
+e3ffformat_3dmf_lz_put_sequence( std::vector<TQ3Uns8>& ioBytes,
+								const TQ3Uns8* inLiterals, TQ3Uns32 inNumLiterals,
+								TQ3Uns32 inOffset, TQ3Uns32 inMatchLength )
+{
+	TQ3Uns32	matchCode = (inMatchLength == 0) ? 0 : inMatchLength - kLZMinMatch;
+	TQ3Uns8		theToken = (TQ3Uns8)( (E3Num_Min( inNumLiterals, 15U ) << 4) |
+		E3Num_Min( matchCode, 15U ) );
+	
+	ioBytes.push_back( theToken );
+	if (inNumLiterals >= 15)
+		e3ffformat_3dmf_lz_put_length( ioBytes, inNumLiterals - 15 );
+	ioBytes.insert( ioBytes.end(), inLiterals, inLiterals + inNumLiterals );
+	
+	if (inMatchLength != 0)
+	{
+		ioBytes.push_back( (TQ3Uns8)(inOffset & 0xFFU) );
+		ioBytes.push_back( (TQ3Uns8)(inOffset >> 8) );
+		if (matchCode >= 15)
+			e3ffformat_3dmf_lz_put_length( ioBytes, matchCode - 15 );
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffformat_3dmf_lz_compress : Compress a block with a greedy LZ77
+//									  parse.
+//-----------------------------------------------------------------------------
+static void
+e3ffformat_3dmf_lz_compress( const std::vector<TQ3Uns8>& inBytes,
+							std::vector<TQ3Uns8>& outBytes )
+{
+	const TQ3Uns8*	src = inBytes.data();
+	TQ3Uns32		srcSize = static_cast<TQ3Uns32>(inBytes.size());
+	TQ3Uns32		anchor = 0;
+	TQ3Uns32		pos = 0;
+	
+	// Positions are stored plus one, so that 0 means an empty slot
+	std::vector<TQ3Uns32>	hashTable( 1U << kLZHashBits, 0 );
+	
+	outBytes.clear();
+	outBytes.reserve( srcSize / 2 + 16 );
+	
+	while (pos + kLZMinMatch <= srcSize)
+	{
+		TQ3Uns32	sequence;
+		memcpy( &sequence, src + pos, sizeof(sequence) );
+		TQ3Uns32	hashIndex = (sequence * 2654435761U) >> (32 - kLZHashBits);
+		TQ3Uns32	candidate = hashTable[ hashIndex ];
+		hashTable[ hashIndex ] = pos + 1;
+		
+		if ( (candidate != 0) && (pos - (candidate - 1) <= kLZMaxOffset) &&
+			(memcmp( src + candidate - 1, src + pos, kLZMinMatch ) == 0) )
+		{
+			TQ3Uns32	matchStart = candidate - 1;
+			TQ3Uns32	matchLength = kLZMinMatch;
+			while ( (pos + matchLength < srcSize) &&
+				(src[ matchStart + matchLength ] == src[ pos + matchLength ]) )
+			{
+				++matchLength;
+			}
+			
+			e3ffformat_3dmf_lz_put_sequence( outBytes, src + anchor, pos - anchor,
+				pos - matchStart, matchLength );
+			pos += matchLength;
+			anchor = pos;
+		}
+		else
+		{
+			++pos;
+		}
+	}
+	
+	e3ffformat_3dmf_lz_put_sequence( outBytes, src + anchor, srcSize - anchor, 0, 0 );
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffformat_3dmf_lz_get_length : Read the extension of a length.
+//-----------------------------------------------------------------------------
+static inline bool
+e3ffformat_3dmf_lz_get_length( const TQ3Uns8*& ioNext, const TQ3Uns8* inEnd,
+								TQ3Uns32& ioLength )
+{
+	TQ3Uns32	theByte;
+	
+	do
+	{
+		if (ioNext == inEnd)
+			return false;
+		theByte = *ioNext++;
+		ioLength += theByte;
+	} while (theByte == 255);
+	
+	return true;
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffformat_3dmf_lz_decompress : Decompress a block written by
+//										e3ffformat_3dmf_lz_compress.
+//-----------------------------------------------------------------------------
+//		Note :	outBytes must have room for kLZSlack bytes after outSize.
+//				Short literal runs and matches are copied in whole 8 or 16
+//				byte pieces, which may write that far past their end.
+//-----------------------------------------------------------------------------
+static bool
+e3ffformat_3dmf_lz_decompress( const TQ3Uns8* inBytes, TQ3Uns32 inSize,
+								TQ3Uns8* outBytes, TQ3Uns32 outSize )
+{
+	const TQ3Uns8*	next = inBytes;
+	const TQ3Uns8*	end = inBytes + inSize;
+	TQ3Uns8*		dst = outBytes;
+	TQ3Uns8*		dstEnd = outBytes + outSize;
+	
+	while (next < end)
+	{
+		TQ3Uns32	theToken = *next++;
+		
+		// Literals
+		TQ3Uns32	numLiterals = theToken >> 4;
+		if ( (numLiterals == 15) &&
+			! e3ffformat_3dmf_lz_get_length( next, end, numLiterals ) )
+			return false;
+		if ( (numLiterals > (TQ3Uns32)(end - next)) ||
+			(numLiterals > (TQ3Uns32)(dstEnd - dst)) )
+			return false;
+		if ( (numLiterals <= 16) && (end - next >= 16) )
+			memcpy( dst, next, 16 );
+		else
+			memcpy( dst, next, numLiterals );
+		dst += numLiterals;
+		next += numLiterals;
+		
+		if (next == end)
+			break;
+		
+		// Match
+		if (end - next < 2)
+			return false;
+		TQ3Uns32	theOffset = next[0] | (next[1] << 8);
+		next += 2;
+		
+		TQ3Uns32	matchLength = theToken & 0x0FU;
+		if ( (matchLength == 15) &&
+			! e3ffformat_3dmf_lz_get_length( next, end, matchLength ) )
+			return false;
+		matchLength += kLZMinMatch;
+		
+		if ( (theOffset == 0) || (theOffset > (TQ3Uns32)(dst - outBytes)) ||
+			(matchLength > (TQ3Uns32)(dstEnd - dst)) )
+			return false;
+		
+		const TQ3Uns8*	from = dst - theOffset;
+		if (theOffset >= 8)
+		{
+			// Each piece starts at least 8 bytes after its source, so
+			// overlapping matches still repeat correctly
+			TQ3Uns8*	matchEnd = dst + matchLength;
+			do
+			{
+				memcpy( dst, from, 8 );
+				dst += 8;
+				from += 8;
+			} while (dst < matchEnd);
+			dst = matchEnd;
+		}
+		else
+		{
+			// Overlapping match, which repeats the last theOffset bytes
+			for (TQ3Uns32 i = 0; i < matchLength; ++i)
+				*dst++ = *from++;
+		}
+	}
+	
+	return dst == dstEnd;
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffformat_3dmf_allocate : Allocate one of the TriMesh arrays.
+//-----------------------------------------------------------------------------
+template <typename T>
+static bool
+e3ffformat_3dmf_allocate( T*& outArray, TQ3Uns32 inCount )
+{
+	outArray = (T*) Q3Memory_Allocate( static_cast<TQ3Uns32>(inCount * sizeof(T)) );
+	return (outArray != nullptr) || (inCount == 0);
+}
+
+
+
+
+
+//=============================================================================
+//      Public functions
+//-----------------------------------------------------------------------------
+//      E3FFormat_3DMF_CompressTriMesh : Compress TriMesh data.
+//-----------------------------------------------------------------------------
+//		Note :	inPositionBits is clamped to the range 8 through
+//				kE3FFormat3DMF_CompressedTriMeshMaxBits, except that values
+//				above that range mean that points are stored exactly.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3FFormat_3DMF_CompressTriMesh( const TQ3TriMeshData* inGeomData,
+								TQ3Uns32 inPositionBits,
+								TE3FFormat3DMF_CompressedTriMesh_Data* outData )
+{
+	TQ3Uns32	i, j;
+
+
+
+	// Fill in the header
+	Q3Memory_Clear( outData, sizeof(TE3FFormat3DMF_CompressedTriMesh_Data) );
+	outData->numTriangles				= inGeomData->numTriangles;
+	outData->numTriangleAttributeTypes	= inGeomData->numTriangleAttributeTypes;
+	outData->numEdges					= inGeomData->numEdges;
+	outData->numEdgeAttributeTypes		= inGeomData->numEdgeAttributeTypes;
+	outData->numPoints					= inGeomData->numPoints;
+	outData->numVertexAttributeTypes	= inGeomData->numVertexAttributeTypes;
+	outData->bBox						= inGeomData->bBox;
+	
+	if (inPositionBits > kE3FFormat3DMF_CompressedTriMeshMaxBits)
+		inPositionBits = 32;
+	else if (inPositionBits < 8)
+		inPositionBits = 8;
+	outData->positionBits = inPositionBits;
+	const bool	isQuantized = (inPositionBits <= kE3FFormat3DMF_CompressedTriMeshMaxBits);
+
+
+
+	// Find the vertex normals and UVs, if any.  Arrays with a use array are
+	// left to be written as AttributeArray objects.
+	outData->normalIndex = kQ3ArrayIndexNULL;
+	outData->uvIndex = kQ3ArrayIndexNULL;
+	for (i = 0; i < inGeomData->numVertexAttributeTypes; ++i)
+	{
+		const TQ3TriMeshAttributeData&	theAtt = inGeomData->vertexAttributeTypes[i];
+		if ( (theAtt.data == nullptr) || (theAtt.attributeUseArray != nullptr) )
+			continue;
+		
+		if ( (theAtt.attributeType == kQ3AttributeTypeNormal) &&
+			(outData->normalIndex == kQ3ArrayIndexNULL) )
+		{
+			outData->normalIndex = i;
+		}
+		else if ( ((theAtt.attributeType == kQ3AttributeTypeSurfaceUV) ||
+			(theAtt.attributeType == kQ3AttributeTypeShadingUV)) &&
+			(outData->uvIndex == kQ3ArrayIndexNULL) )
+		{
+			outData->uvIndex = i;
+			outData->uvType = theAtt.attributeType;
+		}
+	}
+
+
+
+	std::vector<TQ3Uns8>	theBytes;
+	theBytes.reserve( inGeomData->numPoints * 8 + inGeomData->numTriangles * 4 );
+	TQ3Uns32	previous[3] = { 0, 0, 0 };
+
+
+
+	// Points
+	const TQ3Point3D*	thePoints = inGeomData->points;
+	if (isQuantized)
+	{
+		if (inGeomData->numPoints > 0)
+		{
+			outData->quantizeMin = outData->quantizeMax = thePoints[0];
+			for (i = 1; i < inGeomData->numPoints; ++i)
+			{
+				const float*	theCoords = &thePoints[i].x;
+				float*			minCoords = &outData->quantizeMin.x;
+				float*			maxCoords = &outData->quantizeMax.x;
+				for (j = 0; j < 3; ++j)
+				{
+					minCoords[j] = E3Num_Min( minCoords[j], theCoords[j] );
+					maxCoords[j] = E3Num_Max( maxCoords[j], theCoords[j] );
+				}
+			}
+		}
+		
+		const float*	theMin = &outData->quantizeMin.x;
+		const float*	theMax = &outData->quantizeMax.x;
+		const TQ3Uns32	maxValue = (1U << inPositionBits) - 1;
+		double			scale[3];
+		for (j = 0; j < 3; ++j)
+		{
+			double	range = (double) theMax[j] - (double) theMin[j];
+			scale[j] = (range > 0.0) ? maxValue / range : 0.0;
+		}
+		
+		for (i = 0; i < inGeomData->numPoints; ++i)
+		{
+			const float*	theCoords = &thePoints[i].x;
+			for (j = 0; j < 3; ++j)
+			{
+				double	q = ((double) theCoords[j] - theMin[j]) * scale[j] + 0.5;
+				TQ3Uns32	theValue = (q >= maxValue) ? maxValue : (TQ3Uns32) q;
+				e3ffformat_3dmf_put_delta( theBytes, previous[j], theValue );
+			}
+		}
+	}
+	else
+	{
+		for (i = 0; i < inGeomData->numPoints; ++i)
+		{
+			const float*	theCoords = &thePoints[i].x;
+			for (j = 0; j < 3; ++j)
+				e3ffformat_3dmf_put_delta( theBytes, previous[j],
+					e3ffformat_3dmf_float_bits( theCoords[j] ) );
+		}
+	}
+
+
+
+	// Normals
+	if (outData->normalIndex != kQ3ArrayIndexNULL)
+	{
+		const TQ3Vector3D*	theNormals = (const TQ3Vector3D*)
+			inGeomData->vertexAttributeTypes[ outData->normalIndex ].data;
+		previous[0] = previous[1] = previous[2] = 0;
+		
+		for (i = 0; i < inGeomData->numPoints; ++i)
+		{
+			if (isQuantized)
+			{
+				TQ3Uns32	u, v;
+				e3ffformat_3dmf_octahedral_encode( theNormals[i], u, v );
+				e3ffformat_3dmf_put_delta( theBytes, previous[0], u );
+				e3ffformat_3dmf_put_delta( theBytes, previous[1], v );
+			}
+			else
+			{
+				const float*	theCoords = &theNormals[i].x;
+				for (j = 0; j < 3; ++j)
+					e3ffformat_3dmf_put_delta( theBytes, previous[j],
+						e3ffformat_3dmf_float_bits( theCoords[j] ) );
+			}
+		}
+	}
+
+
+
+	// UVs
+	if (outData->uvIndex != kQ3ArrayIndexNULL)
+	{
+		const TQ3Param2D*	theUVs = (const TQ3Param2D*)
+			inGeomData->vertexAttributeTypes[ outData->uvIndex ].data;
+		previous[0] = previous[1] = 0;
+		
+		for (i = 0; i < inGeomData->numPoints; ++i)
+		{
+			e3ffformat_3dmf_put_delta( theBytes, previous[0],
+				e3ffformat_3dmf_float_bits( theUVs[i].u ) );
+			e3ffformat_3dmf_put_delta( theBytes, previous[1],
+				e3ffformat_3dmf_float_bits( theUVs[i].v ) );
+		}
+	}
+
+
+
+	// Triangles.  Neighbouring triangles share vertices, so each index is
+	// stored relative to the one before it.
+	previous[0] = 0;
+	for (i = 0; i < inGeomData->numTriangles; ++i)
+	{
+		for (j = 0; j < 3; ++j)
+			e3ffformat_3dmf_put_delta( theBytes, previous[0],
+				inGeomData->triangles[i].pointIndices[j] );
+	}
+
+
+
+	// Edges.  Triangle indices are stored plus one, so that kQ3ArrayIndexNULL
+	// becomes 0.
+	previous[0] = 0;
+	for (i = 0; i < inGeomData->numEdges; ++i)
+	{
+		const TQ3TriMeshEdgeData&	theEdge = inGeomData->edges[i];
+		e3ffformat_3dmf_put_delta( theBytes, previous[0], theEdge.pointIndices[0] );
+		e3ffformat_3dmf_put_delta( theBytes, previous[0], theEdge.pointIndices[1] );
+		e3ffformat_3dmf_put_varint( theBytes, theEdge.triangleIndices[0] + 1 );
+		e3ffformat_3dmf_put_varint( theBytes, theEdge.triangleIndices[1] + 1 );
+	}
+	
+	if (theBytes.size() > 0x7FFFFFFFU)
+		return kQ3Failure;
+
+
+
+	// Entropy stage, kept only if it helps
+	std::vector<TQ3Uns8>	packedBytes;
+	e3ffformat_3dmf_lz_compress( theBytes, packedBytes );
+	
+	const std::vector<TQ3Uns8>*	theResult = &theBytes;
+	if (packedBytes.size() < theBytes.size())
+	{
+		outData->packing = 1;
+		theResult = &packedBytes;
+	}
+	
+	// The block is kept with its padding, so that it is written in one piece
+	outData->rawSize = static_cast<TQ3Uns32>(theBytes.size());
+	outData->packedSize = static_cast<TQ3Uns32>(theResult->size());
+	outData->packed = (TQ3Uns8*) Q3Memory_AllocateClear( Q3Size_Pad( outData->packedSize ) );
+	if ( (outData->packed == nullptr) && (outData->packedSize != 0) )
+		return kQ3Failure;
+	
+	if (outData->packedSize != 0)
+		memcpy( outData->packed, theResult->data(), outData->packedSize );
+	
+	return kQ3Success;
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffformat_3dmf_decode_arrays : Decode the arrays of a TriMesh.
+//-----------------------------------------------------------------------------
+//		Note :	theCursor covers the block after the entropy stage has been
+//				undone.  See E3FFormat_3DMF_DecompressTriMesh.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3ffformat_3dmf_decode_arrays( const TE3FFormat3DMF_CompressedTriMesh_Data* inData,
+								TE3CompressedTriMeshCursor& theCursor,
+								TQ3TriMeshData* ioGeomData )
+{
+	TQ3Uns32	i, j;
+
+
+
+	// Allocate the arrays
+	TQ3TriMeshAttributeData*	theNormals = nullptr;
+	TQ3TriMeshAttributeData*	theUVs = nullptr;
+	
+	if ( ! e3ffformat_3dmf_allocate( ioGeomData->points, ioGeomData->numPoints ) ||
+		! e3ffformat_3dmf_allocate( ioGeomData->triangles, ioGeomData->numTriangles ) ||
+		! e3ffformat_3dmf_allocate( ioGeomData->edges, ioGeomData->numEdges ) )
+		return kQ3Failure;
+	
+	if (inData->normalIndex != kQ3ArrayIndexNULL)
+	{
+		theNormals = &ioGeomData->vertexAttributeTypes[ inData->normalIndex ];
+		theNormals->attributeType = kQ3AttributeTypeNormal;
+		theNormals->data = Q3Memory_Allocate( ioGeomData->numPoints * sizeof(TQ3Vector3D) );
+		if (theNormals->data == nullptr)
+			return kQ3Failure;
+	}
+	
+	if (inData->uvIndex != kQ3ArrayIndexNULL)
+	{
+		theUVs = &ioGeomData->vertexAttributeTypes[ inData->uvIndex ];
+		theUVs->attributeType = inData->uvType;
+		theUVs->data = Q3Memory_Allocate( ioGeomData->numPoints * sizeof(TQ3Param2D) );
+		if (theUVs->data == nullptr)
+			return kQ3Failure;
+	}
+
+
+
+	// Points
+	TQ3Uns32	previous[3] = { 0, 0, 0 };
+	const bool	isQuantized = (inData->positionBits <= kE3FFormat3DMF_CompressedTriMeshMaxBits);
+	
+	if (isQuantized)
+	{
+		const float*	theMin = &inData->quantizeMin.x;
+		const float*	theMax = &inData->quantizeMax.x;
+		const float		maxValue = (float) ((1U << inData->positionBits) - 1);
+		float			step[3];
+		for (j = 0; j < 3; ++j)
+			step[j] = (theMax[j] - theMin[j]) / maxValue;
+		
+		for (i = 0; i < ioGeomData->numPoints; ++i)
+		{
+			float*	theCoords = &ioGeomData->points[i].x;
+			for (j = 0; j < 3; ++j)
+				theCoords[j] = theMin[j] + step[j] *
+					(float) e3ffformat_3dmf_get_delta( theCursor, previous[j] );
+		}
+	}
+	else
+	{
+		for (i = 0; i < ioGeomData->numPoints; ++i)
+		{
+			float*	theCoords = &ioGeomData->points[i].x;
+			for (j = 0; j < 3; ++j)
+				theCoords[j] = e3ffformat_3dmf_bits_float(
+					e3ffformat_3dmf_get_delta( theCursor, previous[j] ) );
+		}
+	}
+
+
+
+	// Normals. Octahedral normals always decode to unit vectors, but exact
+	// ones get the same check as those in a plain attribute array.
+	if (theNormals != nullptr)
+	{
+		TQ3Vector3D*	theVectors = (TQ3Vector3D*) theNormals->data;
+		previous[0] = previous[1] = previous[2] = 0;
+		
+		for (i = 0; i < ioGeomData->numPoints; ++i)
+		{
+			if (isQuantized)
+			{
+				TQ3Uns32	u = e3ffformat_3dmf_get_delta( theCursor, previous[0] );
+				TQ3Uns32	v = e3ffformat_3dmf_get_delta( theCursor, previous[1] );
+				if ( (u > kOctahedralMax) || (v > kOctahedralMax) )
+					return kQ3Failure;
+				e3ffformat_3dmf_octahedral_decode( u, v, theVectors[i] );
+			}
+			else
+			{
+				float*	theCoords = &theVectors[i].x;
+				for (j = 0; j < 3; ++j)
+					theCoords[j] = e3ffformat_3dmf_bits_float(
+						e3ffformat_3dmf_get_delta( theCursor, previous[j] ) );
+			}
+		}
+		
+		if (! isQuantized)
+			E3FFormat_3DMF_NormalArray_Validate( ioGeomData->numPoints, theVectors );
+	}
+
+
+
+	// UVs
+	if (theUVs != nullptr)
+	{
+		TQ3Param2D*	theParams = (TQ3Param2D*) theUVs->data;
+		previous[0] = previous[1] = 0;
+		
+		for (i = 0; i < ioGeomData->numPoints; ++i)
+		{
+			theParams[i].u = e3ffformat_3dmf_bits_float(
+				e3ffformat_3dmf_get_delta( theCursor, previous[0] ) );
+			theParams[i].v = e3ffformat_3dmf_bits_float(
+				e3ffformat_3dmf_get_delta( theCursor, previous[1] ) );
+		}
+	}
+
+
+
+	// Triangles
+	previous[0] = 0;
+	for (i = 0; i < ioGeomData->numTriangles; ++i)
+	{
+		for (j = 0; j < 3; ++j)
+			ioGeomData->triangles[i].pointIndices[j] =
+				e3ffformat_3dmf_get_delta( theCursor, previous[0] );
+	}
+
+
+
+	// Edges
+	previous[0] = 0;
+	for (i = 0; i < ioGeomData->numEdges; ++i)
+	{
+		TQ3TriMeshEdgeData&	theEdge = ioGeomData->edges[i];
+		theEdge.pointIndices[0] = e3ffformat_3dmf_get_delta( theCursor, previous[0] );
+		theEdge.pointIndices[1] = e3ffformat_3dmf_get_delta( theCursor, previous[0] );
+		theEdge.triangleIndices[0] = e3ffformat_3dmf_get_varint( theCursor ) - 1;
+		theEdge.triangleIndices[1] = e3ffformat_3dmf_get_varint( theCursor ) - 1;
+	}
+
+
+
+	// Make sure that the block held exactly what the header promised
+	if ( ! theCursor.isValid || (theCursor.next != theCursor.end) )
+		return kQ3Failure;
+	
+	return kQ3Success;
+}
+
+
+
+
+
+//=============================================================================
+//      E3FFormat_3DMF_DecompressTriMesh : Fill in TriMesh data.
+//-----------------------------------------------------------------------------
+//		Note :	The caller must have filled in the counts and allocated the
+//				attribute type arrays of ioGeomData.  This function allocates
+//				the points, triangles, edges, and the vertex normal and UV
+//				data, which the caller should free with Q3TriMesh_EmptyData
+//				if this function fails.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3FFormat_3DMF_DecompressTriMesh( const TE3FFormat3DMF_CompressedTriMesh_Data* inData,
+								TQ3TriMeshData* ioGeomData )
+{
+	// Every point takes at least 3 bytes, every triangle at least 3 and every
+	// edge at least 4, so this protects against silly allocations.
+	const uint64_t	rawSize = inData->rawSize;
+	if ( (3 * (uint64_t) inData->numPoints > rawSize) ||
+		(3 * (uint64_t) inData->numTriangles > rawSize) ||
+		(4 * (uint64_t) inData->numEdges > rawSize) ||
+		(rawSize + kLZSlack > 0xFFFFFFFFU) )
+		return kQ3Failure;
+	
+	if ( (inData->normalIndex != kQ3ArrayIndexNULL) &&
+		(inData->normalIndex >= ioGeomData->numVertexAttributeTypes) )
+		return kQ3Failure;
+	
+	if ( (inData->uvIndex != kQ3ArrayIndexNULL) &&
+		( (inData->uvIndex >= ioGeomData->numVertexAttributeTypes) ||
+		(inData->uvIndex == inData->normalIndex) ||
+		((inData->uvType != kQ3AttributeTypeSurfaceUV) &&
+		(inData->uvType != kQ3AttributeTypeShadingUV)) ) )
+		return kQ3Failure;
+
+
+
+	// Undo the entropy stage.  rawSize comes from the file, so a failed
+	// allocation just means a bad file.
+	TQ3Uns8*	unpackedBytes = nullptr;
+	TE3CompressedTriMeshCursor	theCursor = { inData->packed, inData->packed, true };
+	
+	if (inData->packing == 1)
+	{
+		unpackedBytes = (TQ3Uns8*) Q3Memory_Allocate( inData->rawSize + kLZSlack );
+		if ( (unpackedBytes == nullptr) ||
+			! e3ffformat_3dmf_lz_decompress( inData->packed, inData->packedSize,
+				unpackedBytes, inData->rawSize ) )
+		{
+			Q3Memory_Free( &unpackedBytes );
+			return kQ3Failure;
+		}
+		theCursor.next = unpackedBytes;
+	}
+	else if ( (inData->packing != 0) || (inData->packedSize != inData->rawSize) )
+	{
+		return kQ3Failure;
+	}
+	theCursor.end = theCursor.next + inData->rawSize;
+
+
+
+	// Decode the arrays
+	TQ3Status	status = e3ffformat_3dmf_decode_arrays( inData, theCursor, ioGeomData );
+	
+	Q3Memory_Free( &unpackedBytes );
+	
+	return status;
+}
+
+
+
+
+
+//=============================================================================
+//      E3FFormat_3DMF_CompressedTriMesh_Empty : Free the compressed block.
+//-----------------------------------------------------------------------------
+void
+E3FFormat_3DMF_CompressedTriMesh_Empty( TE3FFormat3DMF_CompressedTriMesh_Data* ioData )
+{
+	Q3Memory_Free( &ioData->packed );
+	ioData->packedSize = 0;
+}
+
+
+
+
+
+//=============================================================================
+//      E3FFormat_3DMF_CompressedTriMesh_Size : Size of the object in a file.
+//-----------------------------------------------------------------------------
+TQ3Uns32
+E3FFormat_3DMF_CompressedTriMesh_Size( const TE3FFormat3DMF_CompressedTriMesh_Data* inData )
+{
+	return static_cast<TQ3Uns32>(kE3FFormat3DMF_CompressedTriMeshHeaderSize) +
+		Q3Size_Pad( inData->packedSize );
+}
+
+
+
+
+
+//=============================================================================
+//      E3FFormat_3DMF_CompressedTriMesh_Read : Read a CompressedTriMesh.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3FFormat_3DMF_CompressedTriMesh_Read( TQ3FileObject theFile,
+										TE3FFormat3DMF_CompressedTriMesh_Data* outData )
+{
+	TQ3StorageObject	theStorage = nullptr;
+	TQ3Uns32			storageSize = 0;
+	TQ3Uns32			temp;
+	TQ3Status			status;
+
+
+
+	Q3Memory_Clear( outData, sizeof(TE3FFormat3DMF_CompressedTriMesh_Data) );
+	
+	status = Q3Uns32_Read( &outData->numTriangles, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Read( &outData->numTriangleAttributeTypes, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Read( &outData->numEdges, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Read( &outData->numEdgeAttributeTypes, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Read( &outData->numPoints, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Read( &outData->numVertexAttributeTypes, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Read( &outData->normalIndex, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Read( &outData->uvIndex, theFile );
+	if (status == kQ3Success)
+	{
+		status = Q3Uns32_Read( &temp, theFile );
+		outData->uvType = (TQ3AttributeType) temp;
+	}
+	if (status == kQ3Success)
+		status = Q3Uns32_Read( &outData->positionBits, theFile );
+	if (status == kQ3Success)
+		status = Q3Point3D_Read( &outData->quantizeMin, theFile );
+	if (status == kQ3Success)
+		status = Q3Point3D_Read( &outData->quantizeMax, theFile );
+	if (status == kQ3Success)
+		status = Q3Point3D_Read( &outData->bBox.min, theFile );
+	if (status == kQ3Success)
+		status = Q3Point3D_Read( &outData->bBox.max, theFile );
+	if (status == kQ3Success)
+	{
+		status = Q3Uns32_Read( &temp, theFile );
+		outData->bBox.isEmpty = (temp != 0) ? kQ3True : kQ3False;
+	}
+	if (status == kQ3Success)
+		status = Q3Uns32_Read( &outData->packing, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Read( &outData->rawSize, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Read( &outData->packedSize, theFile );
+	if (status != kQ3Success)
+		return status;
+
+
+
+	// Sanity check the sizes before allocating memory
+	Q3File_GetStorage( theFile, &theStorage );
+	Q3Storage_GetSize( theStorage, &storageSize );
+	Q3Object_CleanDispose( &theStorage );
+	
+	const TQ3Uns32	paddedSize = Q3Size_Pad( outData->packedSize );
+	if ( (paddedSize < outData->packedSize) || (paddedSize > storageSize) )
+		status = kQ3Failure;
+	else if (outData->packing == 1)
+		status = ( (uint64_t) outData->rawSize <=
+			kLZMaxExpansion * (uint64_t) outData->packedSize ) ? kQ3Success : kQ3Failure;
+	else
+		status = ( (outData->packing == 0) &&
+			(outData->rawSize == outData->packedSize) ) ? kQ3Success : kQ3Failure;
+	
+	if (status != kQ3Success)
+	{
+		outData->packedSize = 0;
+		return kQ3Failure;
+	}
+
+
+
+	// Read the block and its padding together, as for pixmap images.  A
+	// zero length read at the end of the storage would fail.
+	if (paddedSize != 0)
+	{
+		outData->packed = (TQ3Uns8*) Q3Memory_Allocate( paddedSize );
+		if (outData->packed == nullptr)
+		{
+			outData->packedSize = 0;
+			return kQ3Failure;
+		}
+		
+		status = Q3RawData_Read( outData->packed, paddedSize, theFile );
+		if (status != kQ3Success)
+			E3FFormat_3DMF_CompressedTriMesh_Empty( outData );
+	}
+	
+	return status;
+}
+
+
+
+
+
+//=============================================================================
+//      E3FFormat_3DMF_CompressedTriMesh_Write : Write a CompressedTriMesh.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3FFormat_3DMF_CompressedTriMesh_Write( const TE3FFormat3DMF_CompressedTriMesh_Data* inData,
+										TQ3FileObject theFile )
+{
+	TQ3Status		status;
+
+
+
+	status = Q3Uns32_Write( inData->numTriangles, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Write( inData->numTriangleAttributeTypes, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Write( inData->numEdges, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Write( inData->numEdgeAttributeTypes, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Write( inData->numPoints, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Write( inData->numVertexAttributeTypes, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Write( inData->normalIndex, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Write( inData->uvIndex, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Write( (TQ3Uns32) inData->uvType, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Write( inData->positionBits, theFile );
+	if (status == kQ3Success)
+		status = Q3Point3D_Write( &inData->quantizeMin, theFile );
+	if (status == kQ3Success)
+		status = Q3Point3D_Write( &inData->quantizeMax, theFile );
+	if (status == kQ3Success)
+		status = Q3Point3D_Write( &inData->bBox.min, theFile );
+	if (status == kQ3Success)
+		status = Q3Point3D_Write( &inData->bBox.max, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Write( inData->bBox.isEmpty, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Write( inData->packing, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Write( inData->rawSize, theFile );
+	if (status == kQ3Success)
+		status = Q3Uns32_Write( inData->packedSize, theFile );
+	if ( (status == kQ3Success) && (inData->packedSize != 0) )
+		status = Q3RawData_Write( inData->packed, Q3Size_Pad( inData->packedSize ), theFile );
+	
+	return status;
+}
+
+
+
+
+
+//=============================================================================
+//      E3FFormat_3DMF_CompressedTriMesh_Delete : Delete method for data
+//												  submitted by the writer.
+//-----------------------------------------------------------------------------
+void
+E3FFormat_3DMF_CompressedTriMesh_Delete( void* ioData )
+{
+	TE3FFormat3DMF_CompressedTriMesh_Data*	theData =
+		(TE3FFormat3DMF_CompressedTriMesh_Data*) ioData;
+	
+	E3FFormat_3DMF_CompressedTriMesh_Empty( theData );
+	Q3Memory_Free( &theData );
+}
@@ -0,0 +1,155 @@
+/*  NAME:
+        E3FFR_3DMF_CompressedTriMesh.h
+
+    DESCRIPTION:
+        Header file for E3FFR_3DMF_CompressedTriMesh.cpp.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+#ifndef E3FFR_3DMF_COMPRESSEDTRIMESH_HDR
+#define E3FFR_3DMF_COMPRESSEDTRIMESH_HDR
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3Prefix.h"
+
+
+
+
+
+//=============================================================================
+//      Constants
+//-----------------------------------------------------------------------------
+// Size of the fixed part of a CompressedTriMesh object in a file
+#define kE3FFormat3DMF_CompressedTriMeshHeaderSize		(26 * sizeof(TQ3Uns32))
+
+// Largest number of bits to which point coordinates are quantized.  Larger
+// values of positionBits mean that points and normals are stored exactly.
+#define kE3FFormat3DMF_CompressedTriMeshMaxBits			24
+
+
+
+
+
+//=============================================================================
+//      Types
+//-----------------------------------------------------------------------------
+/*
+	A CompressedTriMesh object holds the points, triangles and edges of a
+	TriMesh, along with up to one vertex normal array and one vertex UV array,
+	as a single block of bytes.  Any other attribute arrays of the TriMesh
+	follow it as ordinary AttributeArray sub-objects.
+	
+	Within the block, point coordinates are quantized to positionBits bits
+	relative to quantizeMin and quantizeMax, and normals are stored in the
+	octahedral mapping with 16 bits per component.  If positionBits is larger
+	than kE3FFormat3DMF_CompressedTriMeshMaxBits, the bit patterns of points
+	and normals are stored instead.  UVs are always stored exactly.  Each
+	array is stored as the differences between consecutive values, zigzag
+	encoded as variable-length integers.  If packing is 1, the block was then
+	compressed with e3ffformat_3dmf_lz_compress.  The packed buffer holds
+	Q3Size_Pad(packedSize) bytes, the last of them zero padding.
+*/
+typedef struct TE3FFormat3DMF_CompressedTriMesh_Data {
+	TQ3Uns32						numTriangles;
+	TQ3Uns32						numTriangleAttributeTypes;
+	TQ3Uns32						numEdges;
+	TQ3Uns32						numEdgeAttributeTypes;
+	TQ3Uns32						numPoints;
+	TQ3Uns32						numVertexAttributeTypes;
+	TQ3Uns32						normalIndex;	// or kQ3ArrayIndexNULL
+	TQ3Uns32						uvIndex;		// or kQ3ArrayIndexNULL
+	TQ3AttributeType				uvType;
+	TQ3Uns32						positionBits;
+	TQ3Point3D						quantizeMin;
+	TQ3Point3D						quantizeMax;
+	TQ3BoundingBox					bBox;
+	TQ3Uns32						packing;
+	TQ3Uns32						rawSize;
+	TQ3Uns32						packedSize;
+	TQ3Uns8*						packed;
+} TE3FFormat3DMF_CompressedTriMesh_Data;
+
+
+
+
+
+//=============================================================================
+//		C++ preamble
+//-----------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+
+
+//=============================================================================
+//      Function prototypes
+//-----------------------------------------------------------------------------
+TQ3Status		E3FFormat_3DMF_CompressTriMesh(
+								const TQ3TriMeshData* inGeomData,
+								TQ3Uns32 inPositionBits,
+								TE3FFormat3DMF_CompressedTriMesh_Data* outData );
+TQ3Status		E3FFormat_3DMF_DecompressTriMesh(
+								const TE3FFormat3DMF_CompressedTriMesh_Data* inData,
+								TQ3TriMeshData* ioGeomData );
+void			E3FFormat_3DMF_CompressedTriMesh_Empty(
+								TE3FFormat3DMF_CompressedTriMesh_Data* ioData );
+TQ3Uns32		E3FFormat_3DMF_CompressedTriMesh_Size(
+								const TE3FFormat3DMF_CompressedTriMesh_Data* inData );
+TQ3Status		E3FFormat_3DMF_CompressedTriMesh_Read(
+								TQ3FileObject theFile,
+								TE3FFormat3DMF_CompressedTriMesh_Data* outData );
+TQ3Status		E3FFormat_3DMF_CompressedTriMesh_Write(
+								const TE3FFormat3DMF_CompressedTriMesh_Data* inData,
+								TQ3FileObject theFile );
+void			E3FFormat_3DMF_CompressedTriMesh_Delete( void* ioData );
+
+
+
+
+
+//=============================================================================
+//		C++ postamble
+//-----------------------------------------------------------------------------
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -49,6 +49,8 @@
 #include "E3IOData.h"
 #include "E3FFR_3DMF_Geometry.h"
 #include "E3FFR_3DMF_Text.h"
+#include "E3FFR_3DMF_CompressedTriMesh.h"
+#include "E3GeometryTriMesh.h"
 
 
 
@@ -367,6 +369,83 @@ static bool e3read_3dmf_elementset_is_nonempty( TQ3SetObject inSet )
 
 
 
+//=============================================================================
+//      e3read_3dmf_trimesh_finish : Read the sub-objects of a TriMesh and
+//									 create it.
+//-----------------------------------------------------------------------------
+//		Note :	Used by the TriMesh and CompressedTriMesh read methods, which
+//				must have made geomData the currentTriMesh of the format.  If
+//				the TriMesh is created it owns the arrays of geomData, and
+//				geomData is cleared.  Otherwise the caller must empty it.
+//-----------------------------------------------------------------------------
+static TQ3Object
+e3read_3dmf_trimesh_finish( TQ3FileObject theFile, TQ3TriMeshData& geomData )
+{	TQ3Object				childObject;
+	TQ3Object	 			theObject = nullptr;
+	TQ3SetObject			elementSet = nullptr;
+
+
+
+	// Allocate the attribute arrays, unless the caller has done so
+	if ( (geomData.numTriangleAttributeTypes != 0) && (geomData.triangleAttributeTypes == nullptr) ){
+		geomData.triangleAttributeTypes = (TQ3TriMeshAttributeData *)Q3Memory_AllocateClear(sizeof(TQ3TriMeshAttributeData) * geomData.numTriangleAttributeTypes);
+		if(geomData.triangleAttributeTypes == nullptr)
+			return nullptr;
+		}
+	if ( (geomData.numEdgeAttributeTypes != 0) && (geomData.edgeAttributeTypes == nullptr) ){
+		geomData.edgeAttributeTypes = (TQ3TriMeshAttributeData *)Q3Memory_AllocateClear(sizeof(TQ3TriMeshAttributeData) * geomData.numEdgeAttributeTypes);
+		if(geomData.edgeAttributeTypes == nullptr)
+			return nullptr;
+		}
+	if ( (geomData.numVertexAttributeTypes != 0) && (geomData.vertexAttributeTypes == nullptr) ){
+		geomData.vertexAttributeTypes = (TQ3TriMeshAttributeData *)Q3Memory_AllocateClear(sizeof(TQ3TriMeshAttributeData) * geomData.numVertexAttributeTypes);
+		if(geomData.vertexAttributeTypes == nullptr)
+			return nullptr;
+		}
+
+	// Read in the attributes
+	while(Q3File_IsEndOfContainer(theFile,nullptr) == kQ3False){
+		childObject = Q3File_ReadObject(theFile);
+		// the kE3attributearray objects, are read but not created
+		// thir read method just fills the currentTriMesh data
+		if(childObject != nullptr){
+			if(Q3Object_IsType (childObject, kQ3SetTypeAttribute))
+				{
+				geomData.triMeshAttributeSet = childObject;
+				}
+			else if ( Q3Object_IsType (childObject, kQ3SharedTypeSet) )
+				e3read_3dmf_merge_element_set( &elementSet, childObject );
+			else
+				Q3Object_Dispose(childObject);
+			}
+		}
+
+
+
+	// Create the geometry. The arrays were allocated with the Quesa memory
+	// allocators, so the TriMesh can take them over rather than copying
+	// them. That path does not check the indices, so we do it here.
+	if (E3TriMesh_ValidateData(&geomData) == kQ3Success)
+		theObject = E3TriMesh_New_NoCopy(&geomData);
+
+	if (theObject != nullptr)
+		{
+		// The TriMesh now owns the arrays, but holds its own reference to
+		// the attribute set
+		Q3Object_CleanDispose(&geomData.triMeshAttributeSet);
+		Q3Memory_Clear(&geomData, sizeof(geomData));
+		}
+
+
+
+	// Apply any custom elements
+	E3Read_3DMF_Shape_Apply_Element_Set( theObject, elementSet );
+
+	return theObject;
+}
+
+
+
 //=============================================================================
 //      Public functions
 //-----------------------------------------------------------------------------
@@ -3984,13 +4063,11 @@ cleanup:
 //-----------------------------------------------------------------------------
 TQ3Object
 E3Read_3DMF_Geom_TriMesh(TQ3FileObject theFile)
-{	TQ3Object				childObject;
-	TQ3Object	 			theObject = nullptr;
+{	TQ3Object	 			theObject = nullptr;
 	TQ3TriMeshData			geomData;
 	TQ3Uns16				temp16;
 	TQ3Uns8					temp8;
 	TQ3Uns32				i;
-	TQ3Object				elementSet = nullptr;
 	TQ3StorageObject		theStorage = nullptr;
 	TQ3Uns32				storageSize;
 
@@ -4221,59 +4298,94 @@ E3Read_3DMF_Geom_TriMesh(TQ3FileObject theFile)
 	Q3Uns32_Read(&i, theFile);
 	geomData.bBox.isEmpty = (TQ3Boolean)i;
 	
-	//================ Read in the attributes
-	
-	// allocate the arrays
-	if(geomData.numTriangleAttributeTypes != 0){
-		geomData.triangleAttributeTypes = (TQ3TriMeshAttributeData *)Q3Memory_AllocateClear(sizeof(TQ3TriMeshAttributeData) * geomData.numTriangleAttributeTypes);
-		if(geomData.triangleAttributeTypes == nullptr)
-			goto cleanUp;
-		}
-	if(geomData.numEdgeAttributeTypes != 0){
-		geomData.edgeAttributeTypes = (TQ3TriMeshAttributeData *)Q3Memory_AllocateClear(sizeof(TQ3TriMeshAttributeData) * geomData.numEdgeAttributeTypes);
-		if(geomData.edgeAttributeTypes == nullptr)
-			goto cleanUp;
+	// Read the sub-objects and create the geometry
+	theObject = e3read_3dmf_trimesh_finish( theFile, geomData );
+
+
+
+	// Clean up
+cleanUp:
+	Q3TriMesh_EmptyData(&geomData);	// this is illegal in QD3D since we have allocated
+									// the memory, but since we're using the Quesa memory
+									// allocators it's fine to use it here
+		
+	((TE3FFormat3DMF_Data*) format->FindLeafInstanceData () )->currentTriMesh = nullptr;
+	return theObject;
+}
+
+
+
+
+
+//=============================================================================
+//      E3Read_3DMF_Geom_CompressedTriMesh : CompressedTriMesh read method.
+//-----------------------------------------------------------------------------
+TQ3Object
+E3Read_3DMF_Geom_CompressedTriMesh(TQ3FileObject theFile)
+{	TQ3Object	 			theObject = nullptr;
+	TQ3TriMeshData			geomData;
+	TE3FFormat3DMF_CompressedTriMesh_Data	compressedData;
+
+
+
+	// Initialise the geometry data
+	Q3Memory_Clear(&geomData, sizeof(geomData));
+	Q3Memory_Clear(&compressedData, sizeof(compressedData));
+
+
+
+	// let know the system we're reading a trimesh
+	TQ3FileFormatObject format = ( (E3File*) theFile )->GetFileFormat () ;
+	((TE3FFormat3DMF_Data*) format->FindLeafInstanceData () )->currentTriMesh = &geomData;
+
+
+
+	// Read the header and the compressed block
+	if (E3FFormat_3DMF_CompressedTriMesh_Read( theFile, &compressedData ) != kQ3Success)
+		{
+		E3ErrorManager_PostError(kQ3ErrorInvalidMetafile, kQ3False);
+		goto cleanUp;
 		}
+
+	geomData.numTriangles				= compressedData.numTriangles;
+	geomData.numTriangleAttributeTypes	= compressedData.numTriangleAttributeTypes;
+	geomData.numEdges					= compressedData.numEdges;
+	geomData.numEdgeAttributeTypes		= compressedData.numEdgeAttributeTypes;
+	geomData.numPoints					= compressedData.numPoints;
+	geomData.numVertexAttributeTypes	= compressedData.numVertexAttributeTypes;
+	geomData.bBox						= compressedData.bBox;
+
+	if ( (geomData.numPoints == 0) || (geomData.numTriangles == 0) )
+		goto cleanUp;
+
+
+
+	// Decode the arrays.  The vertex attribute array must exist first, since
+	// the vertex normals and UVs are decoded into it.
 	if(geomData.numVertexAttributeTypes != 0){
 		geomData.vertexAttributeTypes = (TQ3TriMeshAttributeData *)Q3Memory_AllocateClear(sizeof(TQ3TriMeshAttributeData) * geomData.numVertexAttributeTypes);
 		if(geomData.vertexAttributeTypes == nullptr)
 			goto cleanUp;
 		}
 
-	// Read in the attributes
-	while(Q3File_IsEndOfContainer(theFile,nullptr) == kQ3False){
-		childObject = Q3File_ReadObject(theFile);
-		// the kE3attributearray objects, are read but not created
-		// thir read method just fills the currentTriMesh data
-		if(childObject != nullptr){
-			if(Q3Object_IsType (childObject, kQ3SetTypeAttribute))
-				{
-				geomData.triMeshAttributeSet = childObject;
-				}
-			else if ( Q3Object_IsType (childObject, kQ3SharedTypeSet) )
-				e3read_3dmf_merge_element_set( &elementSet, childObject );
-			else
-				Q3Object_Dispose(childObject);
-			}
+	if (E3FFormat_3DMF_DecompressTriMesh( &compressedData, &geomData ) != kQ3Success)
+		{
+		E3ErrorManager_PostError(kQ3ErrorInvalidMetafile, kQ3False);
+		goto cleanUp;
 		}
+	E3FFormat_3DMF_CompressedTriMesh_Empty( &compressedData );
 
 
 
-	// Create the geometry
-	theObject = Q3TriMesh_New(&geomData);
-
-
-	
-	// Apply any custom elements
-	E3Read_3DMF_Shape_Apply_Element_Set( theObject, elementSet );
+	// Read any other attribute arrays and create the geometry
+	theObject = e3read_3dmf_trimesh_finish( theFile, geomData );
 
 
 
 	// Clean up
 cleanUp:
-	Q3TriMesh_EmptyData(&geomData);	// this is illegal in QD3D since we have allocated
-									// the memory, but since we're using the Quesa memory
-									// allocators it's fine to use it here
+	E3FFormat_3DMF_CompressedTriMesh_Empty( &compressedData );
+	Q3TriMesh_EmptyData(&geomData);
 		
 	((TE3FFormat3DMF_Data*) format->FindLeafInstanceData () )->currentTriMesh = nullptr;
 	return theObject;
@@ -47,7 +47,9 @@
 #include "E3FFW_3DMFBin_Geometry.h"
 #include "E3FFW_3DMFBin_Writer.h"
 #include "E3Set.h"
+#include "E3View.h"
 #include "E3CustomElements.h"
+#include "E3FFR_3DMF_CompressedTriMesh.h"
 
 
 
@@ -3158,20 +3160,55 @@ e3ffw_3DMF_trimesh_traverse(TQ3Object object,
 	}
 
 
-	// Compute size of data
-	size = 6 * sizeof(TQ3Uns32);
-		// array of triangles
-	pointIndexBytes = e3ffw_3DMF_num_index_bytes( data->numPoints );
-	size += data->numTriangles * pointIndexBytes * 3;
-		// array of edges
-	triIndexBytes = e3ffw_3DMF_num_index_bytes( data->numTriangles );
-	size += data->numEdges * 2 * (pointIndexBytes + triIndexBytes);
-		// array of points
-	size += static_cast<TQ3Uns32>(data->numPoints * sizeof(TQ3Point3D));
-		// bounding box
-	size += Q3Size_Pad( sizeof(TQ3BoundingBox) );
+	// If asked to, write a CompressedTriMesh in place of the TriMesh.  The
+	// compressed object holds the vertex normals and UVs, if any, so those
+	// arrays must not be written again below.
+	TE3FFormatW3DMF_Data*	formatData = (TE3FFormatW3DMF_Data*)
+		E3View_AccessFileFormat( view )->FindLeafInstanceData();
+	TQ3Uns32	skipNormals = kQ3ArrayIndexNULL;
+	TQ3Uns32	skipUVs = kQ3ArrayIndexNULL;
 	
-	qd3dstatus = Q3XView_SubmitWriteData (view, size, (void*)data, nullptr);
+	if (formatData->triMeshPositionBits != 0)
+	{
+		TE3FFormat3DMF_CompressedTriMesh_Data*	compressedData =
+			(TE3FFormat3DMF_CompressedTriMesh_Data*) Q3Memory_AllocateClear(
+				sizeof(TE3FFormat3DMF_CompressedTriMesh_Data) );
+		Q3_REQUIRE_OR_RESULT( compressedData != nullptr, kQ3Failure );
+		
+		if (kQ3Success != E3FFormat_3DMF_CompressTriMesh( data,
+			formatData->triMeshPositionBits, compressedData ))
+		{
+			E3FFormat_3DMF_CompressedTriMesh_Delete( compressedData );
+			return kQ3Failure;
+		}
+		
+		skipNormals = compressedData->normalIndex;
+		skipUVs = compressedData->uvIndex;
+		
+		// The write method is found from lastObjectType, which our caller
+		// restores when we return.
+		formatData->lastObjectType = kQ3ObjectTypeCompressedTriMesh;
+		qd3dstatus = Q3XView_SubmitWriteData( view,
+			E3FFormat_3DMF_CompressedTriMesh_Size( compressedData ), compressedData,
+			E3FFormat_3DMF_CompressedTriMesh_Delete );
+	}
+	else
+	{
+		// Compute size of data
+		size = 6 * sizeof(TQ3Uns32);
+			// array of triangles
+		pointIndexBytes = e3ffw_3DMF_num_index_bytes( data->numPoints );
+		size += data->numTriangles * pointIndexBytes * 3;
+			// array of edges
+		triIndexBytes = e3ffw_3DMF_num_index_bytes( data->numTriangles );
+		size += data->numEdges * 2 * (pointIndexBytes + triIndexBytes);
+			// array of points
+		size += static_cast<TQ3Uns32>(data->numPoints * sizeof(TQ3Point3D));
+			// bounding box
+		size += Q3Size_Pad( sizeof(TQ3BoundingBox) );
+	
+		qd3dstatus = Q3XView_SubmitWriteData (view, size, (void*)data, nullptr);
+	}
 	
 	// Attribute array subobjects
 	
@@ -3193,7 +3230,8 @@ e3ffw_3DMF_trimesh_traverse(TQ3Object object,
 	for (i = 0; (qd3dstatus == kQ3Success) &&
 		(i < data->numVertexAttributeTypes); ++i)
 	{
-		qd3dstatus = e3ffw_3DMF_submit_tm_attarray( view, data, 2, i );
+		if ( (i != skipNormals) && (i != skipUVs) )
+			qd3dstatus = e3ffw_3DMF_submit_tm_attarray( view, data, 2, i );
 	}
 	
 	// Overall attribute set (don't write it unless it's nonempty)
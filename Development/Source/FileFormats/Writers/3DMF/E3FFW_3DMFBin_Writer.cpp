@@ -47,6 +47,9 @@
 #include "E3View.h"
 #include "E3FFW_3DMFBin_Writer.h"
 #include "E3Main.h"
+#include "CQ3ObjectRef.h"
+
+#include <vector>
 
 
 
@@ -76,6 +79,121 @@ e3ffw_3DMF_TraverseObject_CheckRef(TQ3ViewObject			theView,
 
 
 
+//=============================================================================
+//      e3ffw_3DMF_serialize_object : Write an object to memory in stream mode.
+//-----------------------------------------------------------------------------
+//		Stream mode writes shared sub-objects inline rather than as references,
+//		so the bytes depend only on the content of the object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3ffw_3DMF_serialize_object( TQ3Object theObject, std::vector<TQ3Uns8>& outBytes )
+{
+	outBytes.clear();
+	
+	CQ3ObjectRef	theStorage( Q3MemoryStorage_New( nullptr, 0 ) );
+	CQ3ObjectRef	theFile( Q3File_New() );
+	CQ3ObjectRef	theView( Q3View_New() );
+	if ( (theStorage.get() == nullptr) || (theFile.get() == nullptr) ||
+		(theView.get() == nullptr) )
+		return (kQ3Failure);
+	
+	TQ3Status	status = Q3File_SetStorage( theFile.get(), theStorage.get() );
+	if (status == kQ3Success)
+		status = Q3File_OpenWrite( theFile.get(), kQ3FileModeStream );
+	if (status != kQ3Success)
+		return (kQ3Failure);
+	
+	status = Q3View_StartWriting( theView.get(), theFile.get() );
+	if (status == kQ3Success)
+	{
+		do
+		{
+			status = Q3Object_Submit( theObject, theView.get() );
+		} while (Q3View_EndWriting( theView.get() ) == kQ3ViewStatusRetraverse);
+	}
+	Q3File_Close( theFile.get() );
+	
+	unsigned char*	theBuffer = nullptr;
+	TQ3Uns32		validSize = 0;
+	if ( (status == kQ3Success) &&
+		(Q3MemoryStorage_GetBuffer( theStorage.get(), &theBuffer, &validSize,
+			nullptr ) == kQ3Success) && (theBuffer != nullptr) )
+	{
+		outBytes.assign( theBuffer, theBuffer + validSize );
+	}
+	
+	return outBytes.empty() ? kQ3Failure : kQ3Success;
+}
+
+
+
+//=============================================================================
+//      e3ffw_3DMF_find_identical : Look for an earlier TOC entry with the
+//		same content as an object.
+//-----------------------------------------------------------------------------
+//		On entry, ioTocIndex is the index that the object will receive if it
+//		is new.  If an identical object is found, ioTocIndex is changed to its
+//		index and we return true.  Otherwise the content hash is remembered
+//		for the object's index entry.
+//
+//		Hashes are only a filter: a match is confirmed by comparing the bytes
+//		of both objects, so a collision just costs an extra serialization.
+//		In streaming mode, earlier objects that have since been deleted can
+//		no longer be compared and are skipped.
+//-----------------------------------------------------------------------------
+static bool
+e3ffw_3DMF_find_identical( TE3FFormatW3DMF_Data *fileFormatPrivate,
+							TE3FFormatW3DMF_Map::iterator inEntry,
+							TQ3Uns32& ioTocIndex )
+{
+	TQ3Object	theObject = inEntry->second.object;
+
+	const uint64_t	kFNVOffsetBasis	= 14695981039346656037ULL;
+	const uint64_t	kFNVPrime		= 1099511628211ULL;
+	
+	std::vector<TQ3Uns8>	theBytes;
+	if (e3ffw_3DMF_serialize_object( theObject, theBytes ) != kQ3Success)
+		return false;
+	
+	uint64_t	theHash = kFNVOffsetBasis;
+	for (TQ3Uns8 theByte : theBytes)
+	{
+		theHash ^= theByte;
+		theHash *= kFNVPrime;
+	}
+	
+	if (fileFormatPrivate->contentIndex == nullptr)
+	{
+		fileFormatPrivate->contentIndex = new TE3FFormatW3DMF_ContentMap;
+	}
+	
+	std::pair< TE3FFormatW3DMF_ContentMap::iterator,
+		TE3FFormatW3DMF_ContentMap::iterator > matches =
+		fileFormatPrivate->contentIndex->equal_range( theHash );
+	
+	std::vector<TQ3Uns8>	otherBytes;
+	for (TE3FFormatW3DMF_ContentMap::iterator it = matches.first;
+		it != matches.second; ++it)
+	{
+		TQ3Object	otherObject = it->second->second.object;
+		
+		if ( (otherObject != nullptr) && (it->second != inEntry) &&
+			(e3ffw_3DMF_serialize_object( otherObject, otherBytes ) == kQ3Success) &&
+			(otherBytes == theBytes) )
+		{
+			ioTocIndex = it->second->second.tocIndex;
+			return true;
+		}
+	}
+	
+	fileFormatPrivate->contentIndex->insert(
+		TE3FFormatW3DMF_ContentMap::value_type( theHash, inEntry ) );
+	
+	return false;
+}
+
+
+
 //=============================================================================
 //      e3ffw_3DMF_filter_in_toc : Adds the object to the TOC if needed and
 //      returns a reference object
@@ -83,7 +201,7 @@ e3ffw_3DMF_TraverseObject_CheckRef(TQ3ViewObject			theView,
 static TQ3Status
 e3ffw_3DMF_filter_in_toc(TE3FFormatW3DMF_Data *fileFormatPrivate,  TQ3Object theObject , TQ3Object *theReference)
 {
-	const TQ3Uns32 TOC_GROW_SIZE = 1024;
+	const TQ3Uns32 TOC_GROW_SIZE = 1024;	// must be a power of 2
 
 	TE3FFormat3DMF_TOC	*toc = fileFormatPrivate->toc;
 	TQ3Uns32			tocSize, i;
@@ -141,20 +259,52 @@ e3ffw_3DMF_filter_in_toc(TE3FFormatW3DMF_Data *fileFormatPrivate,  TQ3Object the
 	// If the object is already in the table of contents, we want to find it,
 	// and if it is not, we will add it.  We need only search the index once.
 	
-	TE3FFormatW3DMF_Map::value_type newRec( theObject, toc->nEntries );
+	TE3FFormatW3DMF_MapEntry	newEntry = { toc->nEntries, nullptr };
+	TE3FFormatW3DMF_Map::value_type newRec( theObject, newEntry );
 	
 	std::pair< TE3FFormatW3DMF_Map::iterator, bool > insertResult =
 		fileFormatPrivate->index->insert( newRec );
+	
+	TE3FFormatW3DMF_MapEntry&	theEntry( insertResult.first->second );
+	bool	isNew = insertResult.second;
+	
+	// In streaming mode the index only holds weak references, so an entry
+	// whose reference has been zeroed belongs to a deleted object whose
+	// address has been reused.
+	if (theEntry.object == nullptr)
+	{
+		theEntry.tocIndex = toc->nEntries;
+		theEntry.object = theObject;
+		if (fileFormatPrivate->streaming == kQ3True)
+			Q3Object_GetWeakReference( &theEntry.object );
+		else
+			Q3Shared_GetReference( theObject );
+		isNew = true;
+	}
+	
+	i = theEntry.tocIndex;
+	
+	// A new object may still have the same content as an earlier one, in
+	// which case we treat it as if it were that object.
+	if ( isNew && (createReference == kQ3True) &&
+		(fileFormatPrivate->mergeIdentical == kQ3True) &&
+		(Q3Object_IsType( theObject, kQ3ShapeTypeGroup ) == kQ3False) &&
+		e3ffw_3DMF_find_identical( fileFormatPrivate, insertResult.first, i ) )
+	{
+		theEntry.tocIndex = i;
+		isNew = false;
+	}
 		
-	if (insertResult.second) // inserted a new entry, so it was not there before
+	if (isNew) // inserted a new entry, so it was not there before
 	{
-		// make room for the new TOC entry
+		// make room for the new TOC entry, doubling the capacity each time
+		// so that huge scenes do not cause repeated copying
 
-		if ((toc->nEntries != 0) && (toc->nEntries % TOC_GROW_SIZE == 0))
+		if ((toc->nEntries >= TOC_GROW_SIZE) && ((toc->nEntries & (toc->nEntries - 1)) == 0))
 		{
 			tocSize = static_cast<TQ3Uns32>(sizeof(TE3FFormat3DMF_TOC) + 
 			
-					(sizeof(TE3FFormat3DMF_TOCEntry) * (toc->nEntries + TOC_GROW_SIZE - 1)));
+					(sizeof(TE3FFormat3DMF_TOCEntry) * (2 * toc->nEntries - 1)));
 			if(Q3Memory_Reallocate(&fileFormatPrivate->toc,tocSize) != kQ3Success)
 				return (kQ3Failure);
 				
@@ -169,7 +319,7 @@ e3ffw_3DMF_filter_in_toc(TE3FFormatW3DMF_Data *fileFormatPrivate,  TQ3Object the
 		else
 			toc->tocEntries[toc->nEntries].refID = 0;
 			
-		toc->tocEntries[toc->nEntries].object = Q3Shared_GetReference(theObject);
+		toc->tocEntries[toc->nEntries].object = nullptr; // the index holds the object
 		toc->tocEntries[toc->nEntries].objType = fileFormatPrivate->lastObjectType;
 		toc->tocEntries[toc->nEntries].objLocation.hi = 0;
 		toc->tocEntries[toc->nEntries].objLocation.lo = 0; // will be filled in e3ffw_3DMF_write_objects
@@ -181,10 +331,8 @@ e3ffw_3DMF_filter_in_toc(TE3FFormatW3DMF_Data *fileFormatPrivate,  TQ3Object the
 		
 		*theReference = Q3Shared_GetReference(theObject);
 	}
-	else	// the object was already there
+	else	// the object, or an identical one, was already there
 	{
-		i = insertResult.first->second;
-		
 		if (createReference == kQ3True)
 		{
 			if (toc->tocEntries[i].refID == 0)
@@ -315,6 +463,24 @@ E3FFW_3DMF_StartFile(TQ3ViewObject				theView,
 						TQ3DrawContextObject	theDrawContext)
 {
 #pragma unused(theDrawContext)
+	TQ3Boolean	mergeIdentical = kQ3False;
+	Q3Object_GetProperty( E3View_AccessFile( theView ),
+		kQ3FilePropertyMergeIdenticalObjects, sizeof(mergeIdentical), nullptr,
+		&mergeIdentical );
+	fileFormatPrivate->mergeIdentical = mergeIdentical;
+	
+	TQ3Boolean	streaming = kQ3False;
+	Q3Object_GetProperty( E3View_AccessFile( theView ),
+		kQ3FilePropertyStreamingWrite, sizeof(streaming), nullptr,
+		&streaming );
+	fileFormatPrivate->streaming = streaming;
+	
+	TQ3Uns32	positionBits = 0;
+	Q3Object_GetProperty( E3View_AccessFile( theView ),
+		kQ3FilePropertyCompressTriMeshes, sizeof(positionBits), nullptr,
+		&positionBits );
+	fileFormatPrivate->triMeshPositionBits = positionBits;
+	
   	TQ3Status status = fileFormatPrivate->baseData.currentStoragePosition > 0 ? kQ3Success :
   						E3FFW_3DMF_TraverseObject (theView, fileFormatPrivate, nullptr, kQ3ObjectType3DMF, fileFormatPrivate);
 	
@@ -449,25 +615,32 @@ E3FFW_3DMF_Close( TQ3FileFormatObject format, TQ3Boolean abort )
 {
 	TE3FFormatW3DMF_Data*	instanceData = (TE3FFormatW3DMF_Data*) format->FindLeafInstanceData () ;
 	TQ3Status				status = kQ3Success;
-	TE3FFormat3DMF_TOC		*toc = instanceData->toc;
-	TQ3Uns32				i;
 	
-	if(toc != nullptr) // delete the toc
+	if(instanceData->toc != nullptr) // delete the toc
 		{
-		for(i = 0; i < toc->nEntries; i++)
-			{
-			if(toc->tocEntries[i].object != nullptr)
-				{
-				Q3Object_Dispose(toc->tocEntries[i].object);
-				}
-			}
 		Q3Memory_Free(&instanceData->toc);
 		}
 	
 	if (instanceData->index != nullptr)
 	{
+		for (TE3FFormatW3DMF_Map::iterator it = instanceData->index->begin();
+			it != instanceData->index->end(); ++it)
+		{
+			if (it->second.object == nullptr)
+				continue;
+			
+			if (instanceData->streaming == kQ3True)
+				Q3Object_ReleaseWeakReference( &it->second.object );
+			else
+				Q3Object_Dispose( it->second.object );
+		}
 		delete instanceData->index;
 	}
+	
+	if (instanceData->contentIndex != nullptr)
+	{
+		delete instanceData->contentIndex;
+	}
 		
 			
 	return status;
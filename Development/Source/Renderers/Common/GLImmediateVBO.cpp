@@ -46,6 +46,8 @@
 #include "GLUtils.h"
 #include "QORenderer.h"
 
+#include <cstring>
+
 #ifndef GL_ARRAY_BUFFER
 	#define GL_ARRAY_BUFFER					0x8892
 	#define GL_ELEMENT_ARRAY_BUFFER			0x8893
@@ -53,6 +55,16 @@
 	#define GL_DYNAMIC_DRAW                 0x88E8
 #endif
 
+#ifndef GL_STREAM_DRAW
+	#define GL_STREAM_DRAW					0x88E0
+#endif
+
+#ifndef GL_MAP_WRITE_BIT
+	#define GL_MAP_WRITE_BIT				0x0002
+	#define GL_MAP_INVALIDATE_RANGE_BIT		0x0004
+	#define GL_MAP_UNSYNCHRONIZED_BIT		0x0020
+#endif
+
 
 namespace
 {
@@ -60,6 +72,32 @@ namespace
 	
 	const GLsizeiptr	kAbsentBuffer	= -1;
 	
+	// Initial ring sizes for vertex and index data.  A draw that is larger
+	// than its ring makes the ring grow.
+	const GLsizeiptr	kArrayRingSize		= 4 * 1024 * 1024;
+	const GLsizeiptr	kElementRingSize	= 1024 * 1024;
+	
+	// Sub-allocations start on this boundary
+	const GLsizeiptr	kRingAlignment		= 64;
+	
+	enum ERing
+	{
+		kArrayRing = 0,
+		kElementRing
+	};
+	
+	/*
+		ImmedVBOCache holds a pair of ring buffers, one for vertex data and
+		one for index data, per OpenGL sharing group.
+		
+		Each draw gets a fresh region of a ring, so we never overwrite data
+		that the GPU may still be reading for an earlier draw.  When a ring
+		is full, we orphan its storage with glBufferData(nullptr) and start
+		again at the beginning; the driver keeps the old storage alive until
+		the GPU is done with it.  Because of that, regions can be written
+		with an unsynchronized glMapBufferRange, or glBufferSubData if
+		mapping is not available, without an implicit wait for the GPU.
+	*/
 	class ImmedVBOCache : public CQ3GPSharedCache
 	{
 	public:
@@ -67,16 +105,32 @@ namespace
 						~ImmedVBOCache();
 						
 		void			InitBuffers( const QORenderer::GLFuncs& inFuncs );
-		void			UpdateBufferSizes( const QORenderer::GLFuncs& inFuncs,
-											GLsizeiptr inArrayDataSize,
-											GLsizeiptr inElementDataSize );
 		
-		void			BindArrayBuffer( const QORenderer::GLFuncs& inFuncs ) const;
-		void			BindElementBuffer( const QORenderer::GLFuncs& inFuncs ) const;
+		GLintptr		BeginWrite( const QORenderer::GLFuncs& inFuncs,
+									ERing inRing,
+									GLsizeiptr inDataSize );
+		GLintptr		Write( const QORenderer::GLFuncs& inFuncs,
+									const GLvoid* inData,
+									GLsizeiptr inDataSize );
+		void			EndWrite( const QORenderer::GLFuncs& inFuncs );
 		
 	private:
+		static GLenum	Target( ERing inRing )
+						{
+							return (inRing == kArrayRing)? GL_ARRAY_BUFFER :
+								GL_ELEMENT_ARRAY_BUFFER;
+						}
+	
 		GLuint			_GLBufferNames[2];	// 0 is array, 1 is element
 		GLsizeiptr		_GLBufferSize[2];
+		GLsizeiptr		_RingHead[2];
+		
+		// State of the write in progress
+		ERing			_WriteRing;
+		GLintptr		_WriteOffset;
+		GLsizeiptr		_WriteSize;
+		GLsizeiptr		_WriteUsed;
+		TQ3Uns8*		_WriteMapping;
 	};
 }
 
@@ -102,9 +156,15 @@ static ImmedVBOCache* GetVBOCache( TQ3GLContext glContext )
 
 
 ImmedVBOCache::ImmedVBOCache()
+	: _WriteRing( kArrayRing )
+	, _WriteOffset( 0 )
+	, _WriteSize( 0 )
+	, _WriteUsed( 0 )
+	, _WriteMapping( nullptr )
 {
 	_GLBufferNames[0] = _GLBufferNames[1] = 0;
 	_GLBufferSize[0] = _GLBufferSize[1] = 0;
+	_RingHead[0] = _RingHead[1] = 0;
 }
 
 ImmedVBOCache::~ImmedVBOCache()
@@ -122,39 +182,205 @@ void	ImmedVBOCache::InitBuffers( const QORenderer::GLFuncs& inFuncs )
 	}
 }
 
-void	ImmedVBOCache::UpdateBufferSizes( const QORenderer::GLFuncs& inFuncs,
-										GLsizeiptr inArrayDataSize,
-										GLsizeiptr inElementDataSize )
+/*
+	BeginWrite
+	
+	Bind one of the rings and reserve inDataSize bytes of it, orphaning
+	or enlarging the storage if need be.  The result is the offset of the
+	reserved region, which is then filled by calls to Write.
+*/
+GLintptr	ImmedVBOCache::BeginWrite( const QORenderer::GLFuncs& inFuncs,
+										ERing inRing,
+										GLsizeiptr inDataSize )
 {
-	if (inArrayDataSize > _GLBufferSize[0])
+	const GLenum	target = Target( inRing );
+	(*inFuncs.glBindBufferProc)( target, _GLBufferNames[ inRing ] );
+	
+	GLsizeiptr	alignedSize = (inDataSize + kRingAlignment - 1) & ~(kRingAlignment - 1);
+	
+	if (alignedSize > _GLBufferSize[ inRing ])
+	{
+		// Grow the ring
+		GLsizeiptr	newSize = (inRing == kArrayRing)? kArrayRingSize : kElementRingSize;
+		while (newSize < alignedSize)
+		{
+			newSize *= 2;
+		}
+		_GLBufferSize[ inRing ] = newSize;
+		(*inFuncs.glBufferDataProc)( target, newSize, nullptr, GL_STREAM_DRAW );
+		_RingHead[ inRing ] = 0;
+	}
+	else if (_RingHead[ inRing ] + alignedSize > _GLBufferSize[ inRing ])
 	{
-		(*inFuncs.glBindBufferProc)( GL_ARRAY_BUFFER, _GLBufferNames[0] );
-		_GLBufferSize[0] = inArrayDataSize * 2;
-		(*inFuncs.glBufferDataProc)( GL_ARRAY_BUFFER, _GLBufferSize[0], nullptr,
-			GL_DYNAMIC_DRAW );
+		// Wrap around, orphaning the storage that earlier draws may be using
+		(*inFuncs.glBufferDataProc)( target, _GLBufferSize[ inRing ], nullptr,
+			GL_STREAM_DRAW );
+		_RingHead[ inRing ] = 0;
 	}
 	
-	if (inElementDataSize > _GLBufferSize[1])
+	_WriteRing = inRing;
+	_WriteOffset = _RingHead[ inRing ];
+	_WriteSize = inDataSize;
+	_WriteUsed = 0;
+	_RingHead[ inRing ] += alignedSize;
+	
+	_WriteMapping = nullptr;
+	if ( (inFuncs.glMapBufferRangeProc != nullptr) &&
+		(inFuncs.glUnmapBufferProc != nullptr) )
 	{
-		(*inFuncs.glBindBufferProc)( GL_ELEMENT_ARRAY_BUFFER, _GLBufferNames[1] );
-		_GLBufferSize[1] = inElementDataSize * 2;
-		(*inFuncs.glBufferDataProc)( GL_ELEMENT_ARRAY_BUFFER, _GLBufferSize[1], nullptr,
-			GL_DYNAMIC_DRAW );
+		_WriteMapping = static_cast<TQ3Uns8*>( (*inFuncs.glMapBufferRangeProc)(
+			target, _WriteOffset, inDataSize,
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT ) );
 	}
+	
+	return _WriteOffset;
 }
 
-void	ImmedVBOCache::BindArrayBuffer( const QORenderer::GLFuncs& inFuncs ) const
+/*
+	Write
+	
+	Append data to the region reserved by BeginWrite.  The result is the
+	offset of the data within the buffer.
+*/
+GLintptr	ImmedVBOCache::Write( const QORenderer::GLFuncs& inFuncs,
+									const GLvoid* inData,
+									GLsizeiptr inDataSize )
 {
-	(*inFuncs.glBindBufferProc)( GL_ARRAY_BUFFER, _GLBufferNames[0] );
+	Q3_ASSERT( _WriteUsed + inDataSize <= _WriteSize );
+	GLintptr	dataOffset = _WriteOffset + _WriteUsed;
+	
+	if (_WriteMapping != nullptr)
+	{
+		std::memcpy( _WriteMapping + _WriteUsed, inData, inDataSize );
+	}
+	else
+	{
+		(*inFuncs.glBufferSubDataProc)( Target( _WriteRing ), dataOffset,
+			inDataSize, inData );
+		CHECK_GL_ERROR;
+	}
+	_WriteUsed += inDataSize;
+	
+	return dataOffset;
 }
 
-void	ImmedVBOCache::BindElementBuffer( const QORenderer::GLFuncs& inFuncs ) const
+void	ImmedVBOCache::EndWrite( const QORenderer::GLFuncs& inFuncs )
 {
-	(*inFuncs.glBindBufferProc)( GL_ELEMENT_ARRAY_BUFFER, _GLBufferNames[1] );
+	if (_WriteMapping != nullptr)
+	{
+		(*inFuncs.glUnmapBufferProc)( Target( _WriteRing ) );
+		_WriteMapping = nullptr;
+	}
 }
 
 #pragma mark -
 
+/*!
+	@function	StreamImmediateVertices
+	
+	@abstract	Copy separate vertex arrays into the array ring and point the
+				vertex attributes of the current program at them.
+*/
+template <typename ColorType>
+static void	StreamImmediateVertices(
+								ImmedVBOCache& inCache,
+								const QORenderer::Renderer& inRenderer,
+								TQ3Uns32 inNumPoints,
+								const TQ3Point3D* inPoints,
+								const TQ3Vector3D* inNormals,
+								const ColorType* inColors,
+								const TQ3Param2D* inUVs )
+{
+	const QORenderer::ProgramRec* theProgram = inRenderer.Shader().CurrentProgram();
+	
+	// Compute sub-buffer sizes for array data
+	GLsizeiptr	vertexDataSize = static_cast<GLsizeiptr>(inNumPoints * sizeof(TQ3Point3D));
+	GLsizeiptr	normalDataSize = (inNormals == nullptr)? 0 :
+		static_cast<GLsizeiptr>(inNumPoints * sizeof(TQ3Vector3D));
+	GLsizeiptr	colorDataSize = (inColors == nullptr)? 0 :
+		static_cast<GLsizeiptr>(inNumPoints * sizeof(ColorType));
+	GLsizeiptr	uvDataSize = (inUVs == nullptr)? 0 :
+		static_cast<GLsizeiptr>(inNumPoints * sizeof(TQ3Param2D));
+	GLsizeiptr	totalArrayDataSize = vertexDataSize + normalDataSize +
+		colorDataSize + uvDataSize;
+	
+	// Copy the data into the array ring
+	GLintptr	vertexOffset = inCache.BeginWrite( inRenderer.Funcs(), kArrayRing,
+		totalArrayDataSize );
+	inRenderer.Counts().mBufferBinds += 1;
+	inCache.Write( inRenderer.Funcs(), inPoints, vertexDataSize );
+	GLintptr	normalOffset = (inNormals == nullptr)? kAbsentBuffer :
+		inCache.Write( inRenderer.Funcs(), inNormals, normalDataSize );
+	GLintptr	colorOffset = (inColors == nullptr)? kAbsentBuffer :
+		inCache.Write( inRenderer.Funcs(), inColors, colorDataSize );
+	GLintptr	uvOffset = (inUVs == nullptr)? kAbsentBuffer :
+		inCache.Write( inRenderer.Funcs(), inUVs, uvDataSize );
+	inCache.EndWrite( inRenderer.Funcs() );
+	CHECK_GL_ERROR;
+		
+	// Associate vertex data pointers with sub-buffers
+	inRenderer.SLFuncs().glVertexAttribPointer( theProgram->mVertexAttribLoc,
+		3, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( vertexOffset ) );
+	if (inNormals != nullptr)
+	{
+		inRenderer.SLFuncs().glVertexAttribPointer( theProgram->mNormalAttribLoc,
+			3, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( normalOffset ) );
+	}
+	if (inColors != nullptr)
+	{
+		inRenderer.SLFuncs().glVertexAttribPointer( theProgram->mColorAttribLoc,
+			(GLint)(sizeof(ColorType) / sizeof(float)), GL_FLOAT, GL_FALSE, 0,
+			GLBufferObPtr( colorOffset ) );
+	}
+	if (inUVs != nullptr)
+	{
+		inRenderer.SLFuncs().glVertexAttribPointer( theProgram->mTexCoordAttribLoc,
+			2, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( uvOffset ) );
+	}
+}
+
+/*!
+	@function	DrawImmediate
+	
+	@abstract	Draw vertices previously loaded by StreamImmediateVertices,
+				copying indices into the element ring if there are any.
+*/
+static void DrawImmediate(	ImmedVBOCache& inCache,
+							const QORenderer::Renderer& inRenderer,
+							GLenum inMode,
+							TQ3Uns32 inNumPoints,
+							TQ3Uns32 inNumIndices,
+							const TQ3Uns32* inIndices )
+{
+	if (inIndices == nullptr)
+	{
+		(*inRenderer.Funcs().glBindBufferProc)( GL_ELEMENT_ARRAY_BUFFER, 0 );
+		glDrawArrays( inMode, 0, inNumPoints );
+		inRenderer.Counts().mBufferBinds += 1;
+	}
+	else
+	{
+		// Copy data into element ring
+		GLsizeiptr	elementDataSize = inNumIndices * sizeof(TQ3Uns32);
+		GLintptr	elementOffset = inCache.BeginWrite( inRenderer.Funcs(),
+			kElementRing, elementDataSize );
+		inCache.Write( inRenderer.Funcs(), inIndices, elementDataSize );
+		inCache.EndWrite( inRenderer.Funcs() );
+		inRenderer.Counts().mBufferBinds += 1;
+		CHECK_GL_ERROR;
+		
+		// Draw the elements
+		glDrawElements( inMode, inNumIndices, GL_UNSIGNED_INT,
+			GLBufferObPtr( elementOffset ) );
+	}
+	
+	(*inRenderer.Funcs().glBindBufferProc)( GL_ARRAY_BUFFER, 0 );
+	(*inRenderer.Funcs().glBindBufferProc)( GL_ELEMENT_ARRAY_BUFFER, 0 );
+	inRenderer.Counts().mBufferBinds += 2;
+	inRenderer.Counts().mDrawCalls += 1;
+}
+
+#pragma mark -
 /*!
 	@function	RenderImmediateVBO
 	
@@ -193,100 +419,11 @@ void			RenderImmediateVBO(
 	{
 		theCache->InitBuffers( inRenderer.Funcs() );
 		
-		// Compute sub-buffer sizes for array data
-		GLsizeiptr	vertexDataSize = static_cast<GLsizeiptr>(inNumPoints * sizeof(TQ3Point3D));
-		GLsizeiptr	normalDataSize = (inNormals == nullptr)? 0 :
-			static_cast<GLsizeiptr>(inNumPoints * sizeof(TQ3Vector3D));
-		GLsizeiptr	colorDataSize = (inColors == nullptr)? 0 :
-			static_cast<GLsizeiptr>(inNumPoints * sizeof(TQ3ColorRGB));
-		GLsizeiptr	uvDataSize = (inUVs == nullptr)? 0 :
-			static_cast<GLsizeiptr>(inNumPoints * sizeof(TQ3Param2D));
-		GLsizeiptr	totalArrayDataSize = vertexDataSize + normalDataSize +
-			colorDataSize + uvDataSize;
+		StreamImmediateVertices( *theCache, inRenderer, inNumPoints, inPoints,
+			inNormals, inColors, inUVs );
 		
-		// Compute sub-buffer offsets
-		GLsizeiptr normalOffset = (normalDataSize == 0)? kAbsentBuffer : vertexDataSize;
-		GLsizeiptr colorOffset = (colorDataSize == 0)? kAbsentBuffer : vertexDataSize + normalDataSize;
-		GLsizeiptr uvOffset = (uvDataSize == 0)? kAbsentBuffer : vertexDataSize + normalDataSize + colorDataSize;
-
-		// Buffer size for element data
-		if (inIndices == nullptr)
-		{
-			inNumIndices = 0;
-		}
-		GLsizeiptr	elementDataSize = inNumIndices * sizeof(TQ3Uns32);
-		
-		theCache->UpdateBufferSizes( inRenderer.Funcs(), totalArrayDataSize, elementDataSize );
-		
-		// Copy the data into the array VBO
-		theCache->BindArrayBuffer( inRenderer.Funcs() );
-		const GLvoid *	dataAddr;
-		dataAddr = inPoints;
-		(*inRenderer.Funcs().glBufferSubDataProc)( GL_ARRAY_BUFFER, 0,
-			vertexDataSize, dataAddr );
-		CHECK_GL_ERROR;
-		if (inNormals != nullptr)
-		{
-			dataAddr = inNormals;
-			(*inRenderer.Funcs().glBufferSubDataProc)( GL_ARRAY_BUFFER,
-				normalOffset, normalDataSize, dataAddr );
-			CHECK_GL_ERROR;
-		}
-		if (inColors != nullptr)
-		{
-			dataAddr = inColors;
-			(*inRenderer.Funcs().glBufferSubDataProc)( GL_ARRAY_BUFFER,
-				colorOffset, colorDataSize, dataAddr );
-			CHECK_GL_ERROR;
-		}
-		if (inUVs != nullptr)
-		{
-			dataAddr = inUVs;
-			(*inRenderer.Funcs().glBufferSubDataProc)( GL_ARRAY_BUFFER,
-				uvOffset, uvDataSize, dataAddr );
-			CHECK_GL_ERROR;
-		}
-			
-		// Associate vertex data pointers with sub-buffers
-		inRenderer.SLFuncs().glVertexAttribPointer( inRenderer.Shader().CurrentProgram()->mVertexAttribLoc,
-			3, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( 0U ) );
-		if (inNormals != nullptr)
-		{
-			inRenderer.SLFuncs().glVertexAttribPointer( inRenderer.Shader().CurrentProgram()->mNormalAttribLoc,
-				3, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( normalOffset ) );
-		}
-		if (inColors != nullptr)
-		{
-			inRenderer.SLFuncs().glVertexAttribPointer( inRenderer.Shader().CurrentProgram()->mColorAttribLoc,
-				3, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( colorOffset ) );
-		}
-		if (inUVs != nullptr)
-		{
-			inRenderer.SLFuncs().glVertexAttribPointer( inRenderer.Shader().CurrentProgram()->mTexCoordAttribLoc,
-				2, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( uvOffset ) );
-		}
-		
-		if (inIndices == nullptr)
-		{
-			(*inRenderer.Funcs().glBindBufferProc)( GL_ELEMENT_ARRAY_BUFFER, 0 );
-			glDrawArrays( inMode, 0, inNumPoints );
-		}
-		else
-		{
-			// Copy data into element VBO
-			theCache->BindElementBuffer( inRenderer.Funcs() );
-			CHECK_GL_ERROR;
-			dataAddr = inIndices;
-			(*inRenderer.Funcs().glBufferSubDataProc)( GL_ELEMENT_ARRAY_BUFFER,
-				0, elementDataSize, dataAddr );
-			CHECK_GL_ERROR;
-			
-			// Draw the elements
-			glDrawElements( inMode, inNumIndices, GL_UNSIGNED_INT, GLBufferObPtr( 0U ) );
-		}
-		
-		(*inRenderer.Funcs().glBindBufferProc)( GL_ARRAY_BUFFER, 0 );
-		(*inRenderer.Funcs().glBindBufferProc)( GL_ELEMENT_ARRAY_BUFFER, 0 );
+		DrawImmediate( *theCache, inRenderer, inMode, inNumPoints,
+			inNumIndices, inIndices );
 	}
 }
 
@@ -328,100 +465,11 @@ void			RenderImmediateTransVBO(
 	{
 		theCache->InitBuffers( inRenderer.Funcs() );
 		
-		// Compute sub-buffer sizes for array data
-		GLsizeiptr	vertexDataSize = static_cast<GLsizeiptr>(inNumPoints * sizeof(TQ3Point3D));
-		GLsizeiptr	normalDataSize = (inNormals == nullptr)? 0 :
-			static_cast<GLsizeiptr>(inNumPoints * sizeof(TQ3Vector3D));
-		GLsizeiptr	colorDataSize = (inColors == nullptr)? 0 :
-			static_cast<GLsizeiptr>(inNumPoints * sizeof(TQ3ColorRGBA));
-		GLsizeiptr	uvDataSize = (inUVs == nullptr)? 0 :
-			static_cast<GLsizeiptr>(inNumPoints * sizeof(TQ3Param2D));
-		GLsizeiptr	totalArrayDataSize = vertexDataSize + normalDataSize +
-			colorDataSize + uvDataSize;
-		
-		// Compute sub-buffer offsets
-		GLsizeiptr normalOffset = (normalDataSize == 0)? kAbsentBuffer : vertexDataSize;
-		GLsizeiptr colorOffset = (colorDataSize == 0)? kAbsentBuffer : vertexDataSize + normalDataSize;
-		GLsizeiptr uvOffset = (uvDataSize == 0)? kAbsentBuffer : vertexDataSize + normalDataSize + colorDataSize;
-
-		// Buffer size for element data
-		if (inIndices == nullptr)
-		{
-			inNumIndices = 0;
-		}
-		GLsizeiptr	elementDataSize = inNumIndices * sizeof(TQ3Uns32);
-		
-		theCache->UpdateBufferSizes( inRenderer.Funcs(), totalArrayDataSize, elementDataSize );
+		StreamImmediateVertices( *theCache, inRenderer, inNumPoints, inPoints,
+			inNormals, inColors, inUVs );
 		
-		// Copy the data into the array VBO
-		theCache->BindArrayBuffer( inRenderer.Funcs() );
-		const GLvoid *	dataAddr;
-		dataAddr = inPoints;
-		(*inRenderer.Funcs().glBufferSubDataProc)( GL_ARRAY_BUFFER, 0,
-			vertexDataSize, dataAddr );
-		CHECK_GL_ERROR;
-		if (inNormals != nullptr)
-		{
-			dataAddr = inNormals;
-			(*inRenderer.Funcs().glBufferSubDataProc)( GL_ARRAY_BUFFER,
-				normalOffset, normalDataSize, dataAddr );
-			CHECK_GL_ERROR;
-		}
-		if (inColors != nullptr)
-		{
-			dataAddr = inColors;
-			(*inRenderer.Funcs().glBufferSubDataProc)( GL_ARRAY_BUFFER,
-				colorOffset, colorDataSize, dataAddr );
-			CHECK_GL_ERROR;
-		}
-		if (inUVs != nullptr)
-		{
-			dataAddr = inUVs;
-			(*inRenderer.Funcs().glBufferSubDataProc)( GL_ARRAY_BUFFER,
-				uvOffset, uvDataSize, dataAddr );
-			CHECK_GL_ERROR;
-		}
-			
-		// Associate vertex data pointers with sub-buffers
-		inRenderer.SLFuncs().glVertexAttribPointer( inRenderer.Shader().CurrentProgram()->mVertexAttribLoc,
-			3, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( 0U ) );
-		if (inNormals != nullptr)
-		{
-			inRenderer.SLFuncs().glVertexAttribPointer( inRenderer.Shader().CurrentProgram()->mNormalAttribLoc,
-				3, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( normalOffset ) );
-		}
-		if (inColors != nullptr)
-		{
-			inRenderer.SLFuncs().glVertexAttribPointer( inRenderer.Shader().CurrentProgram()->mColorAttribLoc,
-				4, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( colorOffset ) );
-		}
-		if (inUVs != nullptr)
-		{
-			inRenderer.SLFuncs().glVertexAttribPointer( inRenderer.Shader().CurrentProgram()->mTexCoordAttribLoc,
-				2, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( uvOffset ) );
-		}
-		
-		if (inIndices == nullptr)
-		{
-			(*inRenderer.Funcs().glBindBufferProc)( GL_ELEMENT_ARRAY_BUFFER, 0 );
-			glDrawArrays( inMode, 0, inNumPoints );
-		}
-		else
-		{
-			// Copy data into element VBO
-			theCache->BindElementBuffer( inRenderer.Funcs() );
-			CHECK_GL_ERROR;
-			dataAddr = inIndices;
-			(*inRenderer.Funcs().glBufferSubDataProc)( GL_ELEMENT_ARRAY_BUFFER,
-				0, elementDataSize, dataAddr );
-			CHECK_GL_ERROR;
-			
-			// Draw the elements
-			glDrawElements( inMode, inNumIndices, GL_UNSIGNED_INT, GLBufferObPtr( 0U ) );
-		}
-		
-		(*inRenderer.Funcs().glBindBufferProc)( GL_ARRAY_BUFFER, 0 );
-		(*inRenderer.Funcs().glBindBufferProc)( GL_ELEMENT_ARRAY_BUFFER, 0 );
+		DrawImmediate( *theCache, inRenderer, inMode, inNumPoints,
+			inNumIndices, inIndices );
 	}
 }
 
@@ -450,57 +498,43 @@ void			RenderImmediateShadowVolumeVBO(
 	{
 		theCache->InitBuffers( inRenderer.Funcs() );
 		
-		// Compute sub-buffer sizes for array data
+		// Copy the data into the array ring
 		GLsizeiptr	vertexDataSize = static_cast<GLsizeiptr>(inNumPoints * sizeof(TQ3RationalPoint4D));
-		
-		// Buffer size for element data
-		GLsizeiptr	elementDataSize = inNumIndices * sizeof(TQ3Uns32);
-		
-		theCache->UpdateBufferSizes( inRenderer.Funcs(), vertexDataSize, elementDataSize );
-		
-		// Copy the data into the array VBO
-		theCache->BindArrayBuffer( inRenderer.Funcs() );
-		const GLvoid *	dataAddr;
-		dataAddr = inPoints;
-		(*inRenderer.Funcs().glBufferSubDataProc)( GL_ARRAY_BUFFER, 0,
-			vertexDataSize, dataAddr );
+		GLintptr	vertexOffset = theCache->BeginWrite( inRenderer.Funcs(),
+			kArrayRing, vertexDataSize );
+		theCache->Write( inRenderer.Funcs(), inPoints, vertexDataSize );
+		theCache->EndWrite( inRenderer.Funcs() );
+		inRenderer.Counts().mBufferBinds += 1;
 		CHECK_GL_ERROR;
 			
 		// Associate vertex data pointers with sub-buffers
 		inRenderer.SLFuncs().glVertexAttribPointer( inRenderer.Shader().CurrentProgram()->mVertexAttribLoc,
-			4, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( 0U ) );
-		
-		// Copy data into element VBO
-		theCache->BindElementBuffer( inRenderer.Funcs() );
-		CHECK_GL_ERROR;
-		dataAddr = inIndices;
-		(*inRenderer.Funcs().glBufferSubDataProc)( GL_ELEMENT_ARRAY_BUFFER,
-			0, elementDataSize, dataAddr );
-		CHECK_GL_ERROR;
+			4, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( vertexOffset ) );
 		
-		// Draw the elements
-		glDrawElements( GL_TRIANGLES, inNumIndices, GL_UNSIGNED_INT, GLBufferObPtr( 0U ) );
-		
-		(*inRenderer.Funcs().glBindBufferProc)( GL_ARRAY_BUFFER, 0 );
-		(*inRenderer.Funcs().glBindBufferProc)( GL_ELEMENT_ARRAY_BUFFER, 0 );
+		DrawImmediate( *theCache, inRenderer, GL_TRIANGLES, inNumPoints,
+			inNumIndices, inIndices );
 	}
 }
 
 
 /*!
-	@function	SetUpImmediateVBO
+	@function	StreamImmediateVBOArrayData
 	
-	@abstract	Initialize a VBO of a needed size.
+	@abstract	Copy vertex data into the array ring buffer, leaving it
+				bound to GL_ARRAY_BUFFER.
 	
 	@param		inRenderer		A renderer.
-	@param		inVertexDataSize	Size in bytes of vertex data.
-	@param		inElementDataSize	Size in bytes of element index data.
-	@result		True if we are ready for further operations.
+	@param		inDataSize		Size in bytes of vertex data.
+	@param		inData			Vertex data.
+	@param		outOffset		Receives the offset of the data within the
+								buffer, to be used in glVertexAttribPointer.
+	@result		True if the data was loaded.
 */
-bool			SetUpImmediateVBO(
+bool			StreamImmediateVBOArrayData(
 									const QORenderer::Renderer& inRenderer,
-									GLsizeiptr inVertexDataSize,
-									GLsizeiptr inElementDataSize )
+									GLsizeiptr inDataSize,
+									const void* _Nonnull inData,
+									GLintptr& outOffset )
 {
 	ImmedVBOCache* theCache = GetVBOCache( inRenderer.GLContext() );
 	
@@ -508,28 +542,13 @@ bool			SetUpImmediateVBO(
 	{
 		theCache->InitBuffers( inRenderer.Funcs() );
 		
-		theCache->UpdateBufferSizes( inRenderer.Funcs(), inVertexDataSize, inElementDataSize );
+		outOffset = theCache->BeginWrite( inRenderer.Funcs(), kArrayRing,
+			inDataSize );
+		theCache->Write( inRenderer.Funcs(), inData, inDataSize );
+		theCache->EndWrite( inRenderer.Funcs() );
+		inRenderer.Counts().mBufferBinds += 1;
+		CHECK_GL_ERROR;
 	}
 	
 	return (theCache != nullptr);
 }
-
-
-/*!
-	@function	BindImmediateVBOArrayBuffer
-	
-	@abstract	Bind a VBO to GL_ARRAY_BUFFER, preparing to supply
-				vertex data.
-
-	@param		inRenderer		A renderer.
-*/
-void			BindImmediateVBOArrayBuffer(
-									const QORenderer::Renderer& inRenderer )
-{
-	ImmedVBOCache* theCache = GetVBOCache( inRenderer.GLContext() );
-	
-	if (theCache != nullptr)
-	{
-		theCache->BindArrayBuffer( inRenderer.Funcs() );
-	}
-}
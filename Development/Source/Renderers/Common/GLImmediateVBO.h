@@ -146,29 +146,26 @@ void			RenderImmediateShadowVolumeVBO(
 									const TQ3Uns32* _Nonnull inIndices );
 
 /*!
-	@function	SetUpImmediateVBO
+	@function	StreamImmediateVBOArrayData
 	
-	@abstract	Initialize a VBO of a needed size.
+	@abstract	Copy vertex data into the array ring buffer, leaving it
+				bound to GL_ARRAY_BUFFER.
 	
-	@param		inRenderer		A renderer.
-	@param		inVertexDataSize	Size in bytes of vertex data.
-	@param		inElementDataSize	Size in bytes of element index data.
-	@result		True if we are ready for further operations.
-*/
-bool			SetUpImmediateVBO(
-									const QORenderer::Renderer& inRenderer,
-									GLsizeiptr inVertexDataSize,
-									GLsizeiptr inElementDataSize );
-
-/*!
-	@function	BindImmediateVBOArrayBuffer
+	@discussion	Each call gets a fresh region of the ring, so the data of
+				earlier draws is not overwritten while the GPU may still be
+				reading it.
 	
-	@abstract	Bind a VBO to GL_ARRAY_BUFFER, preparing to supply
-				vertex data.
-
 	@param		inRenderer		A renderer.
+	@param		inDataSize		Size in bytes of vertex data.
+	@param		inData			Vertex data.
+	@param		outOffset		Receives the offset of the data within the
+								buffer, to be used in glVertexAttribPointer.
+	@result		True if the data was loaded.
 */
-void			BindImmediateVBOArrayBuffer(
-									const QORenderer::Renderer& inRenderer );
+bool			StreamImmediateVBOArrayData(
+									const QORenderer::Renderer& inRenderer,
+									GLsizeiptr inDataSize,
+									const void* _Nonnull inData,
+									GLintptr& outOffset );
 
 #endif /* GLImmediateVBO_h */
@@ -436,10 +436,12 @@ void	ShadowVolCache::RenderVBO( ShadowVBO* inCachedVBO, const QORenderer::Render
 		{
 			glDrawElements( GL_TRIANGLES, inCachedVBO->mNumTriIndices,
 				GL_UNSIGNED_INT, GLBufferObPtr( 0U ) );
+			inRenderer.Counts().mDrawCalls += 1;
 		}
 
 		(*inRenderer.Funcs().glBindBufferProc)( GL_ARRAY_BUFFER, 0 );
 		(*inRenderer.Funcs().glBindBufferProc)( GL_ELEMENT_ARRAY_BUFFER, 0 );
+		inRenderer.Counts().mBufferBinds += 4;
 	}
 	
 	// Remove the record from the doubly-linked list.
@@ -679,6 +681,7 @@ void	ShadowVolMgr::AddShadowVolume(
 				inNumTriIndices * sizeof(GLuint),
 				inVertIndices, GL_STATIC_DRAW );
 			(*inRenderer.Funcs().glBindBufferProc)( GL_ELEMENT_ARRAY_BUFFER, 0 );
+			inRenderer.Counts().mBufferBinds += 4;
 			RecordVBO( newVBO->mGLBufferNames[1], inGeom, (inNumTriIndices + inNumQuadIndices) * sizeof(GLuint), 2 );
 		}
 		
@@ -46,6 +46,7 @@
 //-----------------------------------------------------------------------------
 
 #include "GLTextureLoader.h"
+#include "GLTexturePrep.h"
 #include "QuesaCustomElements.h"
 #include "QuesaErrors.h"
 #include "QuesaMemory.h"
@@ -57,6 +58,7 @@
 #include "E3Debug.h"
 #include "E3ErrorManager.h"
 #include "E3Utils.h"
+#include "E3Profile.h"
 #include "QORenderer.h"
 
 #include <algorithm>
@@ -675,6 +677,44 @@ static const TQ3Uns8*	GetImageData(
 }
 
 
+/*!
+	@function	ConvertRows
+	@abstract	Run a pixel converter over an image, making the image rows go
+				bottom to top instead of top to bottom unless they are already
+				flipped.
+*/
+static void	ConvertRows(
+								PixelConverter inConverter,
+								const TQ3Uns8* inSrcImageData,
+								TQ3Uns32 inSrcBytesPerPixel,
+								TQ3Uns32 inSrcWidth,
+								TQ3Uns32 inSrcHeight,
+								TQ3Uns32 inSrcRowBytes,
+								TQ3Boolean inSrcRowsAreFlipped,
+								TQ3Uns32 inDstRowBytes,
+								TQ3Uns8* outDstImageData )
+{
+	const TQ3Uns32 dstBytesPerPixel = 4;
+	
+	for (TQ3Uns32 rowNum = 0; rowNum < inSrcHeight; ++rowNum)
+	{
+		TQ3Uns32 srcRowNum = (inSrcRowsAreFlipped == kQ3True)?
+			rowNum : (inSrcHeight - rowNum - 1);
+		const TQ3Uns8* srcRowData = inSrcImageData +
+			srcRowNum * inSrcRowBytes;
+		TQ3Uns8* dstRowData = &outDstImageData[ inDstRowBytes * rowNum ];
+		
+		for (TQ3Uns32 colNum = 0; colNum < inSrcWidth; ++colNum)
+		{
+			(*inConverter)( srcRowData, dstRowData );
+			
+			srcRowData += inSrcBytesPerPixel;
+			dstRowData += dstBytesPerPixel;
+		}
+	}
+}
+
+
 /*!
 	@function	ConvertImageFormat
 	@abstract	Convert the Quesa texture image data to a format OpenGL likes,
@@ -728,40 +768,9 @@ static bool	ConvertImageFormat(
 			GLFormatWork().Grow( dstRowBytes * inSrcHeight );
 			TQ3Uns8* workData = GLFormatWork().Address();
 			
-			if (inSrcRowsAreFlipped == kQ3True)
-			{
-				for (TQ3Uns32 rowNum = 0; rowNum < inSrcHeight; ++rowNum)
-				{
-					const TQ3Uns8* srcRowData = inSrcImageData +
-						rowNum * inSrcRowBytes;
-					TQ3Uns8* dstRowData = &workData[ dstRowBytes * rowNum ];
-					
-					for (TQ3Uns32 colNum = 0; colNum < inSrcWidth; ++colNum)
-					{
-						(*theConverter)( srcRowData, dstRowData );
-						
-						srcRowData += srcBytesPerPixel;
-						dstRowData += dstBytesPerPixel;
-					}
-				}
-			}
-			else
-			{
-				for (TQ3Uns32 rowNum = 0; rowNum < inSrcHeight; ++rowNum)
-				{
-					const TQ3Uns8* srcRowData = inSrcImageData +
-						(inSrcHeight - rowNum - 1) * inSrcRowBytes;
-					TQ3Uns8* dstRowData = &workData[ dstRowBytes * rowNum ];
-					
-					for (TQ3Uns32 colNum = 0; colNum < inSrcWidth; ++colNum)
-					{
-						(*theConverter)( srcRowData, dstRowData );
-						
-						srcRowData += srcBytesPerPixel;
-						dstRowData += dstBytesPerPixel;
-					}
-				}
-			}
+			ConvertRows( theConverter, inSrcImageData, srcBytesPerPixel,
+				inSrcWidth, inSrcHeight, inSrcRowBytes, inSrcRowsAreFlipped,
+				dstRowBytes, workData );
 			
 			outImageData = workData;
 		}
@@ -1042,6 +1051,8 @@ GLuint	GLTextureLoader( TQ3TextureObject inTexture,
 {
 	GLuint	resultTextureName = 0;
 	Q3_ASSERT( inTexture != nullptr );
+	Q3_PROFILE_SCOPE( "GLTextureLoader" );
+	Q3_PROFILE_COUNT( "Texture uploads", 1 );
 	
 	try
 	{
@@ -1088,3 +1099,101 @@ GLuint	GLTextureLoader( TQ3TextureObject inTexture,
 	
 	return resultTextureName;
 }
+
+
+/*!
+	@function	GLTextureLoader_ConvertPixels
+	
+	@abstract	Convert Quesa texture image data to 32-bit BGRA pixels with
+				rows running bottom to top, without involving OpenGL.
+	@discussion	Unlike the rest of the loader, this function uses no shared
+				buffers, so it may be called from any thread.
+	@param		inSrcImageData		Source image data.
+	@param		inSrcPixelType		Pixel type of the source.
+	@param		inSrcWidth			Width of the source in pixels.
+	@param		inSrcHeight			Height of the source in pixels.
+	@param		inSrcRowBytes		Row bytes of the source.
+	@param		inSrcByteOrder		Byte order of the source.
+	@param		inSrcRowsAreFlipped	Whether the source rows run bottom to top.
+	@param		inPremultiplyAlpha	Whether to premultiply color by alpha.
+	@param		outDstImageData		Buffer of at least 4 * width * height bytes.
+	@param		outGLInternalFormat	Receives the internal format to use.
+	@result		True on success.
+*/
+bool	GLTextureLoader_ConvertPixels(
+								const TQ3Uns8* inSrcImageData,
+								TQ3PixelType inSrcPixelType,
+								TQ3Uns32 inSrcWidth,
+								TQ3Uns32 inSrcHeight,
+								TQ3Uns32 inSrcRowBytes,
+								TQ3Endian inSrcByteOrder,
+								TQ3Boolean inSrcRowsAreFlipped,
+								bool inPremultiplyAlpha,
+								TQ3Uns8* outDstImageData,
+								GLint& outGLInternalFormat )
+{
+	bool	didConvert = false;
+	outGLInternalFormat = GLUtils_ConvertPixelType( inSrcPixelType );
+	
+	PixelConverter	theConverter = ChoosePixelConverter( inSrcPixelType,
+		inSrcByteOrder, inPremultiplyAlpha );
+	
+	if (theConverter != nullptr)
+	{
+		// Converters for pixel types without alpha leave the alpha byte
+		// alone, so give it a definite value for the sake of mipmapping.
+		TQ3Uns32 dstRowBytes = 4 * inSrcWidth;
+		memset( outDstImageData, 0xFF, dstRowBytes * inSrcHeight );
+		
+		ConvertRows( theConverter, inSrcImageData,
+			GLUtils_SizeOfPixelType( inSrcPixelType ) / 8,
+			inSrcWidth, inSrcHeight, inSrcRowBytes, inSrcRowsAreFlipped,
+			dstRowBytes, outDstImageData );
+		
+		didConvert = true;
+	}
+	
+	return didConvert;
+}
+
+
+/*!
+	@function	GLTextureLoader_UploadPrepared
+	
+	@abstract	Create an OpenGL texture object from texture data that has
+				already been through the CPU stage of loading.
+	@param		inTexture		The texture object that was prepared.
+	@param		inPrepared		Prepared texture data.
+	@result		An OpenGL texture "name", or 0 on failure.
+*/
+GLuint	GLTextureLoader_UploadPrepared( TQ3TextureObject inTexture,
+								const GLPreparedTexture& inPrepared )
+{
+	GLuint	resultTextureName = 0;
+	Q3_ASSERT( inTexture != nullptr );
+	Q3_PROFILE_SCOPE( "GLTextureLoader_UploadPrepared" );
+	Q3_PROFILE_COUNT( "Texture uploads", 1 );
+	
+	if (! inPrepared.levels.empty())
+	{
+		glGenTextures( 1, &resultTextureName );
+		glBindTexture( GL_TEXTURE_2D, resultTextureName );
+		Q3_ASSERT( glIsTexture( resultTextureName ) );
+
+		glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+		
+		for (size_t i = 0; i < inPrepared.levels.size(); ++i)
+		{
+			const GLPreparedTextureLevel& theLevel( inPrepared.levels[i] );
+			glTexImage2D( GL_TEXTURE_2D, static_cast<GLint>(i),
+				inPrepared.glInternalFormat,
+				theLevel.width, theLevel.height, 0, GL_BGRA, GL_UNSIGNED_BYTE,
+				theLevel.pixels.get() );
+		}
+		
+		MaybeCallBackAfterUpload( inTexture );
+	}
+	
+	return resultTextureName;
+}
@@ -52,6 +52,8 @@ namespace QORenderer
 	struct GLFuncs;
 }
 
+struct GLPreparedTexture;
+
 
 
 
@@ -77,5 +79,51 @@ GLuint	GLTextureLoader( TQ3TextureObject inTexture,
 						const QORenderer::GLFuncs& inFuncs );
 
 
+/*!
+	@function	GLTextureLoader_ConvertPixels
+	
+	@abstract	Convert Quesa texture image data to 32-bit BGRA pixels with
+				rows running bottom to top, without involving OpenGL.
+	@discussion	Unlike the rest of the loader, this function uses no shared
+				buffers, so it may be called from any thread.
+	@param		inSrcImageData		Source image data.
+	@param		inSrcPixelType		Pixel type of the source.
+	@param		inSrcWidth			Width of the source in pixels.
+	@param		inSrcHeight			Height of the source in pixels.
+	@param		inSrcRowBytes		Row bytes of the source.
+	@param		inSrcByteOrder		Byte order of the source.
+	@param		inSrcRowsAreFlipped	Whether the source rows run bottom to top.
+	@param		inPremultiplyAlpha	Whether to premultiply color by alpha.
+	@param		outDstImageData		Buffer of at least 4 * width * height bytes.
+	@param		outGLInternalFormat	Receives the internal format to use.
+	@result		True on success.
+*/
+bool	GLTextureLoader_ConvertPixels(
+						const TQ3Uns8* inSrcImageData,
+						TQ3PixelType inSrcPixelType,
+						TQ3Uns32 inSrcWidth,
+						TQ3Uns32 inSrcHeight,
+						TQ3Uns32 inSrcRowBytes,
+						TQ3Endian inSrcByteOrder,
+						TQ3Boolean inSrcRowsAreFlipped,
+						bool inPremultiplyAlpha,
+						TQ3Uns8* outDstImageData,
+						GLint& outGLInternalFormat );
+
+
+/*!
+	@function	GLTextureLoader_UploadPrepared
+	
+	@abstract	Create an OpenGL texture object from texture data that has
+				already been through the CPU stage of loading.
+	@discussion	Only the glTexImage2D calls remain to be done, one per level.
+	@param		inTexture		The texture object that was prepared.
+	@param		inPrepared		Prepared texture data.
+	@result		An OpenGL texture "name", or 0 on failure.
+*/
+GLuint	GLTextureLoader_UploadPrepared( TQ3TextureObject inTexture,
+						const GLPreparedTexture& inPrepared );
+
+
 
 #endif
@@ -0,0 +1,663 @@
+/*  NAME:
+        GLTexturePrep.cpp
+
+    DESCRIPTION:
+        Background preparation of texture pixel data and mipmaps.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+
+#include "GLTexturePrep.h"
+#include "GLTextureLoader.h"
+#include "QuesaCustomElements.h"
+#include "QuesaStorage.h"
+#include "CQ3ObjectRef.h"
+#include "CQ3WeakObjectRef.h"
+#include "E3Prefix.h"
+#include "E3Debug.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string.h>
+#include <thread>
+
+
+
+//=============================================================================
+//      Constants
+//-----------------------------------------------------------------------------
+
+namespace
+{
+	const unsigned int	kMaxPrepThreads		= 4;
+	const TQ3Uns32		kMaxMipmapLevels	= 32;	// size of TQ3Mipmap::mipmaps
+}
+
+
+
+//=============================================================================
+//      Local types
+//-----------------------------------------------------------------------------
+
+namespace
+{
+	enum EPrepState
+	{
+		kPrepStateWaiting,
+		kPrepStateWorking,
+		kPrepStateDone
+	};
+	
+	/*!
+		@struct		PrepJob
+		@abstract	One request for texture preparation.
+		@discussion	The Quesa object references are only created and destroyed
+					on the thread that owns the queue.  Worker threads look at
+					nothing but the source description and the result.
+	*/
+	struct PrepJob
+	{
+		CQ3WeakObjectRef					texture;
+		CQ3ObjectRef						storage;
+		TQ3Uns32							editIndexTexture;
+		TQ3Uns32							editIndexStorage;
+		std::unique_ptr<TQ3Uns8[]>			imageCopy;
+		GLTexturePrepSource					source;
+		EPrepState							state;
+		std::unique_ptr<GLPreparedTexture>	result;
+	};
+	
+	typedef std::map< TQ3TextureObject, std::unique_ptr<PrepJob> >	JobMap;
+}
+
+struct GLTexturePrepQueue::Impl
+{
+								Impl( TQ3Uns32 inMaxTextureSize );
+								~Impl();
+	
+	void						WorkerLoop();
+	
+	TQ3Uns32					mMaxTextureSize;
+	JobMap						mJobs;
+	std::deque<PrepJob*>		mWaiting;
+	std::mutex					mMutex;
+	std::condition_variable		mWakeWorker;
+	bool						mStopping;
+	std::vector<std::thread>	mThreads;
+};
+
+
+
+//=============================================================================
+//      Internal functions
+//-----------------------------------------------------------------------------
+
+/*!
+	@function	GetStorageEditIndex
+	@abstract	Get the edit index of a storage object, or 0 if it is nullptr.
+*/
+static TQ3Uns32 GetStorageEditIndex( TQ3StorageObject inStorage )
+{
+	return (inStorage == nullptr)? 0 : Q3Shared_GetEditIndex( inStorage );
+}
+
+
+/*!
+	@function	GetStorageBytes
+	@abstract	Make the bytes of an image storage available to other threads.
+	@discussion	The bytes are copied here, because storage objects cannot be
+				used from other threads.  Even memory storage cannot be read in
+				place, since our reference keeps the storage object alive but
+				not its buffer, which Q3MemoryStorage_Set or a write on this
+				thread may reallocate while a worker is reading it.
+*/
+static bool	GetStorageBytes( TQ3StorageObject inStorage,
+							TQ3Uns32 inDataSize,
+							PrepJob& ioJob )
+{
+	bool	gotData = false;
+	
+	if (kQ3Success == Q3Storage_Open( inStorage, kQ3False ))
+	{
+		TQ3Uns32	sizeRead = 0;
+		ioJob.imageCopy.reset( new(std::nothrow) TQ3Uns8[ inDataSize ] );
+		if ( (ioJob.imageCopy.get() != nullptr) &&
+			(kQ3Success == Q3Storage_GetData( inStorage, 0, inDataSize,
+				ioJob.imageCopy.get(), &sizeRead )) &&
+			(sizeRead == inDataSize) )
+		{
+			ioJob.source.imageData = ioJob.imageCopy.get();
+			gotData = true;
+		}
+		Q3Storage_Close( inStorage );
+	}
+	
+	return gotData;
+}
+
+
+/*!
+	@function	InitJobSource
+	@abstract	Fill in the source description of a job from a texture object.
+*/
+static bool	InitJobSource( TQ3TextureObject inTexture,
+							bool inPremultiplyAlpha,
+							TQ3Uns32 inMaxTextureSize,
+							PrepJob& ioJob )
+{
+	GLTexturePrepSource&	theSource( ioJob.source );
+	theSource.imageData = nullptr;
+	theSource.rowsAreFlipped =
+		(kQ3True == CETextureFlippedRowsElement_IsPresent( inTexture ));
+	theSource.premultiplyAlpha = inPremultiplyAlpha;
+	theSource.maxTextureSize = inMaxTextureSize;
+	
+	TQ3Uns32	dataSize = 0;
+	TQ3StorageObject	theStorage = nullptr;
+	
+	switch (Q3Texture_GetType( inTexture ))
+	{
+		case kQ3TextureTypePixmap:
+			{
+				TQ3StoragePixmap	thePixmap;
+				if (kQ3Success == Q3PixmapTexture_GetPixmap( inTexture, &thePixmap ))
+				{
+					theStorage = thePixmap.image;
+					theSource.pixelType = thePixmap.pixelType;
+					theSource.byteOrder = thePixmap.byteOrder;
+					theSource.generateMipmaps = true;
+					TQ3MipmapImage	theLevel = {
+						thePixmap.width, thePixmap.height, thePixmap.rowBytes, 0
+					};
+					theSource.levels.push_back( theLevel );
+					dataSize = thePixmap.rowBytes * thePixmap.height;
+				}
+			}
+			break;
+		
+		case kQ3TextureTypeMipmap:
+			{
+				TQ3Mipmap	theMipmap;
+				if (kQ3Success == Q3MipmapTexture_GetMipmap( inTexture, &theMipmap ))
+				{
+					theStorage = theMipmap.image;
+					theSource.pixelType = theMipmap.pixelType;
+					theSource.byteOrder = theMipmap.byteOrder;
+					theSource.generateMipmaps = false;
+					
+					TQ3Uns32	numImages = 1;
+					if (theMipmap.useMipmapping)
+					{
+						TQ3Uns32 n = E3Num_Max( theMipmap.mipmaps[0].width,
+							theMipmap.mipmaps[0].height );
+						while ( (n > 1) && (numImages < kMaxMipmapLevels) )
+						{
+							n /= 2;
+							numImages += 1;
+						}
+					}
+					
+					for (TQ3Uns32 i = 0; i < numImages; ++i)
+					{
+						const TQ3MipmapImage&	theLevel( theMipmap.mipmaps[i] );
+						theSource.levels.push_back( theLevel );
+						dataSize = E3Num_Max( dataSize,
+							theLevel.offset + theLevel.rowBytes * theLevel.height );
+					}
+				}
+			}
+			break;
+	}
+	
+	bool	didInit = false;
+	
+	if (theStorage != nullptr)
+	{
+		// The texture getters return a new reference to the storage, which
+		// the job takes over.
+		ioJob.storage = CQ3ObjectRef( theStorage );
+		ioJob.editIndexStorage = GetStorageEditIndex( theStorage );
+		didInit = (dataSize > 0) && GetStorageBytes( theStorage, dataSize, ioJob );
+	}
+	
+	return didInit;
+}
+
+
+/*!
+	@function	ShrinkImage
+	@abstract	Shrink a BGRA image using a box filter.
+	@discussion	Each destination pixel is the average of the block of source
+				pixels that it covers.  The destination must be no larger than
+				the source in either dimension.
+*/
+static void ShrinkImage( const TQ3Uns8* inSrc,
+						TQ3Uns32 inSrcWidth,
+						TQ3Uns32 inSrcHeight,
+						TQ3Uns8* outDst,
+						TQ3Uns32 inDstWidth,
+						TQ3Uns32 inDstHeight )
+{
+	for (TQ3Uns32 dstRow = 0; dstRow < inDstHeight; ++dstRow)
+	{
+		TQ3Uns32 rowStart = (dstRow * inSrcHeight) / inDstHeight;
+		TQ3Uns32 rowEnd = E3Num_Max( rowStart + 1,
+			((dstRow + 1) * inSrcHeight) / inDstHeight );
+		
+		for (TQ3Uns32 dstCol = 0; dstCol < inDstWidth; ++dstCol)
+		{
+			TQ3Uns32 colStart = (dstCol * inSrcWidth) / inDstWidth;
+			TQ3Uns32 colEnd = E3Num_Max( colStart + 1,
+				((dstCol + 1) * inSrcWidth) / inDstWidth );
+			
+			TQ3Uns32 sum[4] = { 0, 0, 0, 0 };
+			for (TQ3Uns32 row = rowStart; row < rowEnd; ++row)
+			{
+				const TQ3Uns8* srcPixel = inSrc + 4 * (row * inSrcWidth + colStart);
+				for (TQ3Uns32 col = colStart; col < colEnd; ++col)
+				{
+					sum[0] += srcPixel[0];
+					sum[1] += srcPixel[1];
+					sum[2] += srcPixel[2];
+					sum[3] += srcPixel[3];
+					srcPixel += 4;
+				}
+			}
+			
+			TQ3Uns32 count = (rowEnd - rowStart) * (colEnd - colStart);
+			TQ3Uns8* dstPixel = outDst + 4 * (dstRow * inDstWidth + dstCol);
+			for (int k = 0; k < 4; ++k)
+			{
+				dstPixel[k] = static_cast<TQ3Uns8>( (sum[k] + count / 2) / count );
+			}
+		}
+	}
+}
+
+
+/*!
+	@function	MakeLevel
+	@abstract	Allocate a prepared level of a given size.
+*/
+static void MakeLevel( TQ3Uns32 inWidth, TQ3Uns32 inHeight,
+						GLPreparedTextureLevel& outLevel )
+{
+	outLevel.width = inWidth;
+	outLevel.height = inHeight;
+	outLevel.pixels.reset( new TQ3Uns8[ 4 * inWidth * inHeight ] );
+}
+
+
+/*!
+	@function	PrepareLevel
+	@abstract	Convert one source level, shrinking it if necessary.
+*/
+static bool PrepareLevel( const GLTexturePrepSource& inSource,
+						const TQ3MipmapImage& inSrcLevel,
+						GLint& outGLInternalFormat,
+						GLPreparedTextureLevel& outLevel )
+{
+	if ( (inSrcLevel.width == 0) || (inSrcLevel.height == 0) )
+	{
+		return false;
+	}
+	
+	MakeLevel( inSrcLevel.width, inSrcLevel.height, outLevel );
+	
+	bool didConvert = GLTextureLoader_ConvertPixels(
+		inSource.imageData + inSrcLevel.offset,
+		inSource.pixelType, inSrcLevel.width, inSrcLevel.height,
+		inSrcLevel.rowBytes, inSource.byteOrder,
+		inSource.rowsAreFlipped? kQ3True : kQ3False,
+		inSource.premultiplyAlpha, outLevel.pixels.get(),
+		outGLInternalFormat );
+	
+	if ( didConvert && (inSource.maxTextureSize > 0) &&
+		( (inSrcLevel.width > inSource.maxTextureSize) ||
+		(inSrcLevel.height > inSource.maxTextureSize) ) )
+	{
+		GLPreparedTextureLevel	shrunk;
+		MakeLevel( E3Num_Min( inSrcLevel.width, inSource.maxTextureSize ),
+			E3Num_Min( inSrcLevel.height, inSource.maxTextureSize ), shrunk );
+		ShrinkImage( outLevel.pixels.get(), outLevel.width, outLevel.height,
+			shrunk.pixels.get(), shrunk.width, shrunk.height );
+		outLevel = std::move( shrunk );
+	}
+	
+	return didConvert;
+}
+
+
+/*!
+	@function	BuildMipmapChain
+	@abstract	Add levels to a prepared texture by repeatedly halving the last
+				level, until it is down to size (1, 1).
+*/
+static void BuildMipmapChain( GLPreparedTexture& ioPrepared )
+{
+	while ( (ioPrepared.levels.back().width > 1) ||
+		(ioPrepared.levels.back().height > 1) )
+	{
+		GLPreparedTextureLevel	nextLevel;
+		const GLPreparedTextureLevel&	prevLevel( ioPrepared.levels.back() );
+		MakeLevel( E3Num_Max( prevLevel.width / 2, 1U ),
+			E3Num_Max( prevLevel.height / 2, 1U ), nextLevel );
+		ShrinkImage( prevLevel.pixels.get(), prevLevel.width, prevLevel.height,
+			nextLevel.pixels.get(), nextLevel.width, nextLevel.height );
+		ioPrepared.levels.push_back( std::move( nextLevel ) );
+	}
+}
+
+
+
+//=============================================================================
+//      GLTexturePrepQueue implementation
+//-----------------------------------------------------------------------------
+
+GLTexturePrepQueue::Impl::Impl( TQ3Uns32 inMaxTextureSize )
+	: mMaxTextureSize( inMaxTextureSize )
+	, mStopping( false )
+{
+	unsigned int numThreads = std::thread::hardware_concurrency();
+	numThreads = (numThreads > 1)? numThreads - 1 : 1;
+	numThreads = std::min( numThreads, kMaxPrepThreads );
+	
+	for (unsigned int i = 0; i < numThreads; ++i)
+	{
+		mThreads.push_back( std::thread( &Impl::WorkerLoop, this ) );
+	}
+}
+
+GLTexturePrepQueue::Impl::~Impl()
+{
+	{
+		std::lock_guard<std::mutex>	lock( mMutex );
+		mStopping = true;
+		mWaiting.clear();
+	}
+	mWakeWorker.notify_all();
+	
+	for (std::thread& theThread : mThreads)
+	{
+		theThread.join();
+	}
+}
+
+void	GLTexturePrepQueue::Impl::WorkerLoop()
+{
+	std::unique_lock<std::mutex>	lock( mMutex );
+	
+	while (true)
+	{
+		mWakeWorker.wait( lock, [this]{ return mStopping || ! mWaiting.empty(); } );
+		if (mStopping)
+		{
+			break;
+		}
+		
+		PrepJob* theJob = mWaiting.front();
+		mWaiting.pop_front();
+		theJob->state = kPrepStateWorking;
+		
+		// The job cannot be deleted while it is in the working state, so we
+		// can let go of the lock while doing the real work.
+		lock.unlock();
+		std::unique_ptr<GLPreparedTexture>	thePrepared( new(std::nothrow) GLPreparedTexture );
+		try
+		{
+			if ( (thePrepared.get() != nullptr) &&
+				! GLTexturePrep_Prepare( theJob->source, *thePrepared ) )
+			{
+				thePrepared.reset();
+			}
+		}
+		catch (...)
+		{
+			thePrepared.reset();
+		}
+		lock.lock();
+		
+		theJob->result = std::move( thePrepared );
+		theJob->state = kPrepStateDone;
+	}
+}
+
+
+GLTexturePrepQueue::GLTexturePrepQueue( TQ3Uns32 inMaxTextureSize )
+	: mImpl( new Impl( inMaxTextureSize ) )
+{
+}
+
+GLTexturePrepQueue::~GLTexturePrepQueue()
+{
+	// Stop the workers before the jobs and their object references go away.
+	std::unique_ptr<JobMap>	theJobs( new JobMap );
+	theJobs->swap( mImpl->mJobs );
+	mImpl.reset();
+}
+
+
+bool	GLTexturePrepQueue::Enqueue(
+								TQ3TextureObject _Nonnull inTexture,
+								bool inPremultiplyAlpha )
+{
+	{
+		std::lock_guard<std::mutex>	lock( mImpl->mMutex );
+		if (mImpl->mJobs.find( inTexture ) != mImpl->mJobs.end())
+		{
+			return true;
+		}
+	}
+	
+	std::unique_ptr<PrepJob>	theJob( new PrepJob );
+	theJob->texture = CQ3WeakObjectRef( inTexture );
+	theJob->editIndexTexture = Q3Shared_GetEditIndex( inTexture );
+	theJob->editIndexStorage = 0;
+	theJob->state = kPrepStateWaiting;
+	
+	if (! InitJobSource( inTexture, inPremultiplyAlpha, mImpl->mMaxTextureSize,
+		*theJob ))
+	{
+		return false;
+	}
+	
+	{
+		std::lock_guard<std::mutex>	lock( mImpl->mMutex );
+		mImpl->mWaiting.push_back( theJob.get() );
+		mImpl->mJobs[ inTexture ] = std::move( theJob );
+	}
+	mImpl->mWakeWorker.notify_one();
+	
+	return true;
+}
+
+
+bool	GLTexturePrepQueue::TakeResult(
+								TQ3TextureObject _Nonnull inTexture,
+								std::unique_ptr<GLPreparedTexture>& outPrepared )
+{
+	std::unique_ptr<PrepJob>	theJob;
+	outPrepared.reset();
+	
+	{
+		std::lock_guard<std::mutex>	lock( mImpl->mMutex );
+		JobMap::iterator foundIt = mImpl->mJobs.find( inTexture );
+		if ( (foundIt == mImpl->mJobs.end()) ||
+			(foundIt->second->state != kPrepStateDone) )
+		{
+			return false;
+		}
+		theJob = std::move( foundIt->second );
+		mImpl->mJobs.erase( foundIt );
+	}
+	
+	// Hand back the result only if it still describes the texture.
+	CQ3ObjectRef	currentStorage;
+	if (theJob->texture.get() == inTexture)
+	{
+		switch (Q3Texture_GetType( inTexture ))
+		{
+			case kQ3TextureTypePixmap:
+				{
+					TQ3StoragePixmap	thePixmap;
+					if (kQ3Success == Q3PixmapTexture_GetPixmap( inTexture, &thePixmap ))
+					{
+						currentStorage = CQ3ObjectRef( thePixmap.image );
+					}
+				}
+				break;
+
+			case kQ3TextureTypeMipmap:
+				{
+					TQ3Mipmap	theMipmap;
+					if (kQ3Success == Q3MipmapTexture_GetMipmap( inTexture, &theMipmap ))
+					{
+						currentStorage = CQ3ObjectRef( theMipmap.image );
+					}
+				}
+				break;
+
+			default:
+				break;
+		}
+	}
+	
+	if ( (theJob->texture.get() == inTexture) &&
+		(theJob->editIndexTexture == Q3Shared_GetEditIndex( inTexture )) &&
+		(currentStorage.get() == theJob->storage.get()) &&
+		(theJob->editIndexStorage == GetStorageEditIndex( currentStorage.get() )) )
+	{
+		outPrepared = std::move( theJob->result );
+	}
+	
+	return true;
+}
+
+
+void	GLTexturePrepQueue::Purge()
+{
+	std::vector< std::unique_ptr<PrepJob> >	deadJobs;
+	
+	{
+		std::lock_guard<std::mutex>	lock( mImpl->mMutex );
+		for (JobMap::iterator i = mImpl->mJobs.begin(); i != mImpl->mJobs.end(); )
+		{
+			if ( (i->second->state == kPrepStateDone) &&
+				! i->second->texture.isvalid() )
+			{
+				deadJobs.push_back( std::move( i->second ) );
+				i = mImpl->mJobs.erase( i );
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+	
+	// deadJobs releases storage references here, outside the lock.
+}
+
+
+TQ3Uns32	GLTexturePrepQueue::CountPending() const
+{
+	std::lock_guard<std::mutex>	lock( mImpl->mMutex );
+	TQ3Uns32	numPending = 0;
+	for (const JobMap::value_type& theItem : mImpl->mJobs)
+	{
+		if (theItem.second->state != kPrepStateDone)
+		{
+			++numPending;
+		}
+	}
+	return numPending;
+}
+
+
+
+//=============================================================================
+//      Public functions
+//-----------------------------------------------------------------------------
+
+/*!
+	@function	GLTexturePrep_Prepare
+	@abstract	Perform the CPU stage of texture loading.
+	@discussion	This converts each source level to BGRA, shrinks it if it
+				exceeds the maximum texture size, and if requested builds a
+				complete mipmap chain down to 1x1 using a box filter.  It does
+				not call OpenGL or Quesa, and may be called on any thread.
+	@param		inSource		Description of the source image data.
+	@param		outPrepared		Receives the prepared levels.
+	@result		True on success.
+*/
+bool	GLTexturePrep_Prepare(
+							const GLTexturePrepSource& inSource,
+							GLPreparedTexture& outPrepared )
+{
+	bool	didPrepare = (inSource.imageData != nullptr) &&
+		(! inSource.levels.empty());
+	outPrepared.levels.clear();
+	outPrepared.glInternalFormat = GL_RGBA8;
+	
+	size_t	numSrcLevels = inSource.generateMipmaps? 1 : inSource.levels.size();
+	
+	for (size_t i = 0; didPrepare && (i < numSrcLevels); ++i)
+	{
+		GLPreparedTextureLevel	theLevel;
+		didPrepare = PrepareLevel( inSource, inSource.levels[i],
+			outPrepared.glInternalFormat, theLevel );
+		if (didPrepare)
+		{
+			outPrepared.levels.push_back( std::move( theLevel ) );
+		}
+	}
+	
+	if (didPrepare && inSource.generateMipmaps)
+	{
+		BuildMipmapChain( outPrepared );
+	}
+	
+	return didPrepare;
+}
@@ -0,0 +1,224 @@
+/*  NAME:
+        GLTexturePrep.h
+
+    DESCRIPTION:
+        Header file for GLTexturePrep.cpp.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+#ifndef GLTEXTUREPREP_HDR
+#define GLTEXTUREPREP_HDR
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "GLPrefix.h"
+
+#include <memory>
+#include <vector>
+
+
+
+//=============================================================================
+//      Types
+//-----------------------------------------------------------------------------
+
+/*!
+	@struct		GLPreparedTextureLevel
+	@abstract	One level of a prepared texture, in BGRA byte order with rows
+				running bottom to top, ready to be passed to glTexImage2D.
+	@discussion	Rows are tightly packed, i.e., the row bytes are 4 * width,
+				which satisfies an unpack alignment of 4.
+*/
+struct GLPreparedTextureLevel
+{
+	TQ3Uns32						width;
+	TQ3Uns32						height;
+	std::unique_ptr<TQ3Uns8[]>		pixels;
+};
+
+
+/*!
+	@struct		GLPreparedTexture
+	@abstract	Result of the CPU stage of texture loading: converted pixel
+				data for every mipmap level that will be uploaded.
+	@field		glInternalFormat	Internal format to request from OpenGL.
+	@field		levels				Mipmap levels, largest first.
+*/
+struct GLPreparedTexture
+{
+	GLint								glInternalFormat;
+	std::vector<GLPreparedTextureLevel>	levels;
+};
+
+
+/*!
+	@struct		GLTexturePrepSource
+	@abstract	Description of Quesa texture image data in memory, which is
+				all that the CPU preparation stage needs to know.
+	@discussion	The preparation stage does not touch Quesa objects, so it can
+				be run on any thread as long as the image data stays valid.
+	@field		imageData			Start of the image storage data.
+	@field		pixelType			Pixel type of the source.
+	@field		byteOrder			Byte order of the source pixels.
+	@field		rowsAreFlipped		Whether rows already run bottom to top.
+	@field		premultiplyAlpha	Whether to premultiply color by alpha.
+	@field		generateMipmaps		Whether to compute a full mipmap chain
+									from the first source level.
+	@field		maxTextureSize		Largest width or height that the OpenGL
+									implementation accepts.
+	@field		levels				Source images.  Only the first is used if
+									generateMipmaps is true.
+*/
+struct GLTexturePrepSource
+{
+	const TQ3Uns8*					imageData;
+	TQ3PixelType					pixelType;
+	TQ3Endian						byteOrder;
+	bool							rowsAreFlipped;
+	bool							premultiplyAlpha;
+	bool							generateMipmaps;
+	TQ3Uns32						maxTextureSize;
+	std::vector<TQ3MipmapImage>		levels;
+};
+
+
+/*!
+	@class		GLTexturePrepQueue
+	@abstract	Pool of worker threads that perform the CPU part of texture
+				loading (pixel conversion, resizing and mipmap generation) ahead
+				of the time that the texture must be uploaded to OpenGL.
+	@discussion	All member functions must be called on the thread that uses
+				Quesa objects, normally the rendering thread.  Only the CPU
+				stage, working on a GLTexturePrepSource, happens on the workers.
+				
+				Requests are keyed by texture object, and results are only
+				handed back if the edit indices of the texture and its image
+				storage have not changed since the request was made.
+*/
+class GLTexturePrepQueue
+{
+public:
+	/*!
+		@function	GLTexturePrepQueue
+		@abstract	Constructor.
+		@param		inMaxTextureSize	Value of GL_MAX_TEXTURE_SIZE for the
+										context that will receive the textures.
+	*/
+							GLTexturePrepQueue( TQ3Uns32 inMaxTextureSize );
+	
+	/*!
+		@function	~GLTexturePrepQueue
+		@abstract	Destructor.  Waits for the workers to stop and discards
+					any pending work.
+	*/
+							~GLTexturePrepQueue();
+	
+	/*!
+		@function	Enqueue
+		@abstract	Request background preparation of a texture, unless a
+					request for the same texture is already pending.
+		@discussion	The image data is copied before this function returns,
+					so the texture and its storage may be edited afterwards.
+		@param		inTexture			A texture object.
+		@param		inPremultiplyAlpha	Whether to premultiply color by alpha.
+		@result		True if the texture is now pending.
+	*/
+	bool					Enqueue(
+									TQ3TextureObject _Nonnull inTexture,
+									bool inPremultiplyAlpha );
+	
+	/*!
+		@function	TakeResult
+		@abstract	Collect the finished preparation of a texture.
+		@discussion	If the function returns true, the request has been removed
+					from the queue.  In that case outPrepared may still be empty
+					if preparation failed or the texture was edited, and the
+					caller should fall back to loading synchronously.
+		@param		inTexture			A texture object.
+		@param		outPrepared			Receives the prepared data, if any.
+		@result		False if the texture is still waiting or being worked on,
+					or was never requested.
+	*/
+	bool					TakeResult(
+									TQ3TextureObject _Nonnull inTexture,
+									std::unique_ptr<GLPreparedTexture>& outPrepared );
+	
+	/*!
+		@function	Purge
+		@abstract	Forget finished requests for textures that have since been
+					deleted.
+	*/
+	void					Purge();
+	
+	/*!
+		@function	CountPending
+		@abstract	Number of requests that have not yet been prepared.
+		@discussion	Requests that are finished but not yet collected with
+					TakeResult are not counted.
+	*/
+	TQ3Uns32				CountPending() const;
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl>	mImpl;
+	
+							GLTexturePrepQueue( const GLTexturePrepQueue& ) = delete;
+	GLTexturePrepQueue&		operator=( const GLTexturePrepQueue& ) = delete;
+};
+
+
+
+//=============================================================================
+//      Function prototypes
+//-----------------------------------------------------------------------------
+
+/*!
+	@function	GLTexturePrep_Prepare
+	@abstract	Perform the CPU stage of texture loading.
+	@discussion	This converts each source level to BGRA, shrinks it if it
+				exceeds the maximum texture size, and if requested builds a
+				complete mipmap chain down to 1x1 using a box filter.  It does
+				not call OpenGL or Quesa, and may be called on any thread.
+	@param		inSource		Description of the source image data.
+	@param		outPrepared		Receives the prepared levels.
+	@result		True on success.
+*/
+bool	GLTexturePrep_Prepare(
+							const GLTexturePrepSource& inSource,
+							GLPreparedTexture& outPrepared );
+
+#endif
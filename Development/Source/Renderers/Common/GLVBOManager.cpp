@@ -49,11 +49,14 @@
 #include "CQ3WeakObjectRef.h"
 #include "GLUtils.h"
 #include "E3Main.h"
+#include "E3Profile.h"
 #include "QORenderer.h"
 
 #include <vector>
+#include <map>
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
 
 // In lieu of glext.h
 #ifndef GL_ARB_multitexture
@@ -82,6 +85,19 @@ namespace
 	const TQ3Uns32	kVBOCacheKey	= Q3_FOUR_CHARACTER_CONSTANT('v', 'b', 'o', 'k');
 	
 	const TQ3Uns32	kAbsentBuffer	= 0xFFFFFFFFU;
+	
+	// Size of a shared vertex or index buffer.  A geometry too big for one
+	// gets a buffer of its own.
+	const TQ3Uns32	kPageBytes		= 4 * 1024 * 1024;
+	
+	// Vertex formats, i.e., which optional attributes follow the position
+	const TQ3Uns32	kFormatNormal		= (1 << 0);
+	const TQ3Uns32	kFormatColor		= (1 << 1);
+	const TQ3Uns32	kFormatUV			= (1 << 2);
+	const TQ3Uns32	kFormatLayerShift	= (1 << 3);
+	
+	// Pseudo-format of pages that hold indices
+	const TQ3Uns32	kFormatIndices		= 0xFFFFFFFFU;
 }
 
 #ifndef GL_ARRAY_BUFFER
@@ -90,6 +106,11 @@ namespace
 	#define GL_STATIC_DRAW                  0x88E4
 #endif
 
+#ifndef GL_COPY_READ_BUFFER
+	#define GL_COPY_READ_BUFFER				0x8F36
+	#define GL_COPY_WRITE_BUFFER			0x8F37
+#endif
+
 #if Q3_DEBUG
 	//#define VALIDATE_COUNTS		1
 #endif
@@ -114,6 +135,8 @@ namespace
 
 namespace
 {
+	struct VBOPage;
+	
 #pragma mark struct CachedVBO
 	struct CachedVBO
 	{
@@ -128,16 +151,13 @@ namespace
 		TQ3Object		mSortKey;
 		TQ3Uns32		mEditIndex;
 		GLenum			mGLMode;			// e.g., GL_TRIANGLES
-		TQ3Uns32		mNumIndices;
-	#if Q3_DEBUG
+		TQ3Uns32		mFormat;			// kFormatNormal etc.
 		TQ3Uns32		mNumPoints;
-	#endif
-		GLuint			mGLBufferNames[2];	// 0 is array, 1 is index
-		TQ3Uns32		mVertexBufferOffset;
-		TQ3Uns32		mNormalBufferOffset;
-		TQ3Uns32		mColorBufferOffset;
-		TQ3Uns32		mTextureUVBufferOffset;
-		TQ3Uns32		mLayerShiftBufferOffset;
+		TQ3Uns32		mNumIndices;
+		VBOPage*		mVertexPage;
+		TQ3Uns32		mFirstVertex;
+		VBOPage*		mIndexPage;
+		TQ3Uns32		mFirstIndex;
 		TQ3Uns32		mBufferBytes;
 		CachedVBO*		mPrev;
 		CachedVBO*		mNext;
@@ -150,6 +170,78 @@ namespace
 	};
 	
 	typedef	std::vector< CachedVBO* >	CachedVBOVec;
+	
+	
+#pragma mark struct VertexLayout
+	/*
+		Vertex data is interleaved.  The position comes first, followed by
+		whichever of the optional attributes are present in the format.
+	*/
+	struct VertexLayout
+	{
+		explicit		VertexLayout( TQ3Uns32 inFormat );
+		
+		TQ3Uns32		mStride;
+		TQ3Uns32		mNormalOffset;
+		TQ3Uns32		mColorOffset;
+		TQ3Uns32		mUVOffset;
+		TQ3Uns32		mLayerShiftOffset;
+	};
+	
+	
+#pragma mark class FreeList
+	/*
+		First-fit allocator for ranges of a buffer, measured in elements
+		(vertices or indices).  Adjacent free ranges are merged.
+	*/
+	class FreeList
+	{
+	public:
+		explicit		FreeList( TQ3Uns32 inCapacity );
+		
+		bool			Allocate( TQ3Uns32 inCount, TQ3Uns32& outStart );
+		void			Free( TQ3Uns32 inStart, TQ3Uns32 inCount );
+		void			SetCompacted( TQ3Uns32 inUsedCount );
+		
+		TQ3Uns32		Capacity() const { return mCapacity; }
+		TQ3Uns32		FreeCount() const { return mFreeCount; }
+	
+	private:
+		typedef std::map< TQ3Uns32, TQ3Uns32 >	RangeMap;	// start -> count
+		
+		RangeMap		mFreeRanges;
+		TQ3Uns32		mCapacity;
+		TQ3Uns32		mFreeCount;
+	};
+	
+	
+#pragma mark struct VBOPage
+	/*
+		A buffer object shared by many cached geometries.  A vertex page
+		holds vertices of one format, an index page holds 32-bit indices.
+	*/
+	struct VBOPage
+	{
+						VBOPage( TQ3Uns32 inFormat, TQ3Uns32 inElementSize,
+								TQ3Uns32 inCapacity )
+							: mFormat( inFormat )
+							, mElementSize( inElementSize )
+							, mGLBufferName( 0 )
+							, mFreeList( inCapacity ) {}
+		
+		bool			IsIndexPage() const { return mFormat == kFormatIndices; }
+		GLenum			Target() const { return IsIndexPage()?
+											GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER; }
+		
+		TQ3Uns32		mFormat;
+		TQ3Uns32		mElementSize;
+		GLuint			mGLBufferName;
+		FreeList		mFreeList;
+		std::map< TQ3Uns32, CachedVBO* >	mClients;	// by first element
+	};
+	
+	typedef std::vector< VBOPage* >		VBOPageVec;
+	
 
 	class VBOCache : public CQ3GPSharedCache
 	{
@@ -160,6 +252,7 @@ namespace
 		CachedVBO*		FindVBO( TQ3GeometryObject inGeom, GLenum inMode, const QORenderer::GLFuncs& inFuncs );
 		void			RenderVBO( const QORenderer::Renderer& inRenderer, const CachedVBO* inCachedVBO );
 		void			AddVBO( CachedVBO* inVBO );
+		bool			AllocateStorage( const QORenderer::Renderer& inRenderer, CachedVBO* ioVBO );
 		void			FlushUnreferenced( const QORenderer::GLFuncs& inFuncs );
 		void			DeleteVBO( CachedVBO* inCachedVBO, const QORenderer::GLFuncs& inFuncs );
 		void			DeleteCachedVBOs( CachedVBOVec& inVBOs, const QORenderer::GLFuncs& inFuncs );
@@ -175,6 +268,14 @@ namespace
 		CachedVBOVec*	GetVBOVecForMode( GLenum inMode );
 		CachedVBO*		FindVBOInVec( TQ3GeometryObject inGeom, CachedVBOVec& inVBOs );
 		void			FlushUnreferencedInVec( CachedVBOVec& ioVBOs, const QORenderer::GLFuncs& inFuncs );
+		
+		VBOPage*		AllocateRange( const QORenderer::Renderer& inRenderer,
+									TQ3Uns32 inFormat, TQ3Uns32 inElementSize,
+									CachedVBO* inClient );
+		void			FreeRange( VBOPage* ioPage, CachedVBO* inClient );
+		void			CompactPage( const QORenderer::Renderer& inRenderer,
+									VBOPage* ioPage );
+		void			ReleaseEmptyPages( const QORenderer::GLFuncs& inFuncs );
 
 	#if VALIDATE_COUNTS
 		void			ValidateVBOCount() const;
@@ -188,6 +289,9 @@ namespace
 		CachedVBOVec				mCachedVBOs_triangles;
 		CachedVBOVec				mCachedVBOs_lines;
 		
+		// Shared buffers holding the data of the cached VBOs.
+		VBOPageVec					mPages;
+		
 		CachedVBO					mListOldEnd;
 		CachedVBO					mListNewEnd;
 		long long					mTotalBytes;
@@ -384,6 +488,90 @@ static VBOCache* GetVBOCache( TQ3GLContext glContext )
 }
 
 
+/*!
+	@function	BindBuffer
+	@abstract	Bind a buffer object and count the call for the frame
+				statistics.
+*/
+static void BindBuffer( const QORenderer::Renderer& inRenderer,
+						GLenum inTarget,
+						GLuint inBufferName )
+{
+	(*inRenderer.Funcs().glBindBufferProc)( inTarget, inBufferName );
+	inRenderer.Counts().mBufferBinds += 1;
+}
+
+
+/*!
+	@function	SetVertexPointers
+	@abstract	Point the vertex attributes of the current program at
+				interleaved vertex data in the bound array buffer.
+	@param		inRenderer		An OpenGL renderer.
+	@param		inLayout		Layout of the vertex data.
+	@param		inBaseOffset	Byte offset of the first vertex in the buffer.
+*/
+static void SetVertexPointers( const QORenderer::Renderer& inRenderer,
+								const VertexLayout& inLayout,
+								TQ3Uns32 inBaseOffset )
+{
+	const QORenderer::ProgramRec* theProgram = inRenderer.Shader().CurrentProgram();
+	const GLsizei kStride = static_cast<GLsizei>( inLayout.mStride );
+
+	inRenderer.SLFuncs().glVertexAttribPointer( theProgram->mVertexAttribLoc,
+		3, GL_FLOAT, GL_FALSE, kStride, GLBufferObPtr( inBaseOffset ) );
+	
+	if (inLayout.mNormalOffset != kAbsentBuffer)
+	{
+		inRenderer.SLFuncs().glVertexAttribPointer( theProgram->mNormalAttribLoc,
+			3, GL_FLOAT, GL_FALSE, kStride,
+			GLBufferObPtr( inBaseOffset + inLayout.mNormalOffset ) );
+	}
+	
+	if (inLayout.mUVOffset != kAbsentBuffer)
+	{
+		inRenderer.SLFuncs().glVertexAttribPointer( theProgram->mTexCoordAttribLoc,
+			2, GL_FLOAT, GL_FALSE, kStride,
+			GLBufferObPtr( inBaseOffset + inLayout.mUVOffset ) );
+	}
+	
+	if (inLayout.mColorOffset != kAbsentBuffer)
+	{
+		inRenderer.SLFuncs().glVertexAttribPointer( theProgram->mColorAttribLoc,
+			3, GL_FLOAT, GL_FALSE, kStride,
+			GLBufferObPtr( inBaseOffset + inLayout.mColorOffset ) );
+	}
+	
+	if (inLayout.mLayerShiftOffset != kAbsentBuffer)
+	{
+		inRenderer.SLFuncs().glVertexAttribPointer( theProgram->mLayerShiftAttribLoc,
+			1, GL_FLOAT, GL_FALSE, kStride,
+			GLBufferObPtr( inBaseOffset + inLayout.mLayerShiftOffset ) );
+	}
+}
+
+
+/*!
+	@function	StartInPage
+	@abstract	Get the first element of the range that a cached VBO occupies
+				in a vertex or index page.
+*/
+static TQ3Uns32& StartInPage( CachedVBO* inVBO, const VBOPage* inPage )
+{
+	return inPage->IsIndexPage()? inVBO->mFirstIndex : inVBO->mFirstVertex;
+}
+
+
+/*!
+	@function	CountInPage
+	@abstract	Get the number of elements that a cached VBO occupies in a
+				vertex or index page.
+*/
+static TQ3Uns32 CountInPage( const CachedVBO* inVBO, const VBOPage* inPage )
+{
+	return inPage->IsIndexPage()? inVBO->mNumIndices : inVBO->mNumPoints;
+}
+
+
 /*!
 	@function	FindVBOByGeom
 	@abstract	Look for a VBO record in a sorted vector, matching a geometry.
@@ -439,16 +627,24 @@ CachedVBO::CachedVBO( TQ3GeometryObject inGeom, GLenum inMode )
 	, mSortKey( inGeom )
 	, mEditIndex( Q3Shared_GetEditIndex( inGeom ) )
 	, mGLMode( inMode )
+	, mFormat( 0 )
+	, mNumPoints( 0 )
+	, mNumIndices( 0 )
+	, mVertexPage( nullptr )
+	, mFirstVertex( 0 )
+	, mIndexPage( nullptr )
+	, mFirstIndex( 0 )
 	, mBufferBytes( 0 )
 	, mPrev( nullptr )
 	, mNext( nullptr )
 {
-	// Leave other fields uninitialized for now
 }
 
 CachedVBO::CachedVBO()
 	: mGeomObject()
 	, mSortKey( nullptr )
+	, mVertexPage( nullptr )
+	, mIndexPage( nullptr )
 	, mBufferBytes( 0 )
 	, mPrev( nullptr )
 	, mNext( nullptr )
@@ -463,6 +659,112 @@ bool	CachedVBO::IsStale() const
 
 #pragma mark -
 
+VertexLayout::VertexLayout( TQ3Uns32 inFormat )
+	: mStride( sizeof(TQ3Point3D) )
+	, mNormalOffset( kAbsentBuffer )
+	, mColorOffset( kAbsentBuffer )
+	, mUVOffset( kAbsentBuffer )
+	, mLayerShiftOffset( kAbsentBuffer )
+{
+	if ( (inFormat & kFormatNormal) != 0 )
+	{
+		mNormalOffset = mStride;
+		mStride += sizeof(TQ3Vector3D);
+	}
+	if ( (inFormat & kFormatColor) != 0 )
+	{
+		mColorOffset = mStride;
+		mStride += sizeof(TQ3ColorRGB);
+	}
+	if ( (inFormat & kFormatUV) != 0 )
+	{
+		mUVOffset = mStride;
+		mStride += sizeof(TQ3Param2D);
+	}
+	if ( (inFormat & kFormatLayerShift) != 0 )
+	{
+		mLayerShiftOffset = mStride;
+		mStride += sizeof(float);
+	}
+}
+
+#pragma mark -
+
+FreeList::FreeList( TQ3Uns32 inCapacity )
+	: mCapacity( inCapacity )
+	, mFreeCount( inCapacity )
+{
+	if (inCapacity > 0)
+	{
+		mFreeRanges[ 0 ] = inCapacity;
+	}
+}
+
+bool	FreeList::Allocate( TQ3Uns32 inCount, TQ3Uns32& outStart )
+{
+	for (RangeMap::iterator i = mFreeRanges.begin(); i != mFreeRanges.end(); ++i)
+	{
+		if (i->second >= inCount)
+		{
+			outStart = i->first;
+			TQ3Uns32 restCount = i->second - inCount;
+			mFreeRanges.erase( i );
+			if (restCount > 0)
+			{
+				mFreeRanges[ outStart + inCount ] = restCount;
+			}
+			mFreeCount -= inCount;
+			return true;
+		}
+	}
+	return false;
+}
+
+void	FreeList::Free( TQ3Uns32 inStart, TQ3Uns32 inCount )
+{
+	TQ3Uns32 rangeStart = inStart;
+	TQ3Uns32 rangeCount = inCount;
+	
+	// Merge with the free range that follows, if adjacent
+	RangeMap::iterator nextIt = mFreeRanges.lower_bound( inStart );
+	if ( (nextIt != mFreeRanges.end()) && (nextIt->first == inStart + inCount) )
+	{
+		rangeCount += nextIt->second;
+		nextIt = mFreeRanges.erase( nextIt );
+	}
+	
+	// Merge with the free range that precedes, if adjacent
+	if (nextIt != mFreeRanges.begin())
+	{
+		RangeMap::iterator prevIt = nextIt;
+		--prevIt;
+		if (prevIt->first + prevIt->second == inStart)
+		{
+			rangeStart = prevIt->first;
+			rangeCount += prevIt->second;
+			mFreeRanges.erase( prevIt );
+		}
+	}
+	
+	mFreeRanges[ rangeStart ] = rangeCount;
+	mFreeCount += inCount;
+}
+
+/*
+	After compaction, all the used elements are at the start of the buffer.
+*/
+void	FreeList::SetCompacted( TQ3Uns32 inUsedCount )
+{
+	mFreeRanges.clear();
+	mFreeCount = mCapacity - inUsedCount;
+	if (mFreeCount > 0)
+	{
+		mFreeRanges[ inUsedCount ] = mFreeCount;
+	}
+}
+
+#pragma mark -
+
 VBOCache::VBOCache()
 	: mTotalBytes( 0 )
 	, mMaxBufferBytes( 0 )
@@ -479,6 +781,7 @@ VBOCache::~VBOCache()
 	DeleteCachedVBOs( mCachedVBOs_strips, funcs );
 	DeleteCachedVBOs( mCachedVBOs_triangles, funcs );
 	DeleteCachedVBOs( mCachedVBOs_lines, funcs );
+	ReleaseEmptyPages( funcs );
 }
 
 
@@ -631,67 +934,260 @@ void	VBOCache::AddVBO( CachedVBO* inVBO )
 }
 
 
-void VBOCache::RenderVBO( const QORenderer::Renderer& inRenderer, const CachedVBO* inCachedVBO )
+
+/*!
+	@function	AllocateRange
+	@abstract	Find room for the vertices or the indices of a cached VBO in
+				a shared buffer.
+	@discussion	We first look for a gap in an existing buffer of the right
+				format.  If there is none, but some buffer has enough free
+				space in total, we compact that buffer.  Otherwise we create
+				a new buffer, large enough for this VBO even if it is bigger
+				than the usual buffer size.
+	@param		inRenderer		An OpenGL renderer.
+	@param		inFormat		A vertex format, or kFormatIndices.
+	@param		inElementSize	Size of a vertex or index in bytes.
+	@param		inClient		The VBO needing space.  Its mNumPoints or
+								mNumIndices field must be set.
+	@result		The page where the range was allocated, or nullptr.
+*/
+VBOPage*	VBOCache::AllocateRange( const QORenderer::Renderer& inRenderer,
+									TQ3Uns32 inFormat, TQ3Uns32 inElementSize,
+									CachedVBO* inClient )
 {
-	CHECK_VBO( inCachedVBO );
-	Q3_ASSERT( (*inRenderer.Funcs().glIsBufferProc)( inCachedVBO->mGLBufferNames[0] ) );
-	Q3_ASSERT( (*inRenderer.Funcs().glIsBufferProc)( inCachedVBO->mGLBufferNames[1] ) );
+	const TQ3Uns32 kCount = (inFormat == kFormatIndices)? inClient->mNumIndices :
+		inClient->mNumPoints;
+	TQ3Uns32 rangeStart = 0;
+	VBOPage* thePage = nullptr;
+	
+	for (VBOPage* aPage : mPages)
+	{
+		if ( (aPage->mFormat == inFormat) &&
+			aPage->mFreeList.Allocate( kCount, rangeStart ) )
+		{
+			thePage = aPage;
+			break;
+		}
+	}
+	
+	if ( (thePage == nullptr) &&
+		(inRenderer.Funcs().glCopyBufferSubDataProc != nullptr) )
+	{
+		for (VBOPage* aPage : mPages)
+		{
+			if ( (aPage->mFormat == inFormat) &&
+				(aPage->mFreeList.FreeCount() >= kCount) )
+			{
+				CompactPage( inRenderer, aPage );
+				if (aPage->mFreeList.Allocate( kCount, rangeStart ))
+				{
+					thePage = aPage;
+				}
+				break;
+			}
+		}
+	}
+	
+	if (thePage == nullptr)
+	{
+		const TQ3Uns32 kCapacity = std::max( kCount, kPageBytes / inElementSize );
+		thePage = new VBOPage( inFormat, inElementSize, kCapacity );
+		
+		(*inRenderer.Funcs().glGenBuffersProc)( 1, &thePage->mGLBufferName );
+		sVBOCount += 1;
+		BindBuffer( inRenderer, thePage->Target(), thePage->mGLBufferName );
+		(*inRenderer.Funcs().glBufferDataProc)( thePage->Target(),
+			static_cast<GLsizeiptr>(kCapacity) * inElementSize, nullptr,
+			GL_STATIC_DRAW );
+		GLenum error = glGetError();
+		if (error == GL_OUT_OF_MEMORY)
+		{
+			DumpVBOs();
+			Q3_ASSERT_FMT( false, "Failed to allocate VBO memory!");
+		}
+		BindBuffer( inRenderer, thePage->Target(), 0 );
+		RecordVBO( thePage->mGLBufferName, nullptr, kCapacity * inElementSize,
+			thePage->IsIndexPage()? 1 : 0 );
+		mPages.push_back( thePage );
+		
+		thePage->mFreeList.Allocate( kCount, rangeStart );
+	}
+	
+	StartInPage( inClient, thePage ) = rangeStart;
+	thePage->mClients[ rangeStart ] = inClient;
+	
+	return thePage;
+}
 
-	(*inRenderer.Funcs().glBindBufferProc)( GL_ARRAY_BUFFER, inCachedVBO->mGLBufferNames[0] );
 
-#if Q3_DEBUG
-	GLint elementDataSize, mainDataSize, tcSumSize = 0;
-	(*inRenderer.Funcs().glGetBufferParameterivProc)( GL_ARRAY_BUFFER, GL_BUFFER_SIZE,
-		&mainDataSize );
-#endif
+/*!
+	@function	FreeRange
+	@abstract	Return the range occupied by a cached VBO to its page.
+*/
+void	VBOCache::FreeRange( VBOPage* ioPage, CachedVBO* inClient )
+{
+	const TQ3Uns32 kStart = StartInPage( inClient, ioPage );
+	ioPage->mFreeList.Free( kStart, CountInPage( inClient, ioPage ) );
+	ioPage->mClients.erase( kStart );
+}
+
+
+/*!
+	@function	CompactPage
+	@abstract	Move the data of all VBOs in a page to the start of a new
+				buffer, so that its free space becomes one range.
+	@discussion	Adjacent ranges are moved together.  Data is copied on the
+				GPU, using glCopyBufferSubData.
+*/
+void	VBOCache::CompactPage( const QORenderer::Renderer& inRenderer,
+								VBOPage* ioPage )
+{
+	const QORenderer::GLFuncs& funcs( inRenderer.Funcs() );
+	const GLsizeiptr kElementSize = ioPage->mElementSize;
 	
-	inRenderer.SLFuncs().glVertexAttribPointer( inRenderer.Shader().CurrentProgram()->mVertexAttribLoc,
-		3, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( inCachedVBO->mVertexBufferOffset ) );
+	GLuint newBufferName = 0;
+	(*funcs.glGenBuffersProc)( 1, &newBufferName );
+	sVBOCount += 1;
+	BindBuffer( inRenderer, GL_COPY_WRITE_BUFFER, newBufferName );
+	(*funcs.glBufferDataProc)( GL_COPY_WRITE_BUFFER,
+		ioPage->mFreeList.Capacity() * kElementSize, nullptr, GL_STATIC_DRAW );
+	BindBuffer( inRenderer, GL_COPY_READ_BUFFER, ioPage->mGLBufferName );
 	
-	if (inCachedVBO->mNormalBufferOffset != kAbsentBuffer)
+	std::map< TQ3Uns32, CachedVBO* > movedClients;
+	TQ3Uns32 destStart = 0;
+	TQ3Uns32 copySrcStart = 0;
+	TQ3Uns32 copyDestStart = 0;
+	TQ3Uns32 copyCount = 0;
+	
+	for (auto& client : ioPage->mClients)
 	{
-		inRenderer.SLFuncs().glVertexAttribPointer( inRenderer.Shader().CurrentProgram()->mNormalAttribLoc,
-			3, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( inCachedVBO->mNormalBufferOffset ) );
+		const TQ3Uns32 kCount = CountInPage( client.second, ioPage );
+		
+		if (copySrcStart + copyCount != client.first)
+		{
+			if (copyCount > 0)
+			{
+				(*funcs.glCopyBufferSubDataProc)( GL_COPY_READ_BUFFER,
+					GL_COPY_WRITE_BUFFER, copySrcStart * kElementSize,
+					copyDestStart * kElementSize, copyCount * kElementSize );
+			}
+			copySrcStart = client.first;
+			copyDestStart = destStart;
+			copyCount = 0;
+		}
+		copyCount += kCount;
+		
+		StartInPage( client.second, ioPage ) = destStart;
+		movedClients[ destStart ] = client.second;
+		destStart += kCount;
 	}
 	
-	if (inCachedVBO->mTextureUVBufferOffset != kAbsentBuffer)
+	if (copyCount > 0)
 	{
-		inRenderer.SLFuncs().glVertexAttribPointer( inRenderer.Shader().CurrentProgram()->mTexCoordAttribLoc,
-			2, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( inCachedVBO->mTextureUVBufferOffset ) );
+		(*funcs.glCopyBufferSubDataProc)( GL_COPY_READ_BUFFER,
+			GL_COPY_WRITE_BUFFER, copySrcStart * kElementSize,
+			copyDestStart * kElementSize, copyCount * kElementSize );
 	}
+	CHECK_GL_ERROR;
+	
+	BindBuffer( inRenderer, GL_COPY_READ_BUFFER, 0 );
+	BindBuffer( inRenderer, GL_COPY_WRITE_BUFFER, 0 );
+	
+	(*funcs.glDeleteBuffersProc)( 1, &ioPage->mGLBufferName );
+	ForgetVBO( ioPage->mGLBufferName );
+	sVBOCount -= 1;
+	RecordVBO( newBufferName, nullptr,
+		ioPage->mFreeList.Capacity() * ioPage->mElementSize,
+		ioPage->IsIndexPage()? 1 : 0 );
+	
+	ioPage->mGLBufferName = newBufferName;
+	ioPage->mClients.swap( movedClients );
+	ioPage->mFreeList.SetCompacted( destStart );
+	Q3_MESSAGE_FMT("Compacted VBO page, %u of %u elements in use",
+		(unsigned int) destStart, (unsigned int) ioPage->mFreeList.Capacity() );
+}
+
+
+/*!
+	@function	AllocateStorage
+	@abstract	Allocate vertex and index ranges for a new cached VBO.
+	@discussion	The VBO's format, point count and index count must be set.
+*/
+bool	VBOCache::AllocateStorage( const QORenderer::Renderer& inRenderer,
+									CachedVBO* ioVBO )
+{
+	const VertexLayout layout( ioVBO->mFormat );
 	
-	if (inCachedVBO->mColorBufferOffset != kAbsentBuffer)
+	ioVBO->mVertexPage = AllocateRange( inRenderer, ioVBO->mFormat,
+		layout.mStride, ioVBO );
+	if (ioVBO->mVertexPage != nullptr)
 	{
-		inRenderer.SLFuncs().glVertexAttribPointer( inRenderer.Shader().CurrentProgram()->mColorAttribLoc,
-			3, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( inCachedVBO->mColorBufferOffset ) );
+		ioVBO->mIndexPage = AllocateRange( inRenderer, kFormatIndices,
+			sizeof(TQ3Uns32), ioVBO );
+		if (ioVBO->mIndexPage == nullptr)
+		{
+			FreeRange( ioVBO->mVertexPage, ioVBO );
+			ioVBO->mVertexPage = nullptr;
+		}
 	}
 	
-	if (inCachedVBO->mLayerShiftBufferOffset != kAbsentBuffer)
+	return ioVBO->mIndexPage != nullptr;
+}
+
+
+/*!
+	@function	ReleaseEmptyPages
+	@abstract	Delete shared buffers that no longer hold any VBO.
+*/
+void	VBOCache::ReleaseEmptyPages( const QORenderer::GLFuncs& inFuncs )
+{
+	VBOPageVec::iterator endKept = mPages.begin();
+	
+	for (VBOPage* aPage : mPages)
 	{
-		inRenderer.SLFuncs().glVertexAttribPointer( inRenderer.Shader().CurrentProgram()->mLayerShiftAttribLoc,
-			1, GL_FLOAT, GL_FALSE, 0, GLBufferObPtr( inCachedVBO->mLayerShiftBufferOffset ) );
+		if (aPage->mClients.empty())
+		{
+			Q3_ASSERT( (*inFuncs.glIsBufferProc)( aPage->mGLBufferName ) );
+			(*inFuncs.glDeleteBuffersProc)( 1, &aPage->mGLBufferName );
+			ForgetVBO( aPage->mGLBufferName );
+			sVBOCount -= 1;
+			delete aPage;
+		}
+		else
+		{
+			*endKept = aPage;
+			++endKept;
+		}
 	}
 	
-	(*inRenderer.Funcs().glBindBufferProc)( GL_ELEMENT_ARRAY_BUFFER,
-		inCachedVBO->mGLBufferNames[1] );
-	CHECK_GL_ERROR;
+	mPages.erase( endKept, mPages.end() );
+}
 
-#if Q3_DEBUG
-	(*inRenderer.Funcs().glGetBufferParameterivProc)( GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE,
-		&elementDataSize );
+
+void VBOCache::RenderVBO( const QORenderer::Renderer& inRenderer, const CachedVBO* inCachedVBO )
+{
+	CHECK_VBO( inCachedVBO );
+	const VertexLayout layout( inCachedVBO->mFormat );
+
+	BindBuffer( inRenderer, GL_ARRAY_BUFFER, inCachedVBO->mVertexPage->mGLBufferName );
+	
+	SetVertexPointers( inRenderer, layout,
+		inCachedVBO->mFirstVertex * layout.mStride );
+	
+	BindBuffer( inRenderer, GL_ELEMENT_ARRAY_BUFFER,
+		inCachedVBO->mIndexPage->mGLBufferName );
 	CHECK_GL_ERROR;
-	Q3_ASSERT( (TQ3Uns32)elementDataSize == inCachedVBO->mNumIndices * sizeof(TQ3Uns32) );
-	Q3_ASSERT( (GLint)inCachedVBO->mBufferBytes == elementDataSize + mainDataSize + tcSumSize );
-#endif
 
 	//Q3_MESSAGE_FMT("glDrawElements in RenderVBO (count %d, mode %d)", (int)inCachedVBO->mNumIndices,
 	//	(int)inCachedVBO->mGLMode );
 	glDrawElements( inCachedVBO->mGLMode, inCachedVBO->mNumIndices,
-		GL_UNSIGNED_INT, GLBufferObPtr( 0U ) );
+		GL_UNSIGNED_INT,
+		GLBufferObPtr( static_cast<GLuint>(inCachedVBO->mFirstIndex * sizeof(TQ3Uns32)) ) );
 	CHECK_GL_ERROR;
+	inRenderer.Counts().mDrawCalls += 1;
 		
-	(*inRenderer.Funcs().glBindBufferProc)( GL_ARRAY_BUFFER, 0 );
-	(*inRenderer.Funcs().glBindBufferProc)( GL_ELEMENT_ARRAY_BUFFER, 0 );
+	BindBuffer( inRenderer, GL_ARRAY_BUFFER, 0 );
+	BindBuffer( inRenderer, GL_ELEMENT_ARRAY_BUFFER, 0 );
 }
 
 void	VBOCache::DeleteFromUsageList( CachedVBO* ioVBO )
@@ -705,15 +1201,17 @@ void	VBOCache::DeleteFromUsageList( CachedVBO* ioVBO )
 void	VBOCache::DeleteVBO( CachedVBO* inCachedVBO, const QORenderer::GLFuncs& inFuncs )
 {
 	CHECK_VBO( inCachedVBO );
-	Q3_ASSERT( (*inFuncs.glIsBufferProc)( inCachedVBO->mGLBufferNames[0] ) );
-	Q3_ASSERT( (*inFuncs.glIsBufferProc)( inCachedVBO->mGLBufferNames[1] ) );
-	(*inFuncs.glDeleteBuffersProc)( 2, inCachedVBO->mGLBufferNames );
-	sVBOCount -= 2;
-	ForgetVBO( inCachedVBO->mGLBufferNames[0] );
-	ForgetVBO( inCachedVBO->mGLBufferNames[1] );
-	//Q3_MESSAGE_FMT("Deleted VBOs %d, %d, now there are %d",
-	//	inCachedVBO->mGLBufferNames[0], inCachedVBO->mGLBufferNames[1],
-	//	sVBOCount );
+	
+	// The shared buffers are kept until ReleaseEmptyPages, so that their
+	// free ranges can be reused.
+	if (inCachedVBO->mVertexPage != nullptr)
+	{
+		FreeRange( inCachedVBO->mVertexPage, inCachedVBO );
+	}
+	if (inCachedVBO->mIndexPage != nullptr)
+	{
+		FreeRange( inCachedVBO->mIndexPage, inCachedVBO );
+	}
 	
 	DeleteFromUsageList( inCachedVBO );
 	
@@ -760,6 +1258,7 @@ void	VBOCache::FlushUnreferenced( const QORenderer::GLFuncs& inFuncs )
 	FlushUnreferencedInVec( mCachedVBOs_strips, inFuncs );
 	FlushUnreferencedInVec( mCachedVBOs_triangles, inFuncs );
 	FlushUnreferencedInVec( mCachedVBOs_lines, inFuncs );
+	ReleaseEmptyPages( inFuncs );
 	VALIDATE_COUNT( this );
 }
 
@@ -814,6 +1313,43 @@ void	VBOCache::MakeRoom( TQ3Uns32 inBytesNeeded, const QORenderer::GLFuncs& inFu
 }
 
 
+/*!
+	@function		AddVBOToRun
+	@abstract		Add a cached VBO to a run of geometries waiting for a
+					multi-draw call, first drawing the run if the VBO cannot
+					join it.
+*/
+static void			AddVBOToRun(
+									const QORenderer::Renderer& inRenderer,
+									const CachedVBO* inVBO,
+									QORenderer::CachedVBORun& ioRun )
+{
+	if ( (! ioRun.IsEmpty()) &&
+		(
+			(ioRun.mArrayBuffer != inVBO->mVertexPage->mGLBufferName) ||
+			(ioRun.mIndexBuffer != inVBO->mIndexPage->mGLBufferName) ||
+			(ioRun.mMode != inVBO->mGLMode) ||
+			(ioRun.mFormat != inVBO->mFormat)
+		) )
+	{
+		DrawCachedVBORun( inRenderer, ioRun );
+	}
+	
+	if (ioRun.IsEmpty())
+	{
+		ioRun.mArrayBuffer = inVBO->mVertexPage->mGLBufferName;
+		ioRun.mIndexBuffer = inVBO->mIndexPage->mGLBufferName;
+		ioRun.mMode = inVBO->mGLMode;
+		ioRun.mFormat = inVBO->mFormat;
+	}
+	
+	ioRun.mCounts.push_back( static_cast<GLsizei>( inVBO->mNumIndices ) );
+	ioRun.mIndexOffsets.push_back( GLBufferObPtr(
+		static_cast<GLuint>( inVBO->mFirstIndex * sizeof(TQ3Uns32) ) ) );
+	ioRun.mBaseVertices.push_back( static_cast<GLint>( inVBO->mFirstVertex ) );
+}
+
+
 #pragma mark -
 //=============================================================================
 //		Public functions
@@ -838,21 +1374,29 @@ void				UpdateVBOCacheLimit(
 }
 
 
+
 /*!
 	@function		RenderCachedVBO
 	@abstract		Look for a cached VBO for the given geometry and OpenGL
 					context.  If we find one, render it.
 	@discussion		If we find the object in the cache, but the cached object
 					is stale, we delete it from the cache and return false.
+					
+					When OpenGL 3.2 base-vertex drawing is available, the
+					object is added to ioRun instead of being drawn
+					immediately.  If it cannot join the run, the run is
+					drawn first.
 	@param			inRenderer		An OpenGL renderer.
 	@param			inGeom			A geometry object.
 	@param			inMode			OpenGL mode, e.g., GL_TRIANGLES.
+	@param			ioRun			Geometries waiting for a multi-draw call.
 	@result			True if the object was found and rendered.
 */
 TQ3Boolean			RenderCachedVBO(
 									const QORenderer::Renderer& inRenderer,
 									TQ3GeometryObject inGeom,
-									GLenum inMode )
+									GLenum inMode,
+									QORenderer::CachedVBORun& ioRun )
 {
 	TQ3Boolean	didRender = kQ3False;
 	VBOCache*	theCache = GetVBOCache( inRenderer.GLContext() );
@@ -869,24 +1413,86 @@ TQ3Boolean			RenderCachedVBO(
 		if (theVBO != nullptr)
 		{
 			CHECK_VBO( theVBO );
-			theCache->RenderVBO( inRenderer, theVBO );
+			if ( (inRenderer.Funcs().glDrawElementsBaseVertexProc != nullptr) &&
+				(inRenderer.Funcs().glMultiDrawElementsBaseVertexProc != nullptr) )
+			{
+				AddVBOToRun( inRenderer, theVBO, ioRun );
+			}
+			else
+			{
+				theCache->RenderVBO( inRenderer, theVBO );
+			}
 			theCache->RenewInUsageList( theVBO );
 			didRender = kQ3True;
 		}
 	}
 	
+	if (didRender)
+		Q3_PROFILE_COUNT( "VBO cache hits", 1 );
+	else
+		Q3_PROFILE_COUNT( "VBO cache misses", 1 );
+	
 	return didRender;
 }
 
 
-
-
+/*!
+	@function		DrawCachedVBORun
+	@abstract		Draw and empty a run of cached geometries collected by
+					RenderCachedVBO.
+	@discussion		The vertex attribute pointers are set once, at the start
+					of the shared vertex buffer, and each geometry is located
+					by its base vertex.
+	@param			inRenderer		An OpenGL renderer.
+	@param			ioRun			Geometries waiting for a multi-draw call.
+*/
+void				DrawCachedVBORun(
+									const QORenderer::Renderer& inRenderer,
+									QORenderer::CachedVBORun& ioRun )
+{
+	if (ioRun.IsEmpty())
+	{
+		return;
+	}
+	
+	const VertexLayout layout( ioRun.mFormat );
+	
+	BindBuffer( inRenderer, GL_ARRAY_BUFFER, ioRun.mArrayBuffer );
+	SetVertexPointers( inRenderer, layout, 0 );
+	BindBuffer( inRenderer, GL_ELEMENT_ARRAY_BUFFER, ioRun.mIndexBuffer );
+	
+	if (ioRun.mCounts.size() == 1)
+	{
+		(*inRenderer.Funcs().glDrawElementsBaseVertexProc)( ioRun.mMode,
+			ioRun.mCounts[0], GL_UNSIGNED_INT, ioRun.mIndexOffsets[0],
+			ioRun.mBaseVertices[0] );
+	}
+	else
+	{
+		(*inRenderer.Funcs().glMultiDrawElementsBaseVertexProc)( ioRun.mMode,
+			&ioRun.mCounts[0], GL_UNSIGNED_INT, &ioRun.mIndexOffsets[0],
+			static_cast<GLsizei>( ioRun.mCounts.size() ),
+			&ioRun.mBaseVertices[0] );
+	}
+	CHECK_GL_ERROR;
+	inRenderer.Counts().mDrawCalls += 1;
+	Q3_PROFILE_COUNT( "VBO multi-draw geometries", ioRun.mCounts.size() );
+	
+	BindBuffer( inRenderer, GL_ARRAY_BUFFER, 0 );
+	BindBuffer( inRenderer, GL_ELEMENT_ARRAY_BUFFER, 0 );
+	
+	ioRun.mCounts.clear();
+	ioRun.mIndexOffsets.clear();
+	ioRun.mBaseVertices.clear();
+}
 
 
 /*!
 	@function		AddVBOToCache
 	@abstract		Add VBO data to the cache.  Do not call this unless
 					RenderCachedVBO has just returned false.
+	@discussion		Adding data may purge or move other cached data, so any
+					pending CachedVBORun must be drawn first.
 	@param			inRenderer		An OpenGL renderer.
 	@param			inGeom			A geometry object.
 	@param			inNumPoints		Number of points (vertices).
@@ -914,17 +1520,6 @@ void				AddVBOToCache(
 	
 	if (theCache != nullptr)
 	{
-		CachedVBO*	newVBO = new CachedVBO( inGeom, inMode );
-		ALLOCATED_VBO( newVBO );
-		newVBO->mNumIndices = inNumIndices;
-	#if Q3_DEBUG
-		newVBO->mNumPoints = inNumPoints;
-	#endif
-		(*inRenderer.Funcs().glGenBuffersProc)( 2, newVBO->mGLBufferNames );
-		sVBOCount += 2;
-		//Q3_MESSAGE_FMT("Created VBOs %d, %d, now there are %d",
-		//	newVBO->mGLBufferNames[0], newVBO->mGLBufferNames[1], sVBOCount );
-		
 		// Check for layer shift data
 		TQ3Uns32 bufSize;
 		TQ3LayerShifts* layerShifts = nullptr;
@@ -944,87 +1539,80 @@ void				AddVBOToCache(
 			}
 		}
 		
-		// Compute sizes of each kind of vertex data
-		TQ3Uns32	vertexDataSize = static_cast<TQ3Uns32>(inNumPoints * sizeof(TQ3Point3D));
-		TQ3Uns32	normalDataSize = (inNormals == nullptr)? 0 :
-			static_cast<TQ3Uns32>(inNumPoints * sizeof(TQ3Vector3D));
-		TQ3Uns32	colorDataSize = (inColors == nullptr)? 0 :
-			static_cast<TQ3Uns32>(inNumPoints * sizeof(TQ3ColorRGB));
-		TQ3Uns32	uvDataSize = (inUVs == nullptr)? 0 :
-			static_cast<TQ3Uns32>(inNumPoints * sizeof(TQ3Param2D));
-		TQ3Uns32	layerShiftDataSize = (layerShifts == nullptr)? 0 :
-			static_cast<TQ3Uns32>(inNumPoints * sizeof(float));
-		TQ3Uns32	totalDataSize = vertexDataSize + normalDataSize +
-			colorDataSize + uvDataSize + layerShiftDataSize;
-		
-		newVBO->mBufferBytes = static_cast<TQ3Uns32>(inNumIndices * sizeof(TQ3Uns32) + totalDataSize);
-		theCache->MakeRoom( newVBO->mBufferBytes, inRenderer.Funcs() );
-			
-		newVBO->mVertexBufferOffset = 0;
-		newVBO->mNormalBufferOffset = (inNormals == nullptr)? kAbsentBuffer :
-			vertexDataSize;
-		newVBO->mColorBufferOffset = (inColors == nullptr)? kAbsentBuffer :
-			vertexDataSize + normalDataSize;
-		newVBO->mTextureUVBufferOffset = (inUVs == nullptr)? kAbsentBuffer :
-			vertexDataSize + normalDataSize + colorDataSize;
-		newVBO->mLayerShiftBufferOffset = (layerShifts == nullptr)? kAbsentBuffer :
-			vertexDataSize + normalDataSize + colorDataSize + uvDataSize;
+		// Work out the vertex format
+		TQ3Uns32 theFormat = 0;
+		if (inNormals != nullptr)
+			theFormat |= kFormatNormal;
+		if (inColors != nullptr)
+			theFormat |= kFormatColor;
+		if (inUVs != nullptr)
+			theFormat |= kFormatUV;
+		if (layerShifts != nullptr)
+			theFormat |= kFormatLayerShift;
+		const VertexLayout layout( theFormat );
 		
-		theCache->AddVBO( newVBO );
+		CachedVBO*	newVBO = new CachedVBO( inGeom, inMode );
+		ALLOCATED_VBO( newVBO );
+		newVBO->mFormat = theFormat;
+		newVBO->mNumPoints = inNumPoints;
+		newVBO->mNumIndices = inNumIndices;
 		
-		const GLvoid *	dataAddr;
+		const TQ3Uns32	vertexDataSize = inNumPoints * layout.mStride;
+		const TQ3Uns32	indexDataSize = static_cast<TQ3Uns32>(inNumIndices * sizeof(TQ3Uns32));
+		newVBO->mBufferBytes = vertexDataSize + indexDataSize;
+		theCache->MakeRoom( newVBO->mBufferBytes, inRenderer.Funcs() );
 		
-		// First define an uninitialized buffer of the right size
-		(*inRenderer.Funcs().glBindBufferProc)( GL_ARRAY_BUFFER,
-			newVBO->mGLBufferNames[0] );
-		(*inRenderer.Funcs().glBufferDataProc)( GL_ARRAY_BUFFER, totalDataSize,
-			nullptr, GL_STATIC_DRAW );
-		GLenum error = glGetError();
-		if (error == GL_OUT_OF_MEMORY)
+		if (! theCache->AllocateStorage( inRenderer, newVBO ))
 		{
-			DumpVBOs();
-			Q3_ASSERT_FMT( false, "Failed to allocate VBO memory!");
+			FREED_VBO( newVBO );
+			delete newVBO;
+			return;
 		}
-		RecordVBO( newVBO->mGLBufferNames[0], inGeom, totalDataSize, 0 );
 		
-		// Then set sub-buffer data
-		dataAddr = inPoints;
-		(*inRenderer.Funcs().glBufferSubDataProc)( GL_ARRAY_BUFFER, 0,
-			vertexDataSize, dataAddr );
-		if (inNormals != nullptr)
-		{
-			dataAddr = inNormals;
-			(*inRenderer.Funcs().glBufferSubDataProc)( GL_ARRAY_BUFFER,
-				newVBO->mNormalBufferOffset, normalDataSize, dataAddr );
-		}
-		if (inColors != nullptr)
-		{
-			dataAddr = inColors;
-			(*inRenderer.Funcs().glBufferSubDataProc)( GL_ARRAY_BUFFER,
-				newVBO->mColorBufferOffset, colorDataSize, dataAddr );
-		}
-		if (inUVs != nullptr)
-		{
-			dataAddr = inUVs;
-			(*inRenderer.Funcs().glBufferSubDataProc)( GL_ARRAY_BUFFER,
-				newVBO->mTextureUVBufferOffset, uvDataSize, dataAddr );
-		}
-		if (layerShifts != nullptr)
+		theCache->AddVBO( newVBO );
+		
+		// Interleave the vertex data
+		std::vector<TQ3Uns8>	vertexData( vertexDataSize );
+		TQ3Uns8*	dest = &vertexData[0];
+		for (TQ3Uns32 i = 0; i < inNumPoints; ++i, dest += layout.mStride)
 		{
-			dataAddr = layerShifts->coords;
-			(*inRenderer.Funcs().glBufferSubDataProc)( GL_ARRAY_BUFFER,
-				newVBO->mLayerShiftBufferOffset, layerShiftDataSize, dataAddr );
+			std::memcpy( dest, &inPoints[i], sizeof(TQ3Point3D) );
+			if (inNormals != nullptr)
+			{
+				std::memcpy( dest + layout.mNormalOffset, &inNormals[i],
+					sizeof(TQ3Vector3D) );
+			}
+			if (inColors != nullptr)
+			{
+				std::memcpy( dest + layout.mColorOffset, &inColors[i],
+					sizeof(TQ3ColorRGB) );
+			}
+			if (inUVs != nullptr)
+			{
+				std::memcpy( dest + layout.mUVOffset, &inUVs[i],
+					sizeof(TQ3Param2D) );
+			}
+			if (layerShifts != nullptr)
+			{
+				std::memcpy( dest + layout.mLayerShiftOffset,
+					&layerShifts->coords[i], sizeof(float) );
+			}
 		}
-		(*inRenderer.Funcs().glBindBufferProc)( GL_ARRAY_BUFFER, 0 );
 		
-		// Now for the index data.
-		(*inRenderer.Funcs().glBindBufferProc)( GL_ELEMENT_ARRAY_BUFFER,
-			newVBO->mGLBufferNames[1] );
-		dataAddr = inIndices;
-		(*inRenderer.Funcs().glBufferDataProc)( GL_ELEMENT_ARRAY_BUFFER,
-			inNumIndices * sizeof(TQ3Uns32), dataAddr, GL_STATIC_DRAW );
-		(*inRenderer.Funcs().glBindBufferProc)( GL_ELEMENT_ARRAY_BUFFER, 0 );
-		RecordVBO( newVBO->mGLBufferNames[1], inGeom, inNumIndices * sizeof(TQ3Uns32), 0 );
+		// Copy the data into the ranges of the shared buffers
+		BindBuffer( inRenderer, GL_ARRAY_BUFFER,
+			newVBO->mVertexPage->mGLBufferName );
+		(*inRenderer.Funcs().glBufferSubDataProc)( GL_ARRAY_BUFFER,
+			static_cast<GLintptr>(newVBO->mFirstVertex) * layout.mStride,
+			vertexDataSize, &vertexData[0] );
+		BindBuffer( inRenderer, GL_ARRAY_BUFFER, 0 );
+		
+		BindBuffer( inRenderer, GL_ELEMENT_ARRAY_BUFFER,
+			newVBO->mIndexPage->mGLBufferName );
+		(*inRenderer.Funcs().glBufferSubDataProc)( GL_ELEMENT_ARRAY_BUFFER,
+			static_cast<GLintptr>(newVBO->mFirstIndex) * sizeof(TQ3Uns32),
+			indexDataSize, inIndices );
+		BindBuffer( inRenderer, GL_ELEMENT_ARRAY_BUFFER, 0 );
 	}
 }
 
@@ -1033,7 +1621,8 @@ void				AddVBOToCache(
 /*!
 	@function		FlushVBOCache
 	@abstract		Delete any cached VBOs for geometries that are no longer
-					referenced elsewhere.
+					referenced elsewhere, and release shared buffers that
+					have become empty.
 	@param			inRenderer		An OpenGL renderer.
 */
 void				FlushVBOCache(
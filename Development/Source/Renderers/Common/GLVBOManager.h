@@ -63,6 +63,7 @@
 #include "GLPrefix.h"
 #include "QuesaStyle.h"
 #include <cstddef>
+#include <vector>
 
 
 //=============================================================================
@@ -73,6 +74,44 @@
 namespace QORenderer
 {
 	class Renderer;
+
+	/*!
+		@struct		CachedVBORun
+		@abstract	Cached geometries waiting to be drawn by one multi-draw
+					call.
+		@discussion	Consecutive cached geometries that share vertex and index
+					buffers, primitive mode and vertex format are collected
+					by RenderCachedVBO and drawn together by DrawCachedVBORun.
+					The caller must draw the run before changing any OpenGL
+					state that the recorded geometries depend on.
+					
+					mArrayMask and mConstantColor are not used by the VBO
+					cache.  The renderer uses them to remember the vertex
+					array and constant color state that the run was recorded
+					with.
+	*/
+	struct CachedVBORun
+	{
+							CachedVBORun()
+								: mArrayBuffer( 0 )
+								, mIndexBuffer( 0 )
+								, mMode( 0 )
+								, mFormat( 0 )
+								, mArrayMask( 0 ) {}
+		
+		bool				IsEmpty() const { return mCounts.empty(); }
+	
+		GLuint						mArrayBuffer;
+		GLuint						mIndexBuffer;
+		GLenum						mMode;
+		TQ3Uns32					mFormat;
+		std::vector<GLsizei>		mCounts;
+		std::vector<const GLvoid*>	mIndexOffsets;
+		std::vector<GLint>			mBaseVertices;
+		
+		TQ3Uns32					mArrayMask;
+		TQ3ColorRGB					mConstantColor;
+	};
 }
 
 
@@ -109,20 +148,40 @@ void				UpdateVBOCacheLimit(
 					The caller should have activated the GL context and called
 					glEnableClientState to enable or disable arrays as
 					appropriate.
+					
+					When OpenGL 3.2 base-vertex drawing is available, the
+					object is added to ioRun instead of being drawn
+					immediately.  If it cannot join the run, the run is
+					drawn first.
 	@param			inRenderer		An OpenGL renderer.
 	@param			inGeom			A geometry object.
 	@param			inMode			OpenGL mode, e.g., GL_TRIANGLES.
+	@param			ioRun			Geometries waiting for a multi-draw call.
 	@result			True if the object was found and rendered.
 */
 TQ3Boolean			RenderCachedVBO(
 									const QORenderer::Renderer& inRenderer,
 									TQ3GeometryObject inGeom,
-									GLenum inMode );
+									GLenum inMode,
+									QORenderer::CachedVBORun& ioRun );
+
+/*!
+	@function		DrawCachedVBORun
+	@abstract		Draw and empty a run of cached geometries collected by
+					RenderCachedVBO.
+	@param			inRenderer		An OpenGL renderer.
+	@param			ioRun			Geometries waiting for a multi-draw call.
+*/
+void				DrawCachedVBORun(
+									const QORenderer::Renderer& inRenderer,
+									QORenderer::CachedVBORun& ioRun );
 
 /*!
 	@function		AddVBOToCache
 	@abstract		Add VBO data to the cache.  Do not call this unless
 					RenderCachedVBO has just returned false.
+	@discussion		Adding data may purge or move other cached data, so any
+					pending CachedVBORun must be drawn first.
 	@param			inRenderer		An OpenGL renderer.
 	@param			inGeom			A geometry object.
 	@param			inNumPoints		Number of points (vertices).
@@ -150,7 +209,8 @@ void				AddVBOToCache(
 /*!
 	@function		FlushVBOCache
 	@abstract		Delete any cached VBOs for geometries that are no longer
-					referenced elsewhere.
+					referenced elsewhere, and release shared buffers that
+					have become empty.
 	@param			inRenderer		An OpenGL renderer.
 */
 void				FlushVBOCache(
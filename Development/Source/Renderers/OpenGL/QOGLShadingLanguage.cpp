@@ -247,6 +247,7 @@ QORenderer::ProgramRec::ProgramRec( const ProgramRec& inOther )
 	, mAngleOfViewAttribLoc( inOther.mAngleOfViewAttribLoc )
 	, mFisheyeMappingFuncAttribLoc( inOther.mFisheyeMappingFuncAttribLoc )
 	, mFisheyeCroppingAttribLoc( inOther.mFisheyeCroppingAttribLoc )
+	, mUniformValues( inOther.mUniformValues )
 {}
 
 void	QORenderer::ProgramRec::swap( ProgramRec& ioOther )
@@ -302,6 +303,7 @@ void	QORenderer::ProgramRec::swap( ProgramRec& ioOther )
 	std::swap( mAngleOfViewAttribLoc, ioOther.mAngleOfViewAttribLoc );
 	std::swap( mFisheyeMappingFuncAttribLoc, ioOther.mFisheyeMappingFuncAttribLoc );
 	std::swap( mFisheyeCroppingAttribLoc, ioOther.mFisheyeCroppingAttribLoc );
+	mUniformValues.swap( ioOther.mUniformValues );
 }
 
 QORenderer::ProgramRec&
@@ -369,6 +371,9 @@ void	QORenderer::GLSLFuncs::SetNULL()
 	glVertexAttrib3fv = nullptr;
 	glVertexAttribPointer = nullptr;
 	glBindAttribLocation = nullptr;
+	glGetProgramBinary = nullptr;
+	glProgramBinary = nullptr;
+	glProgramParameteri = nullptr;
 }
 
 void	QORenderer::GLSLFuncs::Initialize( const TQ3GLExtensions& inExts )
@@ -408,6 +413,10 @@ void	QORenderer::GLSLFuncs::Initialize( const TQ3GLExtensions& inExts )
 		GLGetProcAddress( glVertexAttrib3fv, "glVertexAttrib3fv" );
 		GLGetProcAddress( glVertexAttribPointer, "glVertexAttribPointer" );
 		GLGetProcAddress(glBindAttribLocation, "glBindAttribLocation");
+		
+		GLGetProcAddress( glGetProgramBinary, "glGetProgramBinary" );
+		GLGetProcAddress( glProgramBinary, "glProgramBinary" );
+		GLGetProcAddress( glProgramParameteri, "glProgramParameteri" );
 
 		if ( (glCreateShader == nullptr) ||
 			(glShaderSource == nullptr) ||
@@ -472,6 +481,7 @@ QORenderer::PerPixelLighting::PerPixelLighting(
 	, mFogDensity( 1.0f )
 	, mMaxFogOpacity( 1.0f )
 	, mAlphaThreshold( 0.0f )
+	, mBinaryCache( inFuncs )
 	, mCurrentProgram( nullptr )
 {
 	Q3Matrix4x4_SetIdentity( &mModelViewMtx );
@@ -918,7 +928,73 @@ void	QORenderer::PerPixelLighting::StartFrame( TQ3ViewObject inView )
 			break;
 	}
 	
-	InitVertexShader();
+	InitVertexShader( mProgramCharacteristic.mProjectionType );
+	
+	UpdateShaderCacheDirectory();
+	PrewarmPrograms();
+}
+
+
+/*!
+	@function	UpdateShaderCacheDirectory
+	@abstract	Pass the value of kQ3RendererPropertyShaderCacheDirectory, if
+				any, on to the program binary cache.
+*/
+void	QORenderer::PerPixelLighting::UpdateShaderCacheDirectory()
+{
+	std::string	theDirectory;
+	TQ3Uns32	propSize = 0;
+	if ( (kQ3Success == Q3Object_GetProperty( mRendererObject,
+		kQ3RendererPropertyShaderCacheDirectory, 0, &propSize, nullptr )) &&
+		(propSize > 1) )
+	{
+		std::vector<char>	pathBuf( propSize + 1, '\0' );
+		if (kQ3Success == Q3Object_GetProperty( mRendererObject,
+			kQ3RendererPropertyShaderCacheDirectory, propSize, nullptr, &pathBuf[0] ))
+		{
+			theDirectory = &pathBuf[0];
+		}
+	}
+	
+	mBinaryCache.SetDirectory( theDirectory );
+}
+
+
+/*!
+	@function	PrewarmPrograms
+	@abstract	If the client has set kQ3RendererPropertyPrewarmShaders, create
+				every program listed in the shader cache manifest.
+	@discussion	The property is removed afterward, so that the work is only
+				done once per request.
+*/
+void	QORenderer::PerPixelLighting::PrewarmPrograms()
+{
+	TQ3Boolean	doPrewarm = kQ3False;
+	if ( (kQ3Success != Q3Object_GetProperty( mRendererObject,
+		kQ3RendererPropertyPrewarmShaders, sizeof(doPrewarm), nullptr, &doPrewarm )) ||
+		(doPrewarm == kQ3False) )
+	{
+		return;
+	}
+	Q3Object_RemoveProperty( mRendererObject, kQ3RendererPropertyPrewarmShaders );
+	
+	std::vector<ProgramCharacteristic>	manifest;
+	mBinaryCache.ReadManifest( manifest );
+	
+	int	createdCount = 0;
+	for (const ProgramCharacteristic& aCharacteristic : manifest)
+	{
+		InitVertexShader( aCharacteristic.mProjectionType );
+		
+		if ( (ProgCache()->VertexShaderID( aCharacteristic.mProjectionType ) != 0) &&
+			(ProgCache()->FindProgram( aCharacteristic ) == nullptr) )
+		{
+			InitProgram( aCharacteristic );
+			++createdCount;
+		}
+	}
+	Q3_MESSAGE_FMT("Pre-warmed %d of %d shader programs", createdCount,
+		(int) manifest.size() );
 }
 
 void	QORenderer::PerPixelLighting::CalcMaxLights()
@@ -1144,6 +1220,10 @@ void	QORenderer::PerPixelLighting::ChooseProgram()
 	if ( mMayNeedProgramChange &&
 		(ProgCache()->VertexShaderID( mProgramCharacteristic.mProjectionType ) != 0) )
 	{
+		// Cached geometry waiting for a multi-draw call uses the old program
+		// and uniform values.
+		mRenderer.FlushCachedVBORun();
+		
 		mMayNeedProgramChange = false;
 		/*Q3_MESSAGE_FMT("Shader illumination type: %c%c%c%c",
 			(char)(mProgramCharacteristic.mIlluminationType >> 24),
@@ -1157,7 +1237,7 @@ void	QORenderer::PerPixelLighting::ChooseProgram()
 		// If there is none, create it.
 		if (theProgram == nullptr)
 		{
-			InitProgram();
+			InitProgram( mProgramCharacteristic );
 			
 			theProgram = ProgCache()->FindProgram( mProgramCharacteristic );
 		}
@@ -1169,7 +1249,7 @@ void	QORenderer::PerPixelLighting::ChooseProgram()
 			{
 				mCurrentProgram = theProgram;
 				(void)glGetError();	// discard any previous unknown error
-				mFuncs.glUseProgram( theProgram->mProgram );
+				mRenderer.GetGLState().UseProgram( theProgram );
 				CHECK_GL_ERROR_MSG("glUseProgram");
 			#if Q3_DEBUG
 				std::string desc( DescribeProgram( *theProgram ) );
@@ -1191,37 +1271,37 @@ void	QORenderer::PerPixelLighting::ChooseProgram()
 			
 			// Even if we didn't change the program, we need to update some
 			// uniforms.
-			mFuncs.glUniform1i( theProgram->mIsSpecularMappingUniformLoc, mIsSpecularMapped );
-			mFuncs.glUniform1i( theProgram->mIsEmissiveMappingUniformLoc, mIsEmissiveMapped );
-			mFuncs.glUniform1i( theProgram->mIsFlippingNormalsUniformLoc, mIsFlippingNormals );
+			mRenderer.GetGLState().Uniform1i( theProgram->mIsSpecularMappingUniformLoc, mIsSpecularMapped );
+			mRenderer.GetGLState().Uniform1i( theProgram->mIsEmissiveMappingUniformLoc, mIsEmissiveMapped );
+			mRenderer.GetGLState().Uniform1i( theProgram->mIsFlippingNormalsUniformLoc, mIsFlippingNormals );
 			if (mProgramCharacteristic.mFogModeCombined != kFogModeOff)
 			{
-				mFuncs.glUniform1f( theProgram->mMaxFogOpacityUniformLoc, mMaxFogOpacity );
-				mFuncs.glUniform3fv( theProgram->mFogColorUniformLoc, 1, &mFogColor.r );
-				mFuncs.glUniform1f( theProgram->mFogDensityUniformLoc, mFogDensity );
+				mRenderer.GetGLState().Uniform1f( theProgram->mMaxFogOpacityUniformLoc, mMaxFogOpacity );
+				mRenderer.GetGLState().Uniform3fv( theProgram->mFogColorUniformLoc, 1, &mFogColor.r );
+				mRenderer.GetGLState().Uniform1f( theProgram->mFogDensityUniformLoc, mFogDensity );
 				if (mProgramCharacteristic.mFogModeCombined == kFogModeHalfspace)
 				{
-					mFuncs.glUniform1f( theProgram->mHalfspaceFogRateUniformLoc,
+					mRenderer.GetGLState().Uniform1f( theProgram->mHalfspaceFogRateUniformLoc,
 						mHalfspaceFogRate );
-					mFuncs.glUniform4f( theProgram->mHalfspaceFogPlaneUniformLoc,
+					mRenderer.GetGLState().Uniform4f( theProgram->mHalfspaceFogPlaneUniformLoc,
 						mHalfspaceFogPlane.x, mHalfspaceFogPlane.y,
 						mHalfspaceFogPlane.z, mHalfspaceFogPlane.w );
 				}
 				else if (mProgramCharacteristic.mFogModeCombined == kFogModeLinear)
 				{
-					mFuncs.glUniform1f( theProgram->mLinearFogEndUniformLoc, mLinearFogEnd );
-					mFuncs.glUniform1f( theProgram->mLinearFogScaleUniformLoc, mLinearFogScale );
+					mRenderer.GetGLState().Uniform1f( theProgram->mLinearFogEndUniformLoc, mLinearFogEnd );
+					mRenderer.GetGLState().Uniform1f( theProgram->mLinearFogScaleUniformLoc, mLinearFogScale );
 				}
 			}
 			
 			// Alpha threshold.
-			mFuncs.glUniform1f( theProgram->mAlphaThresholdUniformLoc, mAlphaThreshold );
+			mRenderer.GetGLState().Uniform1f( theProgram->mAlphaThresholdUniformLoc, mAlphaThreshold );
 			
 			// Line width
 			if (theProgram->mLineWidthUniformLoc != -1)
 			{
 				//Q3_MESSAGE_FMT("Setting line width uniform to %f", mRenderer.LineWidth() );
-				mFuncs.glUniform1f( theProgram->mLineWidthUniformLoc, mRenderer.LineWidth() );
+				mRenderer.GetGLState().Uniform1f( theProgram->mLineWidthUniformLoc, mRenderer.LineWidth() );
 			}
 			
 			// Culling, only needed with 2D geometries in line-fill mode
@@ -1229,8 +1309,8 @@ void	QORenderer::PerPixelLighting::ChooseProgram()
 			{
 				GLint cullBack =  (GLint)(mCullBackFaces? 1 : 0);
 				GLint cullFront = (GLint)(mCullFrontFaces? 1 : 0);
-				mFuncs.glUniform1i( theProgram->mCullFrontFacesUniformLoc, cullFront );
-				mFuncs.glUniform1i( theProgram->mCullBackFacesUniformLoc, cullBack );
+				mRenderer.GetGLState().Uniform1i( theProgram->mCullFrontFacesUniformLoc, cullFront );
+				mRenderer.GetGLState().Uniform1i( theProgram->mCullBackFacesUniformLoc, cullBack );
 				//Q3_MESSAGE_FMT("Culling back %d, front %d", cullBack, cullFront );
 			}
 		}
@@ -1244,16 +1324,16 @@ void	QORenderer::PerPixelLighting::ChooseProgram()
 void	QORenderer::PerPixelLighting::SetUniformValues()
 {
 	// Set texture units.
-	mFuncs.glUniform1i( mCurrentProgram->mTextureUnit0UniformLoc, 0 );
-	mFuncs.glUniform1i( mCurrentProgram->mTextureUnit1UniformLoc, 1 );
-	mFuncs.glUniform1i( mCurrentProgram->mTextureUnit2UniformLoc, 2 );
+	mRenderer.GetGLState().Uniform1i( mCurrentProgram->mTextureUnit0UniformLoc, 0 );
+	mRenderer.GetGLState().Uniform1i( mCurrentProgram->mTextureUnit1UniformLoc, 1 );
+	mRenderer.GetGLState().Uniform1i( mCurrentProgram->mTextureUnit2UniformLoc, 2 );
 
 	// Set the quantization uniform variables.
 	if (mCurrentProgram->mQuantizationUniformLoc != -1)
 	{
-		mFuncs.glUniform1f( mCurrentProgram->mQuantizationUniformLoc, mQuantization );
+		mRenderer.GetGLState().Uniform1f( mCurrentProgram->mQuantizationUniformLoc, mQuantization );
 		CHECK_GL_ERROR_MSG("glUniform1f mQuantization");
-		mFuncs.glUniform1f( mCurrentProgram->mLightNearEdgeUniformLoc, mLightNearEdge );
+		mRenderer.GetGLState().Uniform1f( mCurrentProgram->mLightNearEdgeUniformLoc, mLightNearEdge );
 		CHECK_GL_ERROR_MSG("glUniform1f mLightNearEdge");
 	}
 	
@@ -1261,50 +1341,50 @@ void	QORenderer::PerPixelLighting::SetUniformValues()
 	const int kNumLights = static_cast<int>(mLights.size());
 	if (kNumLights > 0)
 	{
-		mFuncs.glUniform1fv( mCurrentProgram->mSpotHotAngleUniformLoc, kNumLights,
+		mRenderer.GetGLState().Uniform1fv( mCurrentProgram->mSpotHotAngleUniformLoc, kNumLights,
 			&mSpotLightHotAngles[0] );
-		mFuncs.glUniform1fv( mCurrentProgram->mSpotCutoffAngleUniformLoc, kNumLights,
+		mRenderer.GetGLState().Uniform1fv( mCurrentProgram->mSpotCutoffAngleUniformLoc, kNumLights,
 			&mSpotLightCutoffAngles[0] );
 		
-		mFuncs.glUniform4fv( mCurrentProgram->mLightPositionUniformLoc, kNumLights,
+		mRenderer.GetGLState().Uniform4fv( mCurrentProgram->mLightPositionUniformLoc, kNumLights,
 			&mLightPositions[0].x );
-		mFuncs.glUniform4fv( mCurrentProgram->mLightColorUniformLoc, kNumLights,
+		mRenderer.GetGLState().Uniform4fv( mCurrentProgram->mLightColorUniformLoc, kNumLights,
 			&mLightColors[0].r );
-		mFuncs.glUniform3fv( mCurrentProgram->mSpotLightDirectionUniformLoc, kNumLights,
+		mRenderer.GetGLState().Uniform3fv( mCurrentProgram->mSpotLightDirectionUniformLoc, kNumLights,
 			&mSpotLightDirections[0].x );
-		mFuncs.glUniform3fv( mCurrentProgram->mLightAttenuationUniformLoc, kNumLights,
+		mRenderer.GetGLState().Uniform3fv( mCurrentProgram->mLightAttenuationUniformLoc, kNumLights,
 			&mLightAttenuations[0].x );
 	}
 	
 	// Ambient light.
-	mFuncs.glUniform3fv( mCurrentProgram->mAmbientLightUniformLoc, 1, &mAmbientLight.r );
+	mRenderer.GetGLState().Uniform3fv( mCurrentProgram->mAmbientLightUniformLoc, 1, &mAmbientLight.r );
 	
 	// Set layer shifting flag.
 	TQ3Boolean isShifting = kQ3True;
 	Q3Object_GetProperty( mRendererObject, kQ3RendererPropertyIsLayerShifting,
 		sizeof(TQ3Boolean), nullptr, &isShifting );
-	mFuncs.glUniform1i( mCurrentProgram->mIsLayerShiftingUniformLoc, isShifting );
+	mRenderer.GetGLState().Uniform1i( mCurrentProgram->mIsLayerShiftingUniformLoc, isShifting );
 	
 	// Set extra fog parameters.
-	mFuncs.glUniform1f( mCurrentProgram->mMaxFogOpacityUniformLoc, mMaxFogOpacity );
+	mRenderer.GetGLState().Uniform1f( mCurrentProgram->mMaxFogOpacityUniformLoc, mMaxFogOpacity );
 	
 	// Set transform matrices
-	mFuncs.glUniformMatrix4fv( mCurrentProgram->mModelViewMtxUniformLoc, 1, GL_FALSE, &mModelViewMtx.value[0][0] );
+	mRenderer.GetGLState().UniformMatrix4fv( mCurrentProgram->mModelViewMtxUniformLoc, 1, GL_FALSE, &mModelViewMtx.value[0][0] );
 	SetCameraUniforms();
-	mFuncs.glUniformMatrix4fv( mCurrentProgram->mTextureMtxUniformLoc, 1, GL_FALSE, &mTextureMtx.value[0][0] );
-	mFuncs.glUniformMatrix3fv( mCurrentProgram->mNormalMtxUniformLoc, 1, GL_FALSE, &mNormalMtx.value[0][0] );
+	mRenderer.GetGLState().UniformMatrix4fv( mCurrentProgram->mTextureMtxUniformLoc, 1, GL_FALSE, &mTextureMtx.value[0][0] );
+	mRenderer.GetGLState().UniformMatrix3fv( mCurrentProgram->mNormalMtxUniformLoc, 1, GL_FALSE, &mNormalMtx.value[0][0] );
 	
 	// Initialize specular and emissive color.
-	mFuncs.glUniform1f( mCurrentProgram->mShininessUniformLoc, 0.0f );
-	mFuncs.glUniform3fv( mCurrentProgram->mSpecularColorUniformLoc, 1, &kZeroVec.x );
-	mFuncs.glUniform3fv( mCurrentProgram->mEmissiveColorUniformLoc, 1, &kZeroVec.x );
-	mFuncs.glUniform1f( mCurrentProgram->mMetallicUniformLoc, 0.0f );
+	mRenderer.GetGLState().Uniform1f( mCurrentProgram->mShininessUniformLoc, 0.0f );
+	mRenderer.GetGLState().Uniform3fv( mCurrentProgram->mSpecularColorUniformLoc, 1, &kZeroVec.x );
+	mRenderer.GetGLState().Uniform3fv( mCurrentProgram->mEmissiveColorUniformLoc, 1, &kZeroVec.x );
+	mRenderer.GetGLState().Uniform1f( mCurrentProgram->mMetallicUniformLoc, 0.0f );
 	
 	if ( mCurrentProgram->mViewportSizeUniformLoc != -1 )
 	{
 		GLfloat port[4];
 		glGetFloatv( GL_VIEWPORT, port );
-		mFuncs.glUniform2fv( mCurrentProgram->mViewportSizeUniformLoc, 1, &port[2] );
+		mRenderer.GetGLState().Uniform2fv( mCurrentProgram->mViewportSizeUniformLoc, 1, &port[2] );
 		//Q3_MESSAGE_FMT("Viewport size set to %f %f", port[2], port[3] );
 	}
 }
@@ -1315,7 +1395,7 @@ void	QORenderer::PerPixelLighting::SetUniformValues()
 */
 void	QORenderer::PerPixelLighting::EndPass()
 {
-	mFuncs.glUseProgram( 0 );
+	mRenderer.GetGLState().UseProgram( nullptr );
 	mCurrentProgram = nullptr;
 }
 
@@ -1589,30 +1669,42 @@ static GLuint CreateAndCompileShader( GLenum inShaderType,
 }
 
 /*!
-	@function	InitVertexShader
-	@abstract	Set up the vertex shader, if it has not already
-				been done.
+	@function	BuildVertexShaderSource
+	@abstract	Build the source code of the vertex shader for a camera
+				projection type.
 */
-void	QORenderer::PerPixelLighting::InitVertexShader()
+static void BuildVertexShaderSource( QORenderer::ECameraProjectionType inProjection,
+									std::string& outSource )
 {
-	if (ProgCache()->VertexShaderID( mProgramCharacteristic.mProjectionType ) == 0)
+	outSource = kVertexShaderStart;
+	switch (inProjection)
 	{
-		std::string shaderSource( kVertexShaderStart );
-		switch (mProgramCharacteristic.mProjectionType)
-		{
-			case ECameraProjectionType::standardRectilinear:
-				shaderSource += kVertexShaderStandardProjection;
-				break;
-			
-			case ECameraProjectionType::allSeeingEquirectangular:
-				shaderSource += kVertexShaderAllSeeingProjection;
-				break;
+		case QORenderer::ECameraProjectionType::standardRectilinear:
+			outSource += kVertexShaderStandardProjection;
+			break;
+		
+		case QORenderer::ECameraProjectionType::allSeeingEquirectangular:
+			outSource += kVertexShaderAllSeeingProjection;
+			break;
 
-			case ECameraProjectionType::fisheye:
-				shaderSource += kVertexShaderFisheyeProjection;
-				break;
-		}
-		shaderSource += kVertexShaderEnd;
+		case QORenderer::ECameraProjectionType::fisheye:
+			outSource += kVertexShaderFisheyeProjection;
+			break;
+	}
+	outSource += kVertexShaderEnd;
+}
+
+/*!
+	@function	InitVertexShader
+	@abstract	Set up the vertex shader for a projection type, if it has not
+				already been done.
+*/
+void	QORenderer::PerPixelLighting::InitVertexShader( ECameraProjectionType inProjection )
+{
+	if (ProgCache()->VertexShaderID( inProjection ) == 0)
+	{
+		std::string shaderSource;
+		BuildVertexShaderSource( inProjection, shaderSource );
 		
 		GLuint vertexShader = CreateAndCompileShader( GL_VERTEX_SHADER,
 			shaderSource.c_str(), mFuncs );
@@ -1626,7 +1718,7 @@ void	QORenderer::PerPixelLighting::InitVertexShader()
 			++sVertexShaderCount;
 			//Q3_MESSAGE_FMT("Created vertex shader number %d, ID %d",
 			//	sVertexShaderCount, (int)vertexShader );
-			ProgCache()->SetVertexShaderID( mProgramCharacteristic.mProjectionType, vertexShader );
+			ProgCache()->SetVertexShaderID( inProjection, vertexShader );
 		}
 	}
 }
@@ -1634,45 +1726,44 @@ void	QORenderer::PerPixelLighting::InitVertexShader()
 /*!
 	@function	InitProgram
 	@abstract	Set up the main fragment shader and program.
+	@discussion	If a shader cache directory has been set, we first try to
+				load a saved binary of the program, and save the binary of
+				a program that we had to compile.
 */
-void	QORenderer::PerPixelLighting::InitProgram()
+void	QORenderer::PerPixelLighting::InitProgram( const ProgramCharacteristic& inCharacteristic )
 {
 	CHECK_GL_ERROR_MSG("InitProgram start");
 	ProgramRec	newProgram;
 	
-	newProgram.mCharacteristic = mProgramCharacteristic;
+	newProgram.mCharacteristic = inCharacteristic;
 	
-	// If processing lines, build the geometry shader
-	GLint geomShaderID = 0;
-	if ( (mProgramCharacteristic.mDimension == 1) &&
-		(mProgramCharacteristic.mFillStyle != kQ3FillStylePoints) )
+	// If processing lines, choose a geometry shader
+	const char* geomSource = nullptr;
+	if ( (inCharacteristic.mDimension == 1) &&
+		(inCharacteristic.mFillStyle != kQ3FillStylePoints) )
 	{
 		Q3_MESSAGE_FMT("Using fat line geometry shader");
-		geomShaderID = CreateAndCompileShader( GL_GEOMETRY_SHADER,
-			kLineGeomShader, mFuncs );
+		geomSource = kLineGeomShader;
 	}
-	else if ( (mProgramCharacteristic.mDimension == 2) &&
-		(mProgramCharacteristic.mFillStyle == kQ3FillStyleEdges) )
+	else if ( (inCharacteristic.mDimension == 2) &&
+		(inCharacteristic.mFillStyle == kQ3FillStyleEdges) )
 	{
 		Q3_MESSAGE_FMT("Using triangle edge geometry shader");
-		geomShaderID = CreateAndCompileShader( GL_GEOMETRY_SHADER,
-			kFaceEdgeGeomShader, mFuncs );
+		geomSource = kFaceEdgeGeomShader;
 	}
-	else if ( (mProgramCharacteristic.mDimension == 2) &&
-		(mProgramCharacteristic.mFillStyle == kQ3FillStyleFilled) &&
-		(mProgramCharacteristic.mProjectionType == ECameraProjectionType::allSeeingEquirectangular) )
+	else if ( (inCharacteristic.mDimension == 2) &&
+		(inCharacteristic.mFillStyle == kQ3FillStyleFilled) &&
+		(inCharacteristic.mProjectionType == ECameraProjectionType::allSeeingEquirectangular) )
 	{
 		Q3_MESSAGE_FMT("Using all-seeing geometry shader");
-		geomShaderID = CreateAndCompileShader( GL_GEOMETRY_SHADER,
-			kAllSeeingGeomShader, mFuncs );
+		geomSource = kAllSeeingGeomShader;
 	}
-	else if ( (mProgramCharacteristic.mDimension == 2) &&
-		(mProgramCharacteristic.mFillStyle == kQ3FillStyleFilled) &&
-		(mProgramCharacteristic.mProjectionType == ECameraProjectionType::fisheye) )
+	else if ( (inCharacteristic.mDimension == 2) &&
+		(inCharacteristic.mFillStyle == kQ3FillStyleFilled) &&
+		(inCharacteristic.mProjectionType == ECameraProjectionType::fisheye) )
 	{
 		Q3_MESSAGE_FMT("Using fisheye geometry shader");
-		geomShaderID = CreateAndCompileShader( GL_GEOMETRY_SHADER,
-			kFisheyeGeomShader, mFuncs );
+		geomSource = kFisheyeGeomShader;
 	}
 	else
 	{
@@ -1681,7 +1772,35 @@ void	QORenderer::PerPixelLighting::InitProgram()
 
 	// Build the source of the fragment shader
 	std::string	fragSource;
-	BuildFragmentShaderSource( newProgram.mCharacteristic, geomShaderID != 0, fragSource );
+	BuildFragmentShaderSource( newProgram.mCharacteristic, geomSource != nullptr, fragSource );
+	
+	// Look for a saved binary of the program
+	const bool	isUsingBinaryCache = mBinaryCache.IsEnabled();
+	uint64_t	binaryKey = 0;
+	if (isUsingBinaryCache)
+	{
+		std::string	vertSource;
+		BuildVertexShaderSource( inCharacteristic.mProjectionType, vertSource );
+		binaryKey = mBinaryCache.Key( vertSource, geomSource, fragSource );
+		
+		newProgram.mProgram = mBinaryCache.LoadProgram( binaryKey );
+		if (newProgram.mProgram != 0)
+		{
+			++sProgramCount;
+			InitUniformLocations( newProgram );
+			ProgCache()->AddProgram( newProgram );
+			mBinaryCache.RecordCharacteristic( inCharacteristic );
+			return;
+		}
+	}
+	
+	// Create the geometry shader, if any
+	GLint geomShaderID = 0;
+	if (geomSource != nullptr)
+	{
+		geomShaderID = CreateAndCompileShader( GL_GEOMETRY_SHADER,
+			geomSource, mFuncs );
+	}
 	
 	// Create the fragment shader
 	GLint fragShaderID = CreateAndCompileShader( GL_FRAGMENT_SHADER,
@@ -1722,6 +1841,13 @@ void	QORenderer::PerPixelLighting::InitProgram()
 			// a disabled array.
 			mFuncs.glBindAttribLocation(newProgram.mProgram, 0, "quesaVertex");
 			
+			// Ask that the linked binary be retrievable, so we can save it
+			if (isUsingBinaryCache)
+			{
+				mFuncs.glProgramParameteri( newProgram.mProgram,
+					GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE );
+			}
+			
 			// Link program
 			mFuncs.glLinkProgram( newProgram.mProgram );
 			CHECK_GL_ERROR;
@@ -1763,6 +1889,12 @@ void	QORenderer::PerPixelLighting::InitProgram()
 				InitUniformLocations( newProgram );
 			
 				ProgCache()->AddProgram( newProgram );
+				
+				if (isUsingBinaryCache)
+				{
+					mBinaryCache.SaveProgram( binaryKey, newProgram.mProgram );
+				}
+				mBinaryCache.RecordCharacteristic( inCharacteristic );
 			}
 			else
 			{
@@ -2117,6 +2249,7 @@ void	QORenderer::PerPixelLighting::PreGeomSubmit( TQ3GeometryObject inGeom,
 		}
 	}
 	
+	const TQ3RationalPoint4D oldClippingPlane( mClippingPlane );
 	TQ3Status hadProp = Q3Object_GetProperty( mRendererObject,
 		kQ3RendererPropertyClippingPlane, sizeof(TQ3RationalPoint4D), nullptr,
 		&mClippingPlane );
@@ -2138,13 +2271,17 @@ void	QORenderer::PerPixelLighting::PreGeomSubmit( TQ3GeometryObject inGeom,
 	
 	if (cartoonUpdate && (mCurrentProgram != nullptr))
 	{
-		mFuncs.glUniform1f( mCurrentProgram->mQuantizationUniformLoc,
+		mRenderer.GetGLState().Uniform1f( mCurrentProgram->mQuantizationUniformLoc,
 			mProgramCharacteristic.mIsCartoonish? mQuantization : 0.0f );
 	}
 	
 	if ( useClipPlane && (mCurrentProgram != nullptr) )
 	{
-		mFuncs.glUniform4f( mCurrentProgram->mClippingPlaneUniformLoc,
+		if (mClippingPlane != oldClippingPlane)
+		{
+			mRenderer.FlushCachedVBORun();
+		}
+		mRenderer.GetGLState().Uniform4f( mCurrentProgram->mClippingPlaneUniformLoc,
 			mClippingPlane.x, mClippingPlane.y,
 			mClippingPlane.z, mClippingPlane.w );
 	}
@@ -2199,8 +2336,8 @@ void	QORenderer::PerPixelLighting::SetModelViewMatrix( const TQ3Matrix4x4& inMtx
 	
 	if (mCurrentProgram != nullptr)
 	{
-		mFuncs.glUniformMatrix4fv( mCurrentProgram->mModelViewMtxUniformLoc, 1, GL_FALSE, &mModelViewMtx.value[0][0] );
-		mFuncs.glUniformMatrix3fv( mCurrentProgram->mNormalMtxUniformLoc, 1, GL_FALSE, &mNormalMtx.value[0][0] );
+		mRenderer.GetGLState().UniformMatrix4fv( mCurrentProgram->mModelViewMtxUniformLoc, 1, GL_FALSE, &mModelViewMtx.value[0][0] );
+		mRenderer.GetGLState().UniformMatrix3fv( mCurrentProgram->mNormalMtxUniformLoc, 1, GL_FALSE, &mNormalMtx.value[0][0] );
 	}
 }
 
@@ -2223,7 +2360,7 @@ void	QORenderer::PerPixelLighting::SetProjectionMatrix( const TQ3Matrix4x4& inMt
 
 void	QORenderer::PerPixelLighting::SetCameraUniforms()
 {
-	mFuncs.glUniformMatrix4fv( mCurrentProgram->mProjectionMtxUniformLoc, 1, GL_FALSE, &mProjectionMtx.value[0][0] );
+	mRenderer.GetGLState().UniformMatrix4fv( mCurrentProgram->mProjectionMtxUniformLoc, 1, GL_FALSE, &mProjectionMtx.value[0][0] );
 	
 	if (mView.get() != nullptr)
 	{
@@ -2236,7 +2373,7 @@ void	QORenderer::PerPixelLighting::SetCameraUniforms()
 			GLfloat range[] = {
 				camData.range.hither, camData.range.yon
 			};
-			mFuncs.glUniform2fv( mCurrentProgram->mCameraRangeUniformLoc, 1,
+			mRenderer.GetGLState().Uniform2fv( mCurrentProgram->mCameraRangeUniformLoc, 1,
 				range );
 		}
 		
@@ -2246,7 +2383,7 @@ void	QORenderer::PerPixelLighting::SetCameraUniforms()
 				camData.viewPort.origin.x, camData.viewPort.origin.y,
 				camData.viewPort.width, camData.viewPort.height
 			};
-			mFuncs.glUniform4fv( mCurrentProgram->mCameraViewportUniformLoc, 1,
+			mRenderer.GetGLState().Uniform4fv( mCurrentProgram->mCameraViewportUniformLoc, 1,
 				viewport );
 		}
 		
@@ -2254,20 +2391,20 @@ void	QORenderer::PerPixelLighting::SetCameraUniforms()
 		{
 			TQ3FisheyeCameraData fisheyeData;
 			Q3FisheyeCamera_GetData( (TQ3Object _Nonnull) theCamera.get(), &fisheyeData );
-			mFuncs.glUniform2fv( mCurrentProgram->mSensorSizeAttribLoc, 1,
+			mRenderer.GetGLState().Uniform2fv( mCurrentProgram->mSensorSizeAttribLoc, 1,
 				&fisheyeData.sensorSize.x );
 			CHECK_GL_ERROR;
-			mFuncs.glUniform1f( mCurrentProgram->mFocalLengthAttribLoc, fisheyeData.focalLength );
+			mRenderer.GetGLState().Uniform1f( mCurrentProgram->mFocalLengthAttribLoc, fisheyeData.focalLength );
 			CHECK_GL_ERROR;
 			float angleOfView = Q3FisheyeCamera_CalcAngleOfView(
 				&fisheyeData.sensorSize, fisheyeData.mappingFunction,
 				fisheyeData.croppingFormat, fisheyeData.focalLength );
-			mFuncs.glUniform1f( mCurrentProgram->mAngleOfViewAttribLoc, angleOfView );
+			mRenderer.GetGLState().Uniform1f( mCurrentProgram->mAngleOfViewAttribLoc, angleOfView );
 			CHECK_GL_ERROR;
 			GLint func = (GLint) fisheyeData.mappingFunction;
-			mFuncs.glUniform1i( mCurrentProgram->mFisheyeMappingFuncAttribLoc, func );
+			mRenderer.GetGLState().Uniform1i( mCurrentProgram->mFisheyeMappingFuncAttribLoc, func );
 			CHECK_GL_ERROR;
-			mFuncs.glUniform1i( mCurrentProgram->mFisheyeCroppingAttribLoc, (GLint)fisheyeData.croppingFormat );
+			mRenderer.GetGLState().Uniform1i( mCurrentProgram->mFisheyeCroppingAttribLoc, (GLint)fisheyeData.croppingFormat );
 		}
 	}
 }
@@ -2285,6 +2422,6 @@ void	QORenderer::PerPixelLighting::SetTextureMatrix( const TQ3Matrix4x4& inMtx )
 	
 	if (mCurrentProgram != nullptr)
 	{
-		mFuncs.glUniformMatrix4fv( mCurrentProgram->mTextureMtxUniformLoc, 1, GL_FALSE, &mTextureMtx.value[0][0] );
+		mRenderer.GetGLState().UniformMatrix4fv( mCurrentProgram->mTextureMtxUniformLoc, 1, GL_FALSE, &mTextureMtx.value[0][0] );
 	}
 }
@@ -55,6 +55,7 @@
 #include "QOPrefix.h"
 #include "QuesaStyle.h"
 #include "QOShaderProgramCache.h"
+#include "QOProgramBinaryCache.h"
 #include "CQ3WeakObjectRef.h"
 
 #include <vector>
@@ -78,6 +79,12 @@
 	#define		GL_INFO_LOG_LENGTH			0x8B84
 #endif
 
+#ifndef GL_PROGRAM_BINARY_LENGTH
+	#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT	0x8257
+	#define GL_PROGRAM_BINARY_LENGTH			0x8741
+	#define GL_NUM_PROGRAM_BINARY_FORMATS		0x87FE
+#endif
+
 
 namespace QORenderer
 {
@@ -165,6 +172,18 @@ typedef void (QO_PROCPTR_TYPE glVertexAttribPointerProc)(
 													GLsizei stride,
 													const GLvoid *pointer );
 typedef void (QO_PROCPTR_TYPE glBindAttribLocationProc)(GLuint program, GLuint index, const char* name);
+typedef void (QO_PROCPTR_TYPE glGetProgramBinaryProc)( GLuint program,
+													GLsizei bufSize,
+													GLsizei* outLength,
+													GLenum* outBinaryFormat,
+													void* outBinary );
+typedef void (QO_PROCPTR_TYPE glProgramBinaryProc)( GLuint program,
+													GLenum binaryFormat,
+													const void* binary,
+													GLsizei length );
+typedef void (QO_PROCPTR_TYPE glProgramParameteriProc)( GLuint program,
+													GLenum pname,
+													GLint value );
 
 
 /*!
@@ -216,6 +235,11 @@ struct GLSLFuncs
 	glVertexAttrib3fvProc			glVertexAttrib3fv;
 	glVertexAttribPointerProc		glVertexAttribPointer;
 	glBindAttribLocationProc		glBindAttribLocation;
+	
+	// Optional, used by the program binary cache
+	glGetProgramBinaryProc			glGetProgramBinary;
+	glProgramBinaryProc				glProgramBinary;
+	glProgramParameteriProc			glProgramParameteri;
 
 private:
 	void						SetNULL();
@@ -427,12 +451,34 @@ public:
 	*/
 	const ProgramRec*			CurrentProgram() const { return mCurrentProgram; }
 	
+	/*!
+		@function	IsSpecularMapped
+		@abstract	Tell whether a shininess (specular) map is in use.
+	*/
+	bool						IsSpecularMapped() const { return mIsSpecularMapped; }
+	
+	/*!
+		@function	IsEmissiveMapped
+		@abstract	Tell whether an emissive color map is in use.
+	*/
+	bool						IsEmissiveMapped() const { return mIsEmissiveMapped; }
+	
+	/*!
+		@function	IsUsingClippingPlane
+		@abstract	Tell whether the renderer's clipping plane was in effect
+					at the last call to PreGeomSubmit.
+	*/
+	bool						IsUsingClippingPlane() const
+									{ return mProgramCharacteristic.mIsUsingClippingPlane; }
+	
 	const GLSLFuncs&			Funcs() const { return mFuncs; }
 
 private:
 	void						CheckIfShading();
-	void						InitVertexShader();
-	void						InitProgram();
+	void						InitVertexShader( ECameraProjectionType inProjection );
+	void						InitProgram( const ProgramCharacteristic& inCharacteristic );
+	void						UpdateShaderCacheDirectory();
+	void						PrewarmPrograms();
 	void						InitUniformLocations( ProgramRec& ioProgram );
 	void						ChooseProgram();
 	void						GetLightTypes();
@@ -478,6 +524,7 @@ private:
 	float						mAlphaThreshold;
 
 	ProgramCharacteristic		mProgramCharacteristic;
+	ProgramBinaryCache			mBinaryCache;
 
 	ObVec						mLights;	// Quesa light objects
 	
@@ -0,0 +1,368 @@
+/*  NAME:
+        QOGLStateCache.cpp
+
+    DESCRIPTION:
+        Source for Quesa OpenGL renderer class.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "QOGLStateCache.h"
+#include "QORenderer.h"
+#include "QOShaderProgramCache.h"
+
+#include <cstring>
+
+
+
+//=============================================================================
+//      Local constants
+//-----------------------------------------------------------------------------
+namespace
+{
+	// Not a valid value of any of the enumerations we track
+	const GLenum	kUnknownEnum		= 0xFFFFFFFFU;
+	
+	const GLuint	kUnknownTexture		= 0xFFFFFFFFU;
+}
+
+
+
+//=============================================================================
+//     Class implementation
+//-----------------------------------------------------------------------------
+
+QORenderer::GLStateCache::GLStateCache( const GLSLFuncs& inSLFuncs,
+										const GLFuncs& inFuncs,
+										FrameCounts& ioCounts )
+	: mSLFuncs( inSLFuncs )
+	, mFuncs( inFuncs )
+	, mCounts( ioCounts )
+{
+	Invalidate();
+}
+
+void	QORenderer::GLStateCache::Invalidate()
+{
+	mCapabilities.clear();
+	mBlendSrcFactor = kUnknownEnum;
+	mBlendDstFactor = kUnknownEnum;
+	mDepthMask = -1;
+	mDepthFunc = kUnknownEnum;
+	mCullFace = kUnknownEnum;
+	mFrontFace = kUnknownEnum;
+	mActiveTexture = kUnknownEnum;
+	InvalidateTextures();
+	mIsProgramKnown = false;
+	mProgramName = 0;
+	mProgram = nullptr;
+}
+
+void	QORenderer::GLStateCache::InvalidateTextures()
+{
+	for (int i = 0; i < kNumTextureUnits; ++i)
+	{
+		mBoundTexture[i] = kUnknownTexture;
+	}
+}
+
+/*
+	Count
+	
+	Record a request as issued or elided, and return the argument.
+*/
+bool	QORenderer::GLStateCache::Count( bool inIsChange )
+{
+	if (inIsChange)
+	{
+		mCounts.mStateChanges += 1;
+	}
+	else
+	{
+		mCounts.mElidedStateChanges += 1;
+	}
+	return inIsChange;
+}
+
+void	QORenderer::GLStateCache::Enable( GLenum inCap, bool inEnable )
+{
+	std::map<GLenum, bool>::iterator found = mCapabilities.find( inCap );
+	
+	if (Count( (found == mCapabilities.end()) || (found->second != inEnable) ))
+	{
+		mCapabilities[ inCap ] = inEnable;
+		
+		if (inEnable)
+		{
+			glEnable( inCap );
+		}
+		else
+		{
+			glDisable( inCap );
+		}
+	}
+}
+
+void	QORenderer::GLStateCache::BlendFunc( GLenum inSrcFactor, GLenum inDstFactor )
+{
+	if (Count( (inSrcFactor != mBlendSrcFactor) || (inDstFactor != mBlendDstFactor) ))
+	{
+		mBlendSrcFactor = inSrcFactor;
+		mBlendDstFactor = inDstFactor;
+		glBlendFunc( inSrcFactor, inDstFactor );
+	}
+}
+
+void	QORenderer::GLStateCache::DepthMask( GLboolean inFlag )
+{
+	GLint	flag = (inFlag == GL_FALSE)? 0 : 1;
+	
+	if (Count( flag != mDepthMask ))
+	{
+		mDepthMask = flag;
+		glDepthMask( inFlag );
+	}
+}
+
+void	QORenderer::GLStateCache::DepthFunc( GLenum inFunc )
+{
+	if (Count( inFunc != mDepthFunc ))
+	{
+		mDepthFunc = inFunc;
+		glDepthFunc( inFunc );
+	}
+}
+
+void	QORenderer::GLStateCache::CullFace( GLenum inMode )
+{
+	if (Count( inMode != mCullFace ))
+	{
+		mCullFace = inMode;
+		glCullFace( inMode );
+	}
+}
+
+void	QORenderer::GLStateCache::FrontFace( GLenum inMode )
+{
+	if (Count( inMode != mFrontFace ))
+	{
+		mFrontFace = inMode;
+		glFrontFace( inMode );
+	}
+}
+
+void	QORenderer::GLStateCache::ActiveTexture( GLenum inUnit )
+{
+	if (Count( inUnit != mActiveTexture ))
+	{
+		mActiveTexture = inUnit;
+		(*mFuncs.glActiveTexture)( inUnit );
+	}
+}
+
+void	QORenderer::GLStateCache::BindTexture2D( GLuint inTexture )
+{
+	// If the active unit is unknown, this index will be out of range.
+	TQ3Uns32	unitIndex = mActiveTexture - GL_TEXTURE0_ARB;
+	
+	if (unitIndex < kNumTextureUnits)
+	{
+		if (Count( inTexture != mBoundTexture[ unitIndex ] ))
+		{
+			mBoundTexture[ unitIndex ] = inTexture;
+			glBindTexture( GL_TEXTURE_2D, inTexture );
+		}
+	}
+	else
+	{
+		Count( true );
+		glBindTexture( GL_TEXTURE_2D, inTexture );
+	}
+}
+
+void	QORenderer::GLStateCache::UseProgram( const ProgramRec* inProgram )
+{
+	GLuint	programName = (inProgram == nullptr)? 0 : inProgram->mProgram;
+	mProgram = inProgram;
+	
+	if (Count( (! mIsProgramKnown) || (programName != mProgramName) ))
+	{
+		mIsProgramKnown = true;
+		mProgramName = programName;
+		mSLFuncs.glUseProgram( programName );
+	}
+}
+
+/*
+	IsNewUniformValue
+	
+	Compare a uniform value with the one last given to the current program
+	at the same location, and remember the new value.  Values are compared
+	as raw 32-bit words, which suits both GLint and GLfloat data.
+*/
+bool	QORenderer::GLStateCache::IsNewUniformValue( GLint inLocation,
+													const void* inData,
+													TQ3Uns32 inWords )
+{
+	// OpenGL ignores a location of -1, so the call can always be dropped.
+	if (inLocation == -1)
+	{
+		return Count( false );
+	}
+	
+	if ( (mProgram == nullptr) || (inWords == 0) )
+	{
+		return Count( true );
+	}
+	
+	std::vector<TQ3Uns32>&	oldValue( mProgram->mUniformValues[ inLocation ] );
+	const size_t	kBytes = inWords * sizeof(TQ3Uns32);
+	
+	if ( (oldValue.size() == inWords) &&
+		(std::memcmp( oldValue.data(), inData, kBytes ) == 0) )
+	{
+		return Count( false );
+	}
+	
+	oldValue.resize( inWords );
+	std::memcpy( oldValue.data(), inData, kBytes );
+	return Count( true );
+}
+
+void	QORenderer::GLStateCache::Uniform1i( GLint inLocation, GLint inValue )
+{
+	if (IsNewUniformValue( inLocation, &inValue, 1 ))
+	{
+		mSLFuncs.glUniform1i( inLocation, inValue );
+	}
+}
+
+void	QORenderer::GLStateCache::Uniform1f( GLint inLocation, GLfloat inValue )
+{
+	if (IsNewUniformValue( inLocation, &inValue, 1 ))
+	{
+		mSLFuncs.glUniform1f( inLocation, inValue );
+	}
+}
+
+void	QORenderer::GLStateCache::Uniform4f( GLint inLocation, GLfloat inX,
+											GLfloat inY, GLfloat inZ, GLfloat inW )
+{
+	const GLfloat	theValue[4] = { inX, inY, inZ, inW };
+	
+	if (IsNewUniformValue( inLocation, theValue, 4 ))
+	{
+		mSLFuncs.glUniform4f( inLocation, inX, inY, inZ, inW );
+	}
+}
+
+void	QORenderer::GLStateCache::Uniform1fv( GLint inLocation, GLsizei inCount,
+											const GLfloat* inValues )
+{
+	if (IsNewUniformValue( inLocation, inValues, inCount ))
+	{
+		mSLFuncs.glUniform1fv( inLocation, inCount, inValues );
+	}
+}
+
+void	QORenderer::GLStateCache::Uniform2fv( GLint inLocation, GLsizei inCount,
+											const GLfloat* inValues )
+{
+	if (IsNewUniformValue( inLocation, inValues, 2 * inCount ))
+	{
+		mSLFuncs.glUniform2fv( inLocation, inCount, inValues );
+	}
+}
+
+void	QORenderer::GLStateCache::Uniform3fv( GLint inLocation, GLsizei inCount,
+											const GLfloat* inValues )
+{
+	if (IsNewUniformValue( inLocation, inValues, 3 * inCount ))
+	{
+		mSLFuncs.glUniform3fv( inLocation, inCount, inValues );
+	}
+}
+
+void	QORenderer::GLStateCache::Uniform4fv( GLint inLocation, GLsizei inCount,
+											const GLfloat* inValues )
+{
+	if (IsNewUniformValue( inLocation, inValues, 4 * inCount ))
+	{
+		mSLFuncs.glUniform4fv( inLocation, inCount, inValues );
+	}
+}
+
+void	QORenderer::GLStateCache::UniformMatrix3fv( GLint inLocation, GLsizei inCount,
+								GLboolean inTranspose, const GLfloat* inValues )
+{
+	// Transposed data would be remembered in the wrong order, so it is not
+	// remembered at all.
+	if (inTranspose != GL_FALSE)
+	{
+		if (mProgram != nullptr)
+		{
+			mProgram->mUniformValues.erase( inLocation );
+		}
+		Count( true );
+		mSLFuncs.glUniformMatrix3fv( inLocation, inCount, inTranspose, inValues );
+	}
+	else if (IsNewUniformValue( inLocation, inValues, 9 * inCount ))
+	{
+		mSLFuncs.glUniformMatrix3fv( inLocation, inCount, inTranspose, inValues );
+	}
+}
+
+void	QORenderer::GLStateCache::UniformMatrix4fv( GLint inLocation, GLsizei inCount,
+								GLboolean inTranspose, const GLfloat* inValues )
+{
+	if (inTranspose != GL_FALSE)
+	{
+		if (mProgram != nullptr)
+		{
+			mProgram->mUniformValues.erase( inLocation );
+		}
+		Count( true );
+		mSLFuncs.glUniformMatrix4fv( inLocation, inCount, inTranspose, inValues );
+	}
+	else if (IsNewUniformValue( inLocation, inValues, 16 * inCount ))
+	{
+		mSLFuncs.glUniformMatrix4fv( inLocation, inCount, inTranspose, inValues );
+	}
+}
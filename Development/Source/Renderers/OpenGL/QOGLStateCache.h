@@ -0,0 +1,185 @@
+/*!
+	@header		QOGLStateCache.h
+	
+	This is the header for the GLStateCache class of the Quesa OpenGL renderer.
+*/
+/*  NAME:
+        QOGLStateCache.h
+
+    DESCRIPTION:
+        Header for Quesa OpenGL renderer class.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+#ifndef QOGLSTATECACHE_HDR
+#define QOGLSTATECACHE_HDR
+
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "QOPrefix.h"
+
+#include <map>
+
+
+
+namespace QORenderer
+{
+//=============================================================================
+//      Types
+//-----------------------------------------------------------------------------
+struct GLSLFuncs;
+struct GLFuncs;
+struct ProgramRec;
+struct FrameCounts;
+
+
+/*!
+	@class		GLStateCache
+	
+	@abstract	Helper to set OpenGL server state, the current program, and
+				the values of program uniform variables.
+	
+	@discussion	This object remembers the state that it has set, so that a
+				request to set a value that is already in effect can be
+				dropped.  Each request is counted in the renderer's
+				FrameCounts as either issued or elided.
+				
+				Capabilities, blending, depth, culling and texture bindings
+				belong to one OpenGL context.  Since other code may change
+				them between passes, they are forgotten by Invalidate, which
+				the renderer calls at the start of each pass.  Uniform values
+				belong to the program object, so they are remembered in the
+				ProgramRec and persist as long as the program does.
+				
+				For this to work, any code that changes this state while the
+				renderer is drawing must go through this object.
+*/
+class GLStateCache
+{
+public:
+					GLStateCache( const GLSLFuncs& inSLFuncs,
+								const GLFuncs& inFuncs,
+								FrameCounts& ioCounts );
+	
+	/*!
+		@function	Invalidate
+		@abstract	Forget everything that is known about the state of the
+					OpenGL context, for instance after other code may have
+					changed it.
+	*/
+	void			Invalidate();
+	
+	/*!
+		@function	InvalidateTextures
+		@abstract	Forget which textures are bound, for instance after
+					textures have been created or deleted.
+	*/
+	void			InvalidateTextures();
+	
+	// Capabilities
+	void			Enable( GLenum inCap, bool inEnable = true );
+	void			Disable( GLenum inCap ) { Enable( inCap, false ); }
+	
+	// Fixed-function state
+	void			BlendFunc( GLenum inSrcFactor, GLenum inDstFactor );
+	void			DepthMask( GLboolean inFlag );
+	void			DepthFunc( GLenum inFunc );
+	void			CullFace( GLenum inMode );
+	void			FrontFace( GLenum inMode );
+	
+	// Textures.  Bindings are tracked for the first kNumTextureUnits units.
+	void			ActiveTexture( GLenum inUnit );
+	void			BindTexture2D( GLuint inTexture );
+	
+	/*!
+		@function	UseProgram
+		@abstract	Make a program current, or pass nullptr to use no
+					program.  The uniform setters below apply to this
+					program.
+	*/
+	void			UseProgram( const ProgramRec* inProgram );
+	
+	// Uniform variables of the current program
+	void			Uniform1i( GLint inLocation, GLint inValue );
+	void			Uniform1f( GLint inLocation, GLfloat inValue );
+	void			Uniform4f( GLint inLocation, GLfloat inX, GLfloat inY,
+								GLfloat inZ, GLfloat inW );
+	void			Uniform1fv( GLint inLocation, GLsizei inCount,
+								const GLfloat* inValues );
+	void			Uniform2fv( GLint inLocation, GLsizei inCount,
+								const GLfloat* inValues );
+	void			Uniform3fv( GLint inLocation, GLsizei inCount,
+								const GLfloat* inValues );
+	void			Uniform4fv( GLint inLocation, GLsizei inCount,
+								const GLfloat* inValues );
+	void			UniformMatrix3fv( GLint inLocation, GLsizei inCount,
+								GLboolean inTranspose, const GLfloat* inValues );
+	void			UniformMatrix4fv( GLint inLocation, GLsizei inCount,
+								GLboolean inTranspose, const GLfloat* inValues );
+
+private:
+	enum
+	{
+		kNumTextureUnits = 3
+	};
+
+	bool			IsNewUniformValue( GLint inLocation, const void* inData,
+										TQ3Uns32 inWords );
+	bool			Count( bool inIsChange );
+
+	const GLSLFuncs&			mSLFuncs;
+	const GLFuncs&				mFuncs;
+	FrameCounts&				mCounts;
+	
+	std::map<GLenum, bool>		mCapabilities;	// absent if unknown
+	GLenum						mBlendSrcFactor;
+	GLenum						mBlendDstFactor;
+	GLint						mDepthMask;		// -1 if unknown
+	GLenum						mDepthFunc;
+	GLenum						mCullFace;
+	GLenum						mFrontFace;
+	GLenum						mActiveTexture;
+	GLuint						mBoundTexture[ kNumTextureUnits ];
+	bool						mIsProgramKnown;
+	GLuint						mProgramName;
+	const ProgramRec*			mProgram;
+};
+
+}
+
+#endif
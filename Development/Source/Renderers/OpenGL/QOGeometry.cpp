@@ -196,6 +196,13 @@ namespace
 //      Local functions
 //-----------------------------------------------------------------------------
 
+static bool operator!=( const TQ3ColorRGB& inOne, const TQ3ColorRGB& inTwo )
+{
+	return fabsf( inOne.r - inTwo.r ) +
+		fabsf( inOne.g - inTwo.g ) +
+		fabsf( inOne.b - inTwo.b ) >= kQ3RealZero;
+}
+
 /*!
 	@function	CQ3AttributeSet_GetTextureShader
 	@abstract	Get a reference to a surface shader within an attribute set,
@@ -344,11 +351,12 @@ void	QORenderer::Renderer::SetEmissiveMaterial( const TQ3ColorRGB& inColor )
 		(inColor.g != mCurrentEmissiveColor.g) ||
 		(inColor.b != mCurrentEmissiveColor.b) )
 	{
+		FlushCachedVBORun();
 		mCurrentEmissiveColor = inColor;
 		
 		if (Shader().CurrentProgram() != nullptr)
 		{
-			SLFuncs().glUniform3fv( Shader().CurrentProgram()->mEmissiveColorUniformLoc, 1,
+			GetGLState().Uniform3fv( Shader().CurrentProgram()->mEmissiveColorUniformLoc, 1,
 				&mCurrentEmissiveColor.r );
 		}
 	}
@@ -360,11 +368,12 @@ void	QORenderer::Renderer::SetSpecularColor( const TQ3ColorRGB& inColor )
 		(inColor.g != mCurrentSpecularColor.g) ||
 		(inColor.b != mCurrentSpecularColor.b) )
 	{
+		FlushCachedVBORun();
 		mCurrentSpecularColor = inColor;
 		
 		if (Shader().CurrentProgram() != nullptr)
 		{
-			SLFuncs().glUniform3fv( Shader().CurrentProgram()->mSpecularColorUniformLoc, 1,
+			GetGLState().Uniform3fv( Shader().CurrentProgram()->mSpecularColorUniformLoc, 1,
 				&mCurrentSpecularColor.r );
 		}
 	}
@@ -374,12 +383,13 @@ void	QORenderer::Renderer::SetSpecularControl( float inSpecControl )
 {
 	if (inSpecControl != mCurrentSpecularControl)
 	{
+		FlushCachedVBORun();
 		mCurrentSpecularControl = inSpecControl;
 		
 		if (Shader().CurrentProgram() != nullptr)
 		{
 			GLfloat shininess = GLUtils_SpecularControlToGLShininess( mCurrentSpecularControl );
-			SLFuncs().glUniform1fv( Shader().CurrentProgram()->mShininessUniformLoc, 1,
+			GetGLState().Uniform1fv( Shader().CurrentProgram()->mShininessUniformLoc, 1,
 				&shininess );
 		}
 	}
@@ -389,11 +399,12 @@ void	QORenderer::Renderer::SetMetallic( float inMetallic )
 {
 	if (inMetallic != mCurrentMetallic)
 	{
+		FlushCachedVBORun();
 		mCurrentMetallic = inMetallic;
 		
 		if (Shader().CurrentProgram() != nullptr)
 		{
-			SLFuncs().glUniform1fv( Shader().CurrentProgram()->mMetallicUniformLoc, 1,
+			GetGLState().Uniform1fv( Shader().CurrentProgram()->mMetallicUniformLoc, 1,
 				&mCurrentMetallic );
 		}
 	}
@@ -409,14 +420,14 @@ void	QORenderer::Renderer::SetMetallic( float inMetallic )
 */
 void	QORenderer::Renderer::RefreshMaterials()
 {
-	SLFuncs().glUniform3fv( Shader().CurrentProgram()->mEmissiveColorUniformLoc, 1,
+	GetGLState().Uniform3fv( Shader().CurrentProgram()->mEmissiveColorUniformLoc, 1,
 		&mCurrentEmissiveColor.r );
 
-	SLFuncs().glUniform3fv( Shader().CurrentProgram()->mSpecularColorUniformLoc, 1,
+	GetGLState().Uniform3fv( Shader().CurrentProgram()->mSpecularColorUniformLoc, 1,
 		&mCurrentSpecularColor.r );
 	
 	GLfloat shininess = GLUtils_SpecularControlToGLShininess( mCurrentSpecularControl );
-	SLFuncs().glUniform1fv( Shader().CurrentProgram()->mShininessUniformLoc, 1,
+	GetGLState().Uniform1fv( Shader().CurrentProgram()->mShininessUniformLoc, 1,
 		&shininess );
 	
 	float refreshMetallic = mCurrentMetallic;
@@ -1166,73 +1177,61 @@ void	QORenderer::Renderer::RenderFastPathTriMesh(
 		
 	// If there is a texture, and illumination is not nullptr, use white as the
 	// underlying color.
+	const TQ3ColorRGB*	constantColor = nullptr;
 	if ( mTextures.IsTextureActive() &&
 		(mViewIllumination != kQ3IlluminationTypeNULL) &&
 		(inVertUVs != nullptr) )
 	{
-		mSLFuncs.glVertexAttrib3fv( Shader().CurrentProgram()->mColorAttribLoc, &kWhiteColor.r );
+		constantColor = &kWhiteColor;
 		inVertColors = nullptr;
 	}
 	
 	// If no vertex colors, set the color.
 	else if (inVertColors == nullptr)
 	{
-		mSLFuncs.glVertexAttrib3fv( Shader().CurrentProgram()->mColorAttribLoc, &mGeomState.diffuseColor->r );
+		constantColor = mGeomState.diffuseColor;
 	}
 	
-	// Enable/disable array states.
-	mGLClientStates.EnableNormalArray( inVertNormals != nullptr );
-	mGLClientStates.EnableTextureArray( inVertUVs != nullptr );
-	mGLClientStates.EnableColorArray( inVertColors != nullptr );
-	
-	if ( (inTriMesh != nullptr) &&
-		(inGeomData.numTriangles >= kMinTrianglesToCache) )
+	const bool isCaching = (inTriMesh != nullptr) &&
+		(inGeomData.numTriangles >= kMinTrianglesToCache);
+	CQ3ObjectRef nakedMesh;
+	bool hasLayers = false;
+	if (isCaching)
 	{
-		std::vector<TQ3Uns32>	triangleStrip;
-		CQ3ObjectRef nakedMesh( E3TriMesh_GetNakedGeometry( inTriMesh ) );
-		
+		nakedMesh = CQ3ObjectRef( E3TriMesh_GetNakedGeometry( inTriMesh ) );
 		TQ3Uns32 layerDataSize = 0;
-		TQ3Status hasLayers = Q3Object_GetProperty( (TQ3Object _Nonnull) nakedMesh.get(), kQ3GeometryPropertyLayerShifts,
-			0, &layerDataSize, nullptr );
-		mGLClientStates.EnableLayerShiftArray( hasLayers == kQ3Success );
+		hasLayers = (kQ3Success == Q3Object_GetProperty( (TQ3Object _Nonnull) nakedMesh.get(),
+			kQ3GeometryPropertyLayerShifts, 0, &layerDataSize, nullptr ));
+	}
+	
+	const TQ3Uns32 arrayMask = ((inVertNormals != nullptr)? 1 : 0) |
+		((inVertUVs != nullptr)? 2 : 0) | ((inVertColors != nullptr)? 4 : 0) |
+		(hasLayers? 8 : 0);
+	
+	// When opaque drawing is sorted, cached geometry is drawn at the end of
+	// the pass.
+	if ( isCaching && mOpaqueQueue.CanDefer() )
+	{
+		mOpaqueQueue.AddTriMesh( inTriMesh, nakedMesh, arrayMask, constantColor );
+		return;
+	}
+	
+	SetCachedVBOArrays( arrayMask, constantColor );
+	
+	if (isCaching)
+	{
+		// In edge fill style, the degenerate triangles created by
+		// MakeStrip draw bogus edges.
+		GLenum	mode = (mStyleState.mFill == kQ3FillStyleEdges)?
+			GL_TRIANGLES : GL_TRIANGLE_STRIP;
 		
+		if (kQ3False == RenderCachedVBO( *this, nakedMesh.get(), mode,
+			mCachedVBORun ))
 		{
-			// In edge fill style, the degenerate triangles created by
-			// MakeStrip draw bogus edges.
-			GLenum	mode = (mStyleState.mFill == kQ3FillStyleEdges)?
-				GL_TRIANGLES : GL_TRIANGLE_STRIP;
+			AddTriMeshToVBOCache( inTriMesh, nakedMesh.get(), inGeomData, mode,
+				inVertNormals, inVertUVs, inVertColors );
 			
-			if (kQ3False == RenderCachedVBO( *this, nakedMesh.get(), mode ))
-			{
-				if (mode == GL_TRIANGLE_STRIP)
-				{
-					GetCachedTriangleStrip( mRendererObject, inTriMesh,
-						inGeomData, triangleStrip );
-				}
-				
-				if (triangleStrip.empty())
-				{
-					Q3_CHECK_DRAW_ELEMENTS( inGeomData.numPoints,
-						3 * inGeomData.numTriangles,
-						inGeomData.triangles[0].pointIndices );
-					AddVBOToCache( *this, nakedMesh.get(), inGeomData.numPoints,
-						inGeomData.points, inVertNormals, inVertColors, inVertUVs,
-						GL_TRIANGLES, 3 * inGeomData.numTriangles,
-						inGeomData.triangles[0].pointIndices );
-				}
-				else
-				{
-					Q3_CHECK_DRAW_ELEMENTS( inGeomData.numPoints,
-						static_cast<TQ3Uns32>(triangleStrip.size()),
-						&triangleStrip[0] );
-					AddVBOToCache( *this, nakedMesh.get(), inGeomData.numPoints,
-						inGeomData.points, inVertNormals, inVertColors, inVertUVs,
-						GL_TRIANGLE_STRIP, static_cast<TQ3Uns32>(triangleStrip.size()),
-						&triangleStrip[0] );
-				}
-				
-				RenderCachedVBO( *this, nakedMesh.get(), mode );
-			}
+			RenderCachedVBO( *this, nakedMesh.get(), mode, mCachedVBORun );
 		}
 	}
 	else // small geometry or immediate mode, draw immediately
@@ -1245,6 +1244,134 @@ void	QORenderer::Renderer::RenderFastPathTriMesh(
 }
 
 
+/*!
+	@function	SetCachedVBOArrays
+	
+	@abstract	Set the constant color and enable the vertex arrays for
+				drawing a fast-path TriMesh.
+	
+	@discussion	Bits of inArrayMask stand for normals (1), UVs (2), colors (4)
+				and layer shifts (8).  Cached geometry waiting for a multi-draw
+				call was recorded with the current vertex arrays and constant
+				color, so it is drawn first if they change.
+*/
+void	QORenderer::Renderer::SetCachedVBOArrays(
+								TQ3Uns32 inArrayMask,
+								const TQ3ColorRGB* inConstantColor )
+{
+	if ( (! mCachedVBORun.IsEmpty()) &&
+		(
+			(inArrayMask != mCachedVBORun.mArrayMask) ||
+			( (inConstantColor != nullptr) &&
+				(*inConstantColor != mCachedVBORun.mConstantColor) )
+		) )
+	{
+		FlushCachedVBORun();
+	}
+	
+	mCachedVBORun.mArrayMask = inArrayMask;
+	if (inConstantColor != nullptr)
+	{
+		mCachedVBORun.mConstantColor = *inConstantColor;
+		
+		mSLFuncs.glVertexAttrib3fv( Shader().CurrentProgram()->mColorAttribLoc, &inConstantColor->r );
+	}
+	
+	// Enable/disable array states.
+	mGLClientStates.EnableNormalArray( (inArrayMask & 1) != 0 );
+	mGLClientStates.EnableTextureArray( (inArrayMask & 2) != 0 );
+	mGLClientStates.EnableColorArray( (inArrayMask & 4) != 0 );
+	mGLClientStates.EnableLayerShiftArray( (inArrayMask & 8) != 0 );
+}
+
+
+/*!
+	@function	AddTriMeshToVBOCache
+	
+	@abstract	Add a fast-path TriMesh to the VBO cache, after
+				RenderCachedVBO has failed to find it.
+*/
+void	QORenderer::Renderer::AddTriMeshToVBOCache(
+								TQ3GeometryObject inTriMesh,
+								TQ3GeometryObject inNakedMesh,
+								const TQ3TriMeshData& inGeomData,
+								GLenum inMode,
+								const TQ3Vector3D* inVertNormals,
+								const TQ3Param2D* inVertUVs,
+								const TQ3ColorRGB* inVertColors )
+{
+	std::vector<TQ3Uns32>	triangleStrip;
+	
+	if (inMode == GL_TRIANGLE_STRIP)
+	{
+		GetCachedTriangleStrip( mRendererObject, inTriMesh,
+			inGeomData, triangleStrip );
+	}
+	
+	// Adding to the cache may reuse or move the data of
+	// geometries waiting in the run.
+	FlushCachedVBORun();
+	
+	if (triangleStrip.empty())
+	{
+		Q3_CHECK_DRAW_ELEMENTS( inGeomData.numPoints,
+			3 * inGeomData.numTriangles,
+			inGeomData.triangles[0].pointIndices );
+		AddVBOToCache( *this, inNakedMesh, inGeomData.numPoints,
+			inGeomData.points, inVertNormals, inVertColors, inVertUVs,
+			GL_TRIANGLES, 3 * inGeomData.numTriangles,
+			inGeomData.triangles[0].pointIndices );
+	}
+	else
+	{
+		Q3_CHECK_DRAW_ELEMENTS( inGeomData.numPoints,
+			static_cast<TQ3Uns32>(triangleStrip.size()),
+			&triangleStrip[0] );
+		AddVBOToCache( *this, inNakedMesh, inGeomData.numPoints,
+			inGeomData.points, inVertNormals, inVertColors, inVertUVs,
+			GL_TRIANGLE_STRIP, static_cast<TQ3Uns32>(triangleStrip.size()),
+			&triangleStrip[0] );
+	}
+}
+
+
+/*!
+	@function	RenderQueuedTriMesh
+	
+	@abstract	Draw a TriMesh that was queued by OpaqueQueue, after the
+				queue has restored its state.
+	
+	@discussion	The VBO may have been purged to make room for other
+				geometry after the TriMesh was queued, in which case it is
+				added to the cache again.
+*/
+void	QORenderer::Renderer::RenderQueuedTriMesh(
+								TQ3GeometryObject inTriMesh,
+								TQ3GeometryObject inNakedMesh,
+								TQ3Uns32 inArrayMask,
+								const TQ3ColorRGB* inConstantColor )
+{
+	SetCachedVBOArrays( inArrayMask, inConstantColor );
+	
+	if (kQ3False == RenderCachedVBO( *this, inNakedMesh, GL_TRIANGLE_STRIP,
+		mCachedVBORun ))
+	{
+		CLockTriMeshData	locker;
+		const TQ3TriMeshData* geomData = locker.Lock( inTriMesh );
+		MeshArrays	dataArrays;
+		FindTriMeshData( *geomData, dataArrays );
+		
+		AddTriMeshToVBOCache( inTriMesh, inNakedMesh, *geomData,
+			GL_TRIANGLE_STRIP,
+			((inArrayMask & 1) != 0)? dataArrays.vertNormal : nullptr,
+			((inArrayMask & 2) != 0)? dataArrays.vertUV : nullptr,
+			((inArrayMask & 4) != 0)? dataArrays.vertColor : nullptr );
+		
+		RenderCachedVBO( *this, inNakedMesh, GL_TRIANGLE_STRIP, mCachedVBORun );
+	}
+}
+
+
 /*!
 	@function	FindExplicitEdgesOfFrontFaces
 	
@@ -1373,41 +1500,55 @@ void	QORenderer::Renderer::RenderExplicitEdges(
 	// array drawing.  We can only use per-vertex colors.  A vertex may have different colors
 	// as members of different edges, so we must create new arrays, treating each edge
 	// separately.
-	std::vector< TQ3Point3D > points( 2 * edgeCount );
-	std::vector< TQ3Vector3D > normals;
-	std::vector< TQ3ColorRGB > colors;
+	// These arrays only live for this submit, so they come from the view's
+	// frame scratch memory rather than the heap.
+	const TQ3Uns32 kNumEdgePoints = static_cast<TQ3Uns32>(2 * edgeCount);
+	TQ3Point3D* points = static_cast<TQ3Point3D*>( E3View_AllocateFrameScratch(
+		inView, kNumEdgePoints * sizeof(TQ3Point3D) ) );
+	TQ3Vector3D* normals = nullptr;
+	TQ3ColorRGB* colors = nullptr;
 	if (inVertNormals != nullptr)
 	{
-		normals.resize( 2 * edgeCount );
+		normals = static_cast<TQ3Vector3D*>( E3View_AllocateFrameScratch(
+			inView, kNumEdgePoints * sizeof(TQ3Vector3D) ) );
 	}
 	if ( (inVertColors != nullptr) || (inEdgeColors != nullptr) )
 	{
-		colors.resize( 2 * edgeCount );
+		colors = static_cast<TQ3ColorRGB*>( E3View_AllocateFrameScratch(
+			inView, kNumEdgePoints * sizeof(TQ3ColorRGB) ) );
+	}
+	if ( (points == nullptr) ||
+		((inVertNormals != nullptr) && (normals == nullptr)) ||
+		(((inVertColors != nullptr) || (inEdgeColors != nullptr)) && (colors == nullptr)) )
+	{
+		return;	// out of memory
 	}
 	TQ3Uns32 edgeIndex;
 	
 	if (mStyleState.mBackfacing == kQ3BackfacingStyleRemove)
 	{
+		// Note that the destination index is the position in the list of
+		// rendered edges, not the original edge index.
 		for (size_t i = 0; i < edgeCount; ++i)
 		{
 			edgeIndex = renderedEdgeIndices[i];
 
-			points[ 2 * edgeIndex ] = inGeomData.points[ inGeomData.edges[edgeIndex].pointIndices[ 0 ] ];
-			points[ 2 * edgeIndex + 1 ] = inGeomData.points[ inGeomData.edges[edgeIndex].pointIndices[ 1 ] ];
+			points[ 2 * i ] = inGeomData.points[ inGeomData.edges[edgeIndex].pointIndices[ 0 ] ];
+			points[ 2 * i + 1 ] = inGeomData.points[ inGeomData.edges[edgeIndex].pointIndices[ 1 ] ];
 			if (inVertNormals != nullptr)
 			{
-				normals[ 2 * edgeIndex ] = inVertNormals[ inGeomData.edges[edgeIndex].pointIndices[ 0 ] ];
-				normals[ 2 * edgeIndex + 1 ] = inVertNormals[ inGeomData.edges[edgeIndex].pointIndices[ 1 ] ];
+				normals[ 2 * i ] = inVertNormals[ inGeomData.edges[edgeIndex].pointIndices[ 0 ] ];
+				normals[ 2 * i + 1 ] = inVertNormals[ inGeomData.edges[edgeIndex].pointIndices[ 1 ] ];
 			}
 			if (inVertColors != nullptr)
 			{
-				colors[ 2 * edgeIndex ] = inVertColors[ inGeomData.edges[edgeIndex].pointIndices[ 0 ] ];
-				colors[ 2 * edgeIndex + 1 ] = inVertColors[ inGeomData.edges[edgeIndex].pointIndices[ 1 ] ];
+				colors[ 2 * i ] = inVertColors[ inGeomData.edges[edgeIndex].pointIndices[ 0 ] ];
+				colors[ 2 * i + 1 ] = inVertColors[ inGeomData.edges[edgeIndex].pointIndices[ 1 ] ];
 			}
 			else if (inEdgeColors != nullptr)
 			{
-				colors[ 2 * edgeIndex ] = inEdgeColors[ edgeIndex ];
-				colors[ 2 * edgeIndex + 1 ] = inEdgeColors[ edgeIndex ];
+				colors[ 2 * i ] = inEdgeColors[ edgeIndex ];
+				colors[ 2 * i + 1 ] = inEdgeColors[ edgeIndex ];
 			}
 		}
 	}
@@ -1440,9 +1581,8 @@ void	QORenderer::Renderer::RenderExplicitEdges(
 	mGLClientStates.EnableTextureArray( false );
 	mGLClientStates.EnableColorArray( (inVertColors != nullptr) || (inEdgeColors != nullptr) );
 	
-	RenderImmediateVBO( GL_LINES, *this, static_cast<TQ3Uns32>(2 * edgeCount),
-		&points[0], (inVertNormals != nullptr)? &normals[0] : nullptr,
-		(inVertColors != nullptr) || (inEdgeColors != nullptr)? &colors[0] : nullptr,
+	RenderImmediateVBO( GL_LINES, *this, kNumEdgePoints,
+		points, normals, colors,
 		nullptr, 0, nullptr );
 }
 
@@ -1844,14 +1984,11 @@ void	QORenderer::Renderer::SubmitPoint(
 	}
 	else
 	{
-		mGLClientStates.EnableNormalArray( (dstVertex.flags & kVertexHaveNormal) != 0 );
-		mGLClientStates.EnableColorArray( ((dstVertex.flags & kVertexHaveDiffuse) != 0) );
-		mGLClientStates.EnableTextureArray( false );
-
-		RenderImmediateVBO( GL_POINTS, *this, 1, &dstVertex.point,
-			((dstVertex.flags & kVertexHaveNormal) != 0)? &dstVertex.normal : nullptr,
-			((dstVertex.flags & kVertexHaveDiffuse) != 0)? &dstVertex.diffuseColor : nullptr,
-			nullptr, 0, nullptr );
+		// Points are not textured
+		dstVertex.flags &= ~kVertexHaveUV;
+		
+		// Batch the point with any similar points that precede it
+		mTriBuffer.AddPoint( dstVertex );
 	}
 	
 	mNumPrimitivesRenderedInFrame += 1;
@@ -1911,38 +2048,8 @@ void	QORenderer::Renderer::SubmitLine(
 	}
 	else
 	{
-		VertexFlags flagUnion = theVertices[0].flags | theVertices[1].flags;
-		TQ3Point3D points[2];
-		TQ3Vector3D normals[2];
-		TQ3Param2D uvs[2];
-		TQ3ColorRGB colors[2];
-		
-		for (i = 0; i < 2; ++i)
-		{
-			points[i] = theVertices[i].point;
-			if ( (flagUnion & kVertexHaveNormal) != 0 )
-			{
-				normals[i] = theVertices[i].normal;
-			}
-			if ( (flagUnion & kVertexHaveUV) != 0 )
-			{
-				uvs[i] = theVertices[i].uv;
-			}
-			if ( (flagUnion & kVertexHaveDiffuse) != 0 )
-			{
-				colors[i] = theVertices[i].diffuseColor;
-			}
-		}
-		
-		mGLClientStates.EnableNormalArray( (flagUnion & kVertexHaveNormal) != 0 );
-		mGLClientStates.EnableTextureArray( (flagUnion & kVertexHaveUV) != 0 );
-		mGLClientStates.EnableColorArray( (flagUnion & kVertexHaveDiffuse) != 0 );
-		
-		RenderImmediateVBO( GL_LINES, *this, 
-			2, points, ((flagUnion & kVertexHaveNormal) != 0)? normals : nullptr,
-			((flagUnion & kVertexHaveDiffuse) != 0)? colors : nullptr,
-			((flagUnion & kVertexHaveUV) != 0)? uvs : nullptr,
-			0, nullptr );
+		// Batch the line with any similar lines that precede it
+		mTriBuffer.AddLine( theVertices );
 	}
 	
 	mNumPrimitivesRenderedInFrame += 1;
@@ -2036,24 +2143,31 @@ void	QORenderer::Renderer::SubmitPolyLine(
 	// Notify per-pixel lighting
 	mPPLighting.PreGeomSubmit( inPolyLine, 1 );
 	
-	// Get the vertices
-	std::vector< Vertex >	theVertices( inGeomData->numVertices );
+	// Get the vertices, and set up working arrays for vertex attributes.
+	// These only live for this submit, so they come from the view's frame
+	// scratch memory rather than the heap.
+	GLuint maxIndices = 2 * (inGeomData->numVertices - 1);
+	Vertex* theVertices = static_cast<Vertex*>( E3View_AllocateFrameScratch(
+		inView, inGeomData->numVertices * sizeof(Vertex) ) );
+	TQ3Point3D* points = static_cast<TQ3Point3D*>( E3View_AllocateFrameScratch(
+		inView, maxIndices * sizeof(TQ3Point3D) ) );
+	TQ3Vector3D* normals = static_cast<TQ3Vector3D*>( E3View_AllocateFrameScratch(
+		inView, maxIndices * sizeof(TQ3Vector3D) ) );
+	TQ3Param2D* uvs = static_cast<TQ3Param2D*>( E3View_AllocateFrameScratch(
+		inView, maxIndices * sizeof(TQ3Param2D) ) );
+	TQ3ColorRGB* colors = static_cast<TQ3ColorRGB*>( E3View_AllocateFrameScratch(
+		inView, maxIndices * sizeof(TQ3ColorRGB) ) );
+	if ( (theVertices == nullptr) || (points == nullptr) || (normals == nullptr) ||
+		(uvs == nullptr) || (colors == nullptr) )
+	{
+		return;	// out of memory
+	}
 	TQ3Uns32 i;
 	for (i = 0; i < inGeomData->numVertices; ++i)
 	{
 		CalcVertexState( inGeomData->vertices[i], theVertices[i] );
 	}
-	
-	// Set up working arrays for vertex attributes
-	E3FastArray<TQ3Point3D>		points;
-	E3FastArray<TQ3Vector3D>	normals;
-	E3FastArray<TQ3Param2D>		uvs;
-	E3FastArray<TQ3ColorRGB>	colors;
-	GLuint maxIndices = 2 * (inGeomData->numVertices - 1);
-	points.reserve( maxIndices );
-	normals.reserve( maxIndices );
-	uvs.reserve( maxIndices );
-	colors.reserve( maxIndices );
+	TQ3Uns32 numPoints = 0;
 	
 	// Figure out which arrays we actually need for at least one point.
 	VertexFlags	flagUnion = 0;
@@ -2075,34 +2189,26 @@ void	QORenderer::Renderer::SubmitPolyLine(
 		{
 			for (int j = 0; j < 2; ++j)
 			{
-				points.push_back( theVertices[i+j].point );
-				if ( (flagUnion & kVertexHaveNormal) != 0 )
-				{
-					normals.push_back( theVertices[i+j].normal );
-				}
-				if ( (flagUnion & kVertexHaveUV) != 0 )
-				{
-					uvs.push_back( theVertices[i+j].uv );
-				}
-				if ( (flagUnion & kVertexHaveDiffuse) != 0 )
-				{
-					colors.push_back( theVertices[i+j].diffuseColor );
-				}
+				points[ numPoints ] = theVertices[i+j].point;
+				normals[ numPoints ] = theVertices[i+j].normal;
+				uvs[ numPoints ] = theVertices[i+j].uv;
+				colors[ numPoints ] = theVertices[i+j].diffuseColor;
+				++numPoints;
 			}
 		}
 	}
 	
 	// If we have some to render immediately, do it.
-	if (points.size() > 0)
+	if (numPoints > 0)
 	{
 		mGLClientStates.EnableNormalArray( (flagUnion & kVertexHaveNormal) != 0 );
 		mGLClientStates.EnableTextureArray( (flagUnion & kVertexHaveUV) != 0 );
 		mGLClientStates.EnableColorArray( (flagUnion & kVertexHaveDiffuse) != 0 );
 		
-		RenderImmediateVBO( GL_LINES, *this, points.size(), &points[0],
-			((flagUnion & kVertexHaveNormal) != 0)? &normals[0] : nullptr,
-			((flagUnion & kVertexHaveDiffuse) != 0)? &colors[0] : nullptr,
-			((flagUnion & kVertexHaveUV) != 0)? &uvs[0] : nullptr,
+		RenderImmediateVBO( GL_LINES, *this, numPoints, points,
+			((flagUnion & kVertexHaveNormal) != 0)? normals : nullptr,
+			((flagUnion & kVertexHaveDiffuse) != 0)? colors : nullptr,
+			((flagUnion & kVertexHaveUV) != 0)? uvs : nullptr,
 			0, nullptr );
 	}
 	
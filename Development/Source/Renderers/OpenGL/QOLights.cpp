@@ -447,7 +447,7 @@ void	QORenderer::Lights::Reset( bool inEnableLighting )
 	{
 		// This gets turned on in the shadow marking phase.  If we leave it
 		// on, it can cause blending artifacts in shadow lighting phases.
-		glDisable( GL_DEPTH_CLAMP_NV );
+		mRenderer.GetGLState().Disable( GL_DEPTH_CLAMP_NV );
 	}
 }
 
@@ -553,13 +553,13 @@ void	QORenderer::Lights::SetUpShadowMarkingPass( TQ3ViewObject inView,
 	
 	// This should help prevent problems if shadow-casting geometry is in
 	// front of the near plane.
-	glEnable( GL_DEPTH_CLAMP_NV );
+	mRenderer.GetGLState().Enable( GL_DEPTH_CLAMP_NV );
 
-	glDisable( GL_CULL_FACE );
+	mRenderer.GetGLState().Disable( GL_CULL_FACE );
 	
 	// This helps prevent z-fighting artifacts.
 	// It is unclear what are the best values to pass.
-	glEnable( GL_POLYGON_OFFSET_FILL );
+	mRenderer.GetGLState().Enable( GL_POLYGON_OFFSET_FILL );
 	glPolygonOffset( 1.0f, 1.0f );
 	
 	// do not write to color buffer or depth buffer, only stencil
@@ -572,7 +572,7 @@ void	QORenderer::Lights::SetUpShadowMarkingPass( TQ3ViewObject inView,
 	glClearStencil( 128 );
 	glClear( GL_STENCIL_BUFFER_BIT );
 	
-	glEnable( GL_STENCIL_TEST );
+	mRenderer.GetGLState().Enable( GL_STENCIL_TEST );
 	
 	GLenum	decrEnum = GL_DECR_WRAP_EXT;
 	GLenum	incrEnum = GL_INCR_WRAP_EXT;
@@ -591,7 +591,7 @@ void	QORenderer::Lights::SetUpShadowMarkingPass( TQ3ViewObject inView,
 	glStencilFunc( GL_ALWAYS, 0, ~0U );
 
 	E3View_State_SetStyleDepthCompare( inView, kQ3DepthCompareFuncLess );
-	glDisable( GL_BLEND );
+	mRenderer.GetGLState().Disable( GL_BLEND );
 
 	mIsAnotherPassNeeded = true;
 }
@@ -619,8 +619,8 @@ void	QORenderer::Lights::SetUpShadowLightingPass(TQ3ViewObject inView)
 	glStencilMask( 0 );
 
 	E3View_State_SetStyleDepthCompare( inView, kQ3DepthCompareFuncLessEqual );
-	glEnable( GL_BLEND );
-	glBlendFunc( GL_ONE, GL_ONE );
+	mRenderer.GetGLState().Enable( GL_BLEND );
+	mRenderer.GetGLState().BlendFunc( GL_ONE, GL_ONE );
 }
 
 
@@ -669,15 +669,15 @@ void	QORenderer::Lights::SetUpNonShadowLightingPass( TQ3ViewObject inView,
 
 	if (! mIsFirstPass)
 	{
-		glDepthMask( GL_FALSE );	// no writes to depth buffer
+		mRenderer.GetGLState().DepthMask( GL_FALSE );	// no writes to depth buffer
 		E3View_State_SetStyleDepthCompare( inView, kQ3DepthCompareFuncLessEqual );
-		glEnable( GL_BLEND );
-		glBlendFunc( GL_ONE, GL_ONE );
+		mRenderer.GetGLState().Enable( GL_BLEND );
+		mRenderer.GetGLState().BlendFunc( GL_ONE, GL_ONE );
 		
 		// I was seeing a problem where I had 9 identically configured
 		// spot lights, but the one rendered in the 2nd pass produced a
 		// fainter spot.  This seems to fix it.
-		glEnable( GL_POLYGON_OFFSET_FILL );
+		mRenderer.GetGLState().Enable( GL_POLYGON_OFFSET_FILL );
 		glPolygonOffset( -1.0f, -1.0f );
 	}
 }
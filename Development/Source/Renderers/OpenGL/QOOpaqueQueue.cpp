@@ -0,0 +1,547 @@
+/*  NAME:
+        QOOpaqueQueue.cpp
+
+    DESCRIPTION:
+        Source for Quesa OpenGL renderer class.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "QORenderer.h"
+#include "QOShaderProgramCache.h"
+#include "GLUtils.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+
+//=============================================================================
+//      Local constants
+//-----------------------------------------------------------------------------
+namespace
+{
+	const TQ3Uns32	kDefaultWriteSwitch		= kQ3WriteSwitchMaskDepth |
+												kQ3WriteSwitchMaskColor;
+	
+	const TQ3DepthRangeStyleData	kDefaultDepthRange	= { 0.0f, 1.0f };
+	
+	const TQ3ColorRGB		kBlackColor			= { 0.0f, 0.0f, 0.0f };
+}
+
+
+
+//=============================================================================
+//      Local functions
+//-----------------------------------------------------------------------------
+using namespace QORenderer;
+
+// Matrices are compared exactly, since a matrix that is merely close to the
+// one a geometry was submitted with could move it.
+static bool IsSameMatrix( const TQ3Matrix4x4& inA, const TQ3Matrix4x4& inB )
+{
+	return memcmp( &inA, &inB, sizeof(TQ3Matrix4x4) ) == 0;
+}
+
+static bool IsSameMatrix( const TQ3Matrix3x3& inA, const TQ3Matrix3x3& inB )
+{
+	return memcmp( &inA, &inB, sizeof(TQ3Matrix3x3) ) == 0;
+}
+
+static bool IsSameStyle( const PrimStyleState& inA, const PrimStyleState& inB )
+{
+	return
+		(inA.mFillStyle == inB.mFillStyle) &&
+		(inA.mBackfacingStyle == inB.mBackfacingStyle) &&
+		(inA.mOrientationStyle == inB.mOrientationStyle) &&
+		(inA.mInterpolationStyle == inB.mInterpolationStyle) &&
+		(inA.mDepthCompareStyle == inB.mDepthCompareStyle) &&
+		(inA.mIlluminationType == inB.mIlluminationType) &&
+		(inA.mFogStyleIndex == inB.mFogStyleIndex) &&
+		(inA.mLineWidthStyle == inB.mLineWidthStyle);
+}
+
+static bool IsDefaultDepthRange( const TQ3DepthRangeStyleData& inRange )
+{
+	return (inRange.near == kDefaultDepthRange.near) &&
+		(inRange.far == kDefaultDepthRange.far);
+}
+
+static int CompareColors( const TQ3ColorRGB& inA, const TQ3ColorRGB& inB )
+{
+	int result = 0;
+	if (inA.r != inB.r)
+	{
+		result = (inA.r < inB.r)? -1 : 1;
+	}
+	else if (inA.g != inB.g)
+	{
+		result = (inA.g < inB.g)? -1 : 1;
+	}
+	else if (inA.b != inB.b)
+	{
+		result = (inA.b < inB.b)? -1 : 1;
+	}
+	return result;
+}
+
+/*!
+	@function	IsMaterialLess
+	@abstract	Order geometries by the material uniforms that they set.
+*/
+static bool IsMaterialLess( const QueuedTriMesh& inA, const QueuedTriMesh& inB )
+{
+	int result = CompareColors( inA.mSpecularColor, inB.mSpecularColor );
+	if (result == 0)
+	{
+		if (inA.mSpecularControl != inB.mSpecularControl)
+		{
+			result = (inA.mSpecularControl < inB.mSpecularControl)? -1 : 1;
+		}
+		else if (inA.mMetallic != inB.mMetallic)
+		{
+			result = (inA.mMetallic < inB.mMetallic)? -1 : 1;
+		}
+		else
+		{
+			result = CompareColors( inA.mEmissiveColor, inB.mEmissiveColor );
+		}
+	}
+	return result < 0;
+}
+
+namespace
+{
+	/*!
+		@struct		DrawOrder
+		@abstract	Comparator that sorts queue indices by the state that
+					is most expensive to change: program first, then
+					styles, texture, and material.  Geometries that tie
+					keep their submission order.
+	*/
+	struct DrawOrder
+	{
+						DrawOrder( const std::vector<QueuedTriMesh>& inQueue )
+							: mQueue( inQueue ) {}
+		
+		bool			operator()( TQ3Uns32 inA, TQ3Uns32 inB ) const
+						{
+							const QueuedTriMesh& a( mQueue[ inA ] );
+							const QueuedTriMesh& b( mQueue[ inB ] );
+							
+							if (a.mProgram != b.mProgram)
+							{
+								return a.mProgram < b.mProgram;
+							}
+							if (a.mStyleIndex != b.mStyleIndex)
+							{
+								return a.mStyleIndex < b.mStyleIndex;
+							}
+							if (a.mTextureName != b.mTextureName)
+							{
+								return a.mTextureName < b.mTextureName;
+							}
+							return IsMaterialLess( a, b );
+						}
+		
+		const std::vector<QueuedTriMesh>&	mQueue;
+	};
+}
+
+
+
+//=============================================================================
+//     Class implementation
+//-----------------------------------------------------------------------------
+
+OpaqueQueue::OpaqueQueue(
+							Renderer& inRenderer,
+							PerPixelLighting& inPPLighting )
+	: mRenderer( inRenderer )
+	, mPerPixelLighting( inPPLighting )
+	, mIsEnabled( false )
+{
+}
+
+void	OpaqueQueue::Clear()
+{
+	mQueue.clear();
+	mOrder.clear();
+	mStyles.clear();
+	mLocalToCameraMatrices.clear();
+	mCameraToFrustumMatrices.clear();
+	mUVTransforms.clear();
+}
+
+void	OpaqueQueue::StartPass()
+{
+	Clear();
+	
+	TQ3Boolean	isSorting = kQ3False;
+	Q3Object_GetProperty( mRenderer.GetQuesaRenderer(),
+		kQ3RendererPropertySortOpaqueDraws, sizeof(isSorting), nullptr,
+		&isSorting );
+	mIsEnabled = (isSorting == kQ3True);
+}
+
+bool	OpaqueQueue::CanDefer() const
+{
+	if ( (! mIsEnabled) || mRenderer.mLights.IsShadowFrame() )
+	{
+		return false;
+	}
+	
+	const StyleState& styles( mRenderer.mStyleState );
+	const Texture::TextureState&	textureState(
+		mRenderer.mTextures.GetTextureState() );
+	
+	// Only the Less and LessEqual depth tests give the same image whatever
+	// order the geometries are drawn in.
+	return (styles.mFill == kQ3FillStyleFilled) &&
+		( (styles.mDepthCompare == kQ3DepthCompareFuncLess) ||
+		(styles.mDepthCompare == kQ3DepthCompareFuncLessEqual) ) &&
+		(styles.mWriteSwitch == kDefaultWriteSwitch) &&
+		IsDefaultDepthRange( styles.mDepthRange ) &&
+		(! (textureState.mIsTextureActive && textureState.mIsTextureAlphaTest)) &&
+		(! mPerPixelLighting.IsSpecularMapped()) &&
+		(! mPerPixelLighting.IsEmissiveMapped()) &&
+		(! mPerPixelLighting.IsUsingClippingPlane());
+}
+
+void	OpaqueQueue::AddTriMesh(
+								TQ3GeometryObject inTriMesh,
+								const CQ3ObjectRef& inNakedMesh,
+								TQ3Uns32 inArrayMask,
+								const TQ3ColorRGB* inConstantColor )
+{
+	QueuedTriMesh	theMesh;
+	theMesh.mGeometry = CQ3ObjectRef( Q3Shared_GetReference( inTriMesh ) );
+	theMesh.mNakedGeometry = inNakedMesh;
+	theMesh.mArrayMask = inArrayMask;
+	theMesh.mHasConstantColor = (inConstantColor != nullptr);
+	theMesh.mConstantColor = (inConstantColor != nullptr)?
+		*inConstantColor : kBlackColor;
+	
+	// Record matrices.  Geometries submitted under the same transform share
+	// an entry.
+	const TQ3Matrix4x4& localToCamera( mRenderer.mMatrixState.GetLocalToCamera() );
+	if ( mLocalToCameraMatrices.empty() ||
+		(! IsSameMatrix( mLocalToCameraMatrices.back(), localToCamera )) )
+	{
+		mLocalToCameraMatrices.push_back( localToCamera );
+	}
+	theMesh.mLocalToCameraIndex = static_cast<TQ3Uns32>(mLocalToCameraMatrices.size() - 1);
+	
+	const TQ3Matrix4x4& cameraToFrustum( mRenderer.mMatrixState.GetCameraToFrustum() );
+	if ( mCameraToFrustumMatrices.empty() ||
+		(! IsSameMatrix( mCameraToFrustumMatrices.back(), cameraToFrustum )) )
+	{
+		mCameraToFrustumMatrices.push_back( cameraToFrustum );
+	}
+	theMesh.mCameraToFrustumIndex = static_cast<TQ3Uns32>(mCameraToFrustumMatrices.size() - 1);
+	
+	// Record some style state.
+	PrimStyleState style;
+	style.mFillStyle = mRenderer.mStyleState.mFill;
+	style.mOrientationStyle = mRenderer.mStyleState.mOrientation;
+	style.mBackfacingStyle = mRenderer.mStyleState.mBackfacing;
+	style.mInterpolationStyle = mRenderer.mStyleState.mInterpolation;
+	style.mDepthCompareStyle = mRenderer.mStyleState.mDepthCompare;
+	style.mIlluminationType = mRenderer.mViewIllumination;
+	style.mFogStyleIndex = mRenderer.mStyleState.mCurFogStyleIndex;
+	style.mLineWidthStyle = mRenderer.mLineWidth;
+	std::vector<PrimStyleState>::iterator foundStyle = std::find_if(
+		mStyles.begin(), mStyles.end(),
+		[&style]( const PrimStyleState& inStyle ) { return IsSameStyle( style, inStyle ); } );
+	if (foundStyle == mStyles.end())
+	{
+		mStyles.push_back( style );
+		foundStyle = mStyles.end() - 1;
+	}
+	theMesh.mStyleIndex = static_cast<TQ3Uns32>(foundStyle - mStyles.begin());
+	
+	// Record the program chosen by PreGeomSubmit, which is the main sort key.
+	const ProgramRec* theProgram = mPerPixelLighting.CurrentProgram();
+	theMesh.mProgram = (theProgram == nullptr)? 0 : theProgram->mProgram;
+	
+	// Record texture state
+	const Texture::TextureState&	textureState(
+		mRenderer.mTextures.GetTextureState() );
+	if (! textureState.mIsTextureActive)
+	{
+		theMesh.mTextureName = 0;
+		theMesh.mShaderUBoundary = kQ3ShaderUVBoundaryWrap;
+		theMesh.mShaderVBoundary = kQ3ShaderUVBoundaryWrap;
+		theMesh.mUVTransformIndex = 0;
+	}
+	else
+	{
+		theMesh.mTextureName = textureState.mGLTextureObject;
+		theMesh.mShaderUBoundary = textureState.mShaderUBoundary;
+		theMesh.mShaderVBoundary = textureState.mShaderVBoundary;
+		if ( mUVTransforms.empty() ||
+			(! IsSameMatrix( textureState.mUVTransform, mUVTransforms.back() ) ) )
+		{
+			mUVTransforms.push_back( textureState.mUVTransform );
+		}
+		theMesh.mUVTransformIndex = static_cast<TQ3Uns32>(mUVTransforms.size() - 1);
+	}
+	
+	// Record the material uniforms as they were last set
+	theMesh.mSpecularColor = mRenderer.mCurrentSpecularColor;
+	theMesh.mSpecularControl = mRenderer.mCurrentSpecularControl;
+	theMesh.mMetallic = mRenderer.mCurrentMetallic;
+	theMesh.mEmissiveColor = mRenderer.mCurrentEmissiveColor;
+	
+	mQueue.push_back( theMesh );
+}
+
+void	OpaqueQueue::SortQueue()
+{
+	mOrder.resize( mQueue.size() );
+	for (TQ3Uns32 i = 0; i < mOrder.size(); ++i)
+	{
+		mOrder[i] = i;
+	}
+	
+	std::stable_sort( mOrder.begin(), mOrder.end(), DrawOrder( mQueue ) );
+}
+
+void	OpaqueQueue::InitGLState()
+{
+	mCurLocalToCameraIndex = UINT32_MAX;
+	mCurCameraToFrustumIndex = UINT32_MAX;
+	mCurTexture = UINT32_MAX;	// force initial update
+	mCurUVTransformIndex = UINT32_MAX;
+	mCurUBoundary = kQ3ShaderUVBoundarySize32;
+	mCurVBoundary = kQ3ShaderUVBoundarySize32;
+	
+	// Queued geometry was submitted with the default write switch and depth
+	// range, without specular or emissive maps, and with no alpha test.
+	// Put those back in effect, remembering what to restore afterward.
+	mSavedWriteSwitch = mRenderer.mStyleState.mWriteSwitch;
+	if (mSavedWriteSwitch != kDefaultWriteSwitch)
+	{
+		mRenderer.UpdateWriteSwitchStyle( kDefaultWriteSwitch );
+	}
+	
+	mSavedDepthRange = mRenderer.mStyleState.mDepthRange;
+	if (! IsDefaultDepthRange( mSavedDepthRange ))
+	{
+		mRenderer.UpdateDepthRangeStyle( kDefaultDepthRange );
+	}
+	
+	mSavedSpecularMapping = mPerPixelLighting.IsSpecularMapped();
+	mPerPixelLighting.UpdateSpecularMapping( false );
+	mSavedEmissiveMapping = mPerPixelLighting.IsEmissiveMapped();
+	mPerPixelLighting.UpdateEmissiveMapping( false );
+	
+	mPerPixelLighting.SetAlphaThreshold( 0.0f );
+	
+	if (mRenderer.mStyleState.mFill != kQ3FillStyleFilled)
+	{
+		TQ3FillStyle	theFillStyle = kQ3FillStyleFilled;
+		mRenderer.UpdateFillStyle( &theFillStyle );
+	}
+}
+
+void	OpaqueQueue::RestoreGLState()
+{
+	if (mSavedWriteSwitch != kDefaultWriteSwitch)
+	{
+		mRenderer.UpdateWriteSwitchStyle( mSavedWriteSwitch );
+	}
+	
+	if (! IsDefaultDepthRange( mSavedDepthRange ))
+	{
+		mRenderer.UpdateDepthRangeStyle( mSavedDepthRange );
+	}
+	
+	mPerPixelLighting.UpdateSpecularMapping( mSavedSpecularMapping );
+	mPerPixelLighting.UpdateEmissiveMapping( mSavedEmissiveMapping );
+}
+
+void	OpaqueQueue::UpdateMatrices(
+								TQ3ViewObject inView,
+								const QueuedTriMesh& inMesh )
+{
+	if (inMesh.mCameraToFrustumIndex != mCurCameraToFrustumIndex)
+	{
+		mCurCameraToFrustumIndex = inMesh.mCameraToFrustumIndex;
+		mRenderer.UpdateCameraToFrustum( inView,
+			mCameraToFrustumMatrices[ mCurCameraToFrustumIndex ] );
+	}
+	
+	if (inMesh.mLocalToCameraIndex != mCurLocalToCameraIndex)
+	{
+		mCurLocalToCameraIndex = inMesh.mLocalToCameraIndex;
+		mRenderer.UpdateLocalToCamera( inView,
+			mLocalToCameraMatrices[ mCurLocalToCameraIndex ] );
+	}
+}
+
+void	OpaqueQueue::UpdateStyles(
+								TQ3ViewObject inView,
+								const QueuedTriMesh& inMesh )
+{
+	const PrimStyleState& style( mStyles[ inMesh.mStyleIndex ] );
+	StyleState& current( mRenderer.mStyleState );
+	
+	if (style.mOrientationStyle != current.mOrientation)
+	{
+		mRenderer.UpdateOrientationStyle( &style.mOrientationStyle );
+	}
+	
+	if (style.mBackfacingStyle != current.mBackfacing)
+	{
+		mRenderer.UpdateBackfacingStyle( &style.mBackfacingStyle );
+	}
+	
+	if (style.mInterpolationStyle != current.mInterpolation)
+	{
+		mRenderer.UpdateInterpolationStyle( &style.mInterpolationStyle );
+	}
+	
+	if (style.mDepthCompareStyle != current.mDepthCompare)
+	{
+		mRenderer.UpdateDepthCompareStyle( style.mDepthCompareStyle );
+	}
+	
+	if (style.mFogStyleIndex != current.mCurFogStyleIndex)
+	{
+		mRenderer.UpdateFogStyle( inView,
+			&current.mFogStyles[ style.mFogStyleIndex ] );
+	}
+	
+	mRenderer.mLights.SetLowDimensionalMode( false, style.mIlluminationType );
+	mPerPixelLighting.UpdateIllumination( style.mIlluminationType );
+}
+
+void	OpaqueQueue::UpdateTexture( const QueuedTriMesh& inMesh )
+{
+	if (inMesh.mTextureName != mCurTexture)
+	{
+		mCurTexture = inMesh.mTextureName;
+		
+		if (mCurTexture != 0)
+		{
+			mRenderer.GetGLState().BindTexture2D( mCurTexture );
+		}
+		
+		mPerPixelLighting.UpdateTexture( mCurTexture != 0 );
+	}
+	
+	if (mCurTexture == 0)
+	{
+		return;
+	}
+	
+	if (inMesh.mUVTransformIndex != mCurUVTransformIndex)
+	{
+		mCurUVTransformIndex = inMesh.mUVTransformIndex;
+		GLUtils_LoadShaderUVTransform( &mUVTransforms[ mCurUVTransformIndex ],
+			mPerPixelLighting );
+	}
+	
+	if (inMesh.mShaderUBoundary != mCurUBoundary)
+	{
+		mCurUBoundary = inMesh.mShaderUBoundary;
+		GLint	uBoundary;
+		GLUtils_ConvertUVBoundary( mCurUBoundary, &uBoundary );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, uBoundary );
+	}
+	
+	if (inMesh.mShaderVBoundary != mCurVBoundary)
+	{
+		mCurVBoundary = inMesh.mShaderVBoundary;
+		GLint	vBoundary;
+		GLUtils_ConvertUVBoundary( mCurVBoundary, &vBoundary );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, vBoundary );
+	}
+}
+
+void	OpaqueQueue::UpdateMaterials( const QueuedTriMesh& inMesh )
+{
+	// These only send uniforms when the value changes.
+	mRenderer.SetSpecularColor( inMesh.mSpecularColor );
+	mRenderer.SetSpecularControl( inMesh.mSpecularControl );
+	mRenderer.SetMetallic( inMesh.mMetallic );
+	mRenderer.SetEmissiveMaterial( inMesh.mEmissiveColor );
+}
+
+void	OpaqueQueue::DrawTriMesh(
+								TQ3ViewObject inView,
+								const QueuedTriMesh& inMesh )
+{
+	UpdateMatrices( inView, inMesh );
+	UpdateStyles( inView, inMesh );
+	UpdateTexture( inMesh );
+	
+	mPerPixelLighting.PreGeomSubmit( inMesh.mGeometry.get(), 2 );
+	
+	UpdateMaterials( inMesh );
+	
+	mRenderer.RenderQueuedTriMesh( inMesh.mGeometry.get(),
+		inMesh.mNakedGeometry.get(), inMesh.mArrayMask,
+		inMesh.mHasConstantColor? &inMesh.mConstantColor : nullptr );
+}
+
+void	OpaqueQueue::Flush( TQ3ViewObject inView )
+{
+	if (mQueue.empty())
+	{
+		return;
+	}
+	
+	SortQueue();
+	
+	InitGLState();
+	
+	for (TQ3Uns32 index : mOrder)
+	{
+		DrawTriMesh( inView, mQueue[ index ] );
+	}
+	
+	mRenderer.FlushCachedVBORun();
+	
+	RestoreGLState();
+	
+	Clear();
+}
@@ -0,0 +1,214 @@
+/*!
+	@header		QOOpaqueQueue.h
+	
+	Class to defer and sort opaque cached geometry for the Quesa OpenGL
+	renderer.
+*/
+/*  NAME:
+        QOOpaqueQueue.h
+
+    DESCRIPTION:
+        Header for Quesa OpenGL renderer class.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+#ifndef QOOPAQUEQUEUE_HDR
+#define QOOPAQUEQUEUE_HDR
+
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "QOPrefix.h"
+
+#include <vector>
+
+// This is included by QORenderer.h after QOTransBuffer.h, which declares
+// PrimStyleState.
+
+
+
+namespace QORenderer
+{
+//=============================================================================
+//      Types
+//-----------------------------------------------------------------------------
+class Renderer;
+class PerPixelLighting;
+
+/*!
+	@struct		QueuedTriMesh
+	@abstract	A cached TriMesh waiting to be drawn, with the state that it
+				was submitted with.
+*/
+struct QueuedTriMesh
+{
+	CQ3ObjectRef		mGeometry;
+	CQ3ObjectRef		mNakedGeometry;
+	TQ3Uns32			mArrayMask;
+	bool				mHasConstantColor;
+	TQ3ColorRGB			mConstantColor;
+	
+	TQ3Uns32			mLocalToCameraIndex;
+	TQ3Uns32			mCameraToFrustumIndex;
+	TQ3Uns32			mStyleIndex;
+	GLuint				mProgram;
+	
+	GLuint				mTextureName;
+	TQ3ShaderUVBoundary	mShaderUBoundary;
+	TQ3ShaderUVBoundary	mShaderVBoundary;
+	TQ3Uns32			mUVTransformIndex;
+	
+	TQ3ColorRGB			mSpecularColor;
+	float				mSpecularControl;
+	float				mMetallic;
+	TQ3ColorRGB			mEmissiveColor;
+};
+
+
+/*!
+	@class		OpaqueQueue
+	
+	@abstract	Queue of opaque TriMeshes that are drawn from the VBO cache.
+	
+	@discussion	Opaque geometry is normally drawn in the order in which it
+				is submitted, so a scene that alternates between materials
+				changes program, texture and material uniforms at nearly
+				every geometry.  When kQ3RendererPropertySortOpaqueDraws is
+				on, such geometry is instead recorded here along with the
+				state it was submitted with, and at the end of the pass it
+				is drawn in order of program, style, texture and material.
+				
+				Only the state that is recorded may differ between queued
+				geometries.  Geometry that depends on other state, such as
+				specular or emissive maps, alpha-tested textures, a
+				clipping plane, or a nondefault write switch or depth range,
+				is drawn immediately as usual.  Sorting is skipped in frames
+				with shadows.
+*/
+class OpaqueQueue
+{
+public:
+							OpaqueQueue(
+									Renderer& inRenderer,
+									PerPixelLighting& inPPLighting );
+	
+	/*!
+		@function			StartPass
+		@abstract			Empty the queue and check whether sorting is
+							wanted in this pass.
+	*/
+	void					StartPass();
+	
+	/*!
+		@function			CanDefer
+		@abstract			Tell whether a cached TriMesh submitted in the
+							current state may be queued.
+	*/
+	bool					CanDefer() const;
+	
+	/*!
+		@function			AddTriMesh
+		@abstract			Queue a cached TriMesh along with the current
+							state.
+		@discussion			The program must already have been chosen by
+							PerPixelLighting::PreGeomSubmit.
+		@param				inTriMesh			The TriMesh being rendered.
+		@param				inNakedMesh			Its naked geometry, which
+												keys the VBO cache.
+		@param				inArrayMask			Which vertex arrays are
+												used, as computed by
+												RenderFastPathTriMesh.
+		@param				inConstantColor		Color to use in place of
+												vertex colors, or nullptr.
+	*/
+	void					AddTriMesh(
+									TQ3GeometryObject inTriMesh,
+									const CQ3ObjectRef& inNakedMesh,
+									TQ3Uns32 inArrayMask,
+									const TQ3ColorRGB* inConstantColor );
+	
+	/*!
+		@function			Flush
+		@abstract			Sort and draw the queued geometry, then empty
+							the queue.
+	*/
+	void					Flush( TQ3ViewObject inView );
+
+private:
+	void					Clear();
+	void					SortQueue();
+	void					InitGLState();
+	void					RestoreGLState();
+	void					DrawTriMesh(
+									TQ3ViewObject inView,
+									const QueuedTriMesh& inMesh );
+	void					UpdateMatrices(
+									TQ3ViewObject inView,
+									const QueuedTriMesh& inMesh );
+	void					UpdateStyles(
+									TQ3ViewObject inView,
+									const QueuedTriMesh& inMesh );
+	void					UpdateTexture( const QueuedTriMesh& inMesh );
+	void					UpdateMaterials( const QueuedTriMesh& inMesh );
+
+	Renderer&						mRenderer;
+	PerPixelLighting&				mPerPixelLighting;
+	bool							mIsEnabled;
+	
+	std::vector<QueuedTriMesh>		mQueue;
+	std::vector<TQ3Uns32>			mOrder;
+	std::vector<PrimStyleState>		mStyles;
+	std::vector<TQ3Matrix4x4>		mLocalToCameraMatrices;
+	std::vector<TQ3Matrix4x4>		mCameraToFrustumMatrices;
+	std::vector<TQ3Matrix3x3>		mUVTransforms;
+	
+	// State used when flushing
+	TQ3Uns32						mCurLocalToCameraIndex;
+	TQ3Uns32						mCurCameraToFrustumIndex;
+	GLuint							mCurTexture;
+	TQ3Uns32						mCurUVTransformIndex;
+	TQ3ShaderUVBoundary				mCurUBoundary;
+	TQ3ShaderUVBoundary				mCurVBoundary;
+	TQ3Uns32						mSavedWriteSwitch;
+	TQ3DepthRangeStyleData			mSavedDepthRange;
+	bool							mSavedSpecularMapping;
+	bool							mSavedEmissiveMapping;
+};
+
+}
+
+#endif
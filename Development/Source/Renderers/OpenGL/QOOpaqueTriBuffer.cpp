@@ -82,6 +82,7 @@ static bool operator!=( const TQ3ColorRGB& inOne, const TQ3ColorRGB& inTwo )
 QORenderer::OpaqueTriBuffer::OpaqueTriBuffer(
 									Renderer& inRenderer  )
 	: mRenderer( inRenderer )
+	, mTriBufferMode( GL_TRIANGLES )
 	, mTriBufferFlags( kVertexFlagNone )
 {
 }
@@ -93,13 +94,20 @@ QORenderer::OpaqueTriBuffer::OpaqueTriBuffer(
 */
 void	QORenderer::OpaqueTriBuffer::Flush()
 {
+	// This is called before every change of renderer state, which is also
+	// when cached geometry waiting for a multi-draw call must be drawn.
+	mRenderer.FlushCachedVBORun();
+	
 	if (! mTriBuffer.empty())
 	{
-		// Allow usual lighting
-		mRenderer.mLights.SetLowDimensionalMode( false, mRenderer.mViewIllumination );
+		// Allow usual lighting for triangles, nondirectional lighting for
+		// lines and points
+		const int kDimension = (mTriBufferMode == GL_TRIANGLES)? 2 :
+			((mTriBufferMode == GL_LINES)? 1 : 0);
+		mRenderer.mLights.SetLowDimensionalMode( kDimension < 2, mRenderer.mViewIllumination );
 
 		// Maybe update fragment program.
-		mRenderer.mPPLighting.PreGeomSubmit( nullptr, 2 );
+		mRenderer.mPPLighting.PreGeomSubmit( nullptr, kDimension );
 
 		// Maybe emissive material
 		if ( (mTriBufferFlags & kVertexHaveEmissive) != 0 )
@@ -117,45 +125,45 @@ void	QORenderer::OpaqueTriBuffer::Flush()
 		mRenderer.mGLClientStates.EnableTextureArray( haveUV );
 		mRenderer.mGLClientStates.EnableColorArray( haveDiffuse );
 		
-		if (SetUpImmediateVBO( mRenderer,
-			mTriBuffer.size() * sizeof(QORenderer::Vertex), 0 ))
+		// Load interleaved vertex data into the immediate ring buffer
+		GLintptr	dataOffset = 0;
+		if (StreamImmediateVBOArrayData( mRenderer,
+			mTriBuffer.size() * sizeof(QORenderer::Vertex), &mTriBuffer[0],
+			dataOffset ))
 		{
-			// Load interleaved vertex data into VBO
-			BindImmediateVBOArrayBuffer( mRenderer );
-			(*mRenderer.mFuncs.glBufferSubDataProc)( GL_ARRAY_BUFFER, 0,
-				mTriBuffer.size() * sizeof(QORenderer::Vertex), &mTriBuffer[0] );
-				
 			// Set up pointers
 			mRenderer.mSLFuncs.glVertexAttribPointer( mRenderer.mPPLighting.CurrentProgram()->mVertexAttribLoc,
 				3, GL_FLOAT, GL_FALSE, sizeof(QORenderer::Vertex),
-				GLBufferObPtr( (GLuint)offsetof( QORenderer::Vertex, point ) ) );
+				GLBufferObPtr( dataOffset + (GLintptr)offsetof( QORenderer::Vertex, point ) ) );
 			
 			if ( haveNormal )
 			{
 				mRenderer.mSLFuncs.glVertexAttribPointer( mRenderer.mPPLighting.CurrentProgram()->mNormalAttribLoc,
 					3, GL_FLOAT, GL_FALSE, sizeof(QORenderer::Vertex),
-					GLBufferObPtr( (GLuint)offsetof( QORenderer::Vertex, normal ) ) );
+					GLBufferObPtr( dataOffset + (GLintptr)offsetof( QORenderer::Vertex, normal ) ) );
 			}
 			
 			if ( haveUV )
 			{
 				mRenderer.mSLFuncs.glVertexAttribPointer( mRenderer.mPPLighting.CurrentProgram()->mTexCoordAttribLoc,
 					2, GL_FLOAT, GL_FALSE, sizeof(QORenderer::Vertex),
-					GLBufferObPtr( (GLuint)offsetof( QORenderer::Vertex, uv ) ) );
+					GLBufferObPtr( dataOffset + (GLintptr)offsetof( QORenderer::Vertex, uv ) ) );
 			}
 			
 			if ( haveDiffuse )
 			{
 				mRenderer.mSLFuncs.glVertexAttribPointer( mRenderer.mPPLighting.CurrentProgram()->mColorAttribLoc,
 					3, GL_FLOAT, GL_FALSE, sizeof(QORenderer::Vertex),
-					GLBufferObPtr( (GLuint)offsetof( QORenderer::Vertex, diffuseColor ) ) );
+					GLBufferObPtr( dataOffset + (GLintptr)offsetof( QORenderer::Vertex, diffuseColor ) ) );
 			}
 			
 			// Draw
-			glDrawArrays( GL_TRIANGLES, 0, kNumVertices );
+			glDrawArrays( mTriBufferMode, 0, kNumVertices );
+			mRenderer.Counts().mDrawCalls += 1;
 			
 			(*mRenderer.mFuncs.glBindBufferProc)( GL_ARRAY_BUFFER, 0 );
 			(*mRenderer.mFuncs.glBindBufferProc)( GL_ELEMENT_ARRAY_BUFFER, 0 );
+			mRenderer.Counts().mBufferBinds += 2;
 		}		
 
 		mTriBuffer.clear();
@@ -169,22 +177,63 @@ void	QORenderer::OpaqueTriBuffer::Flush()
 */
 void	QORenderer::OpaqueTriBuffer::AddTriangle( const Vertex* inVertices )
 {
-	// Flush the buffer if the vertex format has changed
-	if (inVertices[0].flags != mTriBufferFlags)
+	StartPrimitive( GL_TRIANGLES, inVertices[0].flags, inVertices[0] );
+	
+	// Append the vertices to the buffer
+	mTriBuffer.insert( mTriBuffer.end(), inVertices, inVertices+3 );
+}
+
+
+/*!
+	@function		AddLine
+	@abstract		Add a line segment to the buffer.
+	@discussion		Consecutive opaque Lines with the same vertex format are
+					drawn with one glDrawArrays call, as triangles are.
+*/
+void	QORenderer::OpaqueTriBuffer::AddLine( const Vertex* inVertices )
+{
+	StartPrimitive( GL_LINES, inVertices[0].flags | inVertices[1].flags,
+		inVertices[0] );
+	
+	mTriBuffer.insert( mTriBuffer.end(), inVertices, inVertices+2 );
+}
+
+
+/*!
+	@function		AddPoint
+	@abstract		Add a point to the buffer.
+*/
+void	QORenderer::OpaqueTriBuffer::AddPoint( const Vertex& inVertex )
+{
+	StartPrimitive( GL_POINTS, inVertex.flags, inVertex );
+	
+	mTriBuffer.push_back( inVertex );
+}
+
+
+/*!
+	@function		StartPrimitive
+	@abstract		Flush the buffer if a new primitive cannot be drawn in the
+					same batch as those already buffered.
+*/
+void	QORenderer::OpaqueTriBuffer::StartPrimitive( GLenum inMode,
+										VertexFlags inFlags,
+										const Vertex& inVertex )
+{
+	// Flush the buffer if the primitive type or vertex format has changed
+	if ( (inMode != mTriBufferMode) || (inFlags != mTriBufferFlags) )
 	{
 		Flush();
-		mTriBufferFlags = inVertices[0].flags;
+		mTriBufferMode = inMode;
+		mTriBufferFlags = inFlags;
 	}
 	
 	// Flush the buffer if the emissive color has changed
 	if ( (! mTriBuffer.empty()) &&
 		((mTriBufferFlags & kVertexHaveEmissive) != 0) &&
-		(inVertices[0].emissiveColor != mTriBuffer.back().emissiveColor)
+		(inVertex.emissiveColor != mTriBuffer.back().emissiveColor)
 	)
 	{
 		Flush();
 	}
-	
-	// Append the vertices to the buffer
-	mTriBuffer.insert( mTriBuffer.end(), inVertices, inVertices+3 );
 }
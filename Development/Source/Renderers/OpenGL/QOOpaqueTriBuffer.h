@@ -1,7 +1,8 @@
 /*!
 	@header		QOOpaqueTriBuffer.h
 	
-	Class to buffer opaque triangles for the Quesa OpenGL renderer.
+	Class to buffer opaque triangles, lines, and points for the Quesa
+	OpenGL renderer.
 */
 
 /*  NAME:
@@ -75,9 +76,18 @@ public:
 	
 	void					AddTriangle( const Vertex* inVertices );
 	
+	void					AddLine( const Vertex* inVertices );
+	
+	void					AddPoint( const Vertex& inVertex );
+	
 private:
+	void					StartPrimitive( GLenum inMode,
+											VertexFlags inFlags,
+											const Vertex& inVertex );
+
 	Renderer&				mRenderer;
 
+	GLenum					mTriBufferMode;
 	VertexFlags				mTriBufferFlags;
 	std::vector<Vertex>		mTriBuffer;
 };
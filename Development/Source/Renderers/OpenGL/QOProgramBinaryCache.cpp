@@ -0,0 +1,427 @@
+/*  NAME:
+        QOProgramBinaryCache.cpp
+
+    DESCRIPTION:
+        Saving and loading of linked GLSL programs for Quesa OpenGL renderer.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "QOProgramBinaryCache.h"
+#include "QOGLShadingLanguage.h"
+#include "QOShaderProgramCache.h"
+#include "GLUtils.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+
+
+//=============================================================================
+//      Local constants
+//-----------------------------------------------------------------------------
+namespace
+{
+	const TQ3Uns32		kBinaryFileMagic		= 'QSPB';
+	const TQ3Uns32		kBinaryFileVersion		= 1;
+	const char*			kManifestFileName		= "QuesaPrograms.txt";
+	
+	const uint64_t		kFNVOffsetBasis			= 14695981039346656037ULL;
+	const uint64_t		kFNVPrime				= 1099511628211ULL;
+	
+	/*
+		Header of a program binary file.  It is followed by mLength bytes
+		of binary data.
+	*/
+	struct BinaryFileHeader
+	{
+		TQ3Uns32	mMagic;
+		TQ3Uns32	mVersion;
+		uint64_t	mKey;
+		TQ3Uns32	mFormat;
+		TQ3Uns32	mLength;
+	};
+}
+
+
+
+
+
+//=============================================================================
+//      Internal functions
+//-----------------------------------------------------------------------------
+//      FNVHash : Fold bytes into a 64-bit FNV-1a hash.
+//-----------------------------------------------------------------------------
+static void FNVHash( const char* inData, TQ3Uns32 inLength, uint64_t& ioHash )
+{
+	for (TQ3Uns32 i = 0; i < inLength; ++i)
+	{
+		ioHash ^= (TQ3Uns8) inData[i];
+		ioHash *= kFNVPrime;
+	}
+	
+	// Separate this string from the next one
+	ioHash ^= 0xFF;
+	ioHash *= kFNVPrime;
+}
+
+
+
+
+
+//=============================================================================
+//      GLString : glGetString, but never nullptr.
+//-----------------------------------------------------------------------------
+static const char* GLString( GLenum inName )
+{
+	const char* theString = (const char*) glGetString( inName );
+	return (theString == nullptr)? "" : theString;
+}
+
+
+
+
+
+#pragma mark -
+//=============================================================================
+//      Public functions
+//-----------------------------------------------------------------------------
+QORenderer::ProgramBinaryCache::ProgramBinaryCache( const GLSLFuncs& inFuncs )
+	: mFuncs( inFuncs )
+	, mLoadedManifest( false )
+{
+}
+
+
+
+/*!
+	@function	SetDirectory
+	@abstract	Set the cache directory, or an empty string to disable
+				the cache.
+*/
+void	QORenderer::ProgramBinaryCache::SetDirectory( const std::string& inDirectory )
+{
+	if (inDirectory != mDirectory)
+	{
+		mDirectory = inDirectory;
+		mManifestLines.clear();
+		mLoadedManifest = false;
+	}
+	
+	if ( (! mDirectory.empty()) && mDriverID.empty() )
+	{
+		mDriverID = GLString( GL_VENDOR );
+		mDriverID += '\n';
+		mDriverID += GLString( GL_RENDERER );
+		mDriverID += '\n';
+		mDriverID += GLString( GL_VERSION );
+	}
+}
+
+
+
+/*!
+	@function	IsEnabled
+	@abstract	Whether binaries can be loaded and saved.
+*/
+bool	QORenderer::ProgramBinaryCache::IsEnabled() const
+{
+	return (! mDirectory.empty()) &&
+		(mFuncs.glGetProgramBinary != nullptr) &&
+		(mFuncs.glProgramBinary != nullptr) &&
+		(mFuncs.glProgramParameteri != nullptr);
+}
+
+
+
+/*!
+	@function	Key
+	@abstract	Compute the key identifying a program, from its shader
+				sources and the driver identification.
+*/
+uint64_t	QORenderer::ProgramBinaryCache::Key( const std::string& inVertexSource,
+										const char* inGeomSource,
+										const std::string& inFragmentSource ) const
+{
+	uint64_t	theHash = kFNVOffsetBasis;
+	
+	FNVHash( mDriverID.data(), (TQ3Uns32) mDriverID.size(), theHash );
+	FNVHash( inVertexSource.data(), (TQ3Uns32) inVertexSource.size(), theHash );
+	if (inGeomSource != nullptr)
+	{
+		FNVHash( inGeomSource, (TQ3Uns32) std::strlen( inGeomSource ), theHash );
+	}
+	FNVHash( inFragmentSource.data(), (TQ3Uns32) inFragmentSource.size(), theHash );
+	
+	return theHash;
+}
+
+
+
+/*!
+	@function	LoadProgram
+	@abstract	Create a program from a saved binary.
+	@discussion	A binary that the driver rejects, for instance after a driver
+				update that kept the same version string, just results in
+				a return value of 0, and the caller compiles the program
+				from source and saves it again.
+*/
+GLuint	QORenderer::ProgramBinaryCache::LoadProgram( uint64_t inKey ) const
+{
+	if (! IsEnabled())
+	{
+		return 0;
+	}
+	
+	FILE* theFile = std::fopen( BinaryPath( inKey ).c_str(), "rb" );
+	if (theFile == nullptr)
+	{
+		return 0;
+	}
+	
+	GLuint	programID = 0;
+	BinaryFileHeader	header;
+	std::vector<char>	binary;
+	
+	if ( (std::fread( &header, sizeof(header), 1, theFile ) == 1) &&
+		(header.mMagic == kBinaryFileMagic) &&
+		(header.mVersion == kBinaryFileVersion) &&
+		(header.mKey == inKey) &&
+		(header.mLength > 0) )
+	{
+		binary.resize( header.mLength );
+		if (std::fread( &binary[0], 1, header.mLength, theFile ) != header.mLength)
+		{
+			binary.clear();
+		}
+	}
+	std::fclose( theFile );
+	
+	if (! binary.empty())
+	{
+		programID = mFuncs.glCreateProgram();
+		if (programID != 0)
+		{
+			(void) glGetError();
+			mFuncs.glProgramBinary( programID, header.mFormat, &binary[0],
+				(GLsizei) binary.size() );
+			
+			GLint	linkStatus = GL_FALSE;
+			if (glGetError() == GL_NO_ERROR)
+			{
+				mFuncs.glGetProgramiv( programID, GL_LINK_STATUS, &linkStatus );
+			}
+			
+			if (linkStatus != GL_TRUE)
+			{
+				Q3_MESSAGE_FMT("Saved program binary %016llX was rejected",
+					(unsigned long long) inKey );
+				mFuncs.glDeleteProgram( programID );
+				programID = 0;
+			}
+		}
+	}
+	
+	return programID;
+}
+
+
+
+/*!
+	@function	SaveProgram
+	@abstract	Save the binary of a linked program.
+*/
+void	QORenderer::ProgramBinaryCache::SaveProgram( uint64_t inKey, GLuint inProgram ) const
+{
+	if (! IsEnabled())
+	{
+		return;
+	}
+	
+	GLint	binaryLength = 0;
+	mFuncs.glGetProgramiv( inProgram, GL_PROGRAM_BINARY_LENGTH, &binaryLength );
+	if (binaryLength <= 0)
+	{
+		return;
+	}
+	
+	std::vector<char>	binary( binaryLength );
+	GLsizei	actualLength = 0;
+	GLenum	binaryFormat = 0;
+	(void) glGetError();
+	mFuncs.glGetProgramBinary( inProgram, binaryLength, &actualLength,
+		&binaryFormat, &binary[0] );
+	if ( (glGetError() != GL_NO_ERROR) || (actualLength <= 0) )
+	{
+		return;
+	}
+	
+	BinaryFileHeader	header;
+	header.mMagic = kBinaryFileMagic;
+	header.mVersion = kBinaryFileVersion;
+	header.mKey = inKey;
+	header.mFormat = binaryFormat;
+	header.mLength = (TQ3Uns32) actualLength;
+	
+	// Write to a temporary file and rename it, so that another process never
+	// sees a partially written binary.
+	std::string	thePath( BinaryPath( inKey ) );
+	std::string	tempPath( thePath + ".tmp" );
+	FILE* theFile = std::fopen( tempPath.c_str(), "wb" );
+	if (theFile != nullptr)
+	{
+		bool	didWrite = (std::fwrite( &header, sizeof(header), 1, theFile ) == 1) &&
+			(std::fwrite( &binary[0], 1, header.mLength, theFile ) == header.mLength);
+		didWrite = (std::fclose( theFile ) == 0) && didWrite;
+		
+		std::remove( thePath.c_str() );
+		if ( (! didWrite) || (std::rename( tempPath.c_str(), thePath.c_str() ) != 0) )
+		{
+			Q3_MESSAGE_FMT("Failed to save program binary %016llX",
+				(unsigned long long) inKey );
+			std::remove( tempPath.c_str() );
+		}
+	}
+}
+
+
+
+/*!
+	@function	RecordCharacteristic
+	@abstract	Add a program characteristic to the manifest, if it is
+				not already there.
+*/
+void	QORenderer::ProgramBinaryCache::RecordCharacteristic(
+								const ProgramCharacteristic& inCharacteristic )
+{
+	if (mDirectory.empty())
+	{
+		return;
+	}
+	
+	LoadManifestLines();
+	
+	std::string	theLine( inCharacteristic.ToString() );
+	if (mManifestLines.insert( theLine ).second)
+	{
+		FILE* theFile = std::fopen( ManifestPath().c_str(), "a" );
+		if (theFile != nullptr)
+		{
+			std::fprintf( theFile, "%s\n", theLine.c_str() );
+			std::fclose( theFile );
+		}
+	}
+}
+
+
+
+/*!
+	@function	ReadManifest
+	@abstract	Get the program characteristics recorded in the manifest.
+*/
+void	QORenderer::ProgramBinaryCache::ReadManifest(
+								std::vector<ProgramCharacteristic>& outCharacteristics )
+{
+	outCharacteristics.clear();
+	LoadManifestLines();
+	
+	ProgramCharacteristic	aCharacteristic;
+	for (const std::string& theLine : mManifestLines)
+	{
+		if (aCharacteristic.FromString( theLine ))
+		{
+			outCharacteristics.push_back( aCharacteristic );
+		}
+	}
+}
+
+
+
+
+
+#pragma mark -
+//=============================================================================
+//      Private functions
+//-----------------------------------------------------------------------------
+std::string	QORenderer::ProgramBinaryCache::BinaryPath( uint64_t inKey ) const
+{
+	char	fileName[32];
+	std::snprintf( fileName, sizeof(fileName), "/%016llX.qsb",
+		(unsigned long long) inKey );
+	return mDirectory + fileName;
+}
+
+
+
+std::string	QORenderer::ProgramBinaryCache::ManifestPath() const
+{
+	return mDirectory + "/" + kManifestFileName;
+}
+
+
+
+void	QORenderer::ProgramBinaryCache::LoadManifestLines()
+{
+	if (mLoadedManifest)
+	{
+		return;
+	}
+	mLoadedManifest = true;
+	
+	FILE* theFile = std::fopen( ManifestPath().c_str(), "r" );
+	if (theFile != nullptr)
+	{
+		char	lineBuf[1024];
+		while (std::fgets( lineBuf, sizeof(lineBuf), theFile ) != nullptr)
+		{
+			std::string	theLine( lineBuf );
+			while ( (! theLine.empty()) &&
+				((theLine.back() == '\n') || (theLine.back() == '\r')) )
+			{
+				theLine.pop_back();
+			}
+			if (! theLine.empty())
+			{
+				mManifestLines.insert( theLine );
+			}
+		}
+		std::fclose( theFile );
+	}
+}
@@ -0,0 +1,160 @@
+/*!
+	@header		QOProgramBinaryCache.h
+	
+	This header holds declarations relating to saving linked OpenGL Shading
+	Language programs to disk in the Quesa OpenGL renderer.
+*/
+/*  NAME:
+        QOProgramBinaryCache.h
+
+    DESCRIPTION:
+        Header for Quesa OpenGL renderer class.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+#ifndef QOPROGRAMBINARYCACHE_HDR
+#define QOPROGRAMBINARYCACHE_HDR
+
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "QOPrefix.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <set>
+
+
+
+namespace QORenderer
+{
+//=============================================================================
+//      Types
+//-----------------------------------------------------------------------------
+struct GLSLFuncs;
+struct ProgramCharacteristic;
+
+
+/*!
+	@class		ProgramBinaryCache
+	
+	@abstract	Directory of linked GLSL program binaries, keyed by a hash of
+				the shader sources and the OpenGL driver, together with a
+				manifest of the program characteristics that have been seen.
+	
+	@discussion	The directory is supplied by the client through the renderer
+				property kQ3RendererPropertyShaderCacheDirectory.  If it is
+				not set, or the driver does not provide glProgramBinary, the
+				cache does nothing.
+*/
+class ProgramBinaryCache
+{
+public:
+								ProgramBinaryCache( const GLSLFuncs& inFuncs );
+	
+	/*!
+		@function	SetDirectory
+		@abstract	Set the cache directory, or an empty string to disable
+					the cache.  The OpenGL context should be current, since
+					the driver identification is read at this point.
+	*/
+	void						SetDirectory( const std::string& inDirectory );
+	
+	/*!
+		@function	IsEnabled
+		@abstract	Whether binaries can be loaded and saved.
+	*/
+	bool						IsEnabled() const;
+	
+	/*!
+		@function	Key
+		@abstract	Compute the key identifying a program, from its shader
+					sources and the driver identification.
+		@param		inVertexSource		Vertex shader source.
+		@param		inGeomSource		Geometry shader source, or nullptr.
+		@param		inFragmentSource	Fragment shader source.
+		@result		A 64-bit FNV-1a hash.
+	*/
+	uint64_t					Key( const std::string& inVertexSource,
+										const char* inGeomSource,
+										const std::string& inFragmentSource ) const;
+	
+	/*!
+		@function	LoadProgram
+		@abstract	Create a program from a saved binary.
+		@result		A linked program ID, or 0 if there was no usable binary.
+	*/
+	GLuint						LoadProgram( uint64_t inKey ) const;
+	
+	/*!
+		@function	SaveProgram
+		@abstract	Save the binary of a linked program.  The program should
+					have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT.
+	*/
+	void						SaveProgram( uint64_t inKey, GLuint inProgram ) const;
+	
+	/*!
+		@function	RecordCharacteristic
+		@abstract	Add a program characteristic to the manifest, if it is
+					not already there.
+	*/
+	void						RecordCharacteristic(
+										const ProgramCharacteristic& inCharacteristic );
+	
+	/*!
+		@function	ReadManifest
+		@abstract	Get the program characteristics recorded in the manifest.
+	*/
+	void						ReadManifest(
+										std::vector<ProgramCharacteristic>& outCharacteristics );
+
+private:
+	std::string					BinaryPath( uint64_t inKey ) const;
+	std::string					ManifestPath() const;
+	void						LoadManifestLines();
+
+	const GLSLFuncs&			mFuncs;
+	std::string					mDirectory;
+	std::string					mDriverID;
+	std::set<std::string>		mManifestLines;
+	bool						mLoadedManifest;
+};
+
+}	// end QORenderer namespace
+
+#endif
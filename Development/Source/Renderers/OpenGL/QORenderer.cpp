@@ -100,6 +100,11 @@ QORenderer::GLFuncs::GLFuncs()
 	, glBufferDataProc( nullptr )
 	, glBufferSubDataProc( nullptr )
 	, glGetBufferParameterivProc( nullptr )
+	, glMapBufferRangeProc( nullptr )
+	, glUnmapBufferProc( nullptr )
+	, glCopyBufferSubDataProc( nullptr )
+	, glDrawElementsBaseVertexProc( nullptr )
+	, glMultiDrawElementsBaseVertexProc( nullptr )
 	, glGenerateMipmapProc( nullptr )
 	, glActiveTexture( nullptr )
 {
@@ -126,6 +131,13 @@ void	QORenderer::GLFuncs::Initialize( const TQ3GLExtensions& inExts )
 	GLGetProcAddress( glBufferSubDataProc, "glBufferSubData", "glBufferSubDataARB" );
 	GLGetProcAddress( glGetBufferParameterivProc, "glGetBufferParameteriv",
 		"glGetBufferParameterivARB" );
+	GLGetProcAddress( glMapBufferRangeProc, "glMapBufferRange" );
+	GLGetProcAddress( glUnmapBufferProc, "glUnmapBuffer", "glUnmapBufferARB" );
+	GLGetProcAddress( glCopyBufferSubDataProc, "glCopyBufferSubData" );
+	
+	// Base-vertex drawing
+	GLGetProcAddress( glDrawElementsBaseVertexProc, "glDrawElementsBaseVertex" );
+	GLGetProcAddress( glMultiDrawElementsBaseVertexProc, "glMultiDrawElementsBaseVertex" );
 	
 	// Misc
 	GLGetProcAddress( glGenerateMipmapProc, "glGenerateMipmap" );
@@ -198,8 +210,10 @@ QORenderer::Renderer::Renderer( TQ3RendererObject inRenderer )
 	, mAttributesMask( kQ3XAttributeMaskAll )
 	, mUpdateShader( true )
 	, mGLClientStates( mSLFuncs, mPPLighting )
+	, mGLState( mSLFuncs, mFuncs, mFrameCounts )
 	, mLights( *this )
 	, mTriBuffer( *this )
+	, mOpaqueQueue( *this, mPPLighting )
 	, mTransBuffer( *this, mPPLighting )
 	, mTextures( *this )
 {
@@ -241,3 +255,18 @@ bool	QORenderer::Renderer::IsBoundingBoxVisible(
 	
 	return isVisible;
 }
+
+/*!
+	@function	FlushCachedVBORun
+	@abstract	Draw any cached geometry waiting for a multi-draw call.
+	@discussion	The run was recorded with the current program, uniforms and
+				vertex array state, so this must be called before any of them
+				change.
+*/
+void	QORenderer::Renderer::FlushCachedVBORun()
+{
+	if (! mCachedVBORun.IsEmpty())
+	{
+		DrawCachedVBORun( *this, mCachedVBORun );
+	}
+}
@@ -59,9 +59,11 @@
 #include "QOLights.h"
 #include "QOTexture.h"
 #include "QOClientStates.h"
+#include "QOGLStateCache.h"
 #include "QOMatrix.h"
 #include "QOOpaqueTriBuffer.h"
 #include "QOTransBuffer.h"
+#include "QOOpaqueQueue.h"
 #include "QOGLShadingLanguage.h"
 #include "QOCalcTriMeshEdges.h"
 
@@ -127,6 +129,8 @@ struct StyleState
 	TQ3FillStyle			mFill;
 	TQ3OrientationStyle		mOrientation;
 	TQ3DepthCompareFunc		mDepthCompare;
+	TQ3Uns32				mWriteSwitch;
+	TQ3DepthRangeStyleData	mDepthRange;
 	CQ3ObjectRef			mHilite;	
 	std::vector<TQ3FogStyleExtendedData>	mFogStyles;
 	TQ3Uns32				mCurFogStyleIndex;
@@ -195,6 +199,29 @@ typedef void (QO_PROCPTR_TYPE BufferSubDataProcPtr) (GLenum target,
 												GLsizeiptr size,
 												const GLvoid *data);
 typedef void (QO_PROCPTR_TYPE GetBufferParameterivProcPtr)(GLenum target, GLenum value, GLint * data);
+typedef GLvoid* (QO_PROCPTR_TYPE MapBufferRangeProcPtr) (GLenum target,
+												GLintptr offset,
+												GLsizeiptr length,
+												GLbitfield access);
+typedef GLboolean (QO_PROCPTR_TYPE UnmapBufferProcPtr) (GLenum target);
+typedef void (QO_PROCPTR_TYPE CopyBufferSubDataProcPtr) (GLenum readTarget,
+												GLenum writeTarget,
+												GLintptr readOffset,
+												GLintptr writeOffset,
+												GLsizeiptr size);
+
+// Function pointer types for base-vertex drawing, GL 3.2
+typedef void (QO_PROCPTR_TYPE DrawElementsBaseVertexProcPtr) (GLenum mode,
+												GLsizei count,
+												GLenum type,
+												const GLvoid *indices,
+												GLint basevertex);
+typedef void (QO_PROCPTR_TYPE MultiDrawElementsBaseVertexProcPtr) (GLenum mode,
+												const GLsizei *count,
+												GLenum type,
+												const GLvoid* const *indices,
+												GLsizei drawcount,
+												const GLint *basevertex);
 
 // Miscellaneous function pointer types
 typedef void (QO_PROCPTR_TYPE GenerateMipmapProcPtr) (GLenum target);
@@ -237,6 +264,13 @@ struct GLFuncs
 	BufferDataProcPtr				glBufferDataProc;
 	BufferSubDataProcPtr			glBufferSubDataProc;
 	GetBufferParameterivProcPtr		glGetBufferParameterivProc;
+	MapBufferRangeProcPtr			glMapBufferRangeProc;	// optional, GL 3.0
+	UnmapBufferProcPtr				glUnmapBufferProc;		// optional
+	CopyBufferSubDataProcPtr		glCopyBufferSubDataProc;	// optional, GL 3.1
+	
+	// Base-vertex drawing, optional, GL 3.2
+	DrawElementsBaseVertexProcPtr		glDrawElementsBaseVertexProc;
+	MultiDrawElementsBaseVertexProcPtr	glMultiDrawElementsBaseVertexProc;
 	
 	// Other
 	GenerateMipmapProcPtr			glGenerateMipmapProc;
@@ -245,6 +279,28 @@ struct GLFuncs
 	BindVertexArrayProcPtr			glBindVertexArray;
 };
 
+/*!
+	@struct		FrameCounts
+	@abstract	Counts of OpenGL calls made in the current frame.  They are
+				reported through renderer properties at the end of each pass.
+*/
+struct FrameCounts
+{
+								FrameCounts()
+									: mBufferBinds( 0 )
+									, mDrawCalls( 0 )
+									, mStateChanges( 0 )
+									, mElidedStateChanges( 0 ) {}
+
+	void						Reset() { mBufferBinds = mDrawCalls =
+											mStateChanges = mElidedStateChanges = 0; }
+
+	TQ3Uns32					mBufferBinds;	// glBindBuffer calls
+	TQ3Uns32					mDrawCalls;		// glDraw* and glMultiDraw* calls
+	TQ3Uns32					mStateChanges;	// calls made by GLStateCache
+	TQ3Uns32					mElidedStateChanges;	// calls it found redundant
+};
+
 //=============================================================================
 //     Main Class
 //-----------------------------------------------------------------------------
@@ -272,11 +328,19 @@ public:
 	StyleState&				GetStyleState() { return mStyleState; }
 	bool&					IsCachingShadows() { return mIsCachingShadows; }
 	ClientStates&			GetClientStates() { return mGLClientStates; }
+	GLStateCache&			GetGLState() { return mGLState; }
 	TQ3RendererObject		GetQuesaRenderer() const { return mRendererObject; }
 	float					LineWidth() const { return mLineWidth; }
 	
 	void					RefreshMaterials();
 	
+	// Counts are updated by code that only has a const renderer.
+	FrameCounts&			Counts() const { return mFrameCounts; }
+	
+	// Draw any cached geometry waiting for a multi-draw call.  This must be
+	// done before changing OpenGL state that the geometry was recorded with.
+	void					FlushCachedVBORun();
+	
 	// Use this to avoid sending normals to a shader that doesn't need them.
 	bool					CurrentShaderHasNormalAttrib() const { return Shader().CurrentProgram()->mNormalAttribLoc != -1; }
 
@@ -287,6 +351,7 @@ protected:
 	friend class Statics;
 	friend class TransBuffer;
 	friend class OpaqueTriBuffer;
+	friend class OpaqueQueue;
 	
 	//
 	//	non-static methods that implement static methods
@@ -413,6 +478,22 @@ protected:
 									const TQ3Vector3D* inVertNormals,
 									const TQ3Param2D* inVertUVs,
 									const TQ3ColorRGB* inVertColors );
+	void					SetCachedVBOArrays(
+									TQ3Uns32 inArrayMask,
+									const TQ3ColorRGB* inConstantColor );
+	void					AddTriMeshToVBOCache(
+									TQ3GeometryObject inTriMesh,
+									TQ3GeometryObject inNakedMesh,
+									const TQ3TriMeshData& inGeomData,
+									GLenum inMode,
+									const TQ3Vector3D* inVertNormals,
+									const TQ3Param2D* inVertUVs,
+									const TQ3ColorRGB* inVertColors );
+	void					RenderQueuedTriMesh(
+									TQ3GeometryObject inTriMesh,
+									TQ3GeometryObject inNakedMesh,
+									TQ3Uns32 inArrayMask,
+									const TQ3ColorRGB* inConstantColor );
 	void					RenderSlowPathTriMesh(
 									TQ3GeometryObject inTriMesh,
 									TQ3ViewObject inView,
@@ -446,6 +527,7 @@ protected:
 	bool					mAllowLineSmooth;
 	bool					mIsCachingShadows;
 	unsigned long long		mNumPrimitivesRenderedInFrame;
+	mutable FrameCounts		mFrameCounts;
 	
 	// Buffers used temporarily in QOGeometry.cpp, only members to reduce
 	// memory allocation
@@ -471,6 +553,9 @@ protected:
 	
 	// OpenGL client state
 	ClientStates			mGLClientStates;
+	
+	// Other OpenGL state, and uniform values
+	GLStateCache			mGLState;
 
 	// Light state
 	Lights					mLights;
@@ -478,6 +563,12 @@ protected:
 	// Buffer for opaque triangles
 	OpaqueTriBuffer			mTriBuffer;
 	
+	// Cached geometry waiting for a multi-draw call
+	CachedVBORun			mCachedVBORun;
+	
+	// Opaque cached geometry waiting to be drawn in sorted order
+	OpaqueQueue				mOpaqueQueue;
+	
 	// Buffer for transparent stuff
 	TransBuffer				mTransBuffer;
 	
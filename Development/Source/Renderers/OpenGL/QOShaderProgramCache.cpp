@@ -46,29 +46,11 @@
 #include "GLUtils.h"
 
 #include <algorithm>
+#include <sstream>
 
 namespace
 {
 	const TQ3Uns32	kGLSLProgramCache = 'SLPC';
-
-
-	struct MatchProgram
-	{
-					MatchProgram(
-							const QORenderer::ProgramCharacteristic& inChar )
-						: mCharacteristic( inChar ) {}
-					
-					MatchProgram( const MatchProgram& inOther )
-						: mCharacteristic( inOther.mCharacteristic ) {}
-	
-		bool		operator()( const QORenderer::ProgramRec& inProg ) const
-					{
-						return (mCharacteristic == inProg.mCharacteristic);
-					}
-		
-	private:
-		const QORenderer::ProgramCharacteristic&	mCharacteristic;
-	};
 }
 
 QORenderer::ProgramCharacteristic::ProgramCharacteristic()
@@ -135,6 +117,98 @@ void	QORenderer::ProgramCharacteristic::swap(
 	std::swap( mProjectionType, ioOther.mProjectionType );
 }
 
+std::size_t	QORenderer::ProgramCharacteristic::Hash() const
+{
+	// Fold each field into the hash, in the manner of boost::hash_combine.
+	std::size_t	theHash = 0;
+	auto mix = [&theHash]( std::size_t inValue )
+	{
+		theHash ^= inValue + 0x9E3779B9 + (theHash << 6) + (theHash >> 2);
+	};
+	
+	mix( static_cast<std::size_t>( mProjectionType ) );
+	mix( mIlluminationType );
+	mix( mInterpolationStyle );
+	mix( mFillStyle );
+	mix( (mIsTextured? 1 : 0) | (mIsCartoonish? 2 : 0) |
+		(mIsUsingClippingPlane? 4 : 0) | (mAngleAffectsAlpha? 8 : 0) );
+	mix( static_cast<std::size_t>( mFogModeCombined + 1 ) );
+	mix( static_cast<std::size_t>( mDimension ) );
+	for (ELightType lightType : mPattern)
+	{
+		mix( static_cast<std::size_t>( lightType + 1 ) );
+	}
+	
+	return theHash;
+}
+
+std::string	QORenderer::ProgramCharacteristic::ToString() const
+{
+	std::ostringstream	desc;
+	desc << static_cast<int>( mProjectionType ) << ' ' <<
+		mIlluminationType << ' ' <<
+		mInterpolationStyle << ' ' <<
+		mFillStyle << ' ' <<
+		mIsTextured << ' ' <<
+		mIsCartoonish << ' ' <<
+		static_cast<int>( mFogModeCombined ) << ' ' <<
+		mIsUsingClippingPlane << ' ' <<
+		mAngleAffectsAlpha << ' ' <<
+		mDimension << ' ' <<
+		mPattern.size();
+	for (ELightType lightType : mPattern)
+	{
+		desc << ' ' << static_cast<int>( lightType );
+	}
+	return desc.str();
+}
+
+bool	QORenderer::ProgramCharacteristic::FromString( const std::string& inText )
+{
+	std::istringstream	desc( inText );
+	int	projection, illumination, interpolation, fill, fog, dimension;
+	bool	isTextured, isCartoonish, isClipping, angleAffectsAlpha;
+	std::size_t	lightCount;
+	
+	desc >> projection >> illumination >> interpolation >> fill >>
+		isTextured >> isCartoonish >> fog >> isClipping >> angleAffectsAlpha >>
+		dimension >> lightCount;
+	if ( desc.fail() || (projection < 0) ||
+		(projection > static_cast<int>( ECameraProjectionType::fisheye )) ||
+		(fog < kFogModeOff) || (fog > kFogModeHalfspace) ||
+		(dimension < 0) || (dimension > 2) || (lightCount > 1000) )
+	{
+		return false;
+	}
+	
+	LightPattern	pattern( lightCount );
+	for (ELightType& lightType : pattern)
+	{
+		int	typeNum;
+		desc >> typeNum;
+		if ( desc.fail() || (typeNum < kLightTypeNone) ||
+			(typeNum > kLightTypeSpotCubic) )
+		{
+			return false;
+		}
+		lightType = static_cast<ELightType>( typeNum );
+	}
+	
+	mProjectionType = static_cast<ECameraProjectionType>( projection );
+	mPattern.swap( pattern );
+	mIlluminationType = static_cast<TQ3ObjectType>( illumination );
+	mInterpolationStyle = static_cast<TQ3InterpolationStyle>( interpolation );
+	mFillStyle = static_cast<TQ3FillStyle>( fill );
+	mIsTextured = isTextured;
+	mIsCartoonish = isCartoonish;
+	mFogModeCombined = static_cast<EFogModeCombined>( fog );
+	mIsUsingClippingPlane = isClipping;
+	mAngleAffectsAlpha = angleAffectsAlpha;
+	mDimension = dimension;
+	
+	return true;
+}
+
 QORenderer::ProgramCharacteristic&	QORenderer::ProgramCharacteristic::operator=( const QORenderer::ProgramCharacteristic& inOther )
 {
 	QORenderer::ProgramCharacteristic temp( inOther );
@@ -219,13 +293,16 @@ const QORenderer::ProgramRec*		QORenderer::ProgramCache::FindProgram(
 						const ProgramCharacteristic& inChar ) const
 {
 	const QORenderer::ProgramRec* foundProg = nullptr;
-	MatchProgram	matcher( inChar );
-	ProgramVec::const_iterator	foundIt = std::find_if( mPrograms.begin(),
-			mPrograms.end(), matcher );
+	auto	candidates = mProgramIndexOfHash.equal_range( inChar.Hash() );
 	
-	if (foundIt != mPrograms.end())
+	for (auto it = candidates.first; it != candidates.second; ++it)
 	{
-		foundProg = &*foundIt;
+		const ProgramRec&	candidate( mPrograms[ it->second ] );
+		if (candidate.mCharacteristic == inChar)
+		{
+			foundProg = &candidate;
+			break;
+		}
 	}
 	
 	return foundProg;
@@ -238,5 +315,7 @@ const QORenderer::ProgramRec*		QORenderer::ProgramCache::FindProgram(
 */
 void	QORenderer::ProgramCache::AddProgram( const QORenderer::ProgramRec& inProgram )
 {
+	mProgramIndexOfHash.insert( std::make_pair( inProgram.mCharacteristic.Hash(),
+		mPrograms.size() ) );
 	mPrograms.push_back( inProgram );
 }
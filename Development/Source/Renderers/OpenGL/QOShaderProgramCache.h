@@ -58,6 +58,8 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <string>
 
 namespace QORenderer
 {
@@ -141,10 +143,40 @@ struct ProgramCharacteristic
 	void					swap( ProgramCharacteristic& ioOther );
 	
 	bool					operator==( const ProgramCharacteristic& inOther ) const;
+	
+	/*!
+		@function			Hash
+		@abstract			Hash value used to index the program cache.
+							Equal characteristics have equal hashes.
+	*/
+	std::size_t				Hash() const;
+	
+	/*!
+		@function			ToString
+		@abstract			Write the characteristic as one line of text,
+							as stored in a shader cache manifest.
+	*/
+	std::string				ToString() const;
+	
+	/*!
+		@function			FromString
+		@abstract			Read a characteristic written by ToString.
+		@result				False if the text could not be parsed.
+	*/
+	bool					FromString( const std::string& inText );
 };
 
 
 
+/*!
+	@typedef	UniformValues
+	@abstract	Values most recently given to the uniform variables of a
+				program, as raw 32-bit words, keyed by uniform location.
+*/
+typedef std::unordered_map< GLint, std::vector<TQ3Uns32> >	UniformValues;
+
+
+
 /*!
 	@struct		ProgramRec
 	@abstract	Structure holding a program ID, its characteristic data, a
@@ -219,6 +251,9 @@ struct ProgramRec
 	GLint			mAngleOfViewAttribLoc;			// float (radians)
 	GLint			mFisheyeMappingFuncAttribLoc;	// int (enumeration)
 	GLint			mFisheyeCroppingAttribLoc;		// int (enumeration)
+	
+	// Maintained by GLStateCache to drop redundant glUniform calls
+	mutable UniformValues	mUniformValues;
 };
 
 
@@ -271,6 +306,9 @@ private:
 
 	ProjectionToVertexShader	mVertexShaderOfProjection;
 	std::vector<ProgramRec>		mPrograms;
+	
+	// Indices into mPrograms, keyed by ProgramCharacteristic::Hash
+	std::unordered_multimap< std::size_t, std::size_t >	mProgramIndexOfHash;
 };
 
 
@@ -64,6 +64,7 @@
 #include "GLUtils.h"
 #include "CQ3ObjectRef_Gets.h"
 #include "E3Math.h"
+#include "E3GeometryTriMesh.h"
 
 #include <cmath>
 
@@ -128,14 +129,31 @@ static void ComputeFaceNormals( const TQ3TriMeshData& inTMData,
 /*!
 	@function	FindLitFaces
 	@abstract	Determine which of the triangles face toward the light.
+	@discussion	If the TriMesh has no face normals of its own but we have its
+				cached structure-of-arrays view, the view's precomputed face
+				planes are used rather than computing normals afresh.
 */
 static void FindLitFaces( const TQ3RationalPoint4D& inLightPos,
 						const TQ3TriMeshData& inTMData,
 						const TQ3Vector3D* inFaceNormals,
+						const TE3TriMeshSoA* inSoA,
 						const TQ3Matrix4x4& inLocalToCamera,
 						TQ3Uns8* outFlags )
 {
 	const TQ3Uns32 kNumFaces = inTMData.numTriangles;
+	TQ3Uns8 matrixFlip = E3Matrix4x4_Determinant( &inLocalToCamera ) < 0.0f;
+	TQ3Uns32	faceNum;
+	
+	if ( (inFaceNormals == nullptr) && (inSoA != nullptr) )
+	{
+		E3TriMeshSoA_FacesToward( *inSoA, inLightPos, outFlags );
+		
+		for (faceNum = 0; faceNum < kNumFaces; ++faceNum)
+		{
+			outFlags[ faceNum ] ^= matrixFlip;
+		}
+		return;
+	}
 
 	// Compute face normals if we do not have them.
 	E3FastArray<TQ3Vector3D>	faceNormals;
@@ -145,10 +163,7 @@ static void FindLitFaces( const TQ3RationalPoint4D& inLightPos,
 		inFaceNormals = &faceNormals[0];
 	}
 	
-	TQ3Uns8 matrixFlip = E3Matrix4x4_Determinant( &inLocalToCamera ) < 0.0f;
-	
 	TQ3Vector3D	toLight;
-	TQ3Uns32	faceNum;
 	
 	if (inLightPos.w == 0.0f)	// directional
 	{
@@ -585,7 +600,12 @@ void	QORenderer::ShadowMarker::CalcFacesAndEdgesForShadows(
 	
 	const TQ3Uns32	kNumFaces = inTMData.numTriangles;
 	mLitFaceFlags.resizeNotPreserving( kNumFaces );
-	FindLitFaces( inLocalLightPos, inTMData, inFaceNormals,
+	const TE3TriMeshSoA* theSoA = nullptr;
+	if ( (inTMObject != nullptr) && (inFaceNormals == nullptr) )
+	{
+		theSoA = E3TriMesh_GetSoA( inTMObject );
+	}
+	FindLitFaces( inLocalLightPos, inTMData, inFaceNormals, theSoA,
 		mMatrixState.GetLocalToCamera(), &mLitFaceFlags[0] );
 	
 	outFaces = inTMData.triangles;
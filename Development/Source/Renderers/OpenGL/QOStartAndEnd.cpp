@@ -119,6 +119,8 @@ TQ3Status	QORenderer::Renderer::StartFrame(
 	// Save draw context for access from StartPass
 	mDrawContextObject = inDrawContext;
 	
+	mFrameCounts.Reset();
+	
 	// Update draw context validation flags
 	TQ3XDrawContextValidation		drawContextFlags;
 	Q3XDrawContext_GetValidationFlags( inDrawContext, &drawContextFlags );
@@ -311,6 +313,9 @@ TQ3Status	QORenderer::Renderer::StartFrame(
 	// prevent clearing the depth buffer if we do not reset it.
 	GLDrawContext_SetDepthState( inDrawContext );
 	CHECK_GL_ERROR;
+	
+	// Other code may have changed OpenGL state since the last frame.
+	mGLState.Invalidate();
 
 	
 	// Tell light manager that a frame is starting
@@ -381,6 +386,9 @@ void		QORenderer::Renderer::StartPass(
 	mStyleState.mFill = kQ3FillStyleFilled;
 	mStyleState.mOrientation = kQ3OrientationStyleCounterClockwise;
 	mStyleState.mDepthCompare = kQ3DepthCompareFuncLess;
+	mStyleState.mWriteSwitch = kQ3WriteSwitchMaskDepth | kQ3WriteSwitchMaskColor;
+	mStyleState.mDepthRange.near = 0.0f;
+	mStyleState.mDepthRange.far = 1.0f;
 	mStyleState.mHilite = CQ3ObjectRef();	// i.e., nullptr
 	mStyleState.mIsCastingShadows = true;
 	mStyleState.mExplicitEdges = false;
@@ -400,10 +408,12 @@ void		QORenderer::Renderer::StartPass(
 	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );	// fill style
 	glColorMask( GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE );
 	GLDrawContext_SetDepthState( mDrawContextObject );
+	mGLState.Invalidate();
 	
 	mPPLighting.StartPass( inCamera );
 	mLights.StartPass( inView, inCamera, mRendererObject );
 	mTextures.StartPass();
+	mOpaqueQueue.StartPass();
 }
 
 static bool IsSwapWanted( TQ3ViewObject inView )
@@ -428,7 +438,7 @@ void	QORenderer::Renderer::RenderTransparent( TQ3ViewObject inView )
 	GLenum	dstFactor = GL_ONE_MINUS_SRC_ALPHA;
 	
 	// Ignore any mask set for shadowing
-	glDisable( GL_STENCIL_TEST );
+	mGLState.Disable( GL_STENCIL_TEST );
 
 	mLights.StartFrame( inView, false );
 	int passNum = 1;
@@ -465,6 +475,9 @@ TQ3ViewStatus		QORenderer::Renderer::EndPass(
 	// Flush any remaining triangles
 	mTriBuffer.Flush();
 	
+	// Draw opaque geometry that was queued for sorting
+	mOpaqueQueue.Flush( inView );
+	
 	// Transparency is drawn at the end of the last lighting pass.
 	// If there was only one lighting pass, we can do it now.
 	bool isFirstLightingPass = mLights.IsFirstPass();
@@ -534,5 +547,20 @@ TQ3ViewStatus		QORenderer::Renderer::EndPass(
 	Q3Object_SetProperty( mRendererObject, kQ3RendererPropertyPrimitivesRenderedCount,
 		sizeof(TQ3Uns64), &mNumPrimitivesRenderedInFrame );
 	
+	// Likewise report textures still being prepared in the background
+	TQ3Uns32	pendingTextures = mTextures.CountPendingTextures();
+	Q3Object_SetProperty( mRendererObject, kQ3RendererPropertyPendingTextureCount,
+		sizeof(pendingTextures), &pendingTextures );
+	
+	// and the buffer binds and draw calls made so far in this frame
+	Q3Object_SetProperty( mRendererObject, kQ3RendererPropertyBufferBindCount,
+		sizeof(TQ3Uns32), &mFrameCounts.mBufferBinds );
+	Q3Object_SetProperty( mRendererObject, kQ3RendererPropertyDrawCallCount,
+		sizeof(TQ3Uns32), &mFrameCounts.mDrawCalls );
+	Q3Object_SetProperty( mRendererObject, kQ3RendererPropertyStateChangeCount,
+		sizeof(TQ3Uns32), &mFrameCounts.mStateChanges );
+	Q3Object_SetProperty( mRendererObject, kQ3RendererPropertyElidedStateChangeCount,
+		sizeof(TQ3Uns32), &mFrameCounts.mElidedStateChanges );
+	
 	return allDone;
 }
@@ -48,6 +48,7 @@
 #include "QOTexture.h"
 #include "GLDrawContext.h"
 #include "GLTextureLoader.h"
+#include "GLTexturePrep.h"
 #include "GLUtils.h"
 #include "E3Shader.h"
 #include "QuesaCustomElements.h"
@@ -188,6 +189,7 @@ Texture::Texture(
 
 Texture::~Texture()
 {
+	mPrepQueue.reset();
 	FlushCache();
 }
 
@@ -198,6 +200,9 @@ void	Texture::FlushCache()
 		GLDrawContext_SetCurrent( mRenderer.GLContext(), kQ3False );
 		
 		GLTextureMgr_FlushUnreferencedTextures( mTextureCache );
+		
+		// A deleted texture name may be reused for a new texture.
+		mRenderer.GetGLState().InvalidateTextures();
 	}
 }
 
@@ -329,6 +334,33 @@ void	Texture::StartPass()
 	mState.Reset();
 	mPendingTextureRemoval = true;
 	mPendingEmissiveTextureRemoval = true;
+	UpdatePrepQueue();
+}
+
+
+/*!
+	@function			UpdatePrepQueue
+	@abstract			Create or delete the background texture preparation
+						queue according to the renderer property.
+*/
+void	Texture::UpdatePrepQueue()
+{
+	TQ3Boolean	wantBackgroundPrep = kQ3False;
+	Q3Object_GetProperty( mRenderer.GetQuesaRenderer(),
+		kQ3RendererPropertyBackgroundTexturePrep,
+		sizeof(wantBackgroundPrep), nullptr, &wantBackgroundPrep );
+	
+	if ( (wantBackgroundPrep == kQ3True) && (mPrepQueue.get() == nullptr) )
+	{
+		GLint	maxGLSize = 0;
+		glGetIntegerv( GL_MAX_TEXTURE_SIZE, &maxGLSize );
+		mPrepQueue.reset( new GLTexturePrepQueue(
+			static_cast<TQ3Uns32>(maxGLSize) ) );
+	}
+	else if ( (wantBackgroundPrep == kQ3False) && (mPrepQueue.get() != nullptr) )
+	{
+		mPrepQueue.reset();
+	}
 }
 
 
@@ -338,10 +370,25 @@ void	Texture::StartPass()
 */
 void	Texture::EndPass()
 {
+	if (mPrepQueue.get() != nullptr)
+	{
+		mPrepQueue->Purge();
+	}
 	FlushCache();
 }
 
 
+/*!
+	@function			CountPendingTextures
+	@abstract			Number of textures that are still being prepared in
+						the background.
+*/
+TQ3Uns32	Texture::CountPendingTextures() const
+{
+	return (mPrepQueue.get() == nullptr)? 0 : mPrepQueue->CountPending();
+}
+
+
 /*!
 	@function	CacheTexture
 	@abstract	Add a texture to the cache.
@@ -351,10 +398,40 @@ TQ3CachedTexturePtr		Texture::CacheTexture( TQ3TextureObject inTexture )
 	TQ3CachedTexturePtr	cacheRec = nullptr;
 	TQ3Boolean	convertAlpha = kQ3False;
 	
+	// A stale copy of the texture may just have been deleted, and loading
+	// binds the new texture directly.
+	mRenderer.GetGLState().InvalidateTextures();
+	
 	Q3Object_GetProperty( mRenderer.GetQuesaRenderer(), kQ3RendererPropertyConvertToPremultipliedAlpha,
 		sizeof(convertAlpha), nullptr, &convertAlpha );
 	
-	GLuint	textureName = GLTextureLoader( inTexture, convertAlpha, mRenderer.Funcs() );
+	GLuint	textureName = 0;
+	
+	if (mPrepQueue.get() != nullptr)
+	{
+		// If the texture has been prepared in the background, all that is left
+		// is the upload.  If it has not been requested yet, request it and
+		// draw untextured for now.  If preparation failed, load it the usual
+		// way below.
+		std::unique_ptr<GLPreparedTexture>	thePrepared;
+		if (mPrepQueue->TakeResult( inTexture, thePrepared ))
+		{
+			if (thePrepared.get() != nullptr)
+			{
+				textureName = GLTextureLoader_UploadPrepared( inTexture,
+					*thePrepared );
+			}
+		}
+		else if (mPrepQueue->Enqueue( inTexture, convertAlpha == kQ3True ))
+		{
+			return nullptr;
+		}
+	}
+	
+	if (textureName == 0)
+	{
+		textureName = GLTextureLoader( inTexture, convertAlpha, mRenderer.Funcs() );
+	}
 	
 	if (textureName != 0)
 	{
@@ -374,16 +451,17 @@ void	Texture::HandlePendingTextureRemoval()
 	if (mPendingTextureRemoval)
 	{
 		GLDrawContext_SetCurrent( mRenderer.GLContext(), kQ3False );
+		mRenderer.FlushCachedVBORun();
 		
-		glBindTexture( GL_TEXTURE_2D, 0 );
+		mRenderer.GetGLState().BindTexture2D( 0 );
 		
 		TQ3Matrix4x4 ident;
 		Q3Matrix4x4_SetIdentity( &ident );
 		mRenderer.Shader().SetTextureMatrix( ident );
 		
-		(*mRenderer.Funcs().glActiveTexture)( GL_TEXTURE1_ARB );
-		glBindTexture( GL_TEXTURE_2D, 0 );
-		(*mRenderer.Funcs().glActiveTexture)( GL_TEXTURE0_ARB );
+		mRenderer.GetGLState().ActiveTexture( GL_TEXTURE1_ARB );
+		mRenderer.GetGLState().BindTexture2D( 0 );
+		mRenderer.GetGLState().ActiveTexture( GL_TEXTURE0_ARB );
 
 		mRenderer.Shader().UpdateSpecularMapping( false );
 		
@@ -393,10 +471,11 @@ void	Texture::HandlePendingTextureRemoval()
 	if (mPendingEmissiveTextureRemoval)
 	{
 		GLDrawContext_SetCurrent( mRenderer.GLContext(), kQ3False );
+		mRenderer.FlushCachedVBORun();
 		
-		(*mRenderer.Funcs().glActiveTexture)( GL_TEXTURE2_ARB );
-		glBindTexture( GL_TEXTURE_2D, 0 );
-		(*mRenderer.Funcs().glActiveTexture)( GL_TEXTURE0_ARB );
+		mRenderer.GetGLState().ActiveTexture( GL_TEXTURE2_ARB );
+		mRenderer.GetGLState().BindTexture2D( 0 );
+		mRenderer.GetGLState().ActiveTexture( GL_TEXTURE0_ARB );
 
 		mRenderer.Shader().UpdateEmissiveMapping( false );
 		
@@ -415,6 +494,9 @@ void	Texture::SetCurrentTexture(
 #if 0//WIN32
 	Q3_MESSAGE_FMT("      +Texture::SetCurrentTexture");
 #endif
+	// Cached geometry waiting for a multi-draw call uses the old texture.
+	mRenderer.FlushCachedVBORun();
+	
 	if (inTexture == nullptr)	// disable texturing
 	{
 		mState.mIsTextureActive = false;
@@ -452,8 +534,8 @@ void	Texture::SetCurrentTexture(
 				(pixelType == kQ3PixelTypeARGB16));
 			mState.mIsTextureMipmapped = IsTextureMipmapped( inTexture );
 			
-			(*mRenderer.Funcs().glActiveTexture)( GL_TEXTURE0_ARB );
-			glBindTexture( GL_TEXTURE_2D, mState.mGLTextureObject );
+			mRenderer.GetGLState().ActiveTexture( GL_TEXTURE0_ARB );
+			mRenderer.GetGLState().BindTexture2D( mState.mGLTextureObject );
 			
 			mPendingTextureRemoval = false;
 			SetSpecularMap( inShader );
@@ -489,16 +571,16 @@ void	Texture::SetSpecularMap( TQ3ShaderObject inShader )
 				mTextureCache, shininessTexture.get() );
 			if (cachedTexture == nullptr)
 			{
-				(*mRenderer.Funcs().glActiveTexture)( GL_TEXTURE1_ARB );
+				mRenderer.GetGLState().ActiveTexture( GL_TEXTURE1_ARB );
 				cachedTexture = CacheTexture( shininessTexture.get() );
 			}
 			if (cachedTexture != nullptr)
 			{
 				GLuint textureName = GLTextureMgr_GetOpenGLTexture( cachedTexture );
-				(*mRenderer.Funcs().glActiveTexture)( GL_TEXTURE1_ARB );
-				glBindTexture( GL_TEXTURE_2D, textureName );
+				mRenderer.GetGLState().ActiveTexture( GL_TEXTURE1_ARB );
+				mRenderer.GetGLState().BindTexture2D( textureName );
 				SetOpenGLTexturingParameters();
-				(*mRenderer.Funcs().glActiveTexture)( GL_TEXTURE0_ARB );
+				mRenderer.GetGLState().ActiveTexture( GL_TEXTURE0_ARB );
 				mRenderer.Shader().UpdateSpecularMapping( true );
 			}
 		}
@@ -525,15 +607,15 @@ void	Texture::SetEmissiveMap( TQ3ShaderObject inShader )
 				mTextureCache, emissiveTexture.get() );
 			if (cachedTexture == nullptr)
 			{
-				(*mRenderer.Funcs().glActiveTexture)( GL_TEXTURE2_ARB );
+				mRenderer.GetGLState().ActiveTexture( GL_TEXTURE2_ARB );
 				cachedTexture = CacheTexture( emissiveTexture.get() );
 			}
 			if (cachedTexture != nullptr)
 			{
 				GLuint textureName = GLTextureMgr_GetOpenGLTexture( cachedTexture );
-				(*mRenderer.Funcs().glActiveTexture)( GL_TEXTURE2_ARB );
-				glBindTexture( GL_TEXTURE_2D, textureName );
-				(*mRenderer.Funcs().glActiveTexture)( GL_TEXTURE0_ARB );
+				mRenderer.GetGLState().ActiveTexture( GL_TEXTURE2_ARB );
+				mRenderer.GetGLState().BindTexture2D( textureName );
+				mRenderer.GetGLState().ActiveTexture( GL_TEXTURE0_ARB );
 				mRenderer.Shader().UpdateEmissiveMapping( true );
 				mPendingEmissiveTextureRemoval = false;
 			}
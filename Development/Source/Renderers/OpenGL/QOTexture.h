@@ -50,8 +50,11 @@
 #include "GLPrefix.h"
 #include "GLTextureManager.h"
 
+#include <memory>
 #include <vector>
 
+class GLTexturePrepQueue;
+
 //=============================================================================
 //      Class declaration
 //-----------------------------------------------------------------------------
@@ -152,6 +155,13 @@ public:
 		@abstract			Called by QORenderer at end of a pass for cleanup.
 	*/
 	void					EndPass();
+	
+	/*!
+		@function			CountPendingTextures
+		@abstract			Number of textures that are still being prepared in
+							the background.
+	*/
+	TQ3Uns32				CountPendingTextures() const;
 
 	
 	
@@ -168,6 +178,7 @@ private:
 									bool& outUseAlphaTest,
 									TQ3Float32& outAlphaTestThreshold );
 	void					FlushCache();
+	void					UpdatePrepQueue();
 	void					SetSpecularMap( TQ3ShaderObject inShader );
 	void					SetEmissiveMap( TQ3ShaderObject inShader );
 
@@ -178,6 +189,7 @@ private:
 	std::vector<GLubyte>	mGLFormatWork;
 	bool					mPendingTextureRemoval;
 	bool					mPendingEmissiveTextureRemoval;
+	std::unique_ptr<GLTexturePrepQueue>	mPrepQueue;
 };
 
 }
@@ -55,6 +55,7 @@
 
 #include <algorithm>
 #include <stdint.h>
+#include <string.h>
 
 using namespace QORenderer;
 
@@ -87,15 +88,26 @@ namespace
 	
 	const TQ3Uns32				kRenderGroupReserve = 10000;
 	const TQ3Uns32				kBlockUnionReserve = 1000;
+	
+	// Below this many primitives, a comparison sort beats the radix sort.
+	const TQ3Uns32				kRadixSortMinimum = 64;
+	
+	// A state key of zero means that the state must be compared in full.
+	const TQ3Uns32				kUnknownStateKey = 0;
 
-	struct PtrCompare
+	struct IndexDepthCompare
 	{
+		explicit				IndexDepthCompare( const TransparentPrim* inArena )
+									: mArena( inArena ) {}
+		
 		inline
-		bool	operator()( const TransparentPrim* inOne,
-							const TransparentPrim* inTwo ) const
+		bool	operator()( TQ3Uns32 inOne, TQ3Uns32 inTwo ) const
 					{
-						return inOne->mSortingDepth < inTwo->mSortingDepth;
+						return mArena[ inOne ].mSortingDepth <
+							mArena[ inTwo ].mSortingDepth;
 					}
+		
+		const TransparentPrim*	mArena;
 	};
 	
 	struct NonNullBlock
@@ -185,6 +197,21 @@ static float CalcPrimDepth( const TransparentPrim& inPrim )
 	return theDepth;
 }
 
+/*!
+	@function	DepthSortKey
+	@abstract	Map a float to an unsigned integer, such that unsigned integer
+				order agrees with float order.
+	@discussion	For a nonnegative float we just set the sign bit, and for a
+				negative float we flip all the bits, so that more negative
+				values get smaller keys.
+*/
+static inline TQ3Uns32 DepthSortKey( float inDepth )
+{
+	TQ3Uns32 bits;
+	memcpy( &bits, &inDepth, sizeof(bits) );
+	return ((bits & 0x80000000U) != 0)? ~bits : (bits | 0x80000000U);
+}
+
 static TQ3ColorRGB EmissiveColor( const TransparentPrim& inPrim )
 {
 	TQ3ColorRGB theColor;
@@ -326,11 +353,22 @@ static bool IsSameStateForDepth( const TransparentPrim& inA, const TransparentPr
 
 TransparentBlock::TransparentBlock()
 	: mVisitOrder( -1 )
-	, mHasUniformVertexFlags( false )
 {
 	Q3FastBoundingBox_Reset( &mFrustumBounds );
 }
 
+/*!
+	@function	Reset
+	@abstract	Empty the block so that it can be reused, keeping the capacity
+				of its index array.
+*/
+void	TransparentBlock::Reset()
+{
+	mPrimIndices.clear();
+	Q3FastBoundingBox_Reset( &mFrustumBounds );
+	mVisitOrder = -1;
+}
+
 bool	TransparentBlock::Intersects( const TransparentBlock& inOther ) const
 {
 	TQ3BoundingBox commonBox;
@@ -342,18 +380,16 @@ void	TransparentBlock::Union( const TransparentBlock& inOther )
 {
 	E3BoundingBox_Union( &mFrustumBounds, &inOther.mFrustumBounds, &mFrustumBounds );
 	
-	TQ3Uns32 oldSize = mPrims.size();
-	TQ3Uns32 newSize = oldSize + inOther.mPrims.size();
-	if (mPrims.capacity() < newSize)
+	TQ3Uns32 oldSize = mPrimIndices.size();
+	TQ3Uns32 newSize = oldSize + inOther.mPrimIndices.size();
+	if (mPrimIndices.capacity() < newSize)
 	{
 		// If we must grow it, make it worth our while.
-		mPrims.reserve( E3Num_Max( 2 * newSize, kBlockUnionReserve ) );
+		mPrimIndices.reserve( E3Num_Max( 2 * newSize, kBlockUnionReserve ) );
 	}
-	mPrims.resize( newSize );
-	E3Memory_Copy( &inOther.mPrims[0], &mPrims[oldSize],
-		inOther.mPrims.size() * sizeof(TransparentPrim) );
-	
-	mHasUniformVertexFlags = false;
+	mPrimIndices.resize( newSize );
+	E3Memory_Copy( &inOther.mPrimIndices[0], &mPrimIndices[oldSize],
+		inOther.mPrimIndices.size() * sizeof(TQ3Uns32) );
 }
 
 /*!
@@ -378,32 +414,65 @@ bool	TransparentBlock::Occludes( const TransparentBlock& inOther ) const
 			(mFrustumBounds.min.z > inOther.mFrustumBounds.max.z);
 }
 
+#pragma mark -
+
+TransBuffer::TransBuffer( Renderer& inRenderer,
+						PerPixelLighting& inPPLighting )
+	: mRenderer( inRenderer )
+	, mPerPixelLighting( inPPLighting )
+	, mLastStateKey( kUnknownStateKey )
+	, mIsSortNeeded( false )
+{
+}
+
+TransBuffer::~TransBuffer()
+{
+	for (TransparentBlock* aBlock : mBlocks)
+	{
+		delete aBlock;
+	}
+	for (TransparentBlock* aBlock : mSpareBlocks)
+	{
+		delete aBlock;
+	}
+}
+
 /*!
-	@function	SortPrimPtrs
-	@abstract	Sort pointers to the primitives, in back to front order.
+	@function	NewBlock
+	@abstract	Get an empty block, reusing one from a previous frame if
+				possible.
 */
-void	TransparentBlock::SortPrimPtrs()
+TransparentBlock*	TransBuffer::NewBlock()
 {
-	const TQ3Uns32 kNumPrims = static_cast<TQ3Uns32>(mPrims.size());
-	mPrimPtrs.resize( kNumPrims );
+	TransparentBlock* theBlock;
 	
-	for (TQ3Uns32 i = 0; i < kNumPrims; ++i)
+	if (mSpareBlocks.empty())
+	{
+		theBlock = new TransparentBlock;
+	}
+	else
 	{
-		mPrimPtrs[i] = &mPrims[i];
+		theBlock = mSpareBlocks[ mSpareBlocks.size() - 1 ];
+		mSpareBlocks.resize( mSpareBlocks.size() - 1 );
 	}
 	
-	PtrCompare	comparator;
-	const TransparentPrim**	ptrArray = &mPrimPtrs[0];
-	std::sort( ptrArray, ptrArray + kNumPrims, comparator );
+	return theBlock;
 }
 
-#pragma mark -
+void	TransBuffer::RecycleBlock( TransparentBlock* inBlock )
+{
+	inBlock->Reset();
+	mSpareBlocks.push_back( inBlock );
+}
 
-TransBuffer::TransBuffer( Renderer& inRenderer,
-						PerPixelLighting& inPPLighting )
-	: mRenderer( inRenderer )
-	, mPerPixelLighting( inPPLighting )
+TQ3Uns32	TransBuffer::NewStateKey()
 {
+	mLastStateKey += 1;
+	if (mLastStateKey == kUnknownStateKey)	// wrapped around
+	{
+		mLastStateKey += 1;
+	}
+	return mLastStateKey;
 }
 
 /*!
@@ -551,15 +620,31 @@ void	TransBuffer::AddPrim(
 	thePrim.mSpecularColor = *mRenderer.mGeomState.specularColor;
 	thePrim.mSpecularControl = mRenderer.mCurrentSpecularControl;
 	
+	// Consecutive primitives with the same state share a key, which lets the
+	// drawing loops skip most full state comparisons.
+	const TransparentPrim* prevPrim = mPrimArena.empty()? nullptr :
+		&mPrimArena[ mPrimArena.size() - 1 ];
+	if ( (prevPrim != nullptr) &&
+		(prevPrim->mStateKey != kUnknownStateKey) &&
+		IsSameState( thePrim, *prevPrim ) )
+	{
+		thePrim.mStateKey = prevPrim->mStateKey;
+	}
+	else
+	{
+		thePrim.mStateKey = NewStateKey();
+	}
+	
 	// Make a new block.
-	TransparentBlock* theBlock = new TransparentBlock;
+	TransparentBlock* theBlock = NewBlock();
 	
 	// Compute bounds in frustum space
 	E3BoundingBox_SetFromPoints3D( &theBlock->mFrustumBounds, &mWorkFrustumPts[0],
 		inNumVerts, sizeof(TQ3Point3D) );
 	
 	// Record the primitive.
-	theBlock->mPrims.push_back( thePrim );
+	theBlock->mPrimIndices.push_back( mPrimArena.size() );
+	mPrimArena.push_back( thePrim );
 	mIsSortNeeded = true;
 	
 	AddBlock( theBlock );
@@ -599,16 +684,16 @@ void	TransBuffer::AddBlock( TransparentBlock* ioBlock )
 				mBlocks[i] = nullptr;
 				
 				// Whichever block is bigger will eat the other.
-				if (olderBlock->mPrims.size() > ioBlock->mPrims.size())
+				if (olderBlock->mPrimIndices.size() > ioBlock->mPrimIndices.size())
 				{
 					olderBlock->Union( *ioBlock );
-					delete ioBlock;
+					RecycleBlock( ioBlock );
 					ioBlock = olderBlock;
 				}
 				else
 				{
 					ioBlock->Union( *olderBlock );
-					delete olderBlock;
+					RecycleBlock( olderBlock );
 				}
 
 				needAnotherPass = true;
@@ -800,12 +885,15 @@ void	TransBuffer::AddTriMesh(
 	TQ3Uns32 cameraToFrustumIndex = static_cast<TQ3Uns32>(mCameraToFrustumMatrices.size() - 1);
 	
 	// Make a new block.
-	TransparentBlock* theBlock = new TransparentBlock;
-	theBlock->mPrims.reserve( inGeomData.numTriangles );
+	TransparentBlock* theBlock = NewBlock();
+	theBlock->mPrimIndices.reserve( inGeomData.numTriangles );
 	
-	if ((inData.faceColor == nullptr) || (inData.vertColor != nullptr))
+	// Grow the arena at most once for this TriMesh, but geometrically, so that
+	// a frame full of TriMeshes does not copy the arena once for each of them.
+	TQ3Uns32 neededPrims = mPrimArena.size() + inGeomData.numTriangles;
+	if (neededPrims > mPrimArena.capacity())
 	{
-		theBlock->mHasUniformVertexFlags = true;
+		mPrimArena.reserve( E3Num_Max( neededPrims, 2 * mPrimArena.capacity() ) );
 	}
 	
 	// Find the bounds in frustum space.
@@ -863,6 +951,16 @@ void	TransBuffer::AddTriMesh(
 		thePrim.mUVTransformIndex = static_cast<TQ3Uns32>(mUVTransforms.size() - 1);
 	}
 	
+	// All the triangles share one state if the vertex flags are uniform.
+	if ((inData.faceColor == nullptr) || (inData.vertColor != nullptr))
+	{
+		thePrim.mStateKey = NewStateKey();
+	}
+	else
+	{
+		thePrim.mStateKey = kUnknownStateKey;
+	}
+	
 	// Add the primitives, filling in the varying fields mVerts, mSortingDepth.
 	for (TQ3Uns32 i = 0; i < inGeomData.numTriangles; ++i)
 	{
@@ -880,7 +978,8 @@ void	TransBuffer::AddTriMesh(
 			thePrim.mVerts[2].uv = inData.vertUV[ vertIndices[2] ];
 		}
 		thePrim.mSortingDepth = CalcPrimDepth( thePrim );
-		theBlock->mPrims.push_back( thePrim );
+		theBlock->mPrimIndices.push_back( mPrimArena.size() );
+		mPrimArena.push_back( thePrim );
 		mIsSortNeeded = true;
 	}
 	
@@ -918,18 +1017,104 @@ void	TransBuffer::SortIndices()
 		//Q3_LOG_FMT( "TransBuffer::SortIndices 1" );
 		SortBlocks();
 		//Q3_LOG_FMT( "TransBuffer::SortIndices 2" );
-		SortPrimPtrsInEachBlock();
+		SortPrimsInEachBlock();
 		//Q3_LOG_FMT( "TransBuffer::SortIndices 3" );
 
 		mIsSortNeeded = false;
 	}
 }
 
-void	TransBuffer::SortPrimPtrsInEachBlock()
+void	TransBuffer::SortPrimsInEachBlock()
 {
 	for (TransparentBlock* aBlock : mBlocks)
 	{
-		aBlock->SortPrimPtrs();
+		SortBlockPrims( *aBlock );
+	}
+}
+
+/*!
+	@function	SortBlockPrims
+	@abstract	Sort the primitive indices of a block in back to front order.
+	@discussion	Large blocks are sorted by an LSD radix sort on the bits of the
+				sorting depth, one byte per pass, using scratch arrays that
+				persist between frames.  A pass is skipped if all keys have
+				the same byte in that position, which is common for the high
+				bytes since the depths of one block tend to be close together.
+*/
+void	TransBuffer::SortBlockPrims( TransparentBlock& ioBlock )
+{
+	const TQ3Uns32 kNumPrims = ioBlock.mPrimIndices.size();
+	if (kNumPrims < 2)
+	{
+		return;
+	}
+	
+	if (kNumPrims < kRadixSortMinimum)
+	{
+		std::stable_sort( &ioBlock.mPrimIndices[0],
+			&ioBlock.mPrimIndices[0] + kNumPrims,
+			IndexDepthCompare( &mPrimArena[0] ) );
+		return;
+	}
+	
+	mSortKeys.resizeNotPreserving( kNumPrims );
+	mSortKeysAlt.resizeNotPreserving( kNumPrims );
+	mSortIndicesAlt.resizeNotPreserving( kNumPrims );
+	
+	// Compute the keys and the histograms for all 4 passes at once.
+	TQ3Uns32	counts[4][256];
+	memset( counts, 0, sizeof(counts) );
+	TQ3Uns32 i;
+	for (i = 0; i < kNumPrims; ++i)
+	{
+		TQ3Uns32 theKey = DepthSortKey(
+			mPrimArena[ ioBlock.mPrimIndices[i] ].mSortingDepth );
+		mSortKeys[i] = theKey;
+		counts[0][ theKey & 0xFF ] += 1;
+		counts[1][ (theKey >> 8) & 0xFF ] += 1;
+		counts[2][ (theKey >> 16) & 0xFF ] += 1;
+		counts[3][ theKey >> 24 ] += 1;
+	}
+	
+	TQ3Uns32*	srcKeys = &mSortKeys[0];
+	TQ3Uns32*	srcIndices = &ioBlock.mPrimIndices[0];
+	TQ3Uns32*	dstKeys = &mSortKeysAlt[0];
+	TQ3Uns32*	dstIndices = &mSortIndicesAlt[0];
+	
+	for (TQ3Uns32 pass = 0; pass < 4; ++pass)
+	{
+		const TQ3Uns32 kShift = 8 * pass;
+		TQ3Uns32* passCounts = counts[pass];
+		
+		if (passCounts[ (srcKeys[0] >> kShift) & 0xFF ] == kNumPrims)
+		{
+			continue;
+		}
+		
+		// Convert counts to starting offsets.
+		TQ3Uns32 offset = 0;
+		for (i = 0; i < 256; ++i)
+		{
+			TQ3Uns32 theCount = passCounts[i];
+			passCounts[i] = offset;
+			offset += theCount;
+		}
+		
+		for (i = 0; i < kNumPrims; ++i)
+		{
+			TQ3Uns32 dest = passCounts[ (srcKeys[i] >> kShift) & 0xFF ]++;
+			dstKeys[ dest ] = srcKeys[i];
+			dstIndices[ dest ] = srcIndices[i];
+		}
+		
+		std::swap( srcKeys, dstKeys );
+		std::swap( srcIndices, dstIndices );
+	}
+	
+	if (srcIndices != &ioBlock.mPrimIndices[0])
+	{
+		E3Memory_Copy( srcIndices, &ioBlock.mPrimIndices[0],
+			kNumPrims * sizeof(TQ3Uns32) );
 	}
 }
 
@@ -1000,9 +1185,10 @@ void	TransBuffer::Cleanup()
 	
 	for (TransparentBlock* aBlock :  mBlocks)
 	{
-		delete aBlock;
+		RecycleBlock( aBlock );
 	}
 	mBlocks.clear();
+	mPrimArena.clear();
 }
 
 void	TransBuffer::InitGLState( TQ3ViewObject inView )
@@ -1017,7 +1203,7 @@ void	TransBuffer::InitGLState( TQ3ViewObject inView )
 	mCurCameraToFrustumIndex = UINT32_MAX;
 
 	// We also enable blending
-	glEnable( GL_BLEND );
+	mRenderer.GetGLState().Enable( GL_BLEND );
 	
     // The transparent pass does not need to write to the depth buffer, since it
     // is done after opaque stuff and is depth-sorted, but we will do depth testing.
@@ -1025,7 +1211,7 @@ void	TransBuffer::InitGLState( TQ3ViewObject inView )
     // change that.  Note that since we are not writing to the depth buffer, we
     // can continue to use the same depth comparison function when adding
     // specular highlights.
-	glDepthMask( GL_FALSE );
+	mRenderer.GetGLState().DepthMask( GL_FALSE );
 	
 	mIsLightingEnabled = true;
 	mIsSortNeeded = false;
@@ -1039,7 +1225,7 @@ void	TransBuffer::InitGLState( TQ3ViewObject inView )
 	TQ3BackfacingStyle	theBackfacing = kQ3BackfacingStyleRemove;
 	mRenderer.UpdateBackfacingStyle( &theBackfacing );
 	
-	glBlendFunc( mSrcBlendFactor, mDstBlendFactor );
+	mRenderer.GetGLState().BlendFunc( mSrcBlendFactor, mDstBlendFactor );
 
 	mCurTexture = UINT32_MAX;	// force initial update
 	mPerPixelLighting.UpdateTexture( false );
@@ -1078,7 +1264,7 @@ void	TransBuffer::UpdateTexture( const TransparentPrim& inPrim )
 		
 		if (mCurTexture != 0)
 		{
-			glBindTexture( GL_TEXTURE_2D, mCurTexture );
+			mRenderer.GetGLState().BindTexture2D( mCurTexture );
 		}
 		
 		mPerPixelLighting.UpdateTexture( mCurTexture != 0 );
@@ -1420,15 +1606,16 @@ void	TransBuffer::DrawTransparency( TQ3ViewObject inView,
 
 		for (TransparentBlock* block : mBlocks)
 		{
-			for (TQ3Uns32 primNum = 0; primNum < block->mPrims.size(); ++primNum)
+			for (TQ3Uns32 primIndex : block->mPrimIndices)
 			{
-				const TransparentPrim& thePrim( *block->mPrimPtrs[primNum] );
+				const TransparentPrim& thePrim( mPrimArena[ primIndex ] );
 				if (gpLeader == nullptr)
 				{
 					gpLeader = &thePrim;
 					mRenderGroup.push_back( gpLeader );
 				}
-				else if ( ((primNum > 0) && block->mHasUniformVertexFlags) ||
+				else if ( ( (thePrim.mStateKey != kUnknownStateKey) &&
+						(thePrim.mStateKey == gpLeader->mStateKey) ) ||
 					IsSameState( thePrim, *gpLeader ) )
 				{
 					mRenderGroup.push_back( &thePrim );
@@ -1474,26 +1661,26 @@ void	TransBuffer::InitGLStateForDepth( TQ3ViewObject inView,
 	// Turn off unneeded fragment operations
 	mPerPixelLighting.UpdateIllumination( kQ3IlluminationTypeNULL );
 	mPerPixelLighting.UpdateTexture( false );
-	glDisable( GL_BLEND );
+	mRenderer.GetGLState().Disable( GL_BLEND );
 	mCurTexture = UINT32_MAX;
 	mCurUVTransformIndex = UINT32_MAX;
 	mCurUBoundary = kQ3ShaderUVBoundarySize32;
 	mCurVBoundary = kQ3ShaderUVBoundarySize32;
-	glDisable( GL_DITHER );
+	mRenderer.GetGLState().Disable( GL_DITHER );
 	
 	// Turn off writing to the color buffer
 	glColorMask( GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE );
 	
 	// Turn on writing to the depth buffer
-	glDepthMask( GL_TRUE );
-	glEnable( GL_DEPTH_TEST );
+	mRenderer.GetGLState().DepthMask( GL_TRUE );
+	mRenderer.GetGLState().Enable( GL_DEPTH_TEST );
 	E3View_State_SetStyleDepthCompare( inView, kQ3DepthCompareFuncLessEqual );
 	
 	// Even though we use GL_LEQUAL, and the depths produced by the depth pass
 	// should be the same as the depths produced by the transparency pass,
 	// I was getting the transparent stuff partially masked out in some cases.
 	// So move the depth a tad deeper.
-	glEnable( GL_POLYGON_OFFSET_FILL );
+	mRenderer.GetGLState().Enable( GL_POLYGON_OFFSET_FILL );
 	glPolygonOffset( 1.0f, 1.0f );
 
 	// Set up alpha test
@@ -1538,15 +1725,16 @@ void	TransBuffer::DrawDepth( TQ3ViewObject inView )
 
 		for (TransparentBlock* block : mBlocks)
 		{
-			for (TQ3Uns32 primNum = 0; primNum < block->mPrims.size(); ++primNum)
+			for (TQ3Uns32 primIndex : block->mPrimIndices)
 			{
-				const TransparentPrim& thePrim( *block->mPrimPtrs[primNum] );
+				const TransparentPrim& thePrim( mPrimArena[ primIndex ] );
 				if (gpLeader == nullptr)
 				{
 					gpLeader = &thePrim;
 					mRenderGroup.push_back( gpLeader );
 				}
-				else if ( ((primNum > 0) && block->mHasUniformVertexFlags) ||
+				else if ( ( (thePrim.mStateKey != kUnknownStateKey) &&
+						(thePrim.mStateKey == gpLeader->mStateKey) ) ||
 					IsSameStateForDepth( thePrim, *gpLeader ) )
 				{
 					mRenderGroup.push_back( &thePrim );
@@ -1567,7 +1755,7 @@ void	TransBuffer::DrawDepth( TQ3ViewObject inView )
 		}
 		
 		// Restore GL state
-		glDisable( GL_POLYGON_OFFSET_FILL );
+		mRenderer.GetGLState().Disable( GL_POLYGON_OFFSET_FILL );
 		glColorMask( GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE );
 	}
 }
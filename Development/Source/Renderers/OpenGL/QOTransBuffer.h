@@ -89,6 +89,10 @@ struct TransparentPrim
 	float				mSpecularControl;
 	TQ3Uns32			mCameraToFrustumIndex;
 	TQ3Uns32			mStyleIndex;
+	
+	// Primitives with the same nonzero state key are known to satisfy
+	// IsSameState.  Zero means that a full comparison is needed.
+	TQ3Uns32			mStateKey;
 };
 
 /*!
@@ -97,6 +101,12 @@ struct TransparentPrim
 	@abstract			Buffer for a group of transparent primitives, whose
 						bounding box in frustum space should be disjoint from
 						each other such block.
+	
+	@discussion			The primitives themselves live in an arena owned by the
+						TransBuffer, and the block just records their indices,
+						so that merging blocks does not copy primitives.
+						Blocks are recycled from frame to frame, so their
+						arrays keep their capacity.
 */
 class TransparentBlock
 {
@@ -104,18 +114,16 @@ public:
 						TransparentBlock();
 						~TransparentBlock() {}
 	
+	void				Reset();
+	
 	bool				Intersects( const TransparentBlock& inOther ) const;
 	void				Union( const TransparentBlock& inOther );
 	
 	bool				Occludes( const TransparentBlock& inOther ) const;
-	
-	void				SortPrimPtrs();
 						
-	E3FastArray<TransparentPrim>			mPrims;
+	E3FastArray<TQ3Uns32>					mPrimIndices;
 	TQ3BoundingBox							mFrustumBounds;
-	E3FastArray<const TransparentPrim*>		mPrimPtrs;
 	TQ3Int32								mVisitOrder;
-	bool									mHasUniformVertexFlags;
 
 private:
 						TransparentBlock( const TransparentBlock& inOther );
@@ -140,6 +148,8 @@ public:
 											Renderer& inRenderer,
 											PerPixelLighting& inPPLighting );
 									
+									~TransBuffer();
+									
 	void							AddTriangle(
 											const Vertex* inVertices );
 
@@ -171,13 +181,17 @@ private:
 											const Vertex* inVertices );
 
 	void							AddBlock( TransparentBlock* ioBlock );
+	TransparentBlock*				NewBlock();
+	void							RecycleBlock( TransparentBlock* inBlock );
+	TQ3Uns32						NewStateKey();
 
 	void							TransformPointsToCameraSpace(
 											const TQ3TriMeshData& inGeomData );
 	bool							FindPointsInFrontOfCamera();
 	void							RemoveBadFrustumPoints();
 
-	void							SortPrimPtrsInEachBlock();
+	void							SortPrimsInEachBlock();
+	void							SortBlockPrims( TransparentBlock& ioBlock );
 	void							SortBlocks();
 	void							SearchBlock( TQ3Uns32 inToVisit,
 												TQ3Int32& ioNextID );
@@ -227,7 +241,11 @@ private:
 	Renderer&						mRenderer;
 	PerPixelLighting&				mPerPixelLighting;
 	
-	// Buffers used when accumulating primitives
+	// Buffers used when accumulating primitives.  None of these can use the
+	// view's frame scratch memory, which E3View_StartRendering resets at the
+	// start of every pass, because primitives gathered in the first pass are
+	// drawn at the end of the last lighting pass.  Instead they are cleared
+	// without shrinking, so after the first frame they stop allocating.
 	std::vector<TQ3Matrix4x4>		mCameraToFrustumMatrices;
 	std::vector<TQ3Matrix3x3>		mUVTransforms;
 	E3FastArray<TQ3Point3D>			mWorkCameraPts;
@@ -238,6 +256,15 @@ private:
 	E3FastArray<TransparentBlock*>	mBlocks;
 	E3FastArray<PrimStyleState>		mStyles;
 	
+	// Frame-persistent storage: cleared at the end of each frame, but keeping
+	// its capacity, so that a steady scene does not allocate.
+	E3FastArray<TransparentPrim>	mPrimArena;
+	E3FastArray<TransparentBlock*>	mSpareBlocks;
+	E3FastArray<TQ3Uns32>			mSortKeys;
+	E3FastArray<TQ3Uns32>			mSortKeysAlt;
+	E3FastArray<TQ3Uns32>			mSortIndicesAlt;
+	TQ3Uns32						mLastStateKey;
+	
 	// State used when flushing (drawing) primitives
 	bool							mIsLightingEnabled;
 	bool							mIsSortNeeded;
@@ -288,19 +288,19 @@ void	QORenderer::Renderer::UpdateBackfacingStyle(
 	switch (mStyleState.mBackfacing)
 	{
 		case kQ3BackfacingStyleRemove:
-			glCullFace( GL_BACK );
-			glEnable( GL_CULL_FACE );
+			mGLState.CullFace( GL_BACK );
+			mGLState.Enable( GL_CULL_FACE );
 			break;
 
 		case kQ3BackfacingStyleRemoveFront:
-			glCullFace( GL_FRONT );
-			glEnable( GL_CULL_FACE );
+			mGLState.CullFace( GL_FRONT );
+			mGLState.Enable( GL_CULL_FACE );
 			break;
 		
 		default:
 		case kQ3BackfacingStyleBoth:
 		case kQ3BackfacingStyleFlip:
-			glDisable( GL_CULL_FACE );
+			mGLState.Disable( GL_CULL_FACE );
 			break;
 	}
 
@@ -369,12 +369,12 @@ void	QORenderer::Renderer::UpdateOrientationStyle(
 	switch (mStyleState.mOrientation)
 	{
 		case kQ3OrientationStyleClockwise:
-			glFrontFace( GL_CW );
+			mGLState.FrontFace( GL_CW );
 			break;
 
 		case kQ3OrientationStyleCounterClockwise:
 		default:
-			glFrontFace( GL_CCW );
+			mGLState.FrontFace( GL_CCW );
 			break;
 	}
 }
@@ -425,11 +425,11 @@ void	QORenderer::Renderer::UpdateAntiAliasStyle(
 
 
 	// Turn everything off
-	glDisable( GL_LINE_SMOOTH );
-	glDisable( GL_POLYGON_SMOOTH );
+	mGLState.Disable( GL_LINE_SMOOTH );
+	mGLState.Disable( GL_POLYGON_SMOOTH );
 	if (mGLExtensions.multiSample)
 	{
-		glDisable( GL_MULTISAMPLE_ARB );
+		mGLState.Disable( GL_MULTISAMPLE_ARB );
 	}
 
 
@@ -440,7 +440,7 @@ void	QORenderer::Renderer::UpdateAntiAliasStyle(
 		{
 			if (mGLExtensions.multiSample)
 			{
-				glEnable( GL_MULTISAMPLE_ARB );
+				mGLState.Enable( GL_MULTISAMPLE_ARB );
 			}
 		}
 		else
@@ -448,12 +448,12 @@ void	QORenderer::Renderer::UpdateAntiAliasStyle(
 			if ( ((inStyleData->mode & kQ3AntiAliasModeMaskEdges) != 0) &&
 				mAllowLineSmooth )
 			{
-				glEnable( GL_LINE_SMOOTH );
+				mGLState.Enable( GL_LINE_SMOOTH );
 			}
 			
 			if ( (inStyleData->mode & kQ3AntiAliasModeMaskFilled) != 0 )
 			{
-				glEnable( GL_POLYGON_SMOOTH );
+				mGLState.Enable( GL_POLYGON_SMOOTH );
 			}
 		}
 	}
@@ -535,11 +535,11 @@ void	QORenderer::Renderer::UpdateReceiveShadowsStyle(
 		
 		if (inStyleData) // do receive shadows
 		{
-			glEnable( GL_STENCIL_TEST );
+			mGLState.Enable( GL_STENCIL_TEST );
 		}
 		else // do not receive shadows
 		{
-			glDisable( GL_STENCIL_TEST );
+			mGLState.Disable( GL_STENCIL_TEST );
 		}
 	}
 }
@@ -570,6 +570,8 @@ void	QORenderer::Renderer::UpdateDepthRangeStyle(
 	
 	
 	mTriBuffer.Flush();
+	
+	mStyleState.mDepthRange = inStyleData;
 
 	glDepthRange( inStyleData.near, inStyleData.far );
 }
@@ -586,9 +588,11 @@ void	QORenderer::Renderer::UpdateWriteSwitchStyle(
 	
 	mTriBuffer.Flush();
 	
+	mStyleState.mWriteSwitch = inStyleData;
+	
 	GLboolean depthMask = ((inStyleData & kQ3WriteSwitchMaskDepth) != 0)?
 		GL_TRUE : GL_FALSE;
-	glDepthMask( depthMask );
+	mGLState.DepthMask( depthMask );
 	
 	GLboolean colorMask = ((inStyleData & kQ3WriteSwitchMaskColor) != 0)?
 		GL_TRUE : GL_FALSE;
@@ -646,14 +650,14 @@ void	QORenderer::Renderer::UpdateDepthCompareStyle(
 			break;
 	}
 	
-	glDepthFunc( func );
+	mGLState.DepthFunc( func );
 	
 	if (inStyleData == kQ3DepthCompareFuncAlwaysPass)
 	{
-		glDisable( GL_DEPTH_TEST );
+		mGLState.Disable( GL_DEPTH_TEST );
 	}
 	else
 	{
-		glEnable( GL_DEPTH_TEST );
+		mGLState.Enable( GL_DEPTH_TEST );
 	}
 }
@@ -5985,6 +5985,234 @@ Test_Q3BoundingSphere_UnionRationalPoint4D()
 
 
 
+//=============================================================================
+//	Vector Kernel Accuracy
+//-----------------------------------------------------------------------------
+//		When Quesa is built with QUESA_USE_SIMD_MATH, the matrix, quaternion
+//		and transform-array routines use SSE or NEON. These tests compare them
+//		with straightforward scalar versions over many random inputs, and
+//		report the number of results that differ and the largest difference.
+//		Any difference from the scalar code is a failure, and makes the
+//		program exit with a nonzero status. Build both this program and
+//		Quesa with -ffp-contract=off where the compiler would otherwise fuse
+//		the scalar multiplies and adds.
+//-----------------------------------------------------------------------------
+#pragma mark -
+const int kAccuracyTrials = 100000;
+
+static int gAccuracyFailures = 0;
+
+static float
+RandomFloat()
+{
+	return (float) (rand() % 20001 - 10000) / 1000.0f;
+}
+
+static void
+RandomMatrix(TQ3Matrix4x4& matrix4x4, bool affine)
+{
+	for (int i = 0; i < 4; ++i)
+		for (int j = 0; j < 4; ++j)
+			matrix4x4.value[i][j] = RandomFloat();
+
+	if (affine)
+	{
+		matrix4x4.value[0][3] = matrix4x4.value[1][3] = matrix4x4.value[2][3] = 0.0f;
+		matrix4x4.value[3][3] = 1.0f;
+	}
+}
+
+//	A result is a mismatch if it differs from the expected value by more
+//	than the tolerance, which is 0 unless there is no exact value to expect.
+class AccuracyStats
+{
+public:
+	AccuracyStats(float inTolerance = 0.0f)
+		: tolerance(inTolerance), mismatches(0), maxError(0.0f) {}
+
+	void Compare(const float* actual, const float* expected, int count)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			float error = fabs(actual[i] - expected[i]);
+			if ((actual[i] != expected[i]) && !(error <= tolerance))
+				++mismatches;
+			if (error > maxError)
+				maxError = error;
+		}
+	}
+
+	void Report(void) const
+	{
+		cout << "    mismatches: " << mismatches << ", max error: " << maxError;
+		if (mismatches != 0)
+		{
+			cout << "  FAILED";
+			++gAccuracyFailures;
+		}
+		cout << endl;
+	}
+
+private:
+	float	tolerance;
+	long	mismatches;
+	float	maxError;
+};
+
+static void
+Reference_Matrix4x4_Multiply(const TQ3Matrix4x4& a, const TQ3Matrix4x4& b, TQ3Matrix4x4& result)
+{
+	for (int i = 0; i < 4; ++i)
+		for (int j = 0; j < 4; ++j)
+			result.value[i][j] = a.value[i][0]*b.value[0][j] + a.value[i][1]*b.value[1][j] +
+								 a.value[i][2]*b.value[2][j] + a.value[i][3]*b.value[3][j];
+}
+
+static void
+Reference_RationalPoint4D_Transform(const TQ3RationalPoint4D& p, const TQ3Matrix4x4& m, TQ3RationalPoint4D& result)
+{
+	#define M(x,y) m.value[x][y]
+	result.x = p.x*M(0,0) + p.y*M(1,0) + p.z*M(2,0) + p.w*M(3,0);
+	result.y = p.x*M(0,1) + p.y*M(1,1) + p.z*M(2,1) + p.w*M(3,1);
+	result.z = p.x*M(0,2) + p.y*M(1,2) + p.z*M(2,2) + p.w*M(3,2);
+	result.w = p.x*M(0,3) + p.y*M(1,3) + p.z*M(2,3) + p.w*M(3,3);
+	#undef M
+}
+
+static void
+Accuracy_Q3Matrix4x4_Multiply()
+{
+	Begin("Q3Matrix4x4_Multiply");
+
+	AccuracyStats stats;
+	for (int n = 0; n < kAccuracyTrials; ++n)
+	{
+		TQ3Matrix4x4 m1, m2, actual, expected;
+		RandomMatrix(m1, false);
+		RandomMatrix(m2, false);
+
+		Q3Matrix4x4_Multiply(&m1, &m2, &actual);
+		Reference_Matrix4x4_Multiply(m1, m2, expected);
+		stats.Compare(&actual.value[0][0], &expected.value[0][0], 16);
+	}
+	stats.Report();
+}
+
+static void
+Accuracy_Q3Matrix4x4_Invert()
+{
+	Begin("Q3Matrix4x4_Invert");
+
+	//	There is no closed form to compare against, so check that m * inv(m)
+	//	is the identity, to within rounding. General and affine matrices take
+	//	different paths.
+	const float kInvertTolerance = 1.0e-2f;
+	for (int affine = 0; affine < 2; ++affine)
+	{
+		BeginPhase(affine ? "Affine" : "General");
+
+		AccuracyStats stats(kInvertTolerance);
+		for (int n = 0; n < kAccuracyTrials; ++n)
+		{
+			TQ3Matrix4x4 m, inverse, product, identity;
+			RandomMatrix(m, affine != 0);
+			if (fabs(Q3Matrix4x4_Determinant(&m)) < 1.0f)
+				continue;
+
+			Q3Matrix4x4_Invert(&m, &inverse);
+			Reference_Matrix4x4_Multiply(m, inverse, product);
+			Q3Matrix4x4_SetIdentity(&identity);
+			stats.Compare(&product.value[0][0], &identity.value[0][0], 16);
+		}
+		stats.Report();
+	}
+}
+
+static void
+Accuracy_Q3Quaternion_Multiply()
+{
+	Begin("Q3Quaternion_Multiply");
+
+	AccuracyStats stats;
+	for (int n = 0; n < kAccuracyTrials; ++n)
+	{
+		TQ3Quaternion q1, q2, actual, expected;
+		Q3Quaternion_Set(&q1, RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat());
+		Q3Quaternion_Set(&q2, RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat());
+
+		Q3Quaternion_Multiply(&q1, &q2, &actual);
+
+		// Quesa multiplies in the reverse order, see E3Quaternion_Multiply
+		expected.w = q1.w*q2.w - q1.x*q2.x - q1.y*q2.y - q1.z*q2.z;
+		expected.x = q1.w*q2.x + q1.x*q2.w - q1.y*q2.z + q1.z*q2.y;
+		expected.y = q1.w*q2.y + q1.y*q2.w - q1.z*q2.x + q1.x*q2.z;
+		expected.z = q1.w*q2.z + q1.z*q2.w - q1.x*q2.y + q1.y*q2.x;
+		stats.Compare(&actual.w, &expected.w, 4);
+	}
+	stats.Report();
+}
+
+static void
+Accuracy_Q3Point3D_To3DTransformArray()
+{
+	Begin("Q3Point3D_To3DTransformArray");
+
+	const int kNumPoints = 16;
+	for (int affine = 0; affine < 2; ++affine)
+	{
+		BeginPhase(affine ? "Affine" : "General");
+
+		AccuracyStats stats;
+		for (int n = 0; n < kAccuracyTrials / kNumPoints; ++n)
+		{
+			TQ3Matrix4x4 m;
+			TQ3Point3D points[kNumPoints], actual[kNumPoints], expected[kNumPoints];
+			RandomMatrix(m, affine != 0);
+			for (int i = 0; i < kNumPoints; ++i)
+			{
+				Q3Point3D_Set(&points[i], RandomFloat(), RandomFloat(), RandomFloat());
+				Q3Point3D_Transform(&points[i], &m, &expected[i]);
+			}
+
+			Q3Point3D_To3DTransformArray(points, &m, actual, kNumPoints,
+				sizeof(TQ3Point3D), sizeof(TQ3Point3D));
+			stats.Compare(&actual[0].x, &expected[0].x, 3 * kNumPoints);
+		}
+		stats.Report();
+	}
+}
+
+static void
+Accuracy_Q3RationalPoint4D_To4DTransformArray()
+{
+	Begin("Q3RationalPoint4D_To4DTransformArray");
+
+	const int kNumPoints = 16;
+	AccuracyStats stats;
+	for (int n = 0; n < kAccuracyTrials / kNumPoints; ++n)
+	{
+		TQ3Matrix4x4 m;
+		TQ3RationalPoint4D points[kNumPoints], actual[kNumPoints], expected[kNumPoints];
+		RandomMatrix(m, false);
+		for (int i = 0; i < kNumPoints; ++i)
+		{
+			Q3RationalPoint4D_Set(&points[i], RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat());
+			Reference_RationalPoint4D_Transform(points[i], m, expected[i]);
+			actual[i] = points[i];
+		}
+
+		//	Transform in place, which the vector kernel must also handle
+		Q3RationalPoint4D_To4DTransformArray(actual, &m, actual, kNumPoints,
+			sizeof(TQ3RationalPoint4D), sizeof(TQ3RationalPoint4D));
+		stats.Compare(&actual[0].x, &expected[0].x, 4 * kNumPoints);
+	}
+	stats.Report();
+}
+
+
+
+
+
 //=============================================================================
 //		Public functions.
 //-----------------------------------------------------------------------------
@@ -6193,8 +6421,15 @@ int main(void)
 	Test_Q3BoundingSphere_UnionPoint3D();
 	Test_Q3BoundingSphere_UnionRationalPoint4D();
 
+	BeginSection("Vector Kernel Accuracy");
+	Accuracy_Q3Matrix4x4_Multiply();
+	Accuracy_Q3Matrix4x4_Invert();
+	Accuracy_Q3Quaternion_Multiply();
+	Accuracy_Q3Point3D_To3DTransformArray();
+	Accuracy_Q3RationalPoint4D_To4DTransformArray();
+
 	// Clean up.
 	Terminate();
 
-	return(0);
+	return(gAccuracyFailures == 0 ? 0 : 1);
 }
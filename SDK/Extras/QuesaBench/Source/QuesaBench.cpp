@@ -0,0 +1,1089 @@
+/*  NAME:
+        QuesaBench.cpp
+
+    DESCRIPTION:
+        Micro-benchmarks for the Quesa math, geometry, file and view code.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "Quesa.h"
+#include "QuesaCamera.h"
+#include "QuesaDrawContext.h"
+#include "QuesaGeometry.h"
+#include "QuesaGroup.h"
+#include "QuesaIO.h"
+#include "QuesaMath.h"
+#include "QuesaRenderer.h"
+#include "QuesaStorage.h"
+#include "QuesaTransform.h"
+#include "QuesaView.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+
+
+
+
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+namespace
+{
+	const TQ3Uns32	kNumMatrices		= 1024;
+	const TQ3Uns32	kNumPoints			= 65536;
+	const TQ3Uns32	kNumTriangles		= 4096;
+	const TQ3Uns32	kGridSize			= 128;		// TriMesh optimize
+	const TQ3Uns32	kSceneGridSize		= 32;		// each TriMesh in the scene
+	const TQ3Uns32	kSceneCopies		= 64;
+	const TQ3Uns32	kDiskGridSize		= 708;		// about 1M triangles
+	const TQ3Uns32	kDiskTriangles		= 2 * (kDiskGridSize - 1) * (kDiskGridSize - 1);
+	const char*		kDiskFileName		= "quesabench_temp.3dmf";
+	const TQ3Uns32	kPositionBits		= 16;		// compressed TriMesh
+	const TQ3Uns32	kStarPoints			= 512;		// general polygon outline
+	const TQ3Uns32	kPixmapSize			= 256;
+	const double	kDefaultMinTime		= 0.25;		// seconds per benchmark
+}
+
+
+
+
+
+//=============================================================================
+//      Internal types
+//-----------------------------------------------------------------------------
+namespace
+{
+	struct BenchResult
+	{
+		const char*		name;
+		TQ3Uns32		iterations;
+		TQ3Uns32		itemsPerIteration;
+		double			nsPerIteration;
+		TQ3Uns32		bytes;
+	};
+}
+
+
+
+
+
+//=============================================================================
+//      Internal static variables
+//-----------------------------------------------------------------------------
+namespace
+{
+	double						sMinTime = kDefaultMinTime;
+	const char*					sFilter = nullptr;
+	std::vector<BenchResult>	sResults;
+	
+	// Results are folded in here so the optimizer can not drop the work
+	volatile float				sSink = 0.0f;
+}
+
+
+
+
+
+//=============================================================================
+//      Internal functions
+//-----------------------------------------------------------------------------
+//      RandomFloat : Repeatable pseudo-random number in [-1, 1].
+//-----------------------------------------------------------------------------
+static float RandomFloat()
+{
+	static TQ3Uns32	sState = 12345;
+	sState = sState * 1664525 + 1013904223;
+	return static_cast<float>( sState >> 8 ) / static_cast<float>( 1 << 23 ) - 1.0f;
+}
+
+
+
+
+
+//=============================================================================
+//      RandomPoint : Repeatable pseudo-random point in the unit cube.
+//-----------------------------------------------------------------------------
+static TQ3Point3D RandomPoint()
+{
+	TQ3Point3D	thePoint = { RandomFloat(), RandomFloat(), RandomFloat() };
+	return thePoint;
+}
+
+
+
+
+
+//=============================================================================
+//      Run : Time a benchmark body.
+//-----------------------------------------------------------------------------
+//		Note :	The body runs once to warm caches, then in batches that
+//				double in size until a batch lasts at least sMinTime.
+//				inBytes is the size of the data written or read by the body,
+//				if that is of interest.
+//-----------------------------------------------------------------------------
+static void Run( const char* inName, TQ3Uns32 inItems,
+				const std::function<void()>& inBody, TQ3Uns32 inBytes = 0 )
+{
+	if ( (sFilter != nullptr) && (strstr( inName, sFilter ) == nullptr) )
+		return;
+	
+	typedef std::chrono::steady_clock	Clock;
+	
+	inBody();
+	
+	TQ3Uns32	iterations = 1;
+	double		elapsed = 0.0;
+	for (;;)
+	{
+		Clock::time_point	startTime = Clock::now();
+		for (TQ3Uns32 i = 0; i < iterations; ++i)
+		{
+			inBody();
+		}
+		elapsed = std::chrono::duration<double>( Clock::now() - startTime ).count();
+		
+		if ( (elapsed >= sMinTime) || (iterations >= 0x40000000) )
+			break;
+		
+		iterations *= 2;
+	}
+	
+	BenchResult	theResult = { inName, iterations, inItems,
+		elapsed * 1.0e9 / iterations, inBytes };
+	sResults.push_back( theResult );
+	
+	if (inBytes != 0)
+		fprintf( stderr, "%-32s %12.1f ns %12u bytes\n", inName,
+			theResult.nsPerIteration, inBytes );
+	else
+		fprintf( stderr, "%-32s %12.1f ns\n", inName, theResult.nsPerIteration );
+}
+
+
+
+
+
+//=============================================================================
+//      FindResult : Find the result of a benchmark that has run.
+//-----------------------------------------------------------------------------
+static const BenchResult* FindResult( const char* inName )
+{
+	for (const BenchResult& theResult : sResults)
+	{
+		if (strcmp( theResult.name, inName ) == 0)
+			return &theResult;
+	}
+	
+	return nullptr;
+}
+
+
+
+
+
+//=============================================================================
+//      NewGridTriMesh : Create a flat TriMesh grid, with or without vertex
+//						 normals.
+//-----------------------------------------------------------------------------
+static TQ3GeometryObject NewGridTriMesh( TQ3Uns32 inSize, bool inNormals = false )
+{
+	std::vector<TQ3Point3D>				thePoints;
+	std::vector<TQ3Vector3D>			theNormals;
+	std::vector<TQ3TriMeshTriangleData>	theTriangles;
+	
+	for (TQ3Uns32 row = 0; row < inSize; ++row)
+	{
+		for (TQ3Uns32 col = 0; col < inSize; ++col)
+		{
+			TQ3Point3D	thePoint = { static_cast<float>(col) / inSize,
+				static_cast<float>(row) / inSize, 0.05f * RandomFloat() };
+			thePoints.push_back( thePoint );
+			
+			if (inNormals)
+			{
+				TQ3Vector3D	theNormal = { 0.1f * RandomFloat(), 0.1f * RandomFloat(), 1.0f };
+				Q3Vector3D_Normalize( &theNormal, &theNormal );
+				theNormals.push_back( theNormal );
+			}
+		}
+	}
+	
+	for (TQ3Uns32 row = 0; row + 1 < inSize; ++row)
+	{
+		for (TQ3Uns32 col = 0; col + 1 < inSize; ++col)
+		{
+			TQ3Uns32	corner = row * inSize + col;
+			TQ3TriMeshTriangleData	lower = { { corner, corner + 1, corner + inSize + 1 } };
+			TQ3TriMeshTriangleData	upper = { { corner, corner + inSize + 1, corner + inSize } };
+			theTriangles.push_back( lower );
+			theTriangles.push_back( upper );
+		}
+	}
+	
+	TQ3TriMeshData	theData;
+	memset( &theData, 0, sizeof(theData) );
+	theData.numTriangles = static_cast<TQ3Uns32>( theTriangles.size() );
+	theData.triangles = &theTriangles[0];
+	theData.numPoints = static_cast<TQ3Uns32>( thePoints.size() );
+	theData.points = &thePoints[0];
+	Q3BoundingBox_SetFromPoints3D( &theData.bBox, theData.points,
+		theData.numPoints, sizeof(TQ3Point3D) );
+	
+	TQ3TriMeshAttributeData	normalData = { kQ3AttributeTypeNormal, theNormals.data(), nullptr };
+	if (inNormals)
+	{
+		theData.numVertexAttributeTypes = 1;
+		theData.vertexAttributeTypes = &normalData;
+	}
+	
+	return Q3TriMesh_New( &theData );
+}
+
+
+
+
+
+//=============================================================================
+//      NewScene : Create a display group of translated TriMeshes.
+//-----------------------------------------------------------------------------
+static TQ3GroupObject NewScene()
+{
+	TQ3GroupObject	theScene = Q3DisplayGroup_New();
+	TQ3GeometryObject	theMesh = NewGridTriMesh( kSceneGridSize );
+	
+	for (TQ3Uns32 i = 0; i < kSceneCopies; ++i)
+	{
+		TQ3Vector3D			offset = { static_cast<float>(i % 8) - 4.0f,
+			static_cast<float>(i / 8) - 4.0f, 0.0f };
+		TQ3GroupObject		theCopy = Q3DisplayGroup_New();
+		TQ3TransformObject	theTranslate = Q3TranslateTransform_New( &offset );
+		
+		Q3Group_AddObject( theCopy, theTranslate );
+		Q3Group_AddObject( theCopy, theMesh );
+		Q3Group_AddObject( theScene, theCopy );
+		
+		Q3Object_Dispose( theTranslate );
+		Q3Object_Dispose( theCopy );
+	}
+	
+	Q3Object_Dispose( theMesh );
+	return theScene;
+}
+
+
+
+
+
+//=============================================================================
+//      NewGeneralPolygon : Create a star-shaped polygon with a hole.
+//-----------------------------------------------------------------------------
+static TQ3GeometryObject NewGeneralPolygon()
+{
+	std::vector<TQ3Vertex3D>	outer( kStarPoints ), inner( kStarPoints / 4 );
+	
+	for (TQ3Uns32 i = 0; i < outer.size(); ++i)
+	{
+		float	angle = 6.2831853f * i / outer.size();
+		float	radius = (i % 2 == 0) ? 1.0f : 0.6f;
+		TQ3Point3D	thePoint = { radius * cosf(angle), radius * sinf(angle), 0.0f };
+		outer[i].point = thePoint;
+		outer[i].attributeSet = nullptr;
+	}
+	
+	for (TQ3Uns32 i = 0; i < inner.size(); ++i)
+	{
+		float	angle = -6.2831853f * i / inner.size();
+		TQ3Point3D	thePoint = { 0.3f * cosf(angle), 0.3f * sinf(angle), 0.0f };
+		inner[i].point = thePoint;
+		inner[i].attributeSet = nullptr;
+	}
+	
+	TQ3GeneralPolygonContourData	theContours[2] =
+	{
+		{ static_cast<TQ3Uns32>( outer.size() ), &outer[0] },
+		{ static_cast<TQ3Uns32>( inner.size() ), &inner[0] }
+	};
+	TQ3GeneralPolygonData	theData = { 2, theContours,
+		kQ3GeneralPolygonShapeHintComplex, nullptr };
+	
+	return Q3GeneralPolygon_New( &theData );
+}
+
+
+
+
+
+//=============================================================================
+//      NewView : Create a view with the generic renderer.
+//-----------------------------------------------------------------------------
+static TQ3ViewObject NewView( std::vector<TQ3Uns32>& ioPixels )
+{
+	TQ3ViewObject	theView = Q3View_New();
+	
+	TQ3RendererObject	theRenderer = Q3Renderer_NewFromType( kQ3RendererTypeGeneric );
+	Q3View_SetRenderer( theView, theRenderer );
+	Q3Object_Dispose( theRenderer );
+	
+	ioPixels.resize( kPixmapSize * kPixmapSize );
+	TQ3PixmapDrawContextData	contextData;
+	memset( &contextData, 0, sizeof(contextData) );
+	contextData.drawContextData.clearImageMethod = kQ3ClearMethodWithColor;
+	contextData.drawContextData.clearImageColor.a = 1.0f;
+	contextData.pixmap.image = &ioPixels[0];
+	contextData.pixmap.width = kPixmapSize;
+	contextData.pixmap.height = kPixmapSize;
+	contextData.pixmap.rowBytes = kPixmapSize * 4;
+	contextData.pixmap.pixelSize = 32;
+	contextData.pixmap.pixelType = kQ3PixelTypeARGB32;
+#if QUESA_HOST_IS_BIG_ENDIAN
+	contextData.pixmap.bitOrder = kQ3EndianBig;
+	contextData.pixmap.byteOrder = kQ3EndianBig;
+#else
+	contextData.pixmap.bitOrder = kQ3EndianLittle;
+	contextData.pixmap.byteOrder = kQ3EndianLittle;
+#endif
+	TQ3DrawContextObject	theContext = Q3PixmapDrawContext_New( &contextData );
+	Q3View_SetDrawContext( theView, theContext );
+	Q3Object_Dispose( theContext );
+	
+	TQ3ViewAngleAspectCameraData	cameraData;
+	memset( &cameraData, 0, sizeof(cameraData) );
+	TQ3Point3D	location = { 0.0f, 0.0f, 12.0f };
+	TQ3Vector3D	up = { 0.0f, 1.0f, 0.0f };
+	cameraData.cameraData.placement.cameraLocation = location;
+	cameraData.cameraData.placement.upVector = up;
+	cameraData.cameraData.range.hither = 0.1f;
+	cameraData.cameraData.range.yon = 100.0f;
+	cameraData.cameraData.viewPort.origin.x = -1.0f;
+	cameraData.cameraData.viewPort.origin.y = 1.0f;
+	cameraData.cameraData.viewPort.width = 2.0f;
+	cameraData.cameraData.viewPort.height = 2.0f;
+	cameraData.fov = 1.0f;
+	cameraData.aspectRatioXToY = 1.0f;
+	TQ3CameraObject	theCamera = Q3ViewAngleAspectCamera_New( &cameraData );
+	Q3View_SetCamera( theView, theCamera );
+	Q3Object_Dispose( theCamera );
+	
+	return theView;
+}
+
+
+
+
+
+//=============================================================================
+//      WriteToStorage : Write an object to binary 3DMF in a storage object.
+//-----------------------------------------------------------------------------
+//		Note :	If inPositionBits is not 0, TriMeshes are written compressed.
+//-----------------------------------------------------------------------------
+static void WriteToStorage( TQ3ViewObject inView, TQ3Object inObject,
+							TQ3StorageObject inStorage,
+							TQ3Uns32 inPositionBits = 0 )
+{
+	TQ3FileObject		theFile = Q3File_New();
+	
+	if (inPositionBits != 0)
+	{
+		Q3Object_SetProperty( theFile, kQ3FilePropertyCompressTriMeshes,
+			sizeof(inPositionBits), &inPositionBits );
+	}
+	
+	Q3File_SetStorage( theFile, inStorage );
+	if (Q3File_OpenWrite( theFile, kQ3FileModeNormal ) == kQ3Success)
+	{
+		if (Q3View_StartWriting( inView, theFile ) == kQ3Success)
+		{
+			do
+			{
+				Q3Object_Submit( inObject, inView );
+			} while (Q3View_EndWriting( inView ) == kQ3ViewStatusRetraverse);
+		}
+		Q3File_Close( theFile );
+	}
+	
+	Q3Object_Dispose( theFile );
+}
+
+
+
+
+
+//=============================================================================
+//      Write3DMF : Write an object to binary 3DMF in memory.
+//-----------------------------------------------------------------------------
+static TQ3StorageObject Write3DMF( TQ3ViewObject inView, TQ3Object inObject,
+									TQ3Uns32 inPositionBits = 0 )
+{
+	TQ3StorageObject	theStorage = Q3MemoryStorage_New( nullptr, 0 );
+	
+	WriteToStorage( inView, inObject, theStorage, inPositionBits );
+	
+	return theStorage;
+}
+
+
+
+
+
+//=============================================================================
+//      Read3DMF : Read every object from 3DMF in memory.
+//-----------------------------------------------------------------------------
+static TQ3Uns32 Read3DMF( unsigned char* inData, TQ3Uns32 inSize )
+{
+	TQ3Uns32			numObjects = 0;
+	TQ3StorageObject	theStorage = Q3MemoryStorage_NewBuffer( inData, inSize, inSize );
+	TQ3FileObject		theFile = Q3File_New();
+	TQ3FileMode			theMode;
+	
+	Q3File_SetStorage( theFile, theStorage );
+	if (Q3File_OpenRead( theFile, &theMode ) == kQ3Success)
+	{
+		while (Q3File_IsEndOfFile( theFile ) == kQ3False)
+		{
+			TQ3Object	theObject = Q3File_ReadObject( theFile );
+			if (theObject == nullptr)
+				break;
+			
+			numObjects += 1;
+			Q3Object_Dispose( theObject );
+		}
+		Q3File_Close( theFile );
+	}
+	
+	Q3Object_Dispose( theFile );
+	Q3Object_Dispose( theStorage );
+	return numObjects;
+}
+
+
+
+
+
+//=============================================================================
+//      SameStructure : Check that an object read back has the types and sizes
+//						of the one written.
+//-----------------------------------------------------------------------------
+//		Note :	Compares leaf types, the members of groups, and the point and
+//				triangle counts of TriMeshes, so that a benchmark can not time
+//				a reader that drops or truncates objects.
+//-----------------------------------------------------------------------------
+static bool SameStructure( TQ3Object inWritten, TQ3Object inRead )
+{
+	const TQ3ObjectType	theType = Q3Object_GetLeafType( inWritten );
+	bool				isSame = (Q3Object_GetLeafType( inRead ) == theType);
+	
+	if ( isSame && (theType == kQ3GeometryTypeTriMesh) )
+	{
+		TQ3TriMeshData*	written = nullptr;
+		TQ3TriMeshData*	read = nullptr;
+		
+		isSame = (Q3TriMesh_LockData( inWritten, kQ3True, &written ) == kQ3Success) &&
+			(Q3TriMesh_LockData( inRead, kQ3True, &read ) == kQ3Success) &&
+			(read->numPoints == written->numPoints) &&
+			(read->numTriangles == written->numTriangles);
+		
+		if (read != nullptr)
+			Q3TriMesh_UnlockData( inRead );
+		if (written != nullptr)
+			Q3TriMesh_UnlockData( inWritten );
+	}
+	else if ( isSame && (Q3Object_IsType( inWritten, kQ3ShapeTypeGroup ) == kQ3True) )
+	{
+		TQ3Uns32	numWritten = 0, numRead = 0;
+		Q3Group_CountObjects( inWritten, &numWritten );
+		Q3Group_CountObjects( inRead, &numRead );
+		isSame = (numRead == numWritten);
+		
+		TQ3GroupPosition	writtenPos = nullptr, readPos = nullptr;
+		Q3Group_GetFirstPosition( inWritten, &writtenPos );
+		Q3Group_GetFirstPosition( inRead, &readPos );
+		while ( isSame && (writtenPos != nullptr) && (readPos != nullptr) )
+		{
+			TQ3Object	writtenMember = nullptr, readMember = nullptr;
+			Q3Group_GetPositionObject( inWritten, writtenPos, &writtenMember );
+			Q3Group_GetPositionObject( inRead, readPos, &readMember );
+			isSame = (writtenMember != nullptr) && (readMember != nullptr) &&
+				SameStructure( writtenMember, readMember );
+			
+			if (readMember != nullptr)
+				Q3Object_Dispose( readMember );
+			if (writtenMember != nullptr)
+				Q3Object_Dispose( writtenMember );
+			
+			Q3Group_GetNextPosition( inWritten, &writtenPos );
+			Q3Group_GetNextPosition( inRead, &readPos );
+		}
+	}
+	
+	return isSame;
+}
+
+
+
+
+
+//=============================================================================
+//      Check3DMF : Check that 3DMF in memory holds just the object written.
+//-----------------------------------------------------------------------------
+//		Note :	Run before timing a read, so that the timed reads need not
+//				keep what they read.  Says what went wrong on standard error.
+//-----------------------------------------------------------------------------
+static bool Check3DMF( unsigned char* inData, TQ3Uns32 inSize,
+						TQ3Object inWritten, const char* inName )
+{
+	TQ3Uns32			numObjects = 0;
+	bool				isSame = false;
+	TQ3StorageObject	theStorage = Q3MemoryStorage_NewBuffer( inData, inSize, inSize );
+	TQ3FileObject		theFile = Q3File_New();
+	TQ3FileMode			theMode;
+	
+	Q3File_SetStorage( theFile, theStorage );
+	if (Q3File_OpenRead( theFile, &theMode ) == kQ3Success)
+	{
+		while (Q3File_IsEndOfFile( theFile ) == kQ3False)
+		{
+			TQ3Object	theObject = Q3File_ReadObject( theFile );
+			if (theObject == nullptr)
+				break;
+			
+			numObjects += 1;
+			isSame = (numObjects == 1) && SameStructure( inWritten, theObject );
+			Q3Object_Dispose( theObject );
+		}
+		Q3File_Close( theFile );
+	}
+	
+	Q3Object_Dispose( theFile );
+	Q3Object_Dispose( theStorage );
+	
+	if (! isSame)
+		fprintf( stderr, "%s: read %u objects, expected one matching the object written\n",
+			inName, numObjects );
+	return isSame;
+}
+
+
+
+
+
+//=============================================================================
+//      SameTriMesh : Check that a TriMesh read back matches the one written.
+//-----------------------------------------------------------------------------
+//		Note :	Quantized points must lie within a step or so of the
+//				original, which lies in the unit cube, and quantized normals
+//				within about 0.06 degrees.  Exact points must match bit for
+//				bit, but creating a TriMesh normalizes its normals again, so
+//				exact normals may move by a rounding error.
+//-----------------------------------------------------------------------------
+static bool SameTriMesh( TQ3GeometryObject inWritten, TQ3GeometryObject inRead,
+						TQ3Uns32 inPositionBits )
+{
+	TQ3TriMeshData*	written = nullptr;
+	TQ3TriMeshData*	read = nullptr;
+	bool			isSame = false;
+	
+	if ( (Q3TriMesh_LockData( inWritten, kQ3True, &written ) == kQ3Success) &&
+		(Q3TriMesh_LockData( inRead, kQ3True, &read ) == kQ3Success) )
+	{
+		const bool	isExact = (inPositionBits > 24);
+		const float	pointTolerance = isExact ? 0.0f : 2.0f / (1U << inPositionBits);
+		const float	normalTolerance = isExact ? 1.0e-6f : 1.0e-3f;
+		
+		isSame = (read->numPoints == written->numPoints) &&
+			(read->numTriangles == written->numTriangles) &&
+			(read->numEdges == written->numEdges) &&
+			(read->numVertexAttributeTypes == written->numVertexAttributeTypes) &&
+			(memcmp( read->triangles, written->triangles,
+				written->numTriangles * sizeof(TQ3TriMeshTriangleData) ) == 0);
+		
+		for (TQ3Uns32 i = 0; isSame && (i < written->numPoints); ++i)
+		{
+			isSame = (fabsf( read->points[i].x - written->points[i].x ) <= pointTolerance) &&
+				(fabsf( read->points[i].y - written->points[i].y ) <= pointTolerance) &&
+				(fabsf( read->points[i].z - written->points[i].z ) <= pointTolerance);
+		}
+		
+		for (TQ3Uns32 j = 0; isSame && (j < written->numVertexAttributeTypes); ++j)
+		{
+			const TQ3TriMeshAttributeData&	writtenAtt = written->vertexAttributeTypes[j];
+			const TQ3TriMeshAttributeData&	readAtt = read->vertexAttributeTypes[j];
+			isSame = (readAtt.attributeType == writtenAtt.attributeType) &&
+				(writtenAtt.attributeType == kQ3AttributeTypeNormal);
+			
+			const TQ3Vector3D*	writtenNormals = (const TQ3Vector3D*) writtenAtt.data;
+			const TQ3Vector3D*	readNormals = (const TQ3Vector3D*) readAtt.data;
+			for (TQ3Uns32 i = 0; isSame && (i < written->numPoints); ++i)
+			{
+				isSame = (fabsf( readNormals[i].x - writtenNormals[i].x ) <= normalTolerance) &&
+					(fabsf( readNormals[i].y - writtenNormals[i].y ) <= normalTolerance) &&
+					(fabsf( readNormals[i].z - writtenNormals[i].z ) <= normalTolerance);
+			}
+		}
+	}
+	
+	if (read != nullptr)
+		Q3TriMesh_UnlockData( inRead );
+	if (written != nullptr)
+		Q3TriMesh_UnlockData( inWritten );
+	return isSame;
+}
+
+
+
+
+
+//=============================================================================
+//      CheckCompressedTriMeshes : Write and read back compressed TriMeshes.
+//-----------------------------------------------------------------------------
+//		Note :	Each TriMesh is the last object in its file, and between them
+//				the grid sizes give compressed blocks of every length modulo
+//				4, including lengths that need no padding.  Returns false if
+//				any TriMesh does not come back as it was written.
+//-----------------------------------------------------------------------------
+static bool CheckCompressedTriMeshes( TQ3ViewObject inView )
+{
+	const TQ3Uns32	kCheckBits[] = { kPositionBits, 32 };
+	bool			isSame = true;
+	
+	for (TQ3Uns32 theSize = 2; theSize <= 17; ++theSize)
+	{
+		for (int withNormals = 0; withNormals < 2; ++withNormals)
+		{
+			TQ3GeometryObject	theMesh = NewGridTriMesh( theSize, withNormals != 0 );
+			
+			for (TQ3Uns32 theBits : kCheckBits)
+			{
+				TQ3StorageObject	theStorage = Write3DMF( inView, theMesh, theBits );
+				TQ3FileObject		theFile = Q3File_New();
+				TQ3FileMode			theMode;
+				TQ3Object			theObject = nullptr;
+				
+				Q3File_SetStorage( theFile, theStorage );
+				if (Q3File_OpenRead( theFile, &theMode ) == kQ3Success)
+				{
+					theObject = Q3File_ReadObject( theFile );
+					Q3File_Close( theFile );
+				}
+				
+				if ( (theObject == nullptr) ||
+					(Q3Object_IsType( theObject, kQ3GeometryTypeTriMesh ) == kQ3False) ||
+					! SameTriMesh( theMesh, theObject, theBits ) )
+				{
+					fprintf( stderr, "Compressed TriMesh round trip failed: %u x %u grid, "
+						"%s normals, %u bits\n", theSize, theSize,
+						(withNormals != 0) ? "with" : "without", theBits );
+					isSame = false;
+				}
+				
+				if (theObject != nullptr)
+					Q3Object_Dispose( theObject );
+				Q3Object_Dispose( theFile );
+				Q3Object_Dispose( theStorage );
+			}
+			
+			Q3Object_Dispose( theMesh );
+		}
+	}
+	
+	return isSame;
+}
+
+
+
+
+
+//=============================================================================
+//      BenchMath : Matrix, point and ray kernels.
+//-----------------------------------------------------------------------------
+static void BenchMath()
+{
+	std::vector<TQ3Matrix4x4>	matrices( kNumMatrices ), results( kNumMatrices );
+	for (TQ3Uns32 i = 0; i < kNumMatrices; ++i)
+	{
+		TQ3Vector3D		axis = { RandomFloat(), RandomFloat(), 1.0f };
+		TQ3Point3D		origin = RandomPoint();
+		TQ3Matrix4x4	theScale, theRotate;
+		Q3Matrix4x4_SetScale( &theScale, 2.0f + RandomFloat(), 2.0f, 1.5f );
+		Q3Matrix4x4_SetRotateAboutAxis( &theRotate, &origin,
+			Q3Vector3D_Normalize( &axis, &axis ), RandomFloat() );
+		Q3Matrix4x4_Multiply( &theScale, &theRotate, &matrices[i] );
+	}
+	
+	Run( "E3Matrix4x4_Multiply", kNumMatrices, [&]()
+	{
+		for (TQ3Uns32 i = 0; i < kNumMatrices; ++i)
+			Q3Matrix4x4_Multiply( &matrices[i], &matrices[ (i + 1) % kNumMatrices ], &results[i] );
+		sSink = sSink + results[ kNumMatrices - 1 ].value[3][0];
+	} );
+	
+	Run( "E3Matrix4x4_Invert", kNumMatrices, [&]()
+	{
+		for (TQ3Uns32 i = 0; i < kNumMatrices; ++i)
+			Q3Matrix4x4_Invert( &matrices[i], &results[i] );
+		sSink = sSink + results[ kNumMatrices - 1 ].value[3][0];
+	} );
+	
+	std::vector<TQ3Point3D>		points( kNumPoints ), transformed( kNumPoints );
+	for (TQ3Point3D& thePoint : points)
+		thePoint = RandomPoint();
+	
+	Run( "E3Point3D_To3DTransformArray", kNumPoints, [&]()
+	{
+		Q3Point3D_To3DTransformArray( &points[0], &matrices[0], &transformed[0],
+			kNumPoints, sizeof(TQ3Point3D), sizeof(TQ3Point3D) );
+		sSink = sSink + transformed[ kNumPoints - 1 ].x;
+	} );
+	
+	Run( "E3BoundingBox_SetFromPoints3D", kNumPoints, [&]()
+	{
+		TQ3BoundingBox	theBounds;
+		Q3BoundingBox_SetFromPoints3D( &theBounds, &points[0], kNumPoints,
+			sizeof(TQ3Point3D) );
+		sSink = sSink + theBounds.max.x;
+	} );
+	
+	TQ3Ray3D	theRay = { { 0.0f, 0.0f, -5.0f }, { 0.0f, 0.0f, 1.0f } };
+	Run( "E3Ray3D_IntersectTriangle", kNumTriangles, [&]()
+	{
+		TQ3Uns32	numHits = 0;
+		TQ3Param3D	theHit;
+		for (TQ3Uns32 i = 0; i < kNumTriangles; ++i)
+		{
+			const TQ3Point3D*	theTriangle = &points[ 3 * i ];
+			if (Q3Ray3D_IntersectTriangle( &theRay, &theTriangle[0], &theTriangle[1],
+				&theTriangle[2], kQ3False, &theHit ))
+			{
+				++numHits;
+			}
+		}
+		sSink = sSink + static_cast<float>( numHits );
+	} );
+}
+
+
+
+
+
+//=============================================================================
+//      BenchGeometry : TriMesh optimize and polygon tessellation.
+//-----------------------------------------------------------------------------
+static void BenchGeometry( TQ3ViewObject inView )
+{
+	TQ3GeometryObject	theGrid = NewGridTriMesh( kGridSize );
+	Run( "TriMesh optimize", 2 * (kGridSize - 1) * (kGridSize - 1), [&]()
+	{
+		TQ3GeometryObject	theResult = Q3TriMesh_Optimize( theGrid );
+		if (theResult != nullptr)
+			Q3Object_Dispose( theResult );
+	} );
+	Q3Object_Dispose( theGrid );
+	
+	TQ3GeometryObject	thePolygon = NewGeneralPolygon();
+	Run( "Tessellate general polygon", kStarPoints + kStarPoints / 4, [&]()
+	{
+		if (Q3View_StartRendering( inView ) == kQ3Success)
+		{
+			do
+			{
+				TQ3Object	theResult = Q3Geometry_GetDecomposed( thePolygon, inView );
+				if (theResult != nullptr)
+					Q3Object_Dispose( theResult );
+			} while (Q3View_EndRendering( inView ) == kQ3ViewStatusRetraverse);
+		}
+	} );
+	Q3Object_Dispose( thePolygon );
+}
+
+
+
+
+
+//=============================================================================
+//      BenchTriMeshFile : Plain and compressed 3DMF of a large TriMesh.
+//-----------------------------------------------------------------------------
+//		Note :	Returns false, without timing the reads, if either file does
+//				not read back as the TriMesh that was written.
+//-----------------------------------------------------------------------------
+static bool BenchTriMeshFile( TQ3ViewObject inView, TQ3GeometryObject inMesh,
+							const char* inReadName, const char* inPackedWriteName,
+							const char* inPackedReadName )
+{
+	TQ3StorageObject	plainStorage = Write3DMF( inView, inMesh );
+	unsigned char*		plainData = nullptr;
+	TQ3Uns32			plainSize = 0;
+	Q3MemoryStorage_GetBuffer( plainStorage, &plainData, &plainSize, nullptr );
+	
+	TQ3StorageObject	packedStorage = Write3DMF( inView, inMesh, kPositionBits );
+	unsigned char*		packedData = nullptr;
+	TQ3Uns32			packedSize = 0;
+	Q3MemoryStorage_GetBuffer( packedStorage, &packedData, &packedSize, nullptr );
+	
+	if ( ! Check3DMF( plainData, plainSize, inMesh, inReadName ) ||
+		! Check3DMF( packedData, packedSize, inMesh, inPackedReadName ) )
+	{
+		Q3Object_Dispose( packedStorage );
+		Q3Object_Dispose( plainStorage );
+		return false;
+	}
+	
+	Run( inReadName, kDiskTriangles, [&]()
+	{
+		sSink = sSink + static_cast<float>( Read3DMF( plainData, plainSize ) );
+	}, plainSize );
+	
+	Run( inPackedWriteName, kDiskTriangles, [&]()
+	{
+		TQ3StorageObject	theStorage = Write3DMF( inView, inMesh, kPositionBits );
+		Q3Object_Dispose( theStorage );
+	}, packedSize );
+	
+	Run( inPackedReadName, kDiskTriangles, [&]()
+	{
+		sSink = sSink + static_cast<float>( Read3DMF( packedData, packedSize ) );
+	}, packedSize );
+	
+	// Reading from memory leaves out the time to fetch the file.  The
+	// compressed file loads faster end to end when the bytes it saves take
+	// longer to fetch than it takes to decode them.
+	const BenchResult*	plainResult = FindResult( inReadName );
+	const BenchResult*	packedResult = FindResult( inPackedReadName );
+	if ( (plainResult != nullptr) && (packedResult != nullptr) )
+	{
+		double	extraSeconds = (packedResult->nsPerIteration - plainResult->nsPerIteration) * 1.0e-9;
+		if (extraSeconds <= 0.0)
+			fprintf( stderr, "  compressed loads faster at any storage speed\n" );
+		else
+			fprintf( stderr, "  compressed loads faster from storage slower than %.0f MB/s\n",
+				(plainSize - packedSize) / extraSeconds / 1.0e6 );
+	}
+	
+	Q3Object_Dispose( packedStorage );
+	Q3Object_Dispose( plainStorage );
+	return true;
+}
+
+
+
+
+
+//=============================================================================
+//      BenchFile : 3DMF write and read in memory, write to disk, and
+//					compressed TriMeshes.
+//-----------------------------------------------------------------------------
+//		Note :	Returns false if a file does not read back as the object
+//				that was written.
+//-----------------------------------------------------------------------------
+static bool BenchFile( TQ3ViewObject inView, TQ3GroupObject inScene )
+{
+	Run( "3DMF write", kSceneCopies, [&]()
+	{
+		TQ3StorageObject	theStorage = Write3DMF( inView, inScene );
+		Q3Object_Dispose( theStorage );
+	} );
+	
+	TQ3StorageObject	theStorage = Write3DMF( inView, inScene );
+	unsigned char*		theData = nullptr;
+	TQ3Uns32			theSize = 0;
+	Q3MemoryStorage_GetBuffer( theStorage, &theData, &theSize, nullptr );
+	
+	bool	isValid = Check3DMF( theData, theSize, inScene, "3DMF read" );
+	if (isValid)
+	{
+		Run( "3DMF read", kSceneCopies, [&]()
+		{
+			sSink = sSink + static_cast<float>( Read3DMF( theData, theSize ) );
+		} );
+	}
+	
+	Q3Object_Dispose( theStorage );
+	if (! isValid)
+		return false;
+	
+	// A single large TriMesh written through a path storage, which measures
+	// the many small writes made by the 3DMF writer
+	TQ3GeometryObject	bigMesh = NewGridTriMesh( kDiskGridSize );
+	
+	Run( "3DMF write to disk", kDiskTriangles, [&]()
+	{
+		TQ3StorageObject	pathStorage = Q3PathStorage_New( kDiskFileName );
+		WriteToStorage( inView, bigMesh, pathStorage );
+		Q3Object_Dispose( pathStorage );
+	} );
+	
+	remove( kDiskFileName );
+	
+	// The same TriMesh in memory, plain and compressed, to compare file size
+	// and load time, then again with vertex normals
+	isValid = BenchTriMeshFile( inView, bigMesh, "3DMF TriMesh read",
+		"3DMF TriMesh write, compressed", "3DMF TriMesh read, compressed" );
+	Q3Object_Dispose( bigMesh );
+	
+	if (isValid)
+	{
+		bigMesh = NewGridTriMesh( kDiskGridSize, true );
+		isValid = BenchTriMeshFile( inView, bigMesh, "3DMF TriMesh read, normals",
+			"3DMF TriMesh write, normals, compressed",
+			"3DMF TriMesh read, normals, compressed" );
+		Q3Object_Dispose( bigMesh );
+	}
+	
+	return isValid;
+}
+
+
+
+
+
+//=============================================================================
+//      BenchSubmit : Render a scene with the generic renderer.
+//-----------------------------------------------------------------------------
+static void BenchSubmit( TQ3ViewObject inView, TQ3GroupObject inScene )
+{
+	Run( "View submit (generic renderer)", kSceneCopies, [&]()
+	{
+		if (Q3View_StartRendering( inView ) == kQ3Success)
+		{
+			do
+			{
+				Q3Object_Submit( inScene, inView );
+			} while (Q3View_EndRendering( inView ) == kQ3ViewStatusRetraverse);
+		}
+	} );
+}
+
+
+
+
+
+//=============================================================================
+//      WriteResults : Write the results as JSON to standard output.
+//-----------------------------------------------------------------------------
+static void WriteResults()
+{
+	TQ3Uns32	majorRevision = 0, minorRevision = 0;
+	Q3GetVersion( &majorRevision, &minorRevision );
+	
+	printf( "{\n" );
+	printf( "  \"quesa_version\": \"%u.%u\",\n", majorRevision, minorRevision );
+	printf( "  \"min_time_seconds\": %g,\n", sMinTime );
+	printf( "  \"benchmarks\": [" );
+	
+	for (size_t i = 0; i < sResults.size(); ++i)
+	{
+		const BenchResult&	theResult = sResults[i];
+		printf( "%s\n    { \"name\": \"%s\", \"iterations\": %u, "
+			"\"items_per_iteration\": %u, \"ns_per_iteration\": %.1f, "
+			"\"ns_per_item\": %.3f",
+			(i == 0) ? "" : ",", theResult.name, theResult.iterations,
+			theResult.itemsPerIteration, theResult.nsPerIteration,
+			theResult.nsPerIteration / theResult.itemsPerIteration );
+		if (theResult.bytes != 0)
+			printf( ", \"bytes\": %u", theResult.bytes );
+		printf( " }" );
+	}
+	
+	printf( "\n  ]\n}\n" );
+}
+
+
+
+
+
+//=============================================================================
+//      main : Entry point.
+//-----------------------------------------------------------------------------
+//		Usage :	quesabench [--min-time seconds] [--filter text]
+//
+//				Writes JSON results to standard output, and a readable
+//				summary to standard error.
+//-----------------------------------------------------------------------------
+int main( int argc, const char* argv[] )
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		if ( (strcmp( argv[i], "--min-time" ) == 0) && (i + 1 < argc) )
+			sMinTime = atof( argv[ ++i ] );
+		else if ( (strcmp( argv[i], "--filter" ) == 0) && (i + 1 < argc) )
+			sFilter = argv[ ++i ];
+		else
+		{
+			fprintf( stderr, "usage: %s [--min-time seconds] [--filter text]\n", argv[0] );
+			return 2;
+		}
+	}
+	
+	if (Q3Initialize() != kQ3Success)
+	{
+		fprintf( stderr, "Q3Initialize failed\n" );
+		return 1;
+	}
+	
+	std::vector<TQ3Uns32>	thePixels;
+	TQ3ViewObject	theView = NewView( thePixels );
+	TQ3GroupObject	theScene = NewScene();
+	
+	bool	isValid = CheckCompressedTriMeshes( theView );
+	if (isValid)
+	{
+		BenchMath();
+		BenchGeometry( theView );
+		isValid = BenchFile( theView, theScene );
+	}
+	if (isValid)
+	{
+		BenchSubmit( theView, theScene );
+	}
+	
+	Q3Object_Dispose( theScene );
+	Q3Object_Dispose( theView );
+	Q3Exit();
+	
+	if (! isValid)
+		return 1;
+	
+	WriteResults();
+	return 0;
+}
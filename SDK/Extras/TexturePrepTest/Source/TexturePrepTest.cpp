@@ -0,0 +1,372 @@
+/*  NAME:
+        TexturePrepTest.cpp
+
+    DESCRIPTION:
+        CPU-only tests of the texture preparation stage of the OpenGL renderer.
+
+    COPYRIGHT:
+        Copyright (c) 2026, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "GLTexturePrep.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+
+
+
+
+//=============================================================================
+//      Internal static variables
+//-----------------------------------------------------------------------------
+namespace
+{
+	TQ3Uns32	sNumChecks = 0;
+	TQ3Uns32	sNumFailures = 0;
+}
+
+
+
+
+
+//=============================================================================
+//      Internal functions
+//-----------------------------------------------------------------------------
+//      Check : Record the result of one check, reporting it if it failed.
+//-----------------------------------------------------------------------------
+static void Check( bool inPassed, const char* inTest, const char* inWhat )
+{
+	++sNumChecks;
+	
+	if (! inPassed)
+	{
+		++sNumFailures;
+		fprintf( stderr, "FAILED: %s: %s\n", inTest, inWhat );
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      CheckPixel : Check one BGRA pixel of a prepared level.
+//-----------------------------------------------------------------------------
+static void CheckPixel( const GLPreparedTextureLevel& inLevel,
+						TQ3Uns32 inCol, TQ3Uns32 inRow,
+						TQ3Uns8 inB, TQ3Uns8 inG, TQ3Uns8 inR, TQ3Uns8 inA,
+						const char* inTest )
+{
+	const TQ3Uns8*	thePixel = inLevel.pixels.get() +
+		4 * (inRow * inLevel.width + inCol);
+	
+	char	theWhat[100];
+	snprintf( theWhat, sizeof(theWhat),
+		"pixel (%u, %u) is %u %u %u %u, expected %u %u %u %u", inCol, inRow,
+		thePixel[0], thePixel[1], thePixel[2], thePixel[3], inB, inG, inR, inA );
+	
+	Check( (thePixel[0] == inB) && (thePixel[1] == inG) &&
+		(thePixel[2] == inR) && (thePixel[3] == inA), inTest, theWhat );
+}
+
+
+
+
+
+//=============================================================================
+//      CheckSize : Check the size of a prepared level.
+//-----------------------------------------------------------------------------
+static void CheckSize( const GLPreparedTexture& inPrepared, TQ3Uns32 inLevel,
+						TQ3Uns32 inWidth, TQ3Uns32 inHeight,
+						const char* inTest )
+{
+	char	theWhat[100];
+	
+	if (inLevel >= inPrepared.levels.size())
+	{
+		snprintf( theWhat, sizeof(theWhat), "level %u is missing", inLevel );
+		Check( false, inTest, theWhat );
+	}
+	else
+	{
+		const GLPreparedTextureLevel&	theLevel( inPrepared.levels[ inLevel ] );
+		snprintf( theWhat, sizeof(theWhat),
+			"level %u is %u x %u, expected %u x %u", inLevel,
+			theLevel.width, theLevel.height, inWidth, inHeight );
+		Check( (theLevel.width == inWidth) && (theLevel.height == inHeight),
+			inTest, theWhat );
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      MakeSource : Describe a single image in memory.
+//-----------------------------------------------------------------------------
+static GLTexturePrepSource MakeSource( const std::vector<TQ3Uns8>& inImage,
+										TQ3PixelType inPixelType,
+										TQ3Endian inByteOrder,
+										TQ3Uns32 inWidth, TQ3Uns32 inHeight,
+										TQ3Uns32 inRowBytes )
+{
+	GLTexturePrepSource	theSource;
+	theSource.imageData = inImage.data();
+	theSource.pixelType = inPixelType;
+	theSource.byteOrder = inByteOrder;
+	theSource.rowsAreFlipped = false;
+	theSource.premultiplyAlpha = false;
+	theSource.generateMipmaps = false;
+	theSource.maxTextureSize = 0;
+	
+	TQ3MipmapImage	theLevel = { inWidth, inHeight, inRowBytes, 0 };
+	theSource.levels.push_back( theLevel );
+	
+	return theSource;
+}
+
+
+
+
+
+//=============================================================================
+//      TestConvert : Pixel conversion and row order.
+//-----------------------------------------------------------------------------
+static void TestConvert()
+{
+	// 2 x 2 big-endian ARGB32, top row first, with 4 bytes of row padding
+	const std::vector<TQ3Uns8>	theImage = {
+		0xFF, 0x10, 0x20, 0x30,		0x80, 0x40, 0x50, 0x60,		0, 0, 0, 0,
+		0x00, 0x70, 0x80, 0x90,		0xC0, 0xA0, 0xB0, 0xC0,		0, 0, 0, 0
+	};
+	GLTexturePrepSource	theSource( MakeSource( theImage,
+		kQ3PixelTypeARGB32, kQ3EndianBig, 2, 2, 12 ) );
+	GLPreparedTexture	thePrepared;
+	
+	Check( GLTexturePrep_Prepare( theSource, thePrepared ), "convert",
+		"GLTexturePrep_Prepare failed" );
+	Check( thePrepared.levels.size() == 1, "convert", "expected one level" );
+	CheckSize( thePrepared, 0, 2, 2, "convert" );
+	if (thePrepared.levels.size() == 1)
+	{
+		// Prepared rows run bottom to top
+		CheckPixel( thePrepared.levels[0], 0, 0, 0x90, 0x80, 0x70, 0x00, "convert" );
+		CheckPixel( thePrepared.levels[0], 1, 0, 0xC0, 0xB0, 0xA0, 0xC0, "convert" );
+		CheckPixel( thePrepared.levels[0], 0, 1, 0x30, 0x20, 0x10, 0xFF, "convert" );
+		CheckPixel( thePrepared.levels[0], 1, 1, 0x60, 0x50, 0x40, 0x80, "convert" );
+	}
+	
+	// The same image with rows already bottom to top keeps its row order
+	theSource.rowsAreFlipped = true;
+	Check( GLTexturePrep_Prepare( theSource, thePrepared ), "flipped",
+		"GLTexturePrep_Prepare failed" );
+	if (thePrepared.levels.size() == 1)
+	{
+		CheckPixel( thePrepared.levels[0], 0, 0, 0x30, 0x20, 0x10, 0xFF, "flipped" );
+		CheckPixel( thePrepared.levels[0], 0, 1, 0x90, 0x80, 0x70, 0x00, "flipped" );
+	}
+	
+	// Premultiplied alpha
+	theSource.rowsAreFlipped = false;
+	theSource.premultiplyAlpha = true;
+	Check( GLTexturePrep_Prepare( theSource, thePrepared ), "premultiply",
+		"GLTexturePrep_Prepare failed" );
+	if (thePrepared.levels.size() == 1)
+	{
+		CheckPixel( thePrepared.levels[0], 0, 0, 0, 0, 0, 0x00, "premultiply" );
+		CheckPixel( thePrepared.levels[0], 1, 1, 0x30, 0x28, 0x20, 0x80, "premultiply" );
+	}
+	
+	// Little-endian RGB24 gets an opaque alpha
+	const std::vector<TQ3Uns8>	theRGB = { 0x11, 0x22, 0x33 };
+	theSource = MakeSource( theRGB, kQ3PixelTypeRGB24, kQ3EndianLittle, 1, 1, 3 );
+	Check( GLTexturePrep_Prepare( theSource, thePrepared ), "rgb24",
+		"GLTexturePrep_Prepare failed" );
+	if (thePrepared.levels.size() == 1)
+	{
+		CheckPixel( thePrepared.levels[0], 0, 0, 0x11, 0x22, 0x33, 0xFF, "rgb24" );
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      TestMipmaps : Generated mipmap chains.
+//-----------------------------------------------------------------------------
+static void TestMipmaps()
+{
+	// 8 x 2 big-endian ARGB32 with a checkerboard of black and white
+	const TQ3Uns32	kWidth = 8;
+	const TQ3Uns32	kHeight = 2;
+	std::vector<TQ3Uns8>	theImage( 4 * kWidth * kHeight );
+	for (TQ3Uns32 row = 0; row < kHeight; ++row)
+	{
+		for (TQ3Uns32 col = 0; col < kWidth; ++col)
+		{
+			TQ3Uns8*	thePixel = &theImage[ 4 * (row * kWidth + col) ];
+			TQ3Uns8		theValue = ((row + col) % 2 == 0)? 0xFF : 0x00;
+			thePixel[0] = 0xFF;
+			thePixel[1] = thePixel[2] = thePixel[3] = theValue;
+		}
+	}
+	
+	GLTexturePrepSource	theSource( MakeSource( theImage,
+		kQ3PixelTypeARGB32, kQ3EndianBig, kWidth, kHeight, 4 * kWidth ) );
+	theSource.generateMipmaps = true;
+	GLPreparedTexture	thePrepared;
+	
+	Check( GLTexturePrep_Prepare( theSource, thePrepared ), "mipmaps",
+		"GLTexturePrep_Prepare failed" );
+	Check( thePrepared.levels.size() == 4, "mipmaps", "expected 4 levels" );
+	CheckSize( thePrepared, 0, 8, 2, "mipmaps" );
+	CheckSize( thePrepared, 1, 4, 1, "mipmaps" );
+	CheckSize( thePrepared, 2, 2, 1, "mipmaps" );
+	CheckSize( thePrepared, 3, 1, 1, "mipmaps" );
+	
+	// Every 2 x 2 block of the checkerboard averages to mid grey
+	if (thePrepared.levels.size() == 4)
+	{
+		for (TQ3Uns32 col = 0; col < 4; ++col)
+		{
+			CheckPixel( thePrepared.levels[1], col, 0, 0x80, 0x80, 0x80, 0xFF,
+				"mipmaps" );
+		}
+		CheckPixel( thePrepared.levels[3], 0, 0, 0x80, 0x80, 0x80, 0xFF,
+			"mipmaps" );
+	}
+	
+	// Mipmaps supplied by the texture are converted, not generated
+	std::vector<TQ3Uns8>	theLevels( 4 * 4 + 4, 0xFF );
+	theSource = MakeSource( theLevels, kQ3PixelTypeARGB32, kQ3EndianBig, 2, 2, 8 );
+	TQ3MipmapImage	smallLevel = { 1, 1, 4, 16 };
+	theSource.levels.push_back( smallLevel );
+	Check( GLTexturePrep_Prepare( theSource, thePrepared ), "given mipmaps",
+		"GLTexturePrep_Prepare failed" );
+	Check( thePrepared.levels.size() == 2, "given mipmaps", "expected 2 levels" );
+	CheckSize( thePrepared, 0, 2, 2, "given mipmaps" );
+	CheckSize( thePrepared, 1, 1, 1, "given mipmaps" );
+}
+
+
+
+
+
+//=============================================================================
+//      TestShrink : Images larger than the maximum texture size.
+//-----------------------------------------------------------------------------
+static void TestShrink()
+{
+	// 16 x 8 opaque red, limited to 4 pixels in each direction
+	const TQ3Uns32	kWidth = 16;
+	const TQ3Uns32	kHeight = 8;
+	std::vector<TQ3Uns8>	theImage( 4 * kWidth * kHeight );
+	for (TQ3Uns32 i = 0; i < kWidth * kHeight; ++i)
+	{
+		theImage[ 4 * i ] = 0xFF;
+		theImage[ 4 * i + 1 ] = 0xFF;
+	}
+	
+	GLTexturePrepSource	theSource( MakeSource( theImage,
+		kQ3PixelTypeARGB32, kQ3EndianBig, kWidth, kHeight, 4 * kWidth ) );
+	theSource.maxTextureSize = 4;
+	theSource.generateMipmaps = true;
+	GLPreparedTexture	thePrepared;
+	
+	Check( GLTexturePrep_Prepare( theSource, thePrepared ), "shrink",
+		"GLTexturePrep_Prepare failed" );
+	Check( thePrepared.levels.size() == 3, "shrink", "expected 3 levels" );
+	CheckSize( thePrepared, 0, 4, 4, "shrink" );
+	CheckSize( thePrepared, 2, 1, 1, "shrink" );
+	if (thePrepared.levels.size() == 3)
+	{
+		CheckPixel( thePrepared.levels[0], 3, 3, 0x00, 0x00, 0xFF, 0xFF, "shrink" );
+		CheckPixel( thePrepared.levels[2], 0, 0, 0x00, 0x00, 0xFF, 0xFF, "shrink" );
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      TestFailure : Sources that can not be prepared.
+//-----------------------------------------------------------------------------
+static void TestFailure()
+{
+	const std::vector<TQ3Uns8>	theImage( 16 );
+	GLTexturePrepSource	theSource( MakeSource( theImage,
+		kQ3PixelTypeARGB32, kQ3EndianBig, 2, 2, 8 ) );
+	GLPreparedTexture	thePrepared;
+	
+	theSource.imageData = nullptr;
+	Check( ! GLTexturePrep_Prepare( theSource, thePrepared ), "failure",
+		"accepted missing image data" );
+	
+	theSource.imageData = theImage.data();
+	theSource.levels[0].width = 0;
+	Check( ! GLTexturePrep_Prepare( theSource, thePrepared ), "failure",
+		"accepted an empty image" );
+	
+	theSource.levels.clear();
+	Check( ! GLTexturePrep_Prepare( theSource, thePrepared ), "failure",
+		"accepted a source with no levels" );
+}
+
+
+
+
+
+//=============================================================================
+//      main : Entry point.
+//-----------------------------------------------------------------------------
+int main()
+{
+	TestConvert();
+	TestMipmaps();
+	TestShrink();
+	TestFailure();
+	
+	printf( "%u checks, %u failures\n", sNumChecks, sNumFailures );
+	
+	return (sNumFailures == 0)? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -638,6 +638,7 @@ enum QUESA_ENUM_BASE(TQ3Int32) {
         kQ3PickTypeWindowPoint                  = Q3_OBJECT_TYPE('p', 'k', 'w', 'p'),
         kQ3PickTypeWindowRect                   = Q3_OBJECT_TYPE('p', 'k', 'w', 'r'),
         kQ3PickTypeWorldRay                     = Q3_OBJECT_TYPE('p', 'k', 'r', 'y'),
+        kQ3PickTypeWorldRayBatch                = Q3_OBJECT_TYPE('p', 'k', 'r', 'b'),
     kQ3ObjectTypeShared                         = Q3_OBJECT_TYPE('s', 'h', 'r', 'd'),
         kQ3SharedTypeRenderer                   = Q3_OBJECT_TYPE('r', 'd', 'd', 'r'),
             kQ3RendererTypeWireFrame            = Q3_OBJECT_TYPE('w', 'r', 'f', 'r'),
@@ -1701,6 +1702,51 @@ Q3SetDebugMode( int inMode );
 
 
 
+/*!
+	@function	Q3Profile_SetCapture
+	@abstract	Start or stop recording where frame time is spent.
+	@discussion	The profiler is only present if Quesa was built with the
+				Q3_PROFILE build constant set to 1; otherwise this function
+				does nothing and returns kQ3Failure.
+				
+				While capturing, a frame starts at the first
+				<code>Q3View_StartRendering</code> and ends when
+				<code>Q3View_EndRendering</code> returns a status other than
+				kQ3ViewStatusRetraverse.  Quesa records the time taken by the
+				rendering calls, by the submission of each object class,
+				by geometry cache rebuilds, attribute inheritance and texture
+				uploads, and counts method lookups and hits and misses of
+				the OpenGL renderer's VBO cache.
+				
+				<em>This function is not available in QD3D.</em>
+	@param		inCapture		True to start recording, false to stop.
+	@result		Success or failure of the operation.
+*/
+Q3_EXTERN_API_C( TQ3Status )
+Q3Profile_SetCapture( TQ3Boolean inCapture );
+
+
+
+/*!
+	@function	Q3Profile_WriteLastFrame
+	@abstract	Write the timings of the last complete frame to a file.
+	@discussion	The file uses the Chrome trace event JSON format, and can be
+				opened with <code>chrome://tracing</code> or Perfetto.  Times
+				are relative to the start of the frame.
+				
+				Call this after <code>Q3View_EndRendering</code>, for example
+				when a frame took longer than expected.
+				
+				<em>This function is not available in QD3D.</em>
+	@param		inPath			Path of the file to create.
+	@result		kQ3Failure if no frame has been captured, if the file can not
+				be written, or if Quesa was built without the profiler.
+*/
+Q3_EXTERN_API_C( TQ3Status )
+Q3Profile_WriteLastFrame( const char* _Nonnull inPath );
+
+
+
 /*!
 	@functiongroup	Object Hierarchy Functions
 */
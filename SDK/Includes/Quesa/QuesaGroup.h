@@ -94,6 +94,9 @@ extern "C" {
  *  @constant kQ3DisplayGroupStateMaskIsInline             The group will be submited without pushing/popping the
  *                                                         view state stack around the group contents.
  *  @constant kQ3DisplayGroupStateMaskUseBoundingBox       The bounding box is used for culling when rendering.
+ *                                                         If no bounding box has been set, Quesa computes one
+ *                                                         for a group which is not inline, and keeps it up to
+ *                                                         date as the group's contents are edited.  (Not in QD3D.)
  *  @constant kQ3DisplayGroupStateMaskUseBoundingSphere    The bounding sphere is used for culling when rendering.
  *  @constant kQ3DisplayGroupStateMaskIsPicked             The group will be eligible for returning during picking.
  *  @constant kQ3DisplayGroupStateMaskIsWritten            The group will be submitted during writing.
@@ -195,6 +195,66 @@ enum QUESA_ENUM_BASE(TQ3Int32) {
 };
 
 
+/*!
+ *  @enum
+ *      File&nbsp;Property&nbsp;Types
+ *  @discussion
+ *      Object properties that may be set on file objects.
+ *
+ *  @constant kQ3FilePropertyMergeIdenticalObjects
+ *					When this property is true, the binary 3DMF writer compares
+ *					the content of shared objects that are not groups, such as
+ *					TriMeshes, textures and attribute sets.  The first copy of
+ *					some content is written once, and later objects with the
+ *					same content are written as references to it, even if they
+ *					are distinct objects in memory.  This only has an effect in
+ *					normal and database modes, and costs extra time while
+ *					writing, since each such object must be serialized to
+ *					memory to be compared.
+ *
+ *					The property must be set before calling Q3View_StartWriting.
+ *
+ *					Data type: TQ3Boolean.  Default value: kQ3False.
+ *  @constant kQ3FilePropertyStreamingWrite
+ *					The binary 3DMF writer writes each object submitted at the
+ *					top level, or within a top-level group, as soon as it has
+ *					been traversed, and writes the table of contents at the end.
+ *					Normally it also keeps a reference to every shared object
+ *					that it writes, so that it can recognize the object if it is
+ *					submitted again.  When this property is true, the writer
+ *					only keeps weak references, so that an application that
+ *					creates a huge scene piece by piece can dispose each piece
+ *					after submitting it.  A shared object that is submitted
+ *					again while still alive is still written as a reference.
+ *
+ *					The property must be set before calling Q3View_StartWriting.
+ *
+ *					Data type: TQ3Boolean.  Default value: kQ3False.
+ *  @constant kQ3FilePropertyCompressTriMeshes
+ *					When this property is nonzero, the binary 3DMF writer writes
+ *					each TriMesh as a CompressedTriMesh object, which only
+ *					Quesa can read.  The points, triangles, edges, vertex
+ *					normals and vertex UVs are delta coded and then compressed,
+ *					and other attribute arrays are written as usual.
+ *
+ *					The value is the number of bits to which each point
+ *					coordinate is quantized, within the bounding box of the
+ *					points.  Values from 8 to 24 are used as given, and vertex
+ *					normals are then stored with 16 bits per component, to an
+ *					accuracy of about 0.04 degrees.  Smaller values are treated
+ *					as 8.  Values above 24 store points and normals exactly.
+ *
+ *					The property must be set before calling Q3View_StartWriting.
+ *
+ *					Data type: TQ3Uns32.  Default value: 0.
+ */
+enum QUESA_ENUM_BASE(TQ3Int32) {
+    kQ3FilePropertyMergeIdenticalObjects                    = Q3_OBJECT_TYPE('m', 'i', 'd', 'o'),
+    kQ3FilePropertyStreamingWrite                           = Q3_OBJECT_TYPE('s', 't', 'r', 'w'),
+    kQ3FilePropertyCompressTriMeshes                        = Q3_OBJECT_TYPE('c', 't', 'r', 'm')
+};
+
+
 // File format methods
 enum QUESA_ENUM_BASE(TQ3Int32) {
     // Common
@@ -1146,6 +1206,10 @@ Q3File_GetVersion (
  *      it is automatically closed, therefore you may not need to call
  *		Q3File_Close.
  *
+ *		Storage may buffer the data written to it, so a write error such as
+ *		a full disk may only be reported when the file is closed.  Check the
+ *		result of Q3File_Close when writing a file.
+ *
  *  @param theFile          The file object.
  *  @result                 Success or failure of the operation.
  */
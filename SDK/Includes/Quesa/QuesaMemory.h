@@ -76,7 +76,7 @@ extern "C" {
 	@constant	kQ3MemoryStatisticsStructureVersion
 	@abstract	Current version of TQ3MemoryStatistics structure.
 */
-#define	kQ3MemoryStatisticsStructureVersion	1
+#define	kQ3MemoryStatisticsStructureVersion	3
 
 
 
@@ -95,6 +95,30 @@ extern "C" {
 	@field		currentBytes		Current number of memory bytes allocated by Quesa.
 	@field		maxBytes			Maximum number of memory bytes allocated by Quesa
 									("high-water mark").
+	@field		totalAllocations	Number of memory blocks allocated by Quesa since
+									it was loaded.  Comparing values before and after
+									rendering a frame tells you how many heap
+									allocations the frame needed.
+									(Structure version 2 or later.)
+	@field		frameScratchAllocations	Number of temporary allocations that have been
+									satisfied from per-view frame scratch memory
+									rather than the heap, since Quesa was loaded.
+									(Structure version 2 or later.)
+	@field		frameScratchBytes	Number of bytes currently reserved for frame
+									scratch memory by all views.
+									(Structure version 2 or later.)
+	@field		poolReservedBytes	Number of bytes obtained from the system for the
+									pools that serve small allocations.  Pool memory
+									is reused but never given back, so this is also
+									the high-water mark of the pools.
+									(Structure version 3 or later.)
+	@field		poolBytes			Number of bytes in pool blocks currently allocated.
+									The difference between poolReservedBytes and
+									poolBytes is memory held by the pools but not in
+									use, i.e., fragmentation.
+									(Structure version 3 or later.)
+	@field		maxPoolBytes		Maximum value of poolBytes.
+									(Structure version 3 or later.)
 */
 typedef struct TQ3MemoryStatistics
 {
@@ -103,6 +127,16 @@ typedef struct TQ3MemoryStatistics
 	TQ3Uns32	maxAllocations;
 	TQ3Int64	currentBytes;
 	TQ3Int64	maxBytes;
+	
+	// Fields added in version 2
+	TQ3Uns32	totalAllocations;
+	TQ3Uns32	frameScratchAllocations;
+	TQ3Int64	frameScratchBytes;
+	
+	// Fields added in version 3
+	TQ3Int64	poolReservedBytes;
+	TQ3Int64	poolBytes;
+	TQ3Int64	maxPoolBytes;
 } TQ3MemoryStatistics;
 
 
@@ -518,6 +552,9 @@ Q3Memory_DumpRecording(
  *
  *	@param		info		Structure to receive memory statistics.  You must initialize
  *							the structureVersion field to kQ3MemoryStatisticsStructureVersion.
+ *							Earlier versions of the structure are still accepted, in
+ *							which case the fields added in later versions are not
+ *							touched.
  *	@result		Success or failure of the operation.
  */
 #if QUESA_ALLOW_QD3D_EXTENSIONS
@@ -257,6 +257,57 @@ typedef struct TQ3WorldRayPickData {
 } TQ3WorldRayPickData;
 
 
+/*!
+ *  @struct
+ *      TQ3WorldRayBatchPickData
+ *  @discussion
+ *      Describes the state for a world-ray batch pick object.
+ *
+ *		A batch pick tests many world rays in a single pass over the scene,
+ *		keeping the nearest surface hit for each ray.  Only surfaces are
+ *		tested: Triangles, TriMeshes, and geometries which decompose into
+ *		them.  The numHitsToReturn and sort fields of data are ignored.
+ *
+ *  @field data             The common state for the pick.
+ *  @field numRays          The number of rays.
+ *  @field rays             The pick rays in world coordinates, which are copied.
+ *							The directions must be normalized.
+ */
+typedef struct TQ3WorldRayBatchPickData {
+    TQ3PickData                                 data;
+    TQ3Uns32                                    numRays;
+    const TQ3Ray3D                              * _Nullable rays;
+} TQ3WorldRayBatchPickData;
+
+
+/*!
+ *  @struct
+ *      TQ3WorldRayBatchHit
+ *  @discussion
+ *      The nearest hit for one ray of a world-ray batch pick.
+ *
+ *  @field didHit           Whether the ray hit anything.  The remaining fields
+ *							are only valid if it did.
+ *  @field hitDistance      Distance from the ray origin to the hit.
+ *  @field hitXYZ           The hit point in world coordinates.
+ *  @field hitNormal        The normalized face normal at the hit, in world coordinates.
+ *  @field pickedID         The pick ID style state of the hit object.
+ *  @field triMeshFaceIndex The index of the hit triangle within a TriMesh, or
+ *							kQ3ArrayIndexNULL.
+ *  @field pickedObject     The hit object.  The reference belongs to the pick
+ *							object, and is released when its hits are emptied.
+ */
+typedef struct TQ3WorldRayBatchHit {
+    TQ3Boolean                                  didHit;
+    float                                       hitDistance;
+    TQ3Point3D                                  hitXYZ;
+    TQ3Vector3D                                 hitNormal;
+    TQ3Uns32                                    pickedID;
+    TQ3Uns32                                    triMeshFaceIndex;
+    TQ3Object                                   _Nullable pickedObject;
+} TQ3WorldRayBatchHit;
+
+
 /*!
  *  @struct
  *      TQ3HitPath
@@ -868,6 +919,101 @@ Q3WorldRayPick_SetData (
     const TQ3WorldRayPickData     * _Nonnull data
 );
 
+/*!
+	@functiongroup	World Ray Batch Picking
+*/
+
+/*!
+ *  @function
+ *      Q3WorldRayBatchPick_New
+ *  @discussion
+ *      Create a new world-ray batch pick object.
+ *
+ *		Picking with a batch pick is much faster than picking each ray
+ *		with its own world-ray pick, since the scene is traversed once and
+ *		rays are tested against geometry in groups.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param data             The data for the pick object.
+ *  @result                 The new pick object.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3PickObject _Nullable )
+Q3WorldRayBatchPick_New (
+    const TQ3WorldRayBatchPickData     * _Nonnull data
+);
+
+
+
+/*!
+ *  @function
+ *      Q3WorldRayBatchPick_GetNumRays
+ *  @discussion
+ *      Get the number of rays of a world-ray batch pick object.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param pick             The pick object to query.
+ *  @param numRays          Receives the number of rays.
+ *  @result                 Success or failure of the operation.
+ */
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3WorldRayBatchPick_GetNumRays (
+    TQ3PickObject _Nonnull                pick,
+    TQ3Uns32                      * _Nonnull numRays
+);
+
+
+
+/*!
+ *  @function
+ *      Q3WorldRayBatchPick_SetRays
+ *  @discussion
+ *      Set the rays of a world-ray batch pick object.  This also empties
+ *      the hit list.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param pick             The pick object to update.
+ *  @param numRays          The number of rays.
+ *  @param rays             The new rays, which are copied.  The directions must
+ *							be normalized.
+ *  @result                 Success or failure of the operation.
+ */
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3WorldRayBatchPick_SetRays (
+    TQ3PickObject _Nonnull                pick,
+    TQ3Uns32                              numRays,
+    const TQ3Ray3D                * _Nullable rays
+);
+
+
+
+/*!
+ *  @function
+ *      Q3WorldRayBatchPick_GetHits
+ *  @discussion
+ *      Get the nearest hit for every ray of a world-ray batch pick object.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param pick             The pick object to query.
+ *  @param hits             Receives one hit for each ray, in the order of the
+ *							rays.  Must have room for the number of rays.
+ *  @result                 Success or failure of the operation.
+ */
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3WorldRayBatchPick_GetHits (
+    TQ3PickObject _Nonnull                pick,
+    TQ3WorldRayBatchHit           * _Nonnull hits
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
 /*!
 	@functiongroup	Object Parts
 */
@@ -282,6 +282,106 @@ enum QUESA_ENUM_BASE(TQ3Int32)
 					for more information.
 					
 					Data type: TQ3CastShadowsOverrideCallback.  Default: nullptr.
+	
+	@constant	kQ3RendererPropertyBackgroundTexturePrep
+					When true, the OpenGL renderer converts texture pixels and
+					computes mipmaps on worker threads, rather than doing all
+					the work at the moment a texture is first drawn.  Until a
+					texture is ready, geometry using it is drawn untextured,
+					so the application should keep rendering frames while
+					kQ3RendererPropertyPendingTextureCount is nonzero, and
+					render one more frame once it drops to zero so that the
+					last textures to finish are uploaded.
+					
+					Data type: TQ3Boolean.  Default: kQ3False.
+	
+	@constant	kQ3RendererPropertyPendingTextureCount
+					The OpenGL renderer sets this property at the end of each
+					frame to report how many textures are still being prepared
+					in the background.  See
+					kQ3RendererPropertyBackgroundTexturePrep.
+					
+					Data type: TQ3Uns32.
+	
+	@constant	kQ3RendererPropertyShaderCacheDirectory
+					Path of an existing directory, in the encoding used by the
+					C library's fopen, where the OpenGL renderer may save
+					linked shader program binaries.  Saved binaries are keyed
+					by the shader source and the OpenGL vendor, renderer and
+					version strings, so a driver update simply causes programs
+					to be compiled and saved again.  The renderer also keeps a
+					list of the programs it has created in this directory, for
+					use with kQ3RendererPropertyPrewarmShaders.  Requires
+					OpenGL 4.1 or ARB_get_program_binary; otherwise only the
+					list of programs is kept.
+					
+					Data type: NUL-terminated C string.  Default: none.
+	
+	@constant	kQ3RendererPropertyPrewarmShaders
+					When this property is set to kQ3True, the OpenGL renderer
+					creates, at the start of the next frame, every shader
+					program listed in the directory given by
+					kQ3RendererPropertyShaderCacheDirectory, and then removes
+					the property.  An application can set it while showing a
+					loading screen, so that programs are not compiled in the
+					middle of later frames.
+					
+					Data type: TQ3Boolean.  Default: kQ3False.
+	
+	@constant	kQ3RendererPropertyBufferBindCount
+					The OpenGL renderer sets this property at the end of each
+					pass to report how many times it has bound an OpenGL
+					buffer object so far in the current frame.
+					
+					Data type: TQ3Uns32.
+	
+	@constant	kQ3RendererPropertyDrawCallCount
+					The OpenGL renderer sets this property at the end of each
+					pass to report how many OpenGL draw calls it has made so far
+					in the current frame.  Cached geometries that share buffers
+					may be drawn by a single call.
+					
+					Data type: TQ3Uns32.
+	
+	@constant	kQ3RendererPropertyStateChangeCount
+					The OpenGL renderer sets this property at the end of each
+					pass to report how many calls it has made so far in the
+					current frame to change capabilities, blending, depth,
+					culling, texture bindings, the current program, or
+					uniform values.
+					
+					Data type: TQ3Uns32.
+	
+	@constant	kQ3RendererPropertyElidedStateChangeCount
+					The OpenGL renderer sets this property at the end of each
+					pass to report how many requests to change the state
+					listed under kQ3RendererPropertyStateChangeCount it has
+					skipped so far in the current frame, because they would
+					have set a value that was already in effect.
+					
+					Data type: TQ3Uns32.
+	
+	@constant	kQ3RendererPropertySortOpaqueDraws
+					When this property is kQ3True, the OpenGL renderer does
+					not draw opaque TriMeshes that use its VBO cache as they
+					are submitted.  Instead it queues them and, at the end of
+					each pass, draws them sorted by shader program, texture
+					and material, so that fewer state changes are needed.
+					
+					Geometries that use specular or emissive maps, alpha-tested
+					textures, a clipping plane, a depth compare function other
+					than Less or LessEqual, or a nondefault write switch or
+					depth range are still drawn immediately, and nothing is
+					sorted in frames with shadows.  A queued geometry that is
+					edited before the end of the pass is drawn as edited.
+					
+					Queued geometries are drawn after all the opaque geometry
+					of the pass that is drawn immediately, whatever order they
+					were submitted in.  Since the drawing order changes,
+					coplanar opaque surfaces that are not separated by layer
+					shifting may resolve differently.
+					
+					Data type: TQ3Boolean.  Default: kQ3False.
 */
 enum QUESA_ENUM_BASE(TQ3Int32)
 {
@@ -305,7 +405,16 @@ enum QUESA_ENUM_BASE(TQ3Int32)
 	kQ3RendererPropertyPrimitivesRenderedCount      = Q3_OBJECT_TYPE('p', 'r', 'n', 'c'),
 	kQ3RendererPropertyIsLayerShifting              = Q3_OBJECT_TYPE('r', 'i', 'l', 's'),
 	kQ3RendererPropertyClippingPlane                = Q3_OBJECT_TYPE('c', 'l', 'i', 'p'),
-	kQ3RendererPropertyCastShadowsOverride          = Q3_OBJECT_TYPE('c', 's', 'o', 'c')
+	kQ3RendererPropertyCastShadowsOverride          = Q3_OBJECT_TYPE('c', 's', 'o', 'c'),
+	kQ3RendererPropertyBackgroundTexturePrep        = Q3_OBJECT_TYPE('b', 'g', 't', 'p'),
+	kQ3RendererPropertyPendingTextureCount          = Q3_OBJECT_TYPE('p', 't', 'x', 'c'),
+	kQ3RendererPropertyShaderCacheDirectory         = Q3_OBJECT_TYPE('s', 'c', 'd', 'r'),
+	kQ3RendererPropertyPrewarmShaders               = Q3_OBJECT_TYPE('p', 'w', 's', 'h'),
+	kQ3RendererPropertyBufferBindCount              = Q3_OBJECT_TYPE('b', 'b', 'c', 'n'),
+	kQ3RendererPropertyDrawCallCount                = Q3_OBJECT_TYPE('d', 'r', 'c', 'n'),
+	kQ3RendererPropertyStateChangeCount             = Q3_OBJECT_TYPE('s', 't', 'c', 'n'),
+	kQ3RendererPropertyElidedStateChangeCount       = Q3_OBJECT_TYPE('e', 's', 'c', 'n'),
+	kQ3RendererPropertySortOpaqueDraws              = Q3_OBJECT_TYPE('s', 'o', 'p', 'q')
 };
 
 
@@ -383,6 +383,10 @@ Q3MemoryStorage_Set (
  *      Creates a memory storage object using a given buffer rather than by
  *		allocating Quesa memory.
  *
+ *		This is a cheap way to read a memory-mapped file, since the mapped
+ *		pages are not copied into the storage.  Binary TriMesh arrays are then
+ *		read from the mapped pages directly into the TriMesh's own arrays.
+ *
  *  @param buffer           Pointer to a buffer of data, or nullptr.
  *  @param validSize        Number of bytes of valid data in the provided buffer,
  *							or if buffer was nullptr, the initial size and grow